@@ -0,0 +1,343 @@
+/******************************************************************************
+ * File Name: app_events.cpp
+ *
+ * Description:
+ *   This file contains the application event queue. The work following each
+ *   host wake, the storage of the committed list, the keep-alive connect and
+ *   the printing of the logs run as events, one after the other, on the main
+ *   thread once the application is up. The suspend of the network stack,
+ *   the commits and the HTTP requests block for seconds and keep their own
+ *   threads. Each event is queued at most once; posting a queued event again
+ *   is coalesced with it. The queue measures the latency and the duration of
+ *   every event and its depth.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "app_events.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Each event is queued at most once. */
+#define APP_EVENTS_QUEUE_SIZE      (APP_EVENT_COUNT * EVENTS_EVENT_SIZE)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* State and statistics of an event. */
+typedef struct
+{
+    volatile uint32_t pending;  /* 1 while queued                          */
+    app_event_handler_t handler;
+    int64_t due_us;             /* Time the event is due to run            */
+    volatile uint32_t posted;   /* Posts queued                            */
+    volatile uint32_t coalesced; /* Posts coalesced with a queued one      */
+    volatile uint32_t failed;   /* Posts rejected by the queue             */
+    uint32_t run;               /* Runs                                    */
+    uint32_t latency_max_us;    /* Delay from due to run                   */
+    uint64_t latency_sum_us;
+    uint32_t run_max_us;        /* Duration of the handler                 */
+    uint64_t run_sum_us;
+} app_event_slot_t;
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+static EventQueue queue(APP_EVENTS_QUEUE_SIZE);
+
+/* Time base of the statistics. It runs in deep sleep, so that the latency
+ * of an event due while the host sleeps includes the sleep.
+ */
+static LowPowerTimer event_clock;
+
+static app_event_slot_t events[APP_EVENT_COUNT];
+
+/* Events queued, and the most queued at once. */
+static volatile uint32_t depth = 0;
+static uint32_t depth_max = 0;
+
+/* Set once the main thread dispatches the queue. */
+static volatile bool running = false;
+
+/* Names of the events in the report. */
+static const char *event_names[APP_EVENT_COUNT] = {
+    "wake", "commit_store", "tko", "log"
+};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: app_events_run
+ ******************************************************************************
+ * Summary:
+ *   This function runs an event from the queue and measures it. The event
+ *   is no longer pending when its handler starts, so that a post made
+ *   during the handler queues it again.
+ *
+ * Parameters:
+ *   ev: Event to run.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void app_events_run(app_event_slot_t *ev)
+{
+    int64_t start_us = event_clock.elapsed_time().count();
+    int64_t latency_us = start_us - ev->due_us;
+    uint32_t run_us = 0;
+
+    core_util_atomic_decr_u32(&depth, 1);
+    core_util_atomic_store_u32(&ev->pending, 0);
+
+    ev->handler();
+
+    run_us = (uint32_t)(event_clock.elapsed_time().count() - start_us);
+    latency_us = (latency_us > 0) ? latency_us : 0;
+
+    core_util_critical_section_enter();
+    ev->run++;
+    ev->latency_sum_us += (uint64_t)latency_us;
+    if ((uint32_t)latency_us > ev->latency_max_us)
+    {
+        ev->latency_max_us = (uint32_t)latency_us;
+    }
+    ev->run_sum_us += run_us;
+    if (run_us > ev->run_max_us)
+    {
+        ev->run_max_us = run_us;
+    }
+    core_util_critical_section_exit();
+}
+
+/******************************************************************************
+ * Function Name: app_events_post_in
+ ******************************************************************************
+ * Summary:
+ *   This function queues an event to run after a delay. If the event is
+ *   already queued, the post is coalesced with it and the queued event
+ *   keeps its handler and its time. It takes no lock and may be called from
+ *   any thread or interrupt.
+ *
+ * Parameters:
+ *   event: Event to queue.
+ *   delay_ms: Delay in milliseconds before the event runs.
+ *   handler: Handler of the event.
+ *
+ * Return:
+ *   bool: False if the queue rejected the event.
+ *
+ *****************************************************************************/
+bool app_events_post_in(app_event_t event, uint32_t delay_ms, app_event_handler_t handler)
+{
+    app_event_slot_t *ev = NULL;
+    uint32_t expected = 0;
+    uint32_t queued = 0;
+    int id = 0;
+
+    if ((APP_EVENT_COUNT <= event) || (NULL == handler))
+    {
+        return false;
+    }
+
+    ev = &events[event];
+    if (!core_util_atomic_cas_u32(&ev->pending, &expected, 1))
+    {
+        core_util_atomic_incr_u32(&ev->coalesced, 1);
+        return true;
+    }
+
+    ev->handler = handler;
+    ev->due_us = event_clock.elapsed_time().count() + ((int64_t)delay_ms * 1000);
+    queued = core_util_atomic_incr_u32(&depth, 1);
+    id = (0 == delay_ms) ? queue.call(app_events_run, ev) :
+         queue.call_in(std::chrono::milliseconds(delay_ms), app_events_run, ev);
+    if (0 == id)
+    {
+        /* Never logged: the logs are printed from an event. */
+        core_util_atomic_decr_u32(&depth, 1);
+        core_util_atomic_incr_u32(&ev->failed, 1);
+        core_util_atomic_store_u32(&ev->pending, 0);
+        return false;
+    }
+
+    core_util_atomic_incr_u32(&ev->posted, 1);
+    if (queued > depth_max)
+    {
+        depth_max = queued;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: app_events_post
+ ******************************************************************************
+ * Summary:
+ *   This function queues an event to run as soon as the events queued
+ *   before it have run. See app_events_post_in().
+ *
+ * Parameters:
+ *   event: Event to queue.
+ *   handler: Handler of the event.
+ *
+ * Return:
+ *   bool: False if the queue rejected the event.
+ *
+ *****************************************************************************/
+bool app_events_post(app_event_t event, app_event_handler_t handler)
+{
+    return app_events_post_in(event, 0, handler);
+}
+
+/******************************************************************************
+ * Function Name: app_events_init
+ ******************************************************************************
+ * Summary:
+ *   This function starts the time base of the event statistics. It must be
+ *   called before the first post.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_events_init(void)
+{
+    event_clock.start();
+}
+
+/******************************************************************************
+ * Function Name: app_events_dispatch
+ ******************************************************************************
+ * Summary:
+ *   This function runs the events on the calling thread and never returns.
+ *   It is called by main() once the application is up. The thread is
+ *   lowered below the normal priority, so that the events run when the web
+ *   server and the thread suspending the network stack are idle.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_events_dispatch(void)
+{
+    osThreadSetPriority(osThreadGetId(), osPriorityBelowNormal);
+    running = true;
+    queue.dispatch_forever();
+}
+
+/******************************************************************************
+ * Function Name: app_events_running
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether the queue is dispatched. Before, the events
+ *   posted wait for app_events_dispatch().
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: True once the queue is dispatched.
+ *
+ *****************************************************************************/
+bool app_events_running(void)
+{
+    return running;
+}
+
+/******************************************************************************
+ * Function Name: app_events_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the queue depth and, for each event, the posts,
+ *   the runs, the latency from the time the event was due to its start, and
+ *   the duration of its handler, as text.
+ *
+ * Parameters:
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int app_events_report(char *buf, size_t buf_len)
+{
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    len = snprintf(buf, buf_len,
+                   "Queue depth: %lu (max %lu)\n"
+                   "event         posted coalesced failed   run  latency avg/max us  run avg/max us\n",
+                   (unsigned long)core_util_atomic_load_u32(&depth),
+                   (unsigned long)depth_max);
+
+    for (uint8_t i = 0; (i < APP_EVENT_COUNT) && (len >= 0) && (len < (int)buf_len); i++)
+    {
+        app_event_slot_t ev;
+
+        core_util_critical_section_enter();
+        ev = events[i];
+        core_util_critical_section_exit();
+
+        len += snprintf(&buf[len], buf_len - len,
+                        "%-12s %7lu %9lu %6lu %5lu %9lu/%-9lu %7lu/%-7lu\n",
+                        event_names[i],
+                        (unsigned long)ev.posted,
+                        (unsigned long)ev.coalesced,
+                        (unsigned long)ev.failed,
+                        (unsigned long)ev.run,
+                        (unsigned long)(ev.run ? (ev.latency_sum_us / ev.run) : 0),
+                        (unsigned long)ev.latency_max_us,
+                        (unsigned long)(ev.run ? (ev.run_sum_us / ev.run) : 0),
+                        (unsigned long)ev.run_max_us);
+    }
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
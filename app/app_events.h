@@ -0,0 +1,82 @@
+/******************************************************************************
+ * File Name: app_events.h
+ *
+ * Description:
+ *   This header file contains the event IDs and the function declarations
+ *   of the application event queue.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef APP_EVENTS_H
+#define APP_EVENTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Buffer length required to report the event statistics as text. */
+#define APP_EVENTS_REPORT_LEN              (512)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Events of the application event queue. */
+typedef enum
+{
+    APP_EVENT_WAKE = 0,         /* Host awake: telemetry and rebalancing   */
+    APP_EVENT_COMMIT_STORE,     /* Storage of the committed filter list    */
+    APP_EVENT_TKO,              /* Connect of the TCP keep-alive socket    */
+    APP_EVENT_LOG,              /* Printing of the deferred logs           */
+    APP_EVENT_COUNT
+} app_event_t;
+
+/* Handler of an event. */
+typedef void (*app_event_handler_t)(void);
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void app_events_init(void);
+void app_events_dispatch(void);
+bool app_events_running(void);
+bool app_events_post(app_event_t event, app_event_handler_t handler);
+bool app_events_post_in(app_event_t event, uint32_t delay_ms, app_event_handler_t handler);
+int app_events_report(char *buf, size_t buf_len);
+
+#endif /* #ifndef APP_EVENTS_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,555 @@
+/******************************************************************************
+ * File Name: app_log.cpp
+ *
+ * Description:
+ *   This file contains the deferred console log: a lock-free ring of log
+ *   records written at the call sites, printed as text or sent as binary
+ *   frames from an event of the application event queue.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "app_log.h"
+#include "app_events.h"
+
+#if (MBED_CONF_APP_LOG_DEFERRED_ENABLE)
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+#if (0 != (MBED_CONF_APP_LOG_RING_SLOTS & (MBED_CONF_APP_LOG_RING_SLOTS - 1)))
+#error "log-ring-slots must be a power of two"
+#endif
+
+/* Length of a log printed as text and of a conversion specification. */
+#define APP_LOG_LINE_LEN           (160)
+#define APP_LOG_SPEC_LEN           (16)
+
+/* Flag of the length byte of a truncated string argument. */
+#define APP_LOG_STR_TRUNCATED      (0x80)
+
+/* Bytes of a binary frame before the arguments: sync, length, format
+ * address, tick and level. A checksum byte follows the arguments.
+ */
+#define APP_LOG_FRAME_HDR_LEN      (11)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/*
+ * Slot of the ring. The sequence number tells the state of the slot for the
+ * ring position pos = index + k * slots: pos when free for a writer, pos + 1
+ * when written. It is stored minus the index of the slot, so that the ring
+ * is ready before any constructor runs.
+ */
+typedef struct
+{
+    volatile uint32_t seq;
+    uint32_t pos;               /* Position reserved by the writer        */
+    app_log_record_t rec;
+} app_log_slot_t;
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+static app_log_slot_t ring[MBED_CONF_APP_LOG_RING_SLOTS];
+
+/* Next position to write, shared by the writers, and to print, owned by the
+ * reader holding drain_mutex.
+ */
+static volatile uint32_t write_pos = 0;
+static uint32_t read_pos = 0;
+
+/* Logs dropped because the ring was full, since the last report. */
+static volatile uint32_t drop_count = 0;
+
+static Mutex drain_mutex;
+
+/* Output buffer of the reader, used under drain_mutex. */
+#if (MBED_CONF_APP_LOG_BINARY_ENABLE)
+static uint8_t frame[APP_LOG_FRAME_HDR_LEN + APP_LOG_ARGS_LEN + 1];
+#else
+static char line[APP_LOG_LINE_LEN];
+#endif
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: app_log_reserve
+ ******************************************************************************
+ * Summary:
+ *   This function reserves the next record of the ring for a log. It takes
+ *   no lock and may be called from any thread or interrupt; concurrent
+ *   writers take distinct records with a compare and swap on the write
+ *   position. The record must be handed back with app_log_commit().
+ *
+ * Parameters:
+ *   level: APP_LOG_LEVEL_ERROR or APP_LOG_LEVEL_INFO.
+ *   fmt: Format string of the log, kept by address.
+ *
+ * Return:
+ *   app_log_record_t *: Record to fill, or NULL if the ring is full.
+ *
+ *****************************************************************************/
+app_log_record_t *app_log_reserve(uint8_t level, const char *fmt)
+{
+    uint32_t pos = core_util_atomic_load_u32(&write_pos);
+    app_log_slot_t *slot = NULL;
+
+    while (1)
+    {
+        uint32_t index = pos & (MBED_CONF_APP_LOG_RING_SLOTS - 1);
+        int32_t diff;
+
+        slot = &ring[index];
+        diff = (int32_t)(core_util_atomic_load_u32(&slot->seq) + index - pos);
+        if (0 == diff)
+        {
+            if (core_util_atomic_cas_u32(&write_pos, &pos, pos + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* The slot still holds the log written one lap earlier. */
+            core_util_atomic_incr_u32(&drop_count, 1);
+            return NULL;
+        }
+        else
+        {
+            pos = core_util_atomic_load_u32(&write_pos);
+        }
+    }
+
+    slot->pos = pos;
+    slot->rec.fmt = fmt;
+    slot->rec.tick = osKernelGetTickCount();
+    slot->rec.level = level;
+    slot->rec.len = 0;
+
+    return &slot->rec;
+}
+
+/******************************************************************************
+ * Function Name: app_log_commit
+ ******************************************************************************
+ * Summary:
+ *   This function hands a filled record over to the reader. Once the event
+ *   queue is dispatched, it posts the log event, which prints the records
+ *   after the events queued before it; until then, as at boot, the records
+ *   are printed at once, except from an interrupt.
+ *
+ * Parameters:
+ *   rec: Record returned by app_log_reserve().
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_log_commit(app_log_record_t *rec)
+{
+    app_log_slot_t *slot = (app_log_slot_t *)((uint8_t *)rec - offsetof(app_log_slot_t, rec));
+    uint32_t index = (uint32_t)(slot - ring);
+
+    core_util_atomic_store_u32(&slot->seq, slot->pos + 1 - index);
+
+    if (app_events_running())
+    {
+        app_events_post(APP_EVENT_LOG, app_log_flush);
+    }
+    else if (!core_util_is_isr_active())
+    {
+        app_log_flush();
+    }
+}
+
+/******************************************************************************
+ * Function Name: app_log_put
+ ******************************************************************************
+ * Summary:
+ *   This function appends an argument to a record, preceded by its type.
+ *   An argument which does not fit is dropped and printed as "?".
+ *
+ * Parameters:
+ *   rec: Record being filled.
+ *   type: app_log_arg_t of the argument.
+ *   value: Bytes of the argument.
+ *   len: Number of bytes.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_log_put(app_log_record_t *rec, uint8_t type, const void *value, size_t len)
+{
+    if ((rec->len + 1 + len) > APP_LOG_ARGS_LEN)
+    {
+        rec->len = APP_LOG_ARGS_LEN;
+        return;
+    }
+
+    rec->args[rec->len] = type;
+    memcpy(&rec->args[rec->len + 1], value, len);
+    rec->len += (uint8_t)(1 + len);
+}
+
+/******************************************************************************
+ * Function Name: app_log_put
+ ******************************************************************************
+ * Summary:
+ *   This function appends a string argument to a record. The string is
+ *   copied, since it may not outlive the call, and truncated to the room
+ *   left in the record.
+ *
+ * Parameters:
+ *   rec: Record being filled.
+ *   value: String, or NULL.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_log_put(app_log_record_t *rec, const char *value)
+{
+    size_t room = APP_LOG_ARGS_LEN - rec->len;
+    size_t len = (NULL != value) ? strlen(value) : 0;
+    uint8_t flags = 0;
+
+    if (room < 2)
+    {
+        rec->len = APP_LOG_ARGS_LEN;
+        return;
+    }
+
+    if (len > (room - 2))
+    {
+        len = room - 2;
+        flags = APP_LOG_STR_TRUNCATED;
+    }
+
+    rec->args[rec->len] = APP_LOG_ARG_STR;
+    rec->args[rec->len + 1] = (uint8_t)(len | flags);
+    memcpy(&rec->args[rec->len + 2], value, len);
+    rec->len += (uint8_t)(2 + len);
+}
+
+#if (MBED_CONF_APP_LOG_BINARY_ENABLE)
+/******************************************************************************
+ * Function Name: app_log_output
+ ******************************************************************************
+ * Summary:
+ *   This function sends a record as a binary frame: APP_LOG_FRAME_SYNC, the
+ *   length of the rest of the frame before the checksum, the format address
+ *   and the tick in little endian, the level, the arguments, and the XOR of
+ *   the bytes after the sync. The frame is written to the console file
+ *   handle, bypassing the newline conversion of the C library.
+ *
+ * Parameters:
+ *   rec: Record to send.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void app_log_output(const app_log_record_t *rec)
+{
+    uint32_t fmt = (uint32_t)(uintptr_t)rec->fmt;
+    size_t len = APP_LOG_FRAME_HDR_LEN + rec->len;
+    uint8_t check = 0;
+
+    frame[0] = APP_LOG_FRAME_SYNC;
+    frame[1] = (uint8_t)(len - 2);
+    memcpy(&frame[2], &fmt, sizeof(fmt));
+    memcpy(&frame[6], &rec->tick, sizeof(rec->tick));
+    frame[10] = rec->level;
+    memcpy(&frame[APP_LOG_FRAME_HDR_LEN], rec->args, rec->len);
+    for (size_t i = 1; i < len; i++)
+    {
+        check ^= frame[i];
+    }
+    frame[len] = check;
+
+    fflush(stdout);
+    mbed_file_handle(STDOUT_FILENO)->write(frame, len + 1);
+}
+#else
+/******************************************************************************
+ * Function Name: app_log_format_arg
+ ******************************************************************************
+ * Summary:
+ *   This function formats one argument of a record with a conversion
+ *   specification. The length modifier of the specification is replaced by
+ *   the one matching the stored type, so that the argument is read back as
+ *   it was stored whatever the modifier of the format string.
+ *
+ * Parameters:
+ *   out: Output buffer.
+ *   out_len: Length of the output buffer.
+ *   spec: Flags, width and precision, after the '%'.
+ *   conv: Conversion character.
+ *   arg: Argument, starting with its type, or NULL if missing.
+ *
+ * Return:
+ *   int: Number of characters written, as snprintf.
+ *
+ *****************************************************************************/
+static int app_log_format_arg(char *out, size_t out_len, const char *spec,
+                              char conv, const uint8_t *arg)
+{
+    char fmt[APP_LOG_SPEC_LEN + 4];
+    uint8_t type = (NULL != arg) ? arg[0] : 0;
+    bool is_int = (NULL != strchr("diouxXc", conv));
+    uint32_t v32 = 0;
+    uint64_t v64 = 0;
+
+    if ((APP_LOG_ARG_I32 == type) || (APP_LOG_ARG_PTR == type))
+    {
+        memcpy(&v32, &arg[1], sizeof(v32));
+    }
+    else if ((APP_LOG_ARG_I64 == type) || (APP_LOG_ARG_F64 == type))
+    {
+        memcpy(&v64, &arg[1], sizeof(v64));
+    }
+
+    if (is_int && (APP_LOG_ARG_I32 == type))
+    {
+        snprintf(fmt, sizeof(fmt), "%%%s%c", spec, conv);
+        return (NULL != strchr("dic", conv)) ?
+               snprintf(out, out_len, fmt, (int)v32) :
+               snprintf(out, out_len, fmt, (unsigned int)v32);
+    }
+    else if (is_int && (APP_LOG_ARG_I64 == type))
+    {
+        snprintf(fmt, sizeof(fmt), "%%%sll%c", spec, conv);
+        return (NULL != strchr("di", conv)) ?
+               snprintf(out, out_len, fmt, (long long)v64) :
+               snprintf(out, out_len, fmt, (unsigned long long)v64);
+    }
+    else if ((NULL != strchr("fFeEgGaA", conv)) && (APP_LOG_ARG_F64 == type))
+    {
+        double d;
+
+        memcpy(&d, &v64, sizeof(d));
+        snprintf(fmt, sizeof(fmt), "%%%s%c", spec, conv);
+        return snprintf(out, out_len, fmt, d);
+    }
+    else if (('s' == conv) && (APP_LOG_ARG_STR == type))
+    {
+        char str[APP_LOG_ARGS_LEN];
+        uint8_t len = arg[1] & ~APP_LOG_STR_TRUNCATED;
+
+        memcpy(str, &arg[2], len);
+        str[len] = '\0';
+        snprintf(fmt, sizeof(fmt), "%%%s%s", spec,
+                 (arg[1] & APP_LOG_STR_TRUNCATED) ? "s..." : "s");
+        return snprintf(out, out_len, fmt, str);
+    }
+    else if (('p' == conv) && ((APP_LOG_ARG_PTR == type) || (APP_LOG_ARG_I32 == type)))
+    {
+        snprintf(fmt, sizeof(fmt), "%%%sp", spec);
+        return snprintf(out, out_len, fmt, (void *)(uintptr_t)v32);
+    }
+
+    return snprintf(out, out_len, "?");
+}
+
+/******************************************************************************
+ * Function Name: app_log_next_arg
+ ******************************************************************************
+ * Summary:
+ *   This function returns the argument of a record following another one.
+ *
+ * Parameters:
+ *   rec: Record.
+ *   arg: Current argument, starting with its type.
+ *
+ * Return:
+ *   const uint8_t *: Next argument, or NULL after the last one.
+ *
+ *****************************************************************************/
+static const uint8_t *app_log_next_arg(const app_log_record_t *rec, const uint8_t *arg)
+{
+    size_t len = 0;
+
+    if (NULL == arg)
+    {
+        return NULL;
+    }
+
+    switch (arg[0])
+    {
+        case APP_LOG_ARG_I32:
+        case APP_LOG_ARG_PTR:
+            len = 1 + sizeof(uint32_t);
+            break;
+        case APP_LOG_ARG_I64:
+        case APP_LOG_ARG_F64:
+            len = 1 + sizeof(uint64_t);
+            break;
+        case APP_LOG_ARG_STR:
+            len = 2 + (arg[1] & ~APP_LOG_STR_TRUNCATED);
+            break;
+        default:
+            return NULL;
+    }
+
+    arg += len;
+
+    return (arg < &rec->args[rec->len]) ? arg : NULL;
+}
+
+/******************************************************************************
+ * Function Name: app_log_output
+ ******************************************************************************
+ * Summary:
+ *   This function prints a record as text, as printf would have printed the
+ *   log at the call site. The '*' width and precision are not supported.
+ *
+ * Parameters:
+ *   rec: Record to print.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void app_log_output(const app_log_record_t *rec)
+{
+    const uint8_t *arg = (0 != rec->len) ? &rec->args[0] : NULL;
+    const char *p = rec->fmt;
+    size_t len = 0;
+
+    while (('\0' != *p) && (len < (sizeof(line) - 1)))
+    {
+        char spec[APP_LOG_SPEC_LEN];
+        size_t spec_len = 0;
+        int n;
+
+        if ('%' != *p)
+        {
+            line[len++] = *p++;
+            continue;
+        }
+
+        p++;
+        if ('%' == *p)
+        {
+            line[len++] = *p++;
+            continue;
+        }
+
+        /* Flags, width and precision, then the length modifier. */
+        while (('\0' != *p) && (NULL != strchr("-+ #0123456789.", *p)))
+        {
+            if (spec_len < (sizeof(spec) - 1))
+            {
+                spec[spec_len++] = *p;
+            }
+            p++;
+        }
+        spec[spec_len] = '\0';
+        while (('\0' != *p) && (NULL != strchr("hljztL", *p)))
+        {
+            p++;
+        }
+        if ('\0' == *p)
+        {
+            break;
+        }
+
+        n = app_log_format_arg(&line[len], sizeof(line) - len, spec, *p++, arg);
+        if (n > 0)
+        {
+            len += (size_t)n;
+        }
+        arg = app_log_next_arg(rec, arg);
+    }
+
+    line[(len < sizeof(line)) ? len : (sizeof(line) - 1)] = '\0';
+    printf("%s%s", (APP_LOG_LEVEL_ERROR == rec->level) ? "Error: " : "Info: ", line);
+}
+#endif /* #if (MBED_CONF_APP_LOG_BINARY_ENABLE) */
+
+/******************************************************************************
+ * Function Name: app_log_flush
+ ******************************************************************************
+ * Summary:
+ *   This function prints the records written so far, in the calling thread.
+ *   A record reserved but not yet committed stops the printing until the
+ *   next call. Call it before an assertion so that the last logs are not
+ *   lost; do not call it from an interrupt.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void app_log_flush(void)
+{
+    ScopedMutexLock lock(drain_mutex);
+    uint32_t dropped;
+
+    while (1)
+    {
+        uint32_t index = read_pos & (MBED_CONF_APP_LOG_RING_SLOTS - 1);
+        app_log_slot_t *slot = &ring[index];
+        app_log_record_t rec;
+
+        if (core_util_atomic_load_u32(&slot->seq) + index != (read_pos + 1))
+        {
+            break;
+        }
+
+        /* Free the slot before the slow output. */
+        rec = slot->rec;
+        core_util_atomic_store_u32(&slot->seq, read_pos + MBED_CONF_APP_LOG_RING_SLOTS - index);
+        read_pos++;
+
+        app_log_output(&rec);
+    }
+
+    dropped = core_util_atomic_exchange_u32(&drop_count, 0);
+    if (0 != dropped)
+    {
+        printf("Error: %lu logs dropped, the log ring is full\n", (unsigned long)dropped);
+    }
+}
+
+#endif /* #if (MBED_CONF_APP_LOG_DEFERRED_ENABLE) */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * File Name: app_log.h
+ *
+ * Description:
+ *   This header file contains the console log macros of the application.
+ *   The logs are written into a ring and printed later from the application
+ *   event queue, see app_log.cpp. Without Mbed OS the header depends on the C
+ *   library only and the logs are printed at once, so that the modules
+ *   including it can be compiled outside of Mbed OS.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+
+/******************************************************************************
+ *                               MACROS
+ *****************************************************************************/
+/* Log levels. The logs above MBED_CONF_APP_LOG_LEVEL are compiled out. */
+#define APP_LOG_LEVEL_NONE                 (0)
+#define APP_LOG_LEVEL_ERROR                (1)
+#define APP_LOG_LEVEL_INFO                 (2)
+
+#ifndef MBED_CONF_APP_LOG_LEVEL
+#define MBED_CONF_APP_LOG_LEVEL            (APP_LOG_LEVEL_INFO)
+#endif
+
+/*
+ * 1 to write the logs into the ring and print them from the event queue,
+ * 0 to print them at once with printf as before.
+ */
+#ifndef MBED_CONF_APP_LOG_DEFERRED_ENABLE
+#if defined(__MBED__)
+#define MBED_CONF_APP_LOG_DEFERRED_ENABLE  (1)
+#else
+#define MBED_CONF_APP_LOG_DEFERRED_ENABLE  (0)
+#endif
+#endif
+
+/*
+ * 1 to send the deferred logs as binary frames decoded on the host by
+ * tools/log_decode.py, 0 to print them as text.
+ */
+#ifndef MBED_CONF_APP_LOG_BINARY_ENABLE
+#define MBED_CONF_APP_LOG_BINARY_ENABLE    (0)
+#endif
+
+/* Records of the ring. A log written while the ring is full is dropped. */
+#ifndef MBED_CONF_APP_LOG_RING_SLOTS
+#define MBED_CONF_APP_LOG_RING_SLOTS       (32)
+#endif
+
+/* Bytes of arguments of a record. A string argument is truncated to the
+ * room left; the log is printed with "..." at the cut.
+ */
+#define APP_LOG_ARGS_LEN                   (50)
+
+/* Start of a binary log frame; the other console output is text. */
+#define APP_LOG_FRAME_SYNC                 (0x1E)
+
+/*
+ * The logs take the printf arguments in an extra pair of parentheses:
+ * APP_INFO(("Port %u\n", port)). The format is checked by the compiler
+ * through app_log_check(), which is never called. A log compiled out still
+ * names its arguments, so that they are not reported as unused.
+ */
+#define APP_LOG_DISCARD(x)         do { (void)sizeof(app_log_check x); } while(0);
+
+#if (MBED_CONF_APP_LOG_DEFERRED_ENABLE)
+#define APP_LOG_WRITE(level, x)    do { (void)sizeof(app_log_check x); \
+                                        app_log_writer<level>::write x; } while(0);
+#else
+#define APP_LOG_WRITE(level, x)    do { printf((APP_LOG_LEVEL_ERROR == level) ? \
+                                               "Error: " : "Info: "); \
+                                        printf x; } while(0);
+#endif
+
+#if (MBED_CONF_APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+#define APP_INFO(x)                APP_LOG_WRITE(APP_LOG_LEVEL_INFO, x)
+#else
+#define APP_INFO(x)                APP_LOG_DISCARD(x)
+#endif
+
+#if (MBED_CONF_APP_LOG_LEVEL >= APP_LOG_LEVEL_ERROR)
+#define ERR_INFO(x)                APP_LOG_WRITE(APP_LOG_LEVEL_ERROR, x)
+#else
+#define ERR_INFO(x)                APP_LOG_DISCARD(x)
+#endif
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Types of the arguments of a record, each stored after its type byte. */
+typedef enum
+{
+    APP_LOG_ARG_I32 = 1,        /* Integer up to 32 bits, 4 bytes          */
+    APP_LOG_ARG_I64,            /* 64-bit integer, 8 bytes                 */
+    APP_LOG_ARG_F64,            /* Floating point, 8 bytes                 */
+    APP_LOG_ARG_STR,            /* String: length byte, then the bytes     */
+    APP_LOG_ARG_PTR             /* Pointer, 4 bytes                        */
+} app_log_arg_t;
+
+/* Log record, filled at the call site and printed from the event queue. */
+typedef struct
+{
+    const char *fmt;            /* Format string, also the ID of the log   */
+    uint32_t tick;              /* Kernel tick count when written          */
+    uint8_t level;              /* APP_LOG_LEVEL_ERROR or _INFO            */
+    uint8_t len;                /* Bytes used in args                      */
+    uint8_t args[APP_LOG_ARGS_LEN];
+} app_log_record_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+int app_log_check(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#if (MBED_CONF_APP_LOG_DEFERRED_ENABLE)
+void app_log_flush(void);
+app_log_record_t *app_log_reserve(uint8_t level, const char *fmt);
+void app_log_commit(app_log_record_t *rec);
+void app_log_put(app_log_record_t *rec, uint8_t type, const void *value, size_t len);
+void app_log_put(app_log_record_t *rec, const char *value);
+#else
+static inline void app_log_flush(void) { fflush(stdout); }
+#endif
+
+/******************************************************************************
+ *                         INLINE FUNCTIONS
+ *****************************************************************************/
+#if (MBED_CONF_APP_LOG_DEFERRED_ENABLE)
+/* Integers and enumerations, stored as 32 or 64 bits. */
+template <typename T>
+inline void app_log_put(app_log_record_t *rec, T value)
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "Unsupported log argument type");
+
+    if (sizeof(T) > sizeof(uint32_t))
+    {
+        uint64_t v = (uint64_t)value;
+        app_log_put(rec, APP_LOG_ARG_I64, &v, sizeof(v));
+    }
+    else
+    {
+        uint32_t v = (uint32_t)value;
+        app_log_put(rec, APP_LOG_ARG_I32, &v, sizeof(v));
+    }
+}
+
+/* Pointers other than strings, stored as their address. */
+template <typename T>
+inline void app_log_put(app_log_record_t *rec, T *value)
+{
+    uint32_t v = (uint32_t)(uintptr_t)value;
+    app_log_put(rec, APP_LOG_ARG_PTR, &v, sizeof(v));
+}
+
+inline void app_log_put(app_log_record_t *rec, char *value)
+{
+    app_log_put(rec, (const char *)value);
+}
+
+inline void app_log_put(app_log_record_t *rec, double value)
+{
+    app_log_put(rec, APP_LOG_ARG_F64, &value, sizeof(value));
+}
+
+inline void app_log_put(app_log_record_t *rec, float value)
+{
+    app_log_put(rec, (double)value);
+}
+
+inline void app_log_put_args(app_log_record_t *rec)
+{
+    (void)rec;
+}
+
+template <typename T, typename... Args>
+inline void app_log_put_args(app_log_record_t *rec, T value, Args... args)
+{
+    app_log_put(rec, value);
+    app_log_put_args(rec, args...);
+}
+
+/* Writes a log of one level. The arguments are copied into a record of the
+ * ring, the strings included; nothing is formatted at the call site.
+ */
+template <uint8_t level>
+struct app_log_writer
+{
+    template <typename... Args>
+    static void write(const char *fmt, Args... args)
+    {
+        app_log_record_t *rec = app_log_reserve(level, fmt);
+
+        if (NULL != rec)
+        {
+            app_log_put_args(rec, args...);
+            app_log_commit(rec);
+        }
+    }
+};
+#endif /* #if (MBED_CONF_APP_LOG_DEFERRED_ENABLE) */
+
+#endif /* #ifndef APP_LOG_H */
+
+
+/* [] END OF FILE */
+
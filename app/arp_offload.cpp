@@ -0,0 +1,241 @@
+/******************************************************************************
+ * File Name: arp_offload.cpp
+ *
+ * Description:
+ *   This file contains the configuration of the ARP offload of the Offload
+ *   Manager. While the host sleeps, the WLAN device answers the ARP requests
+ *   for the IP address of the host, which is set after each connect, and
+ *   optionally learns the peers by snooping and answers the ARP requests of
+ *   the host from its cache. The settings can be changed from the web page;
+ *   they are applied to the WLAN device by the next packet filter commit.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "arp_offload.h"
+#include "whd_emac.h"
+#include "whd_wifi_api.h"
+#include "app_log.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* ARP offload features enabled while the host sleeps. */
+#define ARP_OFFLOAD_SLEEP_MASK(snoop, peer_auto_reply)                         \
+            (CY_ARP_OL_AGENT_ENABLE | CY_ARP_OL_HOST_AUTO_REPLY_ENABLE |       \
+             ((snoop) ? CY_ARP_OL_SNOOP_ENABLE : 0) |                          \
+             ((peer_auto_reply) ? CY_ARP_OL_PEER_AUTO_REPLY_ENABLE : 0))
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/*
+ * While the host is awake, its network stack answers the ARP requests; the
+ * WLAN device only does while the host sleeps.
+ */
+arp_ol_cfg_t arp_ol_cfg =
+{
+    .awake_enable_mask = 0,
+    .sleep_enable_mask = ARP_OFFLOAD_SLEEP_MASK(MBED_CONF_APP_ARP_OFFLOAD_SNOOP,
+                                                MBED_CONF_APP_ARP_OFFLOAD_PEER_AUTO_REPLY),
+    .peerage = MBED_CONF_APP_ARP_OFFLOAD_PEERAGE_S,
+};
+
+/* IP address of the host offloaded after the last connect, 0 if none. */
+static uint32_t host_ip;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: arp_offload_set_host_ip
+ ******************************************************************************
+ * Summary:
+ *   This function replaces the host IP address list of the ARP offload with
+ *   the IP address obtained by DHCP. It is called after each connect.
+ *
+ * Parameters:
+ *   wifi: Connected Wi-Fi interface.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void arp_offload_set_host_ip(WhdSTAInterface *wifi)
+{
+#if MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+    WHD_EMAC &emac = WHD_EMAC::get_instance();
+    SocketAddress sock_addr;
+    uint32_t ip = 0;
+
+    if ((NULL == wifi) || (NSAPI_ERROR_OK != wifi->get_ip_address(&sock_addr)) ||
+        (NSAPI_IPv4 != sock_addr.get_ip_version()))
+    {
+        ERR_INFO(("ARP offload: no IPv4 address\n"));
+        return;
+    }
+
+    /* In network byte order, as stored by the network stack. */
+    memcpy(&ip, sock_addr.get_ip_bytes(), sizeof(ip));
+
+    whd_arp_hostip_list_clear(emac.ifp);
+    if (WHD_SUCCESS != whd_arp_hostip_list_add(emac.ifp, &ip, 1))
+    {
+        ERR_INFO(("ARP offload: failed to set the host IP address\n"));
+        return;
+    }
+    host_ip = ip;
+#endif /* MBED_CONF_APP_ARP_OFFLOAD_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: arp_offload_configure
+ ******************************************************************************
+ * Summary:
+ *   This function changes the settings of the ARP offload. The ARP cache age
+ *   is applied at once; all the settings are applied to the WLAN device by
+ *   the next restart of the Offload Manager, at the next packet filter
+ *   commit.
+ *
+ * Parameters:
+ *   snoop: Learn the peers from the snooped ARP traffic.
+ *   peer_auto_reply: Answer the ARP requests of the host from the cache.
+ *   peerage_s: Age in seconds of the ARP cache entries.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the ARP
+ *     offload is disabled or the age is out of range.
+ *
+ *****************************************************************************/
+cy_rslt_t arp_offload_configure(bool snoop, bool peer_auto_reply, uint32_t peerage_s)
+{
+#if MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+    if (ARP_OFFLOAD_PEERAGE_MAX_S < peerage_s)
+    {
+        ERR_INFO(("ARP offload: cache age %lu s out of range\n", (unsigned long)peerage_s));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    core_util_critical_section_enter();
+    arp_ol_cfg.sleep_enable_mask = ARP_OFFLOAD_SLEEP_MASK(snoop, peer_auto_reply);
+    arp_ol_cfg.peerage = peerage_s;
+    core_util_critical_section_exit();
+
+    if (0 != host_ip)
+    {
+        whd_arp_peerage_set(WHD_EMAC::get_instance().ifp, peerage_s);
+    }
+
+    APP_INFO(("ARP offload: snoop %d, peer auto reply %d, cache age %lu s\n",
+              snoop, peer_auto_reply, (unsigned long)peerage_s));
+
+    return CY_RSLT_SUCCESS;
+#else
+    return CY_RSLT_TYPE_ERROR;
+#endif /* MBED_CONF_APP_ARP_OFFLOAD_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: arp_offload_get_snoop
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether the ARP offload snoops the peers.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: true if snooping is enabled.
+ *
+ *****************************************************************************/
+bool arp_offload_get_snoop(void)
+{
+    return 0 != (arp_ol_cfg.sleep_enable_mask & CY_ARP_OL_SNOOP_ENABLE);
+}
+
+/******************************************************************************
+ * Function Name: arp_offload_get_peer_auto_reply
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether the ARP offload answers the ARP requests of
+ *   the host from its cache.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: true if the peer auto reply is enabled.
+ *
+ *****************************************************************************/
+bool arp_offload_get_peer_auto_reply(void)
+{
+    return 0 != (arp_ol_cfg.sleep_enable_mask & CY_ARP_OL_PEER_AUTO_REPLY_ENABLE);
+}
+
+/******************************************************************************
+ * Function Name: arp_offload_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the state of the ARP offload as text.
+ *
+ * Parameters:
+ *   buf: Buffer receiving the text.
+ *   buf_len: Length of the buffer.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int arp_offload_report(char *buf, size_t buf_len)
+{
+    const uint8_t *ip = (const uint8_t *)&host_ip;
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    len = snprintf(buf, buf_len, "ARP offload %s, host IP %u.%u.%u.%u, snoop %s, "
+                   "peer auto reply %s, cache age %lu s\n",
+                   MBED_CONF_APP_ARP_OFFLOAD_ENABLE ? "enabled" : "disabled",
+                   ip[0], ip[1], ip[2], ip[3],
+                   arp_offload_get_snoop() ? "on" : "off",
+                   arp_offload_get_peer_auto_reply() ? "on" : "off",
+                   (unsigned long)arp_ol_cfg.peerage);
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
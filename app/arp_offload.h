@@ -0,0 +1,96 @@
+/******************************************************************************
+ * File Name: arp_offload.h
+ *
+ * Description:
+ *   This header file contains the macros and the function declarations of
+ *   the ARP offload, which lets the WLAN device answer the ARP requests for
+ *   the IP address of the host while the host sleeps.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef ARP_OFFLOAD_H
+#define ARP_OFFLOAD_H
+
+#include "mbed.h"
+#include "WhdSTAInterface.h"
+#include "cy_lpa_wifi_arp_ol.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* ARP offload is enabled unless disabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+#define MBED_CONF_APP_ARP_OFFLOAD_ENABLE   (1)
+#endif
+
+/* Age in seconds of the entries of the ARP cache of the WLAN device. */
+#ifndef MBED_CONF_APP_ARP_OFFLOAD_PEERAGE_S
+#define MBED_CONF_APP_ARP_OFFLOAD_PEERAGE_S (1200)
+#endif
+
+/* Learn the peers from the ARP traffic snooped by the WLAN device. */
+#ifndef MBED_CONF_APP_ARP_OFFLOAD_SNOOP
+#define MBED_CONF_APP_ARP_OFFLOAD_SNOOP    (1)
+#endif
+
+/* Answer the ARP requests of the host for peers in the ARP cache. */
+#ifndef MBED_CONF_APP_ARP_OFFLOAD_PEER_AUTO_REPLY
+#define MBED_CONF_APP_ARP_OFFLOAD_PEER_AUTO_REPLY (1)
+#endif
+
+/* Largest ARP cache age accepted from the web page, one day. */
+#define ARP_OFFLOAD_PEERAGE_MAX_S          (86400)
+
+/* Buffer length required to report the ARP offload state as text. */
+#define ARP_OFFLOAD_REPORT_LEN             (160)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Configuration of the ARP offload referenced by the offload lists. */
+extern arp_ol_cfg_t arp_ol_cfg;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void arp_offload_set_host_ip(WhdSTAInterface *wifi);
+cy_rslt_t arp_offload_configure(bool snoop, bool peer_auto_reply, uint32_t peerage_s);
+bool arp_offload_get_snoop(void);
+bool arp_offload_get_peer_auto_reply(void);
+int arp_offload_report(char *buf, size_t buf_len);
+
+#endif /* #ifndef ARP_OFFLOAD_H */
+
+
+/* [] END OF FILE */
+
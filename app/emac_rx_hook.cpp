@@ -0,0 +1,522 @@
+/******************************************************************************
+ * File Name: emac_rx_hook.cpp
+ *
+ * Description:
+ *   This file hooks the WLAN receive path. The WHD EMAC driver hands every
+ *   received frame to the link input callback installed by the lwIP network
+ *   stack. The hook is installed in its place so that every frame passes
+ *   through the application before reaching the network stack.
+ *
+ *   The first frames after a host wake are checked against a small host-side
+ *   reject table. A rejected frame is dropped before the suspended network
+ *   stack is notified of any activity, so the host goes straight back to deep
+ *   sleep without resuming the network stack. Every frame is then run
+ *   through the host classifier, which drops the unwanted frames before
+ *   lwIP input.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "whd_emac.h"
+#include "cyhal_syspm.h"
+#include "emac_rx_hook.h"
+#include "wake_latency.h"
+#include "host_classifier.h"
+#include "pf_tier_manager.h"
+#include "storm_detector.h"
+#include "pf_ipv6.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Ethernet frame layout. */
+#define ETH_HDR_LEN                (14)
+#define ETH_TYPE_OFFSET            (12)
+#define ETH_TYPE_IPV4              (0x0800)
+#define ETH_TYPE_ARP               (0x0806)
+#define ETH_ADDR_LEN               (6)
+
+/* ARP packet layout (from the start of the ARP header). */
+#define ARP_PKT_LEN                (28)
+#define ARP_TARGET_IP_OFFSET       (24)
+
+/* IPv4 and UDP header layout (from the start of the respective header). */
+#define IPV4_MIN_HDR_LEN           (20)
+#define IPV4_PROTO_OFFSET          (9)
+#define IPV4_ADDR_LEN              (4)
+#define IP_PROTO_UDP               (17)
+#define UDP_HDR_LEN                (8)
+#define UDP_DST_PORT_OFFSET        (2)
+
+/* DHCP client port and client hardware address offset in the DHCP message. */
+#define DHCP_CLIENT_PORT           (68)
+#define DHCP_CHADDR_OFFSET         (28)
+
+/* Reads a big-endian 16-bit value from a frame. */
+#define READ_BE16(p)               ((uint16_t)(((p)[0] << 8) | (p)[1]))
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Entry of the host-side reject table. */
+typedef struct
+{
+    rx_reject_type_t type;
+    uint16_t value;
+} rx_reject_entry_t;
+
+/* Link input callback of the network stack. */
+static emac_link_input_cb_t stack_input_cb;
+
+/* EMAC of the hooked interface. */
+static WHD_EMAC *hooked_emac;
+
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+
+/* Activity callback of the network activity handler. */
+static mbed::Callback<void(bool)> activity_cb;
+
+/* Host addresses the frames are checked against. */
+static uint8_t host_mac[ETH_ADDR_LEN];
+static uint8_t host_ip[IPV4_ADDR_LEN];
+
+/*
+ * Host-side reject table. Frames addressed to other hosts are rejected by
+ * default.
+ */
+static rx_reject_entry_t reject_table[RX_REJECT_TABLE_SIZE] = {
+    { RX_REJECT_ARP_NOT_FOR_HOST, 0 },
+    { RX_REJECT_DHCP_NOT_FOR_HOST, 0 }
+};
+static uint8_t reject_count = 2;
+
+/* Set on a host wake until a frame is accepted. */
+static volatile bool early_discard_armed = false;
+
+/* Set when the notification of the network activity has been held back. */
+static volatile bool activity_deferred = false;
+
+/* Number of frames dropped by the early discard. */
+static volatile uint32_t discard_count = 0;
+
+static cyhal_syspm_callback_data_t syspm_cb_data;
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+/******************************************************************************
+ * Function Name: rx_reject_match
+ ******************************************************************************
+ * Summary:
+ *   This function checks a received frame against one entry of the reject
+ *   table.
+ *
+ * Parameters:
+ *   entry: Reject table entry.
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   bool: Returns true if the frame is rejected by the entry.
+ *
+ *****************************************************************************/
+static bool rx_reject_match(const rx_reject_entry_t *entry,
+                            const uint8_t *frame,
+                            uint32_t len)
+{
+    uint16_t eth_type = READ_BE16(&frame[ETH_TYPE_OFFSET]);
+    const uint8_t *ip = &frame[ETH_HDR_LEN];
+    const uint8_t *udp = NULL;
+    uint32_t ip_hdr_len = 0;
+
+    if (RX_REJECT_ETHERTYPE == entry->type)
+    {
+        return (eth_type == entry->value);
+    }
+
+    if (RX_REJECT_ARP_NOT_FOR_HOST == entry->type)
+    {
+        /* Nothing to compare with until the host has an IP address. */
+        return ((ETH_TYPE_ARP == eth_type) &&
+                ((ETH_HDR_LEN + ARP_PKT_LEN) <= len) &&
+                (0 != (host_ip[0] | host_ip[1] | host_ip[2] | host_ip[3])) &&
+                (0 != memcmp(&ip[ARP_TARGET_IP_OFFSET], host_ip, IPV4_ADDR_LEN)));
+    }
+
+    /* The remaining entries apply to UDP datagrams only. */
+    if ((ETH_TYPE_IPV4 != eth_type) ||
+        ((ETH_HDR_LEN + IPV4_MIN_HDR_LEN + UDP_HDR_LEN) > len) ||
+        (IP_PROTO_UDP != ip[IPV4_PROTO_OFFSET]))
+    {
+        return false;
+    }
+
+    ip_hdr_len = (ip[0] & 0x0F) * 4;
+    if ((ETH_HDR_LEN + ip_hdr_len + UDP_HDR_LEN) > len)
+    {
+        return false;
+    }
+    udp = &ip[ip_hdr_len];
+
+    switch (entry->type)
+    {
+        case RX_REJECT_DHCP_NOT_FOR_HOST:
+            return ((DHCP_CLIENT_PORT == READ_BE16(&udp[UDP_DST_PORT_OFFSET])) &&
+                    ((ETH_HDR_LEN + ip_hdr_len + UDP_HDR_LEN +
+                      DHCP_CHADDR_OFFSET + ETH_ADDR_LEN) <= len) &&
+                    (0 != memcmp(&udp[UDP_HDR_LEN + DHCP_CHADDR_OFFSET],
+                                 host_mac, ETH_ADDR_LEN)));
+        case RX_REJECT_UDP_BROADCAST_PORT:
+            /* Broadcast destination MAC address is all ones. */
+            return ((0xFF == (frame[0] & frame[1] & frame[2] &
+                              frame[3] & frame[4] & frame[5])) &&
+                    (entry->value == READ_BE16(&udp[UDP_DST_PORT_OFFSET])));
+        default:
+            return false;
+    }
+}
+
+/******************************************************************************
+ * Function Name: rx_reject_frame
+ ******************************************************************************
+ * Summary:
+ *   This function checks a received frame against the reject table.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   bool: Returns true if the frame is rejected.
+ *
+ *****************************************************************************/
+static bool rx_reject_frame(const uint8_t *frame, uint32_t len)
+{
+    if ((NULL == frame) || (ETH_HDR_LEN > len))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < reject_count; i++)
+    {
+        if (rx_reject_match(&reject_table[i], frame, len))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: emac_rx_hook_activity
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the WHD EMAC driver on every network activity
+ *   in place of the callback of the network activity handler. The receive
+ *   activity following a host wake is held back until the frame has passed
+ *   the reject table, so that a rejected frame does not resume the network
+ *   stack.
+ *
+ * Parameters:
+ *   is_tx_activity: True for a transmit activity, false for a receive one.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void emac_rx_hook_activity(bool is_tx_activity)
+{
+    if ((!is_tx_activity) && early_discard_armed)
+    {
+        activity_deferred = true;
+        return;
+    }
+
+    if (activity_cb)
+    {
+        activity_cb(is_tx_activity);
+    }
+}
+
+/******************************************************************************
+ * Function Name: emac_rx_hook_syspm_cb
+ ******************************************************************************
+ * Summary:
+ *   This is the deep sleep callback. After deep sleep, the early discard is
+ *   armed for the frames that woke the host, if the WLAN host wake interrupt
+ *   woke it; the other wakes deliver no frame to check.
+ *
+ * Parameters:
+ *   syspm_state: Power state for which the callback is invoked.
+ *   mode: Transition mode of the power state.
+ *   callback_arg: Argument as set in callback registration.
+ *
+ * Return:
+ *   bool: Always returns true to allow the transition.
+ *
+ *****************************************************************************/
+static bool emac_rx_hook_syspm_cb(cyhal_syspm_callback_state_t syspm_state,
+                                  cyhal_syspm_callback_mode_t mode,
+                                  void *callback_arg)
+{
+    if (CYHAL_SYSPM_BEFORE_TRANSITION == mode)
+    {
+        activity_deferred = false;
+    }
+    else if ((CYHAL_SYSPM_AFTER_TRANSITION == mode) &&
+             wake_latency_host_wake_pending())
+    {
+        early_discard_armed = true;
+    }
+
+    return true;
+}
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+/******************************************************************************
+ * Function Name: emac_rx_hook_input
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the WHD EMAC driver for every received frame
+ *   in place of the link input callback of the network stack. After a host
+ *   wake, the frames rejected by the reject table are dropped here, as are
+ *   the frames dropped by the host classifier. The first accepted frame
+ *   releases the held back activity notification, which resumes the network
+ *   stack.
+ *
+ * Parameters:
+ *   buf: Received frame.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void emac_rx_hook_input(emac_mem_buf_t *buf)
+{
+    const uint8_t *frame = (const uint8_t *)hooked_emac->memory_manager->get_ptr(buf);
+    uint32_t len = hooked_emac->memory_manager->get_len(buf);
+
+    WAKE_LATENCY_MARK(WAKE_MARK_EMAC_RX);
+
+    /* Count the packets and the wakes per class, including the dropped ones. */
+    pf_ipv6_count_frame(frame, len);
+
+#if MBED_CONF_APP_STORM_DETECTOR_ENABLE
+    /* Every frame delivered to the host counts, including the dropped ones. */
+    storm_detector_input(frame, len);
+#endif /* MBED_CONF_APP_STORM_DETECTOR_ENABLE */
+
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    if (early_discard_armed && rx_reject_frame(frame, len))
+    {
+        hooked_emac->memory_manager->free(buf);
+        discard_count++;
+        return;
+    }
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+#if MBED_CONF_APP_HOST_CLASSIFIER_ENABLE
+    if (HC_ACTION_DROP == host_classifier_run(frame, len))
+    {
+        hooked_emac->memory_manager->free(buf);
+        return;
+    }
+#endif /* MBED_CONF_APP_HOST_CLASSIFIER_ENABLE */
+
+#if MBED_CONF_APP_TIER_ENABLE
+    if (!pf_tier_host_match(frame, len))
+    {
+        hooked_emac->memory_manager->free(buf);
+        return;
+    }
+#endif /* MBED_CONF_APP_TIER_ENABLE */
+
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    if (early_discard_armed)
+    {
+        early_discard_armed = false;
+        if (activity_deferred)
+        {
+            activity_deferred = false;
+            emac_rx_hook_activity(false);
+        }
+    }
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+    WAKE_LATENCY_MARK(WAKE_MARK_STACK_INPUT);
+
+    stack_input_cb(buf);
+}
+
+/******************************************************************************
+ * Function Name: emac_rx_hook_attach
+ ******************************************************************************
+ * Summary:
+ *   This function installs the receive hook in place of the link input
+ *   callback of the network stack. It must be called once the interface is
+ *   connected, as the network stack installs its callback when the interface
+ *   is brought up. It also records the host addresses used by the reject
+ *   table and wraps the activity callback of the network activity handler.
+ *
+ * Parameters:
+ *   wifi: A pointer to WLAN interface whose receive path is hooked.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void emac_rx_hook_attach(WhdSTAInterface *wifi)
+{
+    emac_link_input_cb_t hook_cb = mbed::callback(emac_rx_hook_input);
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    mbed::Callback<void(bool)> activity_hook_cb = mbed::callback(emac_rx_hook_activity);
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+    if (NULL == wifi)
+    {
+        return;
+    }
+
+    WHD_EMAC &emac = static_cast<WHD_EMAC &>(wifi->get_emac());
+
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    SocketAddress sock_addr;
+
+    /* Host addresses may change on every connect. */
+    emac.get_hwaddr(host_mac);
+    if ((NSAPI_ERROR_OK == wifi->get_ip_address(&sock_addr)) &&
+        (NSAPI_IPv4 == sock_addr.get_ip_version()))
+    {
+        memcpy(host_ip, sock_addr.get_ip_bytes(), IPV4_ADDR_LEN);
+    }
+
+    if (NULL == hooked_emac)
+    {
+        syspm_cb_data.callback = emac_rx_hook_syspm_cb;
+        syspm_cb_data.states = CYHAL_SYSPM_CB_CPU_DEEPSLEEP;
+        syspm_cb_data.ignore_modes = (cyhal_syspm_callback_mode_t)
+                                     (CYHAL_SYSPM_CHECK_READY | CYHAL_SYSPM_CHECK_FAIL);
+        syspm_cb_data.args = NULL;
+        syspm_cb_data.next = NULL;
+        cyhal_syspm_register_callback(&syspm_cb_data);
+    }
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+    hooked_emac = &emac;
+
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    /* Wrap the activity callback once; the wrapper forwards to it. */
+    if (emac.activity_cb != activity_hook_cb)
+    {
+        core_util_critical_section_enter();
+        activity_cb = emac.activity_cb;
+        emac.activity_cb = activity_hook_cb;
+        core_util_critical_section_exit();
+    }
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+
+    if ((!emac.emac_link_input_cb) || (emac.emac_link_input_cb == hook_cb))
+    {
+        return;
+    }
+
+    core_util_critical_section_enter();
+    stack_input_cb = emac.emac_link_input_cb;
+    emac.emac_link_input_cb = hook_cb;
+    core_util_critical_section_exit();
+}
+
+/******************************************************************************
+ * Function Name: emac_rx_hook_add_reject
+ ******************************************************************************
+ * Summary:
+ *   This function adds an entry to the host-side reject table.
+ *
+ * Parameters:
+ *   type: Type of frames to reject.
+ *   value: Ether type or UDP port for the entries which need one. Ignored
+ *     otherwise.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the table is
+ *     full or the early discard is disabled.
+ *
+ *****************************************************************************/
+cy_rslt_t emac_rx_hook_add_reject(rx_reject_type_t type, uint16_t value)
+{
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+
+    core_util_critical_section_enter();
+    if (RX_REJECT_TABLE_SIZE > reject_count)
+    {
+        reject_table[reject_count].type = type;
+        reject_table[reject_count].value = value;
+        reject_count++;
+        result = CY_RSLT_SUCCESS;
+    }
+    core_util_critical_section_exit();
+
+    return result;
+#else
+    return CY_RSLT_TYPE_ERROR;
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: emac_rx_hook_get_discard_count
+ ******************************************************************************
+ * Summary:
+ *   This function returns the number of frames dropped by the early discard.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint32_t: Number of frames dropped since boot.
+ *
+ *****************************************************************************/
+uint32_t emac_rx_hook_get_discard_count(void)
+{
+#if MBED_CONF_APP_EARLY_DISCARD_ENABLE
+    return discard_count;
+#else
+    return 0;
+#endif /* MBED_CONF_APP_EARLY_DISCARD_ENABLE */
+}
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * File Name: emac_rx_hook.h
+ *
+ * Description:
+ *   This header file contains function declarations to hook the WLAN receive
+ *   path between the WHD EMAC driver and the lwIP network stack.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef EMAC_RX_HOOK_H
+#define EMAC_RX_HOOK_H
+
+#include "WhdSTAInterface.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Early discard is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_EARLY_DISCARD_ENABLE
+#define MBED_CONF_APP_EARLY_DISCARD_ENABLE (0)
+#endif
+
+/* Maximum number of entries in the host-side reject table. */
+#define RX_REJECT_TABLE_SIZE               (8)
+
+/******************************************************************************
+ *                                 ENUMS
+ *****************************************************************************/
+/* Types of the host-side reject table entries. */
+typedef enum
+{
+    RX_REJECT_ARP_NOT_FOR_HOST = 1, /* ARP whose target IP is not the host IP  */
+    RX_REJECT_DHCP_NOT_FOR_HOST,    /* DHCP reply to another client hardware   */
+    RX_REJECT_ETHERTYPE,            /* Any frame of the given Ether type       */
+    RX_REJECT_UDP_BROADCAST_PORT    /* Broadcast UDP datagram to the given port */
+} rx_reject_type_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void emac_rx_hook_attach(WhdSTAInterface *wifi);
+cy_rslt_t emac_rx_hook_add_reject(rx_reject_type_t type, uint16_t value);
+uint32_t emac_rx_hook_get_discard_count(void);
+
+#endif /* #ifndef EMAC_RX_HOOK_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,611 @@
+/******************************************************************************
+ * File Name: fast_join.cpp
+ *
+ * Description:
+ *   This file contains the Wi-Fi STA interface which reassociates to the
+ *   last AP with a directed join. A full connect scans all the channels for
+ *   the SSID and lets the WLAN firmware derive the PMK from the passphrase
+ *   (4096 rounds of PBKDF2). After a successful connect, the BSSID, the
+ *   channel and the security of the AP are cached, and the PMK is derived
+ *   once on the host. The next connect joins the cached BSSID on the cached
+ *   channel with the cached PMK, which skips both, and falls back to the
+ *   full connect on failure.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "fast_join.h"
+#include "whd_emac.h"
+#include "OlmInterface.h"
+#include "mbedtls/md.h"
+#include "mbedtls/pkcs5.h"
+#include "http_webserver_config.h"
+
+/******************************************************************************
+ *                              EXTERNS
+ *****************************************************************************/
+extern "C" void whd_emac_wifi_link_state_changed(whd_interface_t ifp, whd_bool_t state_up);
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* PBKDF2 iterations of the WPA PMK derivation (IEEE 802.11i). */
+#define FAST_JOIN_PMK_ITERATIONS   (4096)
+
+/* Supplicant state of the WLC_E_PSK_SUP event once the 4-way handshake is
+ * complete.
+ */
+#define FAST_JOIN_SUP_KEYED        (6)
+
+/* Last 2.4 GHz channel. */
+#define FAST_JOIN_MAX_2G4_CHANNEL  (14)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* WHD events marking the end of the scan, authentication and 4-way
+ * handshake phases.
+ */
+static const uint32_t join_events[] = {WLC_E_AUTH, WLC_E_ASSOC, WLC_E_REASSOC,
+                                       WLC_E_PSK_SUP, WLC_E_NONE};
+
+/* Names of the connect phases and kinds in the report. */
+static const char *join_phase_names[JOIN_PHASE_MAX] = {"scan", "auth", "4-way", "dhcp"};
+static const char *join_kind_names[JOIN_KIND_MAX] = {"Full", "Directed"};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: FastJoinSTAInterface
+ ******************************************************************************
+ * Summary:
+ *   Constructor. The interface uses the default WHD EMAC and the default
+ *   offload manager, as WhdSTAInterface does.
+ *
+ *****************************************************************************/
+FastJoinSTAInterface::FastJoinSTAInterface()
+    : WhdSTAInterface(),
+      _fj_security(NSAPI_SECURITY_NONE),
+      _ap_valid(false),
+      _pmk_valid(false),
+      _pmk_supported(true),
+      _start_ms(0),
+      _auth_ms(0),
+      _assoc_ms(0),
+      _keyed_ms(0),
+      _event_index(0),
+      _fallbacks(0)
+{
+    memset(_fj_ssid, 0, sizeof(_fj_ssid));
+    memset(_fj_pass, 0, sizeof(_fj_pass));
+    memset(&_ap, 0, sizeof(_ap));
+    memset(_pmk_hex, 0, sizeof(_pmk_hex));
+    memset(_count, 0, sizeof(_count));
+    memset(_last_ms, 0, sizeof(_last_ms));
+    memset(_sum_ms, 0, sizeof(_sum_ms));
+}
+
+/******************************************************************************
+ * Function Name: set_credentials
+ ******************************************************************************
+ * Summary:
+ *   This function keeps a copy of the credentials for the directed join and
+ *   drops the cache when they change.
+ *
+ * Parameters:
+ *   ssid: WiFi AP SSID.
+ *   pass: WiFi AP Password.
+ *   security: WiFi security type as defined in structure nsapi_security_t.
+ *
+ * Return:
+ *   nsapi_error_t: Returns NSAPI_ERROR_OK on success.
+ *
+ *****************************************************************************/
+nsapi_error_t FastJoinSTAInterface::set_credentials(const char *ssid, const char *pass,
+                                                    nsapi_security_t security)
+{
+    nsapi_error_t err = WhdSTAInterface::set_credentials(ssid, pass, security);
+
+    if (NSAPI_ERROR_OK != err)
+    {
+        return err;
+    }
+
+    if (strncmp(_fj_ssid, ssid, sizeof(_fj_ssid)) ||
+        strncmp(_fj_pass, (NULL != pass) ? pass : "", sizeof(_fj_pass)) ||
+        (_fj_security != security))
+    {
+        invalidate_cache();
+    }
+
+    strncpy(_fj_ssid, ssid, sizeof(_fj_ssid) - 1);
+    strncpy(_fj_pass, (NULL != pass) ? pass : "", sizeof(_fj_pass) - 1);
+    _fj_security = security;
+
+    return err;
+}
+
+/******************************************************************************
+ * Function Name: set_phase_callback
+ ******************************************************************************
+ * Summary:
+ *   This function registers the function called when a connect reaches the
+ *   DHCP phase. The function may be called from the WHD thread.
+ *
+ * Parameters:
+ *   phase_cb: Function to call, or an empty callback.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void FastJoinSTAInterface::set_phase_callback(mbed::Callback<void(join_phase_t)> phase_cb)
+{
+    _phase_cb = phase_cb;
+}
+
+/******************************************************************************
+ * Function Name: invalidate_cache
+ ******************************************************************************
+ * Summary:
+ *   This function drops the cached AP and PMK. The next connect is a full
+ *   connect.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void FastJoinSTAInterface::invalidate_cache(void)
+{
+    _ap_valid = false;
+    _pmk_valid = false;
+    memset(_pmk_hex, 0, sizeof(_pmk_hex));
+}
+
+/******************************************************************************
+ * Function Name: connect
+ ******************************************************************************
+ * Summary:
+ *   This function connects to the AP. A directed join is tried first when
+ *   the AP is cached; the full connect of WhdSTAInterface is used otherwise
+ *   or when the directed join fails. The AP is cached after a successful
+ *   full connect.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   nsapi_error_t: Returns NSAPI_ERROR_OK on success.
+ *
+ *****************************************************************************/
+nsapi_error_t FastJoinSTAInterface::connect()
+{
+    WHD_EMAC &emac = static_cast<WHD_EMAC &>(get_emac());
+    nsapi_error_t err = NSAPI_ERROR_OK;
+
+#if MBED_CONF_APP_FAST_JOIN_ENABLE
+    if (_ap_valid && (NULL != _interface))
+    {
+        err = directed_connect();
+        if (NSAPI_ERROR_OK == err)
+        {
+            return err;
+        }
+
+        ERR_INFO(("Directed join failed (%d), falling back to a full connect\n", err));
+        _fallbacks++;
+        _ap_valid = false;
+        WhdSTAInterface::disconnect();
+    }
+#endif /* MBED_CONF_APP_FAST_JOIN_ENABLE */
+
+    /* Power the WLAN device up here rather than in WhdSTAInterface, so that
+     * the join events of the first connect can be registered.
+     */
+    if (!emac.powered_up && !emac.power_up())
+    {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    start_timing();
+    err = WhdSTAInterface::connect();
+
+    if (NSAPI_ERROR_OK == err)
+    {
+        /* The full connect does not return between the join and DHCP. */
+        record_timing(JOIN_KIND_FULL, 0, Kernel::get_ms_count());
+#if MBED_CONF_APP_FAST_JOIN_ENABLE
+        update_cache();
+#endif /* MBED_CONF_APP_FAST_JOIN_ENABLE */
+    }
+
+    whd_wifi_deregister_event_handler(emac.ifp, _event_index);
+    _start_ms = 0;
+
+    return err;
+}
+
+/******************************************************************************
+ * Function Name: directed_connect
+ ******************************************************************************
+ * Summary:
+ *   This function joins the cached AP on its cached channel with the cached
+ *   PMK and brings the network interface up, as WhdSTAInterface::connect()
+ *   does after its join. A PMK rejected by the WLAN firmware is not used
+ *   again.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   nsapi_error_t: Returns NSAPI_ERROR_OK on success.
+ *
+ *****************************************************************************/
+nsapi_error_t FastJoinSTAInterface::directed_connect(void)
+{
+    WHD_EMAC &emac = static_cast<WHD_EMAC &>(get_emac());
+    const uint8_t *key = (const uint8_t *)_fj_pass;
+    uint8_t key_len = (uint8_t)strlen(_fj_pass);
+    bool use_pmk = _pmk_valid && _pmk_supported;
+    whd_result_t res = WHD_SUCCESS;
+    nsapi_error_t err = NSAPI_ERROR_OK;
+    uint64_t join_ms = 0;
+
+    if (use_pmk)
+    {
+        key = (const uint8_t *)_pmk_hex;
+        key_len = FAST_JOIN_PMK_HEX_LEN;
+    }
+
+    start_timing();
+    res = whd_wifi_join_specific(emac.ifp, &_ap, key, key_len);
+    join_ms = Kernel::get_ms_count();
+    whd_wifi_deregister_event_handler(emac.ifp, _event_index);
+
+    if (WHD_SUCCESS != res)
+    {
+        _start_ms = 0;
+        if (use_pmk)
+        {
+            /* The firmware may take the key for a passphrase. */
+            _pmk_supported = false;
+        }
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    if (WHD_SUCCESS == whd_wifi_is_ready_to_transceive(emac.ifp))
+    {
+        whd_emac_wifi_link_state_changed(emac.ifp, WHD_TRUE);
+    }
+
+    /* The offloads are initialized on every connect. pf_commit_list()
+     * reconfigures the default offload manager with the new list.
+     */
+    OlmInterface::get_default_instance().init_ols(emac.ifp, this);
+
+    if (_phase_cb)
+    {
+        _phase_cb(JOIN_PHASE_DHCP);
+    }
+
+    err = _interface->bringup(_dhcp,
+                              _ip_address[0] ? _ip_address : 0,
+                              _netmask[0] ? _netmask : 0,
+                              _gateway[0] ? _gateway : 0,
+                              DEFAULT_STACK);
+    if (NSAPI_ERROR_OK == err)
+    {
+        record_timing(JOIN_KIND_DIRECTED, join_ms, Kernel::get_ms_count());
+    }
+    _start_ms = 0;
+
+    return err;
+}
+
+/******************************************************************************
+ * Function Name: update_cache
+ ******************************************************************************
+ * Summary:
+ *   This function caches the BSSID, the channel and the security of the AP
+ *   the interface is connected to, and derives the PMK on the first connect.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void FastJoinSTAInterface::update_cache(void)
+{
+    WHD_EMAC &emac = static_cast<WHD_EMAC &>(get_emac());
+    whd_bss_info_t bss_info;
+    whd_security_t security = WHD_SECURITY_UNKNOWN;
+    uint32_t channel = 0;
+
+    memset(&_ap, 0, sizeof(_ap));
+    if ((WHD_SUCCESS != whd_wifi_get_bssid(emac.ifp, &_ap.BSSID)) ||
+        (WHD_SUCCESS != whd_wifi_get_channel(emac.ifp, &channel)) ||
+        (WHD_SUCCESS != whd_wifi_get_ap_info(emac.ifp, &bss_info, &security)))
+    {
+        _ap_valid = false;
+        return;
+    }
+
+    _ap.SSID.length = (uint8_t)strlen(_fj_ssid);
+    memcpy(_ap.SSID.value, _fj_ssid, _ap.SSID.length);
+    _ap.security = security;
+    _ap.channel = (uint8_t)channel;
+    _ap.band = (FAST_JOIN_MAX_2G4_CHANNEL >= channel) ? WHD_802_11_BAND_2_4GHZ :
+                                                        WHD_802_11_BAND_5GHZ;
+    _ap.bss_type = WHD_BSS_TYPE_INFRASTRUCTURE;
+    _ap_valid = true;
+
+    if (!_pmk_valid && (security & (WPA_SECURITY | WPA2_SECURITY)))
+    {
+        derive_pmk();
+    }
+
+    APP_INFO(("Cached AP %02x:%02x:%02x:%02x:%02x:%02x on channel %lu\n",
+              _ap.BSSID.octet[0], _ap.BSSID.octet[1], _ap.BSSID.octet[2],
+              _ap.BSSID.octet[3], _ap.BSSID.octet[4], _ap.BSSID.octet[5],
+              (unsigned long)channel));
+}
+
+/******************************************************************************
+ * Function Name: derive_pmk
+ ******************************************************************************
+ * Summary:
+ *   This function derives the WPA PMK from the passphrase and the SSID
+ *   (PBKDF2-HMAC-SHA1, 4096 iterations) and keeps it in hexadecimal, the
+ *   format the WLAN firmware takes a PMK in.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void FastJoinSTAInterface::derive_pmk(void)
+{
+    mbedtls_md_context_t ctx;
+    uint8_t pmk[FAST_JOIN_PMK_LEN];
+    int ret = 0;
+
+    mbedtls_md_init(&ctx);
+    ret = mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA1), 1);
+    if (0 == ret)
+    {
+        ret = mbedtls_pkcs5_pbkdf2_hmac(&ctx,
+                                        (const unsigned char *)_fj_pass, strlen(_fj_pass),
+                                        (const unsigned char *)_fj_ssid, strlen(_fj_ssid),
+                                        FAST_JOIN_PMK_ITERATIONS, sizeof(pmk), pmk);
+    }
+    mbedtls_md_free(&ctx);
+
+    if (0 != ret)
+    {
+        ERR_INFO(("PMK derivation failed (%d)\n", ret));
+        return;
+    }
+
+    for (int i = 0; i < FAST_JOIN_PMK_LEN; i++)
+    {
+        sprintf(&_pmk_hex[2 * i], "%02x", pmk[i]);
+    }
+    memset(pmk, 0, sizeof(pmk));
+    _pmk_valid = true;
+}
+
+/******************************************************************************
+ * Function Name: start_timing
+ ******************************************************************************
+ * Summary:
+ *   This function starts timing a connect and registers for the WHD events
+ *   marking the end of the scan and authentication phases.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void FastJoinSTAInterface::start_timing(void)
+{
+    WHD_EMAC &emac = static_cast<WHD_EMAC &>(get_emac());
+
+    _auth_ms = 0;
+    _assoc_ms = 0;
+    _keyed_ms = 0;
+    _start_ms = Kernel::get_ms_count();
+    whd_wifi_set_event_handler(emac.ifp, join_events, join_event_handler,
+                               this, &_event_index);
+}
+
+/******************************************************************************
+ * Function Name: join_event_handler
+ ******************************************************************************
+ * Summary:
+ *   This function is called by WHD on the authentication, association and
+ *   supplicant events of a join and timestamps them.
+ *
+ * Parameters:
+ *   ifp: WHD interface.
+ *   event_header: Header of the event.
+ *   event_data: Data of the event.
+ *   handler_user_data: Interface being connected.
+ *
+ * Return:
+ *   void*: The handler user data, to keep the handler registered.
+ *
+ *****************************************************************************/
+void *FastJoinSTAInterface::join_event_handler(whd_interface_t ifp,
+                                               const whd_event_header_t *event_header,
+                                               const uint8_t *event_data,
+                                               void *handler_user_data)
+{
+    FastJoinSTAInterface *self = (FastJoinSTAInterface *)handler_user_data;
+    uint64_t now_ms = Kernel::get_ms_count();
+
+    if ((NULL == self) || (NULL == event_header))
+    {
+        return handler_user_data;
+    }
+
+    switch (event_header->event_type)
+    {
+        case WLC_E_PSK_SUP:
+            if ((FAST_JOIN_SUP_KEYED == event_header->status) && (0 == self->_keyed_ms))
+            {
+                self->_keyed_ms = now_ms;
+                if (self->_phase_cb)
+                {
+                    self->_phase_cb(JOIN_PHASE_DHCP);
+                }
+            }
+            break;
+        case WLC_E_AUTH:
+            if ((WLC_E_STATUS_SUCCESS == event_header->status) && (0 == self->_auth_ms))
+            {
+                self->_auth_ms = now_ms;
+            }
+            break;
+        default:
+            if ((WLC_E_STATUS_SUCCESS == event_header->status) && (0 == self->_assoc_ms))
+            {
+                self->_assoc_ms = now_ms;
+            }
+            break;
+    }
+
+    return handler_user_data;
+}
+
+/******************************************************************************
+ * Function Name: record_timing
+ ******************************************************************************
+ * Summary:
+ *   This function records the phase durations of a successful connect. A
+ *   phase whose end event was missed, such as the 4-way handshake of an
+ *   open network, is accounted to the next phase.
+ *
+ * Parameters:
+ *   kind: Kind of connect.
+ *   join_ms: Time the join returned, 0 if unknown.
+ *   up_ms: Time the network interface was brought up.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void FastJoinSTAInterface::record_timing(join_kind_t kind, uint64_t join_ms, uint64_t up_ms)
+{
+    uint64_t marks[JOIN_PHASE_MAX + 1];
+
+    if (0 == _start_ms)
+    {
+        return;
+    }
+
+    marks[0] = _start_ms;
+    marks[JOIN_PHASE_SCAN + 1] = _auth_ms ? _auth_ms : _start_ms;
+    marks[JOIN_PHASE_AUTH + 1] = _assoc_ms ? _assoc_ms : marks[JOIN_PHASE_SCAN + 1];
+    marks[JOIN_PHASE_HANDSHAKE + 1] = _keyed_ms ? _keyed_ms :
+                                      (join_ms ? join_ms : marks[JOIN_PHASE_AUTH + 1]);
+    marks[JOIN_PHASE_DHCP + 1] = up_ms;
+
+    _count[kind]++;
+    for (int phase = 0; phase < JOIN_PHASE_MAX; phase++)
+    {
+        _last_ms[kind][phase] = (uint32_t)(marks[phase + 1] - marks[phase]);
+        _sum_ms[kind][phase] += _last_ms[kind][phase];
+    }
+
+    APP_INFO(("%s join: scan %lu ms, auth %lu ms, 4-way %lu ms, dhcp %lu ms\n",
+              join_kind_names[kind],
+              (unsigned long)_last_ms[kind][JOIN_PHASE_SCAN],
+              (unsigned long)_last_ms[kind][JOIN_PHASE_AUTH],
+              (unsigned long)_last_ms[kind][JOIN_PHASE_HANDSHAKE],
+              (unsigned long)_last_ms[kind][JOIN_PHASE_DHCP]));
+}
+
+/******************************************************************************
+ * Function Name: report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the last and average phase durations of each kind
+ *   of connect as text.
+ *
+ * Parameters:
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int FastJoinSTAInterface::report(char *buf, size_t buf_len)
+{
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    len = snprintf(buf, buf_len, "Directed join fallbacks: %lu\n", (unsigned long)_fallbacks);
+
+    for (int kind = 0; (kind < JOIN_KIND_MAX) && (len < (int)buf_len); kind++)
+    {
+        len += snprintf(&buf[len], buf_len - len, "%s joins: %lu\n",
+                        join_kind_names[kind], (unsigned long)_count[kind]);
+        for (int phase = 0; (phase < JOIN_PHASE_MAX) && (len < (int)buf_len); phase++)
+        {
+            len += snprintf(&buf[len], buf_len - len, "  %-6s last %6lu ms, avg %6lu ms\n",
+                            join_phase_names[phase],
+                            (unsigned long)_last_ms[kind][phase],
+                            (unsigned long)(_count[kind] ? _sum_ms[kind][phase] / _count[kind] : 0));
+        }
+    }
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
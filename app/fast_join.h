@@ -0,0 +1,152 @@
+/******************************************************************************
+ * File Name: fast_join.h
+ *
+ * Description:
+ *   This header file contains the declaration of the Wi-Fi STA interface
+ *   which reassociates to the last AP with a directed join.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef FAST_JOIN_H
+#define FAST_JOIN_H
+
+#include "mbed.h"
+#include "WhdSTAInterface.h"
+#include "whd_wifi_api.h"
+#include "whd_events.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Fast reassociation is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_FAST_JOIN_ENABLE
+#define MBED_CONF_APP_FAST_JOIN_ENABLE     (0)
+#endif
+
+/* Length of the WPA PMK and of its hexadecimal representation. */
+#define FAST_JOIN_PMK_LEN                  (32)
+#define FAST_JOIN_PMK_HEX_LEN              (2 * FAST_JOIN_PMK_LEN)
+
+/* Buffer length required to report the join timings as text. */
+#define FAST_JOIN_REPORT_LEN               (384)
+
+/******************************************************************************
+ *                                 ENUMS
+ *****************************************************************************/
+/* Phases of a connect to the AP. */
+typedef enum
+{
+    JOIN_PHASE_SCAN = 0,    /* Join start to 802.11 authentication    */
+    JOIN_PHASE_AUTH,        /* Authentication to association          */
+    JOIN_PHASE_HANDSHAKE,   /* Association to keys installed (4-way)  */
+    JOIN_PHASE_DHCP,        /* Link up to IP address obtained         */
+    JOIN_PHASE_MAX
+} join_phase_t;
+
+/* Kinds of connect to the AP. */
+typedef enum
+{
+    JOIN_KIND_FULL = 0,     /* Join by SSID, with a scan of all channels */
+    JOIN_KIND_DIRECTED,     /* Join to the cached BSSID and channel      */
+    JOIN_KIND_MAX
+} join_kind_t;
+
+/******************************************************************************
+ *                           CLASS DECLARATION
+ *****************************************************************************/
+/*
+ * WhdSTAInterface which caches the BSSID, the channel and the PMK of the AP
+ * after a successful connect. The next connect, after the disconnect of a
+ * packet filter commit, first tries a directed join to the cached AP with
+ * the cached PMK, and falls back to the full connect of WhdSTAInterface on
+ * failure. Every phase of every connect is timed.
+ */
+class FastJoinSTAInterface : public WhdSTAInterface
+{
+public:
+    FastJoinSTAInterface();
+
+    nsapi_error_t set_credentials(const char *ssid, const char *pass,
+                                  nsapi_security_t security = NSAPI_SECURITY_NONE) override;
+    nsapi_error_t connect() override;
+    using WhdSTAInterface::connect;
+
+    void set_phase_callback(mbed::Callback<void(join_phase_t)> phase_cb);
+    void invalidate_cache(void);
+    int report(char *buf, size_t buf_len);
+
+private:
+    nsapi_error_t directed_connect(void);
+    void update_cache(void);
+    void derive_pmk(void);
+    void start_timing(void);
+    void record_timing(join_kind_t kind, uint64_t join_ms, uint64_t up_ms);
+    static void *join_event_handler(whd_interface_t ifp,
+                                    const whd_event_header_t *event_header,
+                                    const uint8_t *event_data,
+                                    void *handler_user_data);
+
+    /* Credentials given to the last connect. */
+    char _fj_ssid[33];
+    char _fj_pass[64];
+    nsapi_security_t _fj_security;
+
+    /* Cached AP and PMK. */
+    whd_scan_result_t _ap;
+    bool _ap_valid;
+    char _pmk_hex[FAST_JOIN_PMK_HEX_LEN + 1];
+    bool _pmk_valid;
+    bool _pmk_supported;
+
+    /* Phase timestamps of the connect in progress. */
+    uint64_t _start_ms;
+    volatile uint64_t _auth_ms;
+    volatile uint64_t _assoc_ms;
+    volatile uint64_t _keyed_ms;
+    uint16_t _event_index;
+
+    /* Called when a connect reaches a new phase. */
+    mbed::Callback<void(join_phase_t)> _phase_cb;
+
+    /* Timings per kind of connect. */
+    uint32_t _count[JOIN_KIND_MAX];
+    uint32_t _last_ms[JOIN_KIND_MAX][JOIN_PHASE_MAX];
+    uint64_t _sum_ms[JOIN_KIND_MAX][JOIN_PHASE_MAX];
+    uint32_t _fallbacks;
+};
+
+#endif /* #ifndef FAST_JOIN_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,774 @@
+/******************************************************************************
+ * File Name: host_classifier.cpp
+ *
+ * Description:
+ *   This file contains the host-side packet classifier. It is a small
+ *   table-driven engine: each received frame is parsed once and then
+ *   compared against a fixed-size table of rules, first match wins. It does
+ *   not allocate memory and has no dependency on the RTOS or the network
+ *   stack, so it can be built and exercised on any host.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_classifier.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Ethernet, IPv4 and transport header layout. */
+#define HC_ETH_HDR_LEN             (14)
+#define HC_ETH_TYPE_OFFSET         (12)
+#define HC_ETH_TYPE_IPV4           (0x0800)
+#define HC_IPV4_MIN_HDR_LEN        (20)
+#define HC_IPV4_FRAG_OFFSET        (6)
+#define HC_IPV4_FRAG_OFFSET_MASK   (0x1FFF)
+#define HC_IPV4_PROTO_OFFSET       (9)
+#define HC_IPV4_SRC_OFFSET         (12)
+#define HC_IPV4_DST_OFFSET         (16)
+#define HC_IP_PROTO_TCP            (6)
+#define HC_IP_PROTO_UDP            (17)
+#define HC_TCP_MIN_HDR_LEN         (20)
+#define HC_TCP_FLAGS_OFFSET        (13)
+#define HC_TCP_DATA_OFFSET         (12)
+#define HC_UDP_HDR_LEN             (8)
+
+/* Reads big-endian values from a frame. */
+#define HC_READ_BE16(p)            ((uint16_t)(((p)[0] << 8) | (p)[1]))
+#define HC_READ_BE32(p)            (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                                    ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Fields of a received frame as seen by the rules. */
+typedef struct
+{
+    uint8_t present;            /* HC_MATCH_* fields found in the frame */
+    uint8_t ip_proto;
+    uint8_t tcp_flags;
+    uint32_t src_ip;
+    uint32_t dst_ip;
+    const uint8_t *payload;
+    uint32_t payload_len;
+} hc_packet_t;
+
+/* Rule table, immutable once published. */
+typedef struct
+{
+    hc_rule_t rules[HC_MAX_RULES];
+    uint8_t count;
+} hc_table_t;
+
+/*
+ * The rules are double-buffered. The web server thread, the only writer,
+ * builds the next table in the spare one and publishes it by switching
+ * active_table. The receive path counts itself in the readers of the table
+ * it uses, and the writer waits for the spare table to have no reader
+ * before writing it. The hit counters are kept apart, by rule position:
+ * rules are only appended, and a position is reset when a rule is added.
+ */
+static hc_table_t tables[2];
+static uint8_t active_table = 0;
+static uint32_t table_readers[2];
+static uint32_t rule_hits[HC_MAX_RULES];
+
+/* Number of frames dropped by the classifier. */
+static uint32_t drop_count = 0;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: hc_parse_frame
+ ******************************************************************************
+ * Summary:
+ *   This function extracts the fields compared by the rules from a received
+ *   Ethernet frame. Fields which are not present in the frame are left out
+ *   of the 'present' mask, so that the rules comparing them do not match.
+ *   The TCP flags and the payload are only present in the first fragment
+ *   of an IPv4 packet.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *   pkt: Pointer to the parsed fields.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void hc_parse_frame(const uint8_t *frame, uint32_t len, hc_packet_t *pkt)
+{
+    const uint8_t *ip = &frame[HC_ETH_HDR_LEN];
+    const uint8_t *l4 = NULL;
+    uint32_t ip_hdr_len = 0;
+    uint32_t l4_len = 0;
+    uint32_t l4_hdr_len = 0;
+
+    memset(pkt, 0, sizeof(*pkt));
+
+    if (HC_ETH_HDR_LEN > len)
+    {
+        return;
+    }
+
+    /* Group bit of the destination MAC: multicast or broadcast. */
+    pkt->present = HC_MATCH_MCAST;
+
+    if ((HC_ETH_TYPE_IPV4 != HC_READ_BE16(&frame[HC_ETH_TYPE_OFFSET])) ||
+        ((HC_ETH_HDR_LEN + HC_IPV4_MIN_HDR_LEN) > len))
+    {
+        return;
+    }
+
+    ip_hdr_len = (ip[0] & 0x0F) * 4;
+    if ((HC_IPV4_MIN_HDR_LEN > ip_hdr_len) || ((HC_ETH_HDR_LEN + ip_hdr_len) > len))
+    {
+        return;
+    }
+
+    pkt->present |= HC_MATCH_SRC_NET | HC_MATCH_DST_NET | HC_MATCH_IP_PROTO;
+    pkt->ip_proto = ip[HC_IPV4_PROTO_OFFSET];
+    pkt->src_ip = HC_READ_BE32(&ip[HC_IPV4_SRC_OFFSET]);
+    pkt->dst_ip = HC_READ_BE32(&ip[HC_IPV4_DST_OFFSET]);
+
+    /* Only the first fragment carries the transport header. */
+    if (HC_READ_BE16(&ip[HC_IPV4_FRAG_OFFSET]) & HC_IPV4_FRAG_OFFSET_MASK)
+    {
+        return;
+    }
+
+    l4 = &ip[ip_hdr_len];
+    l4_len = len - HC_ETH_HDR_LEN - ip_hdr_len;
+
+    if ((HC_IP_PROTO_TCP == pkt->ip_proto) && (HC_TCP_MIN_HDR_LEN <= l4_len))
+    {
+        pkt->present |= HC_MATCH_TCP_FLAGS;
+        pkt->tcp_flags = l4[HC_TCP_FLAGS_OFFSET];
+        l4_hdr_len = (l4[HC_TCP_DATA_OFFSET] >> 4) * 4;
+    }
+    else if ((HC_IP_PROTO_UDP == pkt->ip_proto) && (HC_UDP_HDR_LEN <= l4_len))
+    {
+        l4_hdr_len = HC_UDP_HDR_LEN;
+    }
+
+    if ((0 != l4_hdr_len) && (l4_hdr_len <= l4_len))
+    {
+        pkt->present |= HC_MATCH_PAYLOAD;
+        pkt->payload = &l4[l4_hdr_len];
+        pkt->payload_len = l4_len - l4_hdr_len;
+    }
+}
+
+/******************************************************************************
+ * Function Name: hc_rule_match
+ ******************************************************************************
+ * Summary:
+ *   This function compares the parsed fields of a frame with one rule.
+ *
+ * Parameters:
+ *   rule: Rule to compare with.
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   pkt: Parsed fields of the frame.
+ *
+ * Return:
+ *   bool: Returns true if all the fields of the rule match.
+ *
+ *****************************************************************************/
+static bool hc_rule_match(const hc_rule_t *rule,
+                          const uint8_t *frame,
+                          const hc_packet_t *pkt)
+{
+    if (rule->match & ~pkt->present)
+    {
+        return false;
+    }
+    if ((rule->match & HC_MATCH_SRC_NET) &&
+        ((pkt->src_ip & rule->src_mask) != rule->src_ip))
+    {
+        return false;
+    }
+    if ((rule->match & HC_MATCH_DST_NET) &&
+        ((pkt->dst_ip & rule->dst_mask) != rule->dst_ip))
+    {
+        return false;
+    }
+    if ((rule->match & HC_MATCH_IP_PROTO) && (pkt->ip_proto != rule->ip_proto))
+    {
+        return false;
+    }
+    if ((rule->match & HC_MATCH_TCP_FLAGS) &&
+        ((pkt->tcp_flags & rule->tcp_flags_mask) != rule->tcp_flags_value))
+    {
+        return false;
+    }
+    if ((rule->match & HC_MATCH_MCAST) && !(frame[0] & 0x01))
+    {
+        return false;
+    }
+    if ((rule->match & HC_MATCH_PAYLOAD) &&
+        ((pkt->payload_len < rule->prefix_len) ||
+         (0 != memcmp(pkt->payload, rule->prefix, rule->prefix_len))))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: hc_table_acquire
+ ******************************************************************************
+ * Summary:
+ *   This function enters the published rule table as a reader. The reader
+ *   count is taken before the table is checked again, so that the writer
+ *   either sees the reader or has not switched the table yet.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint8_t: Index of the rule table, to pass to hc_table_release().
+ *
+ *****************************************************************************/
+static uint8_t hc_table_acquire(void)
+{
+    uint8_t index = 0;
+
+    while (true)
+    {
+        index = __atomic_load_n(&active_table, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&table_readers[index], 1, __ATOMIC_SEQ_CST);
+        if (index == __atomic_load_n(&active_table, __ATOMIC_SEQ_CST))
+        {
+            return index;
+        }
+        __atomic_sub_fetch(&table_readers[index], 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+/******************************************************************************
+ * Function Name: hc_table_release
+ ******************************************************************************
+ * Summary:
+ *   This function leaves a rule table entered with hc_table_acquire().
+ *
+ * Parameters:
+ *   index: Index of the rule table.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void hc_table_release(uint8_t index)
+{
+    __atomic_sub_fetch(&table_readers[index], 1, __ATOMIC_SEQ_CST);
+}
+
+/******************************************************************************
+ * Function Name: hc_table_spare
+ ******************************************************************************
+ * Summary:
+ *   This function returns the rule table not published, once the readers
+ *   which entered it before the last switch have left it. The receive path
+ *   runs at a higher priority than the web server and does not block, so
+ *   the wait is short.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   hc_table_t *: The spare rule table, free to write.
+ *
+ *****************************************************************************/
+static hc_table_t *hc_table_spare(void)
+{
+    uint8_t index = 1 - __atomic_load_n(&active_table, __ATOMIC_SEQ_CST);
+
+    while (0 != __atomic_load_n(&table_readers[index], __ATOMIC_SEQ_CST))
+    {
+    }
+
+    return &tables[index];
+}
+
+/******************************************************************************
+ * Function Name: hc_table_publish
+ ******************************************************************************
+ * Summary:
+ *   This function makes the spare rule table the one used by the receive
+ *   path.
+ *
+ * Parameters:
+ *   table: Spare rule table returned by hc_table_spare().
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void hc_table_publish(hc_table_t *table)
+{
+    __atomic_store_n(&active_table, (uint8_t)(table - &tables[0]), __ATOMIC_SEQ_CST);
+}
+
+/******************************************************************************
+ * Function Name: host_classifier_run
+ ******************************************************************************
+ * Summary:
+ *   This function classifies a received frame. The rules are evaluated in
+ *   order and the first matching rule decides the verdict.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   hc_action_t: HC_ACTION_DROP if the frame must be dropped before lwIP
+ *     input, HC_ACTION_KEEP otherwise.
+ *
+ *****************************************************************************/
+hc_action_t host_classifier_run(const uint8_t *frame, uint32_t len)
+{
+    hc_action_t action = HC_ACTION_KEEP;
+    const hc_table_t *table = NULL;
+    hc_packet_t pkt;
+    uint8_t index = 0;
+
+    if (NULL == frame)
+    {
+        return HC_ACTION_KEEP;
+    }
+
+    index = hc_table_acquire();
+    table = &tables[index];
+
+    if (0 != table->count)
+    {
+        hc_parse_frame(frame, len, &pkt);
+    }
+
+    for (uint8_t i = 0; i < table->count; i++)
+    {
+        if (hc_rule_match(&table->rules[i], frame, &pkt))
+        {
+            __atomic_add_fetch(&rule_hits[i], 1, __ATOMIC_RELAXED);
+            action = (hc_action_t)table->rules[i].action;
+            if (HC_ACTION_DROP == action)
+            {
+                __atomic_add_fetch(&drop_count, 1, __ATOMIC_RELAXED);
+            }
+            break;
+        }
+    }
+
+    hc_table_release(index);
+
+    return action;
+}
+
+/******************************************************************************
+ * Function Name: host_classifier_add
+ ******************************************************************************
+ * Summary:
+ *   This function appends a rule to the rule table. The rule takes effect on
+ *   the next received frame. It is called from the web server thread only.
+ *
+ * Parameters:
+ *   rule: Rule to append. The hit counter is reset.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the table is
+ *     full or the rule is invalid.
+ *
+ *****************************************************************************/
+cy_rslt_t host_classifier_add(const hc_rule_t *rule)
+{
+    const hc_table_t *active = &tables[active_table];
+    hc_table_t *spare = NULL;
+    uint8_t count = active->count;
+
+    if ((NULL == rule) || (HC_MAX_RULES <= count) ||
+        (HC_ACTION_DROP < rule->action) || (HC_PREFIX_MAX_LEN < rule->prefix_len))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    spare = hc_table_spare();
+    memcpy(spare->rules, active->rules, count * sizeof(hc_rule_t));
+    spare->rules[count] = *rule;
+    spare->rules[count].hits = 0;
+    spare->rules[count].src_ip &= spare->rules[count].src_mask;
+    spare->rules[count].dst_ip &= spare->rules[count].dst_mask;
+    spare->count = count + 1;
+
+    /* No table with the old rule at this position is in use any more. */
+    __atomic_store_n(&rule_hits[count], 0, __ATOMIC_RELAXED);
+    hc_table_publish(spare);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: host_classifier_clear
+ ******************************************************************************
+ * Summary:
+ *   This function removes all the rules. It is called from the web server
+ *   thread only.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void host_classifier_clear(void)
+{
+    hc_table_t *spare = hc_table_spare();
+
+    spare->count = 0;
+    hc_table_publish(spare);
+}
+
+/******************************************************************************
+ * Function Name: host_classifier_get_rule_count
+ ******************************************************************************
+ * Summary:
+ *   This function returns the number of rules. It is called from the web
+ *   server thread, which publishes the rule tables.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint8_t: Number of rules in the table.
+ *
+ *****************************************************************************/
+uint8_t host_classifier_get_rule_count(void)
+{
+    return tables[active_table].count;
+}
+
+/******************************************************************************
+ * Function Name: host_classifier_get_rule
+ ******************************************************************************
+ * Summary:
+ *   This function copies a rule with its hit counter. It is called from the
+ *   web server thread, which publishes the rule tables.
+ *
+ * Parameters:
+ *   index: Position of the rule in the table.
+ *   rule: Receives the rule.
+ *
+ * Return:
+ *   bool: false if there is no rule at this position.
+ *
+ *****************************************************************************/
+bool host_classifier_get_rule(uint8_t index, hc_rule_t *rule)
+{
+    const hc_table_t *table = &tables[active_table];
+
+    if ((NULL == rule) || (index >= table->count))
+    {
+        return false;
+    }
+
+    *rule = table->rules[index];
+    rule->hits = __atomic_load_n(&rule_hits[index], __ATOMIC_RELAXED);
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: host_classifier_get_drop_count
+ ******************************************************************************
+ * Summary:
+ *   This function returns the number of frames dropped by the classifier.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint32_t: Number of frames dropped since boot.
+ *
+ *****************************************************************************/
+uint32_t host_classifier_get_drop_count(void)
+{
+    return __atomic_load_n(&drop_count, __ATOMIC_RELAXED);
+}
+
+/******************************************************************************
+ * Function Name: hc_parse_net
+ ******************************************************************************
+ * Summary:
+ *   This function parses an IPv4 address with an optional prefix length,
+ *   for example "192.168.0.0/24". The separator may be URL encoded as "%2F".
+ *   A missing prefix length selects a single host.
+ *
+ * Parameters:
+ *   str: String to parse.
+ *   ip: Pointer to hold the address in host byte order.
+ *   mask: Pointer to hold the network mask in host byte order.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t hc_parse_net(const char *str, uint32_t *ip, uint32_t *mask)
+{
+    unsigned long octet = 0;
+    unsigned long prefix = 32;
+    uint32_t addr = 0;
+    char *end = NULL;
+
+    if ((NULL == str) || (NULL == ip) || (NULL == mask))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        octet = strtoul(str, &end, 10);
+        if ((end == str) || (255 < octet) || ((i < 3) && ('.' != *end)))
+        {
+            return CY_RSLT_TYPE_ERROR;
+        }
+        addr = (addr << 8) | octet;
+        str = (i < 3) ? (end + 1) : end;
+    }
+
+    if ('/' == *str)
+    {
+        str++;
+    }
+    else if (!strncmp(str, "%2F", 3) || !strncmp(str, "%2f", 3))
+    {
+        str += 3;
+    }
+    else if ('\0' != *str)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if ('\0' != *str)
+    {
+        prefix = strtoul(str, &end, 10);
+        if ((end == str) || ('\0' != *end) || (32 < prefix))
+        {
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+
+    *mask = (0 == prefix) ? 0 : (0xFFFFFFFFu << (32 - prefix));
+    *ip = addr & *mask;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: hc_parse_tcp_flags
+ ******************************************************************************
+ * Summary:
+ *   This function parses a TCP flags condition. Each upper-case letter
+ *   (F, S, R, P, A, U) requires the flag to be set and each lower-case
+ *   letter requires it to be clear. For example, "Sa" matches connection
+ *   requests.
+ *
+ * Parameters:
+ *   str: String to parse.
+ *   value: Pointer to hold the required value of the flags.
+ *   mask: Pointer to hold the mask of the flags compared.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t hc_parse_tcp_flags(const char *str, uint8_t *value, uint8_t *mask)
+{
+    static const char flag_letters[] = "FSRPAU";
+    const char *pos = NULL;
+    uint8_t flag = 0;
+
+    if ((NULL == str) || (NULL == value) || (NULL == mask))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    *value = 0;
+    *mask = 0;
+    for (; '\0' != *str; str++)
+    {
+        pos = strchr(flag_letters, (*str >= 'a') ? (*str - 'a' + 'A') : *str);
+        if ((NULL == pos) || ('\0' == *pos))
+        {
+            return CY_RSLT_TYPE_ERROR;
+        }
+        flag = (uint8_t)(1u << (pos - flag_letters));
+        *mask |= flag;
+        if (*str < 'a')
+        {
+            *value |= flag;
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: hc_parse_prefix
+ ******************************************************************************
+ * Summary:
+ *   This function parses a payload prefix given as hexadecimal digits, for
+ *   example "474554" for "GET".
+ *
+ * Parameters:
+ *   str: String to parse.
+ *   prefix: Buffer of HC_PREFIX_MAX_LEN bytes to hold the prefix.
+ *   prefix_len: Pointer to hold the prefix length.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t hc_parse_prefix(const char *str, uint8_t *prefix, uint8_t *prefix_len)
+{
+    char byte_str[3] = {0};
+    char *end = NULL;
+    size_t len = 0;
+
+    if ((NULL == str) || (NULL == prefix) || (NULL == prefix_len))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    len = strlen(str);
+    if ((0 != (len % 2)) || ((HC_PREFIX_MAX_LEN * 2) < len))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (size_t i = 0; i < len / 2; i++)
+    {
+        byte_str[0] = str[2 * i];
+        byte_str[1] = str[2 * i + 1];
+        prefix[i] = (uint8_t)strtoul(byte_str, &end, 16);
+        if ('\0' != *end)
+        {
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+    *prefix_len = (uint8_t)(len / 2);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: hc_print_rule
+ ******************************************************************************
+ * Summary:
+ *   This function formats a rule in a user readable way.
+ *
+ * Parameters:
+ *   rule: Rule to format.
+ *   buf: Buffer to hold the string.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int hc_print_rule(const hc_rule_t *rule, char *buf, size_t buf_len)
+{
+    int len = 0;
+
+    if ((NULL == rule) || (NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    len = snprintf(buf, buf_len, "\nID %d[Host Rule]:\n\tAction = %s,\n\tHits = %lu",
+                   rule->id,
+                   (HC_ACTION_DROP == rule->action) ? "Discard" : "Keep",
+                   (unsigned long)rule->hits);
+
+    if ((rule->match & HC_MATCH_SRC_NET) && (len < (int)buf_len))
+    {
+        len += snprintf(&buf[len], buf_len - len, ",\n\tSource = %lu.%lu.%lu.%lu/%d",
+                        (unsigned long)(rule->src_ip >> 24),
+                        (unsigned long)((rule->src_ip >> 16) & 0xFF),
+                        (unsigned long)((rule->src_ip >> 8) & 0xFF),
+                        (unsigned long)(rule->src_ip & 0xFF),
+                        rule->src_mask ? (33 - (int)__builtin_ffs(rule->src_mask)) : 0);
+    }
+    if ((rule->match & HC_MATCH_DST_NET) && (len < (int)buf_len))
+    {
+        len += snprintf(&buf[len], buf_len - len, ",\n\tDestination = %lu.%lu.%lu.%lu/%d",
+                        (unsigned long)(rule->dst_ip >> 24),
+                        (unsigned long)((rule->dst_ip >> 16) & 0xFF),
+                        (unsigned long)((rule->dst_ip >> 8) & 0xFF),
+                        (unsigned long)(rule->dst_ip & 0xFF),
+                        rule->dst_mask ? (33 - (int)__builtin_ffs(rule->dst_mask)) : 0);
+    }
+    if ((rule->match & HC_MATCH_IP_PROTO) && (len < (int)buf_len))
+    {
+        len += snprintf(&buf[len], buf_len - len, ",\n\tIP Protocol = 0x%x", rule->ip_proto);
+    }
+    if ((rule->match & HC_MATCH_TCP_FLAGS) && (len < (int)buf_len))
+    {
+        len += snprintf(&buf[len], buf_len - len, ",\n\tTCP Flags = 0x%02x/0x%02x",
+                        rule->tcp_flags_value, rule->tcp_flags_mask);
+    }
+    if ((rule->match & HC_MATCH_MCAST) && (len < (int)buf_len))
+    {
+        len += snprintf(&buf[len], buf_len - len, ",\n\tMulticast only");
+    }
+    for (int i = 0; (rule->match & HC_MATCH_PAYLOAD) && (i < rule->prefix_len) &&
+                    (len < (int)buf_len); i++)
+    {
+        len += snprintf(&buf[len], buf_len - len, "%s%02x",
+                        (0 == i) ? ",\n\tPayload = " : "", rule->prefix[i]);
+    }
+    if (len < (int)buf_len)
+    {
+        len += snprintf(&buf[len], buf_len - len, "\n");
+    }
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
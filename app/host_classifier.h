@@ -0,0 +1,131 @@
+/******************************************************************************
+ * File Name: host_classifier.h
+ *
+ * Description:
+ *   This header file contains macros, structures and function declarations
+ *   of the host-side packet classifier. The classifier runs on the packets
+ *   passed by the WLAN packet filters, before they are handed to lwIP.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_CLASSIFIER_H
+#define HOST_CLASSIFIER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_result.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Host classifier is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_HOST_CLASSIFIER_ENABLE
+#define MBED_CONF_APP_HOST_CLASSIFIER_ENABLE (0)
+#endif
+
+/* Maximum number of host classifier rules. */
+#define HC_MAX_RULES                       (16)
+
+/* Maximum length of the payload prefix matched by a rule. */
+#define HC_PREFIX_MAX_LEN                  (8)
+
+/* Fields compared by a rule. A rule matches when all its fields match. */
+#define HC_MATCH_SRC_NET                   (0x01)
+#define HC_MATCH_DST_NET                   (0x02)
+#define HC_MATCH_IP_PROTO                  (0x04)
+#define HC_MATCH_TCP_FLAGS                 (0x08)
+#define HC_MATCH_MCAST                     (0x10)
+#define HC_MATCH_PAYLOAD                   (0x20)
+
+/* TCP header flags. */
+#define HC_TCP_FIN                         (0x01)
+#define HC_TCP_SYN                         (0x02)
+#define HC_TCP_RST                         (0x04)
+#define HC_TCP_PSH                         (0x08)
+#define HC_TCP_ACK                         (0x10)
+#define HC_TCP_URG                         (0x20)
+
+/******************************************************************************
+ *                                 ENUMS
+ *****************************************************************************/
+/* Verdict of the host classifier. */
+typedef enum
+{
+    HC_ACTION_KEEP = 0,
+    HC_ACTION_DROP
+} hc_action_t;
+
+/******************************************************************************
+ *                               STRUCTURES
+ *****************************************************************************/
+/*
+ * Host classifier rule. IPv4 addresses and masks are in host byte order.
+ * Rules are evaluated in order and the first matching rule decides the
+ * verdict. Packets matching no rule are kept.
+ */
+typedef struct
+{
+    uint8_t id;                         /* Rule ID shown on the web page    */
+    uint8_t match;                      /* HC_MATCH_* fields to compare     */
+    uint8_t action;                     /* hc_action_t                      */
+    uint8_t ip_proto;                   /* IP protocol                      */
+    uint32_t src_ip;                    /* Source network                   */
+    uint32_t src_mask;
+    uint32_t dst_ip;                    /* Destination network or group     */
+    uint32_t dst_mask;
+    uint8_t tcp_flags_value;            /* Value of the TCP flags in mask   */
+    uint8_t tcp_flags_mask;
+    uint8_t prefix_len;                 /* Length of the payload prefix     */
+    uint8_t prefix[HC_PREFIX_MAX_LEN];  /* Start of the transport payload   */
+    uint32_t hits;                      /* Number of packets matched        */
+} hc_rule_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+hc_action_t host_classifier_run(const uint8_t *frame, uint32_t len);
+cy_rslt_t host_classifier_add(const hc_rule_t *rule);
+void host_classifier_clear(void);
+uint8_t host_classifier_get_rule_count(void);
+bool host_classifier_get_rule(uint8_t index, hc_rule_t *rule);
+uint32_t host_classifier_get_drop_count(void);
+cy_rslt_t hc_parse_net(const char *str, uint32_t *ip, uint32_t *mask);
+cy_rslt_t hc_parse_tcp_flags(const char *str, uint8_t *value, uint8_t *mask);
+cy_rslt_t hc_parse_prefix(const char *str, uint8_t *prefix, uint8_t *prefix_len);
+int hc_print_rule(const hc_rule_t *rule, char *buf, size_t buf_len);
+
+#endif /* #ifndef HOST_CLASSIFIER_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,259 @@
+/******************************************************************************
+ * File Name: http_bench.cpp
+ *
+ * Description:
+ *   This file benchmarks the render of the home page against the number of
+ *   packet filters. For each count from none to a full list, the active and
+ *   the pending lists are filled with a mix of port, EtherType and IP type
+ *   filters and the home page handler is run with its response discarded.
+ *   The CPU cycles, the bytes and writes of the response and the stack
+ *   high-water mark are printed as one JSON object per line, decoded by
+ *   tools/http_bench.py.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "http_bench.h"
+#include "http_webserver_config.h"
+#include "http_stats.h"
+#include "pf_olm_config.h"
+#include "pf_snapshot.h"
+
+#if MBED_CONF_APP_HTTP_BENCH_ENABLE
+#if !MBED_CONF_APP_HTTP_STATS_ENABLE
+#error "http-bench-enable requires http-stats-enable in mbed_app.json"
+#endif
+#if defined(MBED_CONF_RTOS_MAIN_THREAD_STACK_SIZE) && \
+    (MBED_CONF_RTOS_MAIN_THREAD_STACK_SIZE < HTTP_BENCH_MAIN_STACK_SIZE)
+#error "http-bench-enable requires rtos.main-thread-stack-size of 6144 or more in mbed_app.json"
+#endif
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* First port number and EtherType of the generated filters. */
+#define HTTP_BENCH_PORT_BASE       (5000)
+#define HTTP_BENCH_ETH_TYPE_BASE   (0x88B5)
+
+/* First IP protocol of the generated filters. */
+#define HTTP_BENCH_IP_TYPE_BASE    (140)
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_bench_fill
+ ******************************************************************************
+ * Summary:
+ *   This function generates keep filters, cycling through port, EtherType
+ *   and IP type filters. Every filter has a distinct value so that the list
+ *   is valid.
+ *
+ * Parameters:
+ *   cfgs: Array receiving the filters.
+ *   count: Number of filters to generate.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void http_bench_fill(cy_pf_ol_cfg_t *cfgs, uint8_t count)
+{
+    memset(cfgs, 0, count * sizeof(*cfgs));
+    for (uint8_t i = 0; i < count; i++)
+    {
+        cfgs[i].id = i;
+        cfgs[i].bits = CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE;
+
+        switch (i % 3)
+        {
+            case 0:
+                cfgs[i].feature = CY_PF_OL_FEAT_PORTNUM;
+                cfgs[i].u.pf.proto = (decltype(cfgs[i].u.pf.proto))((i / 3) % 2);
+                cfgs[i].u.pf.portnum.portnum = HTTP_BENCH_PORT_BASE + i;
+                cfgs[i].u.pf.portnum.range = 0;
+                cfgs[i].u.pf.portnum.direction = (decltype(cfgs[i].u.pf.portnum.direction))1;
+                break;
+            case 1:
+                cfgs[i].feature = CY_PF_OL_FEAT_ETHTYPE;
+                cfgs[i].u.eth.eth_type = HTTP_BENCH_ETH_TYPE_BASE + i;
+                break;
+            default:
+                cfgs[i].feature = CY_PF_OL_FEAT_IPTYPE;
+                cfgs[i].u.ip.ip_type = HTTP_BENCH_IP_TYPE_BASE + i;
+                break;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_bench_copy
+ ******************************************************************************
+ * Summary:
+ *   This function copies a packet filter list terminated with
+ *   CY_PF_OL_FEAT_LAST.
+ *
+ * Parameters:
+ *   list: Packet filter list, may be NULL.
+ *   copy: Array of MAX_FILTERS entries receiving the filters.
+ *
+ * Return:
+ *   uint8_t: Number of filters copied.
+ *
+ *****************************************************************************/
+static uint8_t http_bench_copy(const cy_pf_ol_cfg_t *list, cy_pf_ol_cfg_t *copy)
+{
+    uint8_t count = 0;
+
+    while ((NULL != list) && (count < MAX_FILTERS - 1) &&
+           (CY_PF_OL_FEAT_LAST != list[count].feature))
+    {
+        copy[count] = list[count];
+        count++;
+    }
+
+    return count;
+}
+
+/******************************************************************************
+ * Function Name: http_bench_run
+ ******************************************************************************
+ * Summary:
+ *   This function runs the benchmark and prints its report. The active list
+ *   is replaced for each packet filter count, which is only possible while
+ *   the Wi-Fi interface is disconnected; the benchmark must therefore run at
+ *   boot before the first connect. The active list is restored and the
+ *   pending list is left empty afterwards.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if a packet
+ *     filter list could not be activated.
+ *
+ *****************************************************************************/
+cy_rslt_t http_bench_run(void)
+{
+    cy_pf_ol_cfg_t saved[MAX_FILTERS];
+    pf_ipv6_attrs_t saved_ipv6;
+    cy_pf_ol_cfg_t cfgs[MAX_FILTERS];
+    http_stats_sample_t sample;
+    pf_snapshot_reader_t reader = pf_snapshot_read_lock();
+    const pf_snapshot_t *active = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+    uint8_t saved_count = http_bench_copy(active->cfgs, saved);
+    bool saved_default = active->is_default;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    saved_ipv6 = active->ipv6;
+    pf_snapshot_read_unlock(reader);
+
+    APP_INFO((HTTP_BENCH_TAG "{\"cpu_hz\":%lu,\"max_filters\":%u,\"iterations\":%u}\n",
+              (unsigned long)SystemCoreClock, (unsigned int)get_max_filter(),
+              (unsigned int)MBED_CONF_APP_HTTP_BENCH_ITERATIONS));
+
+    for (uint8_t count = 0; (count <= get_max_filter()) && (CY_RSLT_SUCCESS == result); count++)
+    {
+        uint32_t cycles_min = UINT32_MAX;
+        uint32_t cycles_max = 0;
+        uint64_t cycles_sum = 0;
+        uint32_t stack = 0;
+
+        http_bench_fill(cfgs, count);
+        result = pf_stage_list(cfgs, NULL, count);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            result = pf_activate_list(false);
+        }
+        if (CY_RSLT_SUCCESS == result)
+        {
+            result = pf_stage_list(cfgs, NULL, count);
+        }
+        if (CY_RSLT_SUCCESS != result)
+        {
+            break;
+        }
+
+        for (uint32_t i = 0; i < MBED_CONF_APP_HTTP_BENCH_ITERATIONS; i++)
+        {
+            http_stats_measure(http_startup_webpage, "/", NULL, NULL, NULL, NULL, &sample);
+            cycles_min = (sample.cycles < cycles_min) ? sample.cycles : cycles_min;
+            cycles_max = (sample.cycles > cycles_max) ? sample.cycles : cycles_max;
+            cycles_sum += sample.cycles;
+            stack = (sample.stack > stack) ? sample.stack : stack;
+        }
+
+        /* The response of the home page depends only on the lists. */
+        APP_INFO((HTTP_BENCH_TAG "{\"filters\":%u,\"cycles_min\":%lu,\"cycles_avg\":%lu,"
+                  "\"cycles_max\":%lu,\"bytes\":%lu,\"writes\":%lu,\"stack\":%lu}\n",
+                  (unsigned int)count,
+                  (unsigned long)cycles_min,
+                  (unsigned long)(cycles_sum / MBED_CONF_APP_HTTP_BENCH_ITERATIONS),
+                  (unsigned long)cycles_max,
+                  (unsigned long)sample.bytes,
+                  (unsigned long)sample.writes,
+                  (unsigned long)stack));
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Page render benchmark stopped.\n"));
+    }
+
+    /* Restore the active list and leave the pending list empty. The default
+     * list is restored as such, so that it is still reported as the default.
+     */
+    if ((CY_RSLT_SUCCESS == pf_stage_list(saved, &saved_ipv6, saved_default ? 0 : saved_count)) &&
+        (CY_RSLT_SUCCESS == pf_activate_list(saved_default)))
+    {
+        pf_stage_list(NULL, NULL, 0);
+    }
+    else
+    {
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    return result;
+}
+
+#else /* MBED_CONF_APP_HTTP_BENCH_ENABLE */
+
+cy_rslt_t http_bench_run(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+#endif /* MBED_CONF_APP_HTTP_BENCH_ENABLE */
+
+
+/* [] END OF FILE */
+
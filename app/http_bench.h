@@ -0,0 +1,75 @@
+/******************************************************************************
+ * File Name: http_bench.h
+ *
+ * Description:
+ *   This header file contains the macros and the function declaration of the
+ *   benchmark of the home page render cost against the packet filter count.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HTTP_BENCH_H
+#define HTTP_BENCH_H
+
+#include "cy_result.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* The page render benchmark is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_HTTP_BENCH_ENABLE
+#define MBED_CONF_APP_HTTP_BENCH_ENABLE    (0)
+#endif
+
+/* Number of renders measured per packet filter count. */
+#ifndef MBED_CONF_APP_HTTP_BENCH_ITERATIONS
+#define MBED_CONF_APP_HTTP_BENCH_ITERATIONS (8)
+#endif
+
+/* Prefix of the report lines printed on the serial terminal. */
+#define HTTP_BENCH_TAG                     "HTTP_BENCH "
+
+/* Main thread stack size in bytes required by the benchmark, which runs the
+ * home page handler on the main thread at boot.
+ */
+#define HTTP_BENCH_MAIN_STACK_SIZE         (6144)
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+cy_rslt_t http_bench_run(void);
+
+#endif /* #ifndef HTTP_BENCH_H */
+
+
+/* [] END OF FILE */
+
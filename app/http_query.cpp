@@ -0,0 +1,217 @@
+/******************************************************************************
+ * File Name: http_query.cpp
+ *
+ * Description:
+ *   This file contains the parsers of the URL query string and of the form
+ *   data posted by the web page. The input is untrusted: the copies are
+ *   bounded and missing values are reported as empty strings or NULL.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "http_query.h"
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_query_value
+ ******************************************************************************
+ * Summary:
+ *   This function copies the value of the first parameter of the URL query
+ *   string, e.g. "add" from "add=add". The value is empty if the query string
+ *   is missing or has no value.
+ *
+ * Parameters:
+ *   query: Pointer to HTTP url query string. May be NULL.
+ *   value: Buffer receiving the NUL terminated value.
+ *   value_len: Length of the buffer.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_query_value(const char *query, char *value, size_t value_len)
+{
+    const char *start = (NULL != query) ? strchr(query, '=') : NULL;
+    size_t len = 0;
+
+    value[0] = '\0';
+    if (NULL == start)
+    {
+        return;
+    }
+
+    start += strspn(start, "=");
+    len = strcspn(start, "=");
+    if (len >= value_len)
+    {
+        len = value_len - 1;
+    }
+    memcpy(value, start, len);
+    value[len] = '\0';
+}
+
+/******************************************************************************
+ * Function Name: http_query_param
+ ******************************************************************************
+ * Summary:
+ *   This function copies the value of the named parameter of the URL query
+ *   string, e.g. "600" for "peerage" from "snoop=1&peerage=600".
+ *
+ * Parameters:
+ *   query: Pointer to HTTP url query string. May be NULL.
+ *   name: Name of the parameter.
+ *   value: Buffer receiving the NUL terminated value.
+ *   value_len: Length of the buffer.
+ *
+ * Return:
+ *   bool: true if the parameter is present.
+ *
+ *****************************************************************************/
+bool http_query_param(const char *query, const char *name,
+                      char *value, size_t value_len)
+{
+    size_t name_len = strlen(name);
+    size_t len = 0;
+
+    value[0] = '\0';
+    while ((NULL != query) && ('\0' != *query))
+    {
+        len = strcspn(query, "&");
+        if ((len > name_len) && !strncmp(query, name, name_len) &&
+            ('=' == query[name_len]))
+        {
+            query += name_len + 1;
+            len -= name_len + 1;
+            if (len >= value_len)
+            {
+                len = value_len - 1;
+            }
+            memcpy(value, query, len);
+            value[len] = '\0';
+            return true;
+        }
+        query += len;
+        query += strspn(query, "&");
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * Function Name: http_query_is
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether a value of the URL query string selects the
+ *   given action. As for the web buttons, the last character of the value is
+ *   not compared; values shorter than two characters select no action.
+ *
+ * Parameters:
+ *   value: Value of the URL query string.
+ *   action: Name of the action.
+ *
+ * Return:
+ *   bool: true if the value selects the action.
+ *
+ *****************************************************************************/
+bool http_query_is(const char *value, const char *action)
+{
+    size_t len = strlen(value);
+
+    return (1 < len) && !strncmp(value, action, len - 1);
+}
+
+/******************************************************************************
+ * Function Name: http_form_split
+ ******************************************************************************
+ * Summary:
+ *   This function splits the form data posted by the web page into the
+ *   values of its fields, in the order of the form. The form data is not
+ *   NUL terminated; it is copied to the given buffer first. A field left
+ *   empty in the form is NULL.
+ *
+ * Parameters:
+ *   data: Form data, "name=value" fields separated with '&'.
+ *   data_len: Length of the form data.
+ *   body: Buffer receiving a NUL terminated copy of the form data. The
+ *     values point into it.
+ *   body_len: Length of the buffer.
+ *   fields[]: Receives the values of the fields. Must be cleared by the
+ *     caller.
+ *   field_count: Number of entries of fields[].
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the form
+ *     data is missing or does not fit in the buffer.
+ *
+ *****************************************************************************/
+cy_rslt_t http_form_split(const char *data, size_t data_len,
+                          char *body, size_t body_len,
+                          char *fields[], uint8_t field_count)
+{
+    uint8_t index = 0;
+    char *token = NULL;
+    char *save = NULL;
+
+    if ((NULL == data) || (data_len >= body_len))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memcpy(body, data, data_len);
+    body[data_len] = '\0';
+
+    /* The fields point into the body buffer; nothing is allocated. */
+    token = strtok_r(body, "&", &save);
+    while ((NULL != token) && (field_count > index))
+    {
+        fields[index] = token;
+        token = strtok_r(NULL, "&", &save);
+        index++;
+    }
+
+    index = 0;
+    while ((field_count > index) && (NULL != fields[index]))
+    {
+        strtok_r(fields[index], "=", &save);
+        fields[index] = strtok_r(NULL, "=", &save);
+        index++;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/* [] END OF FILE */
+
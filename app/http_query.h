@@ -0,0 +1,72 @@
+/******************************************************************************
+ * File Name: http_query.h
+ *
+ * Description:
+ *   This header file contains the declarations of the parsers of the URL
+ *   query string and of the form data posted by the web page. They depend
+ *   only on the C library, so that they can be fuzzed on a host.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HTTP_QUERY_H
+#define HTTP_QUERY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_result.h"
+
+/******************************************************************************
+ *                               MACROS
+ *****************************************************************************/
+/* Longest value of a URL query string parameter, with its NUL. */
+#define HTTP_QUERY_STR_VALUE_LEN   (50)
+
+/* Longest form data accepted, with its NUL. */
+#define HTTP_BODY_MAX_LEN          (512)
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void http_query_value(const char *query, char *value, size_t value_len);
+bool http_query_param(const char *query, const char *name,
+                      char *value, size_t value_len);
+bool http_query_is(const char *value, const char *action);
+cy_rslt_t http_form_split(const char *data, size_t data_len,
+                          char *body, size_t body_len,
+                          char *fields[], uint8_t field_count);
+
+#endif /* #ifndef HTTP_QUERY_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,451 @@
+/******************************************************************************
+ * File Name: http_stats.cpp
+ *
+ * Description:
+ *   This file measures the HTTP page handlers. Each resource registered
+ *   through http_stats_wrap() is served by a dispatch function which times
+ *   the handler in CPU cycles and microseconds, counts the bytes and the writes of its response and paints
+ *   the free stack below it to find the stack high-water mark of the call.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "http_stats.h"
+#include "rtx_os.h"
+#include "http_webserver_config.h"
+
+#if MBED_CONF_APP_HTTP_STATS_ENABLE
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Pattern of the painted stack words. */
+#define HTTP_STATS_STACK_PATTERN   (0x5A5AA5A5UL)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Statistics of one HTTP page resource. */
+typedef struct
+{
+    const char *path;                       /* URL path of the resource       */
+    url_processor_t handler;                /* Page handler                   */
+    void *arg;                              /* Argument of the page handler   */
+    uint32_t requests;                      /* Number of requests served      */
+    uint64_t sum_cycles;                    /* Sum of the handler CPU cycles  */
+    uint32_t max_cycles;                    /* Most CPU cycles of a handler   */
+    uint64_t sum_us;                        /* Sum of the handler durations   */
+    uint32_t max_us;                        /* Longest handler duration       */
+    uint64_t sum_bytes;                     /* Sum of the response lengths    */
+    uint32_t max_bytes;                     /* Longest response               */
+    uint64_t sum_writes;                    /* Sum of the writes per response */
+    uint32_t max_stack;                     /* Stack high-water mark in bytes */
+    uint32_t buckets[HTTP_STATS_BUCKETS];   /* Latency histogram              */
+} http_stats_entry_t;
+
+static http_stats_entry_t entries[HTTP_STATS_MAX_RESOURCES];
+static uint8_t entry_count;
+
+/*
+ * Response lengths of the request being served. The HTTP server runs the
+ * page handlers one at a time on its own thread.
+ */
+static uint32_t cur_bytes;
+static uint32_t cur_writes;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_stats_cycles_enable
+ ******************************************************************************
+ * Summary:
+ *   This function enables the DWT cycle counter, unless it already runs.
+ *   The wake latency measurement uses the same counter and only enables it
+ *   when it is compiled in.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void http_stats_cycles_enable(void)
+{
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+/******************************************************************************
+ * Function Name: http_stats_stack_paint
+ ******************************************************************************
+ * Summary:
+ *   This function fills the free stack of the calling thread, from its
+ *   bottom to HTTP_STATS_STACK_MARGIN bytes below the stack pointer, with a
+ *   pattern.
+ *
+ * Parameters:
+ *   top: Set to the highest address painted, or NULL if nothing is painted.
+ *
+ * Return:
+ *   uint32_t *: Lowest address painted.
+ *
+ *****************************************************************************/
+static uint32_t *http_stats_stack_paint(uint32_t **top)
+{
+    osRtxThread_t *thread = (osRtxThread_t *)osThreadGetId();
+    uint32_t *bottom = NULL;
+    uint32_t *end = (uint32_t *)((__get_PSP() - HTTP_STATS_STACK_MARGIN) & ~3UL);
+
+    *top = NULL;
+    if ((NULL == thread) || (NULL == thread->stack_mem))
+    {
+        return NULL;
+    }
+
+    /* The first word holds the stack overflow magic word of RTX. */
+    bottom = (uint32_t *)thread->stack_mem + 1;
+    if (end <= bottom)
+    {
+        return NULL;
+    }
+
+    for (uint32_t *p = bottom; p < end; p++)
+    {
+        *p = HTTP_STATS_STACK_PATTERN;
+    }
+    *top = end;
+
+    return bottom;
+}
+
+/******************************************************************************
+ * Function Name: http_stats_measure
+ ******************************************************************************
+ * Summary:
+ *   This function calls a page handler and measures its duration in CPU
+ *   cycles and microseconds, its response length and writes, and its stack
+ *   use. The DWT cycle counter is enabled on the first call.
+ *
+ * Parameters:
+ *   handler: Page handler to call.
+ *   url_path: Pointer to HTTP url path.
+ *   url_query_string: Pointer to HTTP url query string.
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   arg: Argument of the page handler.
+ *   http_data: Pointer to HTTP data.
+ *   sample: Receives the measurement.
+ *
+ * Return:
+ *   int32_t: Returns the result of the page handler.
+ *
+ *****************************************************************************/
+int32_t http_stats_measure(url_processor_t handler,
+                           const char *url_path,
+                           const char *url_query_string,
+                           cy_http_response_stream_t *stream,
+                           void *arg,
+                           cy_http_message_body_t *http_data,
+                           http_stats_sample_t *sample)
+{
+    uint32_t *top = NULL;
+    uint32_t *bottom = NULL;
+    uint32_t *p = NULL;
+    uint32_t cycles = 0;
+    int32_t result = 0;
+    Timer timer;
+
+    http_stats_cycles_enable();
+
+    cur_bytes = 0;
+    cur_writes = 0;
+    sample->stack = 0;
+    bottom = http_stats_stack_paint(&top);
+
+    timer.start();
+    cycles = DWT->CYCCNT;
+    result = handler(url_path, url_query_string, stream, arg, http_data);
+    sample->cycles = DWT->CYCCNT - cycles;
+    timer.stop();
+
+    /* The deepest word no longer holding the pattern is the high-water mark. */
+    if (NULL != bottom)
+    {
+        for (p = bottom; (p < top) && (HTTP_STATS_STACK_PATTERN == *p); p++)
+        {
+        }
+        sample->stack = (uint32_t)((uint8_t *)top - (uint8_t *)p) + HTTP_STATS_STACK_MARGIN;
+    }
+
+    sample->us = (uint32_t)timer.elapsed_time().count();
+    sample->bytes = cur_bytes;
+    sample->writes = cur_writes;
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: http_stats_dispatch
+ ******************************************************************************
+ * Summary:
+ *   This function is the page handler of every measured resource. It calls
+ *   the real handler of the resource and records its duration, response
+ *   length, writes and stack use.
+ *
+ * Parameters:
+ *   url_path: Pointer to HTTP url path.
+ *   url_query_string: Pointer to HTTP url query string.
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   arg: Statistics of the resource.
+ *   http_data: Pointer to HTTP data.
+ *
+ * Return:
+ *   int32_t: Returns the result of the real handler.
+ *
+ *****************************************************************************/
+static int32_t http_stats_dispatch(const char *url_path,
+                                   const char *url_query_string,
+                                   cy_http_response_stream_t *stream,
+                                   void *arg,
+                                   cy_http_message_body_t *http_data)
+{
+    http_stats_entry_t *entry = (http_stats_entry_t *)arg;
+    http_stats_sample_t sample;
+    uint32_t bucket = 0;
+    int32_t result = 0;
+
+    result = http_stats_measure(entry->handler, url_path, url_query_string,
+                                stream, entry->arg, http_data, &sample);
+
+    bucket = (sample.us < 2u) ? 0u : (31u - __CLZ(sample.us));
+    if (HTTP_STATS_BUCKETS <= bucket)
+    {
+        bucket = HTTP_STATS_BUCKETS - 1;
+    }
+
+    core_util_critical_section_enter();
+    entry->requests++;
+    entry->sum_cycles += sample.cycles;
+    entry->max_cycles = (sample.cycles > entry->max_cycles) ? sample.cycles : entry->max_cycles;
+    entry->sum_us += sample.us;
+    entry->max_us = (sample.us > entry->max_us) ? sample.us : entry->max_us;
+    entry->sum_bytes += sample.bytes;
+    entry->max_bytes = (sample.bytes > entry->max_bytes) ? sample.bytes : entry->max_bytes;
+    entry->sum_writes += sample.writes;
+    entry->max_stack = (sample.stack > entry->max_stack) ? sample.stack : entry->max_stack;
+    entry->buckets[bucket]++;
+    core_util_critical_section_exit();
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: http_stats_percentile
+ ******************************************************************************
+ * Summary:
+ *   This function returns the upper bound of the latency histogram bucket
+ *   holding the given percentile of the requests.
+ *
+ * Parameters:
+ *   entry: Statistics of the resource.
+ *   percent: Percentile, 1 - 100.
+ *
+ * Return:
+ *   uint32_t: Upper bound of the bucket in microseconds.
+ *
+ *****************************************************************************/
+static uint32_t http_stats_percentile(const http_stats_entry_t *entry, uint32_t percent)
+{
+    uint64_t rank = ((uint64_t)entry->requests * percent + 99) / 100;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < HTTP_STATS_BUCKETS; i++)
+    {
+        seen += entry->buckets[i];
+        if ((0 != seen) && (seen >= rank))
+        {
+            return (i == HTTP_STATS_BUCKETS - 1) ? entry->max_us : (2ul << i);
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+ * Function Name: http_stats_wrap
+ ******************************************************************************
+ * Summary:
+ *   This function routes a page resource through the dispatch function so
+ *   that its handler is measured. It must be called before the resource is
+ *   registered to the HTTP server. Resources beyond HTTP_STATS_MAX_RESOURCES
+ *   are left unchanged.
+ *
+ * Parameters:
+ *   path: URL path of the resource.
+ *   data: Dynamic resource data holding the page handler.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stats_wrap(const char *path, cy_resource_dynamic_data_t *data)
+{
+    http_stats_entry_t *entry = NULL;
+
+    if ((NULL == data) || (HTTP_STATS_MAX_RESOURCES <= entry_count))
+    {
+        return;
+    }
+
+    entry = &entries[entry_count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->path = path;
+    entry->handler = data->resource_handler;
+    entry->arg = data->arg;
+
+    data->resource_handler = http_stats_dispatch;
+    data->arg = entry;
+}
+
+/******************************************************************************
+ * Function Name: http_stats_add_write
+ ******************************************************************************
+ * Summary:
+ *   This function accounts a write of the response being built.
+ *
+ * Parameters:
+ *   len: Number of bytes written.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void http_stats_add_write(uint32_t len)
+{
+    cur_bytes += len;
+    cur_writes++;
+}
+
+/******************************************************************************
+ * Function Name: http_stats_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the statistics of one resource as text.
+ *
+ * Parameters:
+ *   index: Index of the resource, in registration order.
+ *   buf: Buffer receiving the text.
+ *   buf_len: Length of the buffer.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer, 0 past the last
+ *     resource.
+ *
+ *****************************************************************************/
+int http_stats_report(uint8_t index, char *buf, size_t buf_len)
+{
+    http_stats_entry_t entry;
+    uint32_t n = 0;
+    int len = 0;
+
+    if ((index >= entry_count) || (NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    /* Report a consistent copy of the statistics. */
+    core_util_critical_section_enter();
+    entry = entries[index];
+    core_util_critical_section_exit();
+
+    n = entry.requests ? entry.requests : 1;
+    len = snprintf(buf, buf_len, "%s n=%lu avg=%lu p50<%lu p90<%lu p99<%lu max=%lu us "
+                   "cycles avg=%lu max=%lu bytes avg=%lu max=%lu writes avg=%lu stack max=%lu\n",
+                   entry.path,
+                   (unsigned long)entry.requests,
+                   (unsigned long)(entry.sum_us / n),
+                   (unsigned long)http_stats_percentile(&entry, 50),
+                   (unsigned long)http_stats_percentile(&entry, 90),
+                   (unsigned long)http_stats_percentile(&entry, 99),
+                   (unsigned long)entry.max_us,
+                   (unsigned long)(entry.sum_cycles / n),
+                   (unsigned long)entry.max_cycles,
+                   (unsigned long)(entry.sum_bytes / n),
+                   (unsigned long)entry.max_bytes,
+                   (unsigned long)(entry.sum_writes / n),
+                   (unsigned long)entry.max_stack);
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+#else /* MBED_CONF_APP_HTTP_STATS_ENABLE */
+
+void http_stats_wrap(const char *path, cy_resource_dynamic_data_t *data)
+{
+}
+
+int32_t http_stats_measure(url_processor_t handler,
+                           const char *url_path,
+                           const char *url_query_string,
+                           cy_http_response_stream_t *stream,
+                           void *arg,
+                           cy_http_message_body_t *http_data,
+                           http_stats_sample_t *sample)
+{
+    memset(sample, 0, sizeof(*sample));
+
+    return handler(url_path, url_query_string, stream, arg, http_data);
+}
+
+void http_stats_add_write(uint32_t len)
+{
+}
+
+int http_stats_report(uint8_t index, char *buf, size_t buf_len)
+{
+    if ((NULL == buf) || (0 == buf_len) || (0 != index))
+    {
+        return 0;
+    }
+
+    return snprintf(buf, buf_len, "HTTP handler statistics are disabled. "
+                    "Set http-stats-enable to 1 in mbed_app.json.\n");
+}
+
+#endif /* MBED_CONF_APP_HTTP_STATS_ENABLE */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * File Name: http_stats.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations to measure
+ *   the cost of the HTTP page handlers: latency, bytes and writes per
+ *   response, and stack high-water mark.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HTTP_STATS_H
+#define HTTP_STATS_H
+
+#include "mbed.h"
+#include "HTTP_server.hpp"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* HTTP handler statistics are disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_HTTP_STATS_ENABLE
+#define MBED_CONF_APP_HTTP_STATS_ENABLE    (0)
+#endif
+
+/* Maximum number of HTTP page resources measured. */
+#define HTTP_STATS_MAX_RESOURCES           (10)
+
+/*
+ * Number of latency histogram buckets per resource. Bucket 'n' counts the
+ * requests served in [2^n, 2^(n+1)) microseconds; the last bucket also holds
+ * all the requests beyond its upper bound.
+ */
+#define HTTP_STATS_BUCKETS                 (20)
+
+/*
+ * Bytes left unpainted below the stack pointer of the handler call, for the
+ * frame of the dispatch function itself.
+ */
+#define HTTP_STATS_STACK_MARGIN            (128)
+
+/* Buffer length required to report one resource as text. */
+#define HTTP_STATS_REPORT_LEN              (320)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Measurement of one call of a page handler. */
+typedef struct
+{
+    uint32_t cycles;                        /* CPU cycles (DWT)               */
+    uint32_t us;                            /* Duration in microseconds       */
+    uint32_t bytes;                         /* Response length                */
+    uint32_t writes;                        /* Writes of the response         */
+    uint32_t stack;                         /* Stack high-water mark in bytes */
+} http_stats_sample_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void http_stats_wrap(const char *path, cy_resource_dynamic_data_t *data);
+int32_t http_stats_measure(url_processor_t handler,
+                           const char *url_path,
+                           const char *url_query_string,
+                           cy_http_response_stream_t *stream,
+                           void *arg,
+                           cy_http_message_body_t *http_data,
+                           http_stats_sample_t *sample);
+void http_stats_add_write(uint32_t len);
+int http_stats_report(uint8_t index, char *buf, size_t buf_len);
+
+#endif /* #ifndef HTTP_STATS_H */
+
+
+/* [] END OF FILE */
+
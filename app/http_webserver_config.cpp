@@ -42,21 +42,42 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <new>
 #include "WhdOlmInterface.h"
 #include "cy_lpa_wifi_ol.h"
 #include "pf_olm_config.h"
+#include "wake_latency.h"
+#include "emac_rx_hook.h"
+#include "host_classifier.h"
+#include "pf_tier_manager.h"
+#include "storm_detector.h"
+#include "fast_join.h"
+#include "pf_commit_worker.h"
+#include "pf_profiles.h"
+#include "http_stats.h"
+#include "qspi_xip.h"
+#include "arp_offload.h"
+#include "tko_offload.h"
+#include "pf_snapshot.h"
+#include "pf_ipv6.h"
+#include "app_events.h"
+#include "http_query.h"
 
 /******************************************************************************
  *                              EXTERNS
  *****************************************************************************/
-extern cy_pf_ol_cfg_t *downloaded;
+extern WhdSTAInterface *wifi;
 
 /******************************************************************************
  *                         GLOBAL VARIABLES
  *****************************************************************************/
-static int8_t entry_id = 0;
 HTTPServer *server;
 
+/* Static storage of the HTTP server object. It is constructed once by
+ * app_http_server_init() and never destroyed.
+ */
+alignas(HTTPServer) static uint8_t server_storage[sizeof(HTTPServer)];
+
 static char http_text_heading[] =
 "<html><h1>Packet Filter Offload</h1>"
   "<body>"
@@ -66,6 +87,38 @@ static char http_text_heading[] =
   "</body>"
 "</html>";
 
+/*
+ * Page returned when a commit is queued. The kit disconnects from the AP
+ * during the commit; the page polls the commit status until the kit answers
+ * again and the commit is over, then loads the home page.
+ */
+QSPI_XIP_DATA static const char http_commit_webpage[] =
+"<html>"
+  "<body>"
+    "<h2>Applying packet filters</h2>"
+    "<p>The kit is reassociating with the AP. State: <b id=\"state\">queued</b></p>"
+    "<script>"
+      "function poll() {"
+        "var req = new XMLHttpRequest();"
+        "req.timeout = 2000;"
+        "req.onload = function() {"
+          "var state = req.responseText.split('\\n')[0];"
+          "document.getElementById('state').innerHTML = state;"
+          "if (state == 'done' || state == 'failed') {"
+            "setTimeout(function() { window.location.href = '/'; }, 1000);"
+          "} else {"
+            "setTimeout(poll, 1000);"
+          "}"
+        "};"
+        "req.onerror = req.ontimeout = function() { setTimeout(poll, 1000); };"
+        "req.open('GET', '/commit_status');"
+        "req.send();"
+      "}"
+      "setTimeout(poll, 1000);"
+    "</script>"
+  "</body>"
+"</html>";
+
 static char http_text_start[] = 
 "<html>"
   "<body>"
@@ -99,8 +152,8 @@ static char http_text_start[] =
         "if (confirm('Warning! Applying the new packet filter(s) "
                      "list will overwrite the current active filter(s). "
                      "The webpage will temporarily go down as the kit "
-                     "will disconnect and rejoin the AP. Stop the current "
-                     "page from loading and browse to root URL. Proceed to apply ?'))"
+                     "will disconnect and rejoin the AP. The page reloads "
+                     "once the kit is back. Proceed to apply ?'))"
         "{"
             "if (document.getElementById(\"pending_list\").value == '')"
             "{"
@@ -121,33 +174,26 @@ static char http_text_start[] =
         "<div class=\"one\">";
 static char http_text_end[] =
       "</section>"
-    "</form>"
+    "</form>";
+static char http_text_close[] =
   "</body>"
 "</html>";
 
-static char configure_pkt_filter_webpage[] =
+/* Largest page of the application, read in place from the external flash
+ * when the XIP is enabled.
+ */
+QSPI_XIP_DATA static const char configure_pkt_filter_webpage[] =
 "<html>"
   "<body onload=\"show_hide('PF');\">"
     "<script>"
       "function show_hide(val) {"
-        "if(val == \"PF\") {"
-          "document.getElementById(\"id3\").style.display = '';"
-          "document.getElementById(\"id4\").style.display = '';"
-          "document.getElementById(\"id5\").style.display = '';"
-          "document.getElementById(\"id6\").style.display = 'none';"
-          "document.getElementById(\"id7\").style.display = 'none';"
-        "} else if(val == \"ET\") {"
-          "document.getElementById(\"id6\").style.display = '';"
-          "document.getElementById(\"id3\").style.display = 'none';"
-          "document.getElementById(\"id4\").style.display = 'none';"
-          "document.getElementById(\"id5\").style.display = 'none';"
-          "document.getElementById(\"id7\").style.display = 'none';"
-        "} else {"
-          "document.getElementById(\"id7\").style.display = '';"
-          "document.getElementById(\"id3\").style.display = 'none';"
-          "document.getElementById(\"id4\").style.display = 'none';"
-          "document.getElementById(\"id5\").style.display = 'none';"
-          "document.getElementById(\"id6\").style.display = 'none';"
+        "var rows = {\"PF\": [\"id3\", \"id4\", \"id5\", \"id13\"],"
+                    "\"ET\": [\"id6\", \"id13\"],"
+                    "\"IT\": [\"id7\", \"id13\", \"id14\", \"id15\"],"
+                    "\"HC\": [\"id7\", \"id8\", \"id9\", \"id10\", \"id11\", \"id12\"]};"
+        "for (var i = 3; i <= 15; i++) {"
+          "document.getElementById(\"id\" + i).style.display = "
+            "(rows[val].indexOf(\"id\" + i) < 0) ? 'none' : '';"
         "}"
       "}"
 
@@ -182,6 +228,12 @@ static char configure_pkt_filter_webpage[] =
             "alert('Invalid IP type specified. Valid range: 0x01-0xFF.');"
             "return false;"
           "}"
+          "icmp6_type = document.getElementById(\"icmp6_type\").value;"
+          "if ((icmp6_type != '') && ((document.getElementById(\"ip_version\").value != '6') ||"
+              "(parseInt(ip_proto, 16) != 58) || (icmp6_type < 0) || (icmp6_type > 255))) {"
+            "alert('An ICMPv6 type (0-255) needs IP version 6 and IP protocol 0x3a.');"
+            "return false;"
+          "}"
         "}"
         "return true;"
       "}"
@@ -195,6 +247,7 @@ static char configure_pkt_filter_webpage[] =
             "<option value=\"PF\">Port Filter</option>"
             "<option value=\"ET\">Ether Type</option>"
             "<option value=\"IT\">IP Type</option>"
+            "<option value=\"HC\">Host Classifier</option>"
           "</select>"
         "</td>"
       "</tr>"
@@ -247,14 +300,81 @@ static char configure_pkt_filter_webpage[] =
             "(event.keyCode >= 97 && event.keyCode <= 102)\" onkeydown=\"keep_partial_text(this);\"/> (0x01 - 0xFF)"
         "</td>"
       "</tr>"
+      "<tr id=\"id8\">"
+        "<td id=\"cell15\">Source Network:</td>"
+        "<td id=\"cell16\">"
+          "<input id=\"src_net\" name=\"src_net\" type=\"text\"/> (e.g. 192.168.0.0/24)"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id9\">"
+        "<td id=\"cell17\">Destination Network:</td>"
+        "<td id=\"cell18\">"
+          "<input id=\"dst_net\" name=\"dst_net\" type=\"text\"/> (e.g. 239.255.255.250)"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id10\">"
+        "<td id=\"cell19\">TCP Flags:</td>"
+        "<td id=\"cell20\">"
+          "<input id=\"tcp_flags\" name=\"tcp_flags\" type=\"text\"/> (FSRPAU: upper case set, lower case clear)"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id11\">"
+        "<td id=\"cell21\">Destination:</td>"
+        "<td id=\"cell22\">"
+          "<select id=\"mcast\" name=\"mcast\">"
+            "<option value=\"A\">Any</option>"
+            "<option value=\"M\">Multicast/Broadcast only</option>"
+          "</select>"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id12\">"
+        "<td id=\"cell23\">Payload Prefix:</td>"
+        "<td id=\"cell24\">"
+          "<input id=\"payload\" name=\"payload\" type=\"text\"/> (hex, up to 8 bytes)"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id13\">"
+        "<td id=\"cell25\">Active:</td>"
+        "<td id=\"cell26\">"
+          "<select id=\"active\" name=\"active\">"
+            "<option value=\"A\">Host asleep and awake</option>"
+            "<option value=\"S\">Host asleep only</option>"
+            "<option value=\"W\">Host awake only</option>"
+          "</select>"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id14\">"
+        "<td id=\"cell27\">IP Version:</td>"
+        "<td id=\"cell28\">"
+          "<select id=\"ip_version\" name=\"ip_version\">"
+            "<option value=\"4\">IPv4 protocol</option>"
+            "<option value=\"6\">IPv6 next header (Keep only)</option>"
+          "</select>"
+        "</td>"
+      "</tr>"
+      "<tr id=\"id15\">"
+        "<td id=\"cell29\">ICMPv6 Type:</td>"
+        "<td id=\"cell30\">"
+          "<input id=\"icmp6_type\" name=\"icmp6_type\" type=\"text\" onkeypress=\"return (event.keyCode >= 48 && event.keyCode <= 57)\"/> (0 - 255, empty for any)"
+        "</td>"
+      "</tr>"
     "</table>"
       "<input type=\"submit\" name=\"add\" value=\"Submit\">"
+      "<input type=\"submit\" name=\"tier\" value=\"Add to Tiered Catalog\" formaction=\"/?add=tier\">"
     "</form>"
     "<label type=\"text\" style=\"color: maroon;\">Note:<br>"
       "<ul type=\"square\">"
         "<li>Adding combination of \"Keep\" and \"Discard\" filters are not allowed."
         " The filter action should follow only \"Keep\" filters or only \"Discard\" filters.</li>"
         "<li>Duplicate filters will be rejected and not added to the pending filter list.</li>"
+        "<li>A filter active only while the host is asleep or awake is enabled and disabled in the WLAN device "
+        "at each host sleep and wake. For example, a Keep filter for port 80 active only while the host is awake "
+        "passes web traffic during an operator session but never wakes a sleeping host.</li>"
+        "<li>An IP Type filter with IP version 6 keeps the IPv6 packets with the given next header in the "
+        "fixed IPv6 header, such as 0x3a for ICMPv6, optionally of one ICMPv6 type: 134 for router advertisements, "
+        "135 and 136 for neighbor solicitations and advertisements.</li>"
+        "<li>Host Classifier rules run on the host, on the packets passed by the WLAN packet filters. "
+        "They take effect immediately, without reassociation to the AP. Empty fields match any packet.</li>"
         "<li> Only one Discard filter can be added. If any discard filter already exists in the"
         " pending list, then no further filter can be added and the operation will be rejected.</li>"
         "<li>Packet types:</li>"
@@ -272,24 +392,72 @@ static char configure_pkt_filter_webpage[] =
 /* HTML resources to register with the HTTP server. */
 cy_resource_dynamic_data_t test_data = {http_startup_webpage, NULL};
 cy_resource_dynamic_data_t http_configure_filter_url = {http_configure_filter, NULL};
+cy_resource_dynamic_data_t http_wake_latency_url = {http_wake_latency, NULL};
+cy_resource_dynamic_data_t http_tier_url = {http_tier_report, NULL};
+cy_resource_dynamic_data_t http_join_timing_url = {http_join_timing, NULL};
+cy_resource_dynamic_data_t http_commit_status_url = {http_commit_status, NULL};
+cy_resource_dynamic_data_t http_stats_url = {http_handler_stats, NULL};
+cy_resource_dynamic_data_t http_arp_offload_url = {http_arp_offload, NULL};
+cy_resource_dynamic_data_t http_event_stats_url = {http_event_stats, NULL};
 
 /******************************************************************************
  *                     FUNCTION DEFINITIONS
  *****************************************************************************/
+/******************************************************************************
+ * Function Name: http_write
+ ******************************************************************************
+ * Summary:
+ *   This function writes a part of the HTTP response and accounts it in the
+ *   statistics of the page handler being measured. A NULL stream discards the
+ *   response, for the page render benchmark.
+ *
+ * Parameters:
+ *   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+ *   data: Data to write.
+ *   len: Number of bytes to write.
+ *
+ * Return:
+ *   cy_rslt_t: Returns error code as defined in cy_rslt_t.
+ *
+ *****************************************************************************/
+static cy_rslt_t http_write(cy_http_response_stream_t *stream,
+                            const void *data,
+                            uint32_t len)
+{
+    http_stats_add_write(len);
+
+    if (NULL == stream)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    return server->http_response_stream_write(stream, data, len);
+}
+
 /******************************************************************************
  * Function Name: add_remove_restore_filters
  ******************************************************************************
  * Summary:
  *   This function is called when the user selects any of these buttons from
- *   the webpage: Add Filter, Remove Last Filter, Import minimal keep filters,
- *   and Restore Defaults.
+ *   the webpage: Add Filter, Remove Last Filter, Remove Filter ID, Import
+ *   minimal keep filters, Load Profile, Restore Defaults, Clear Host Rules,
+ *   Clear Tiered Catalog and Save ARP Settings.
  *   Add Filter: Redirects to another page to configure and add a new packet
  *   filter to the pending list.
  *   Remove Last Filter: Removes the last added filter from the pending list.
+ *   Remove Filter ID: Removes the filter with the given ID from the pending
+ *   list.
  *   Import minimal keep filters: Pulls the list of minimum keep filters
  *   (default filters) as selected in the device configurator tool.
+ *   Load Profile: Replaces the pending list with the selected precompiled
+ *   packet filter profile.
  *   Restore Defaults: Applies the default packet filters as selected in the
  *   device configurator tool.
+ *   Clear Host Rules: Removes all the host classifier rules.
+ *   Clear Tiered Catalog: Removes all the keep filters of the tiered filter
+ *   manager.
+ *   Save ARP Settings: Changes the settings of the ARP offload, applied to
+ *   the WLAN device by the next commit.
  *
  * Parameters:
  *   query_string: Pointer to HTTP url query string.
@@ -307,29 +475,72 @@ cy_rslt_t add_remove_restore_filters(const char *query_string,
 
     if (NULL != query_string)
     {
-        if (!strncmp(query_string, "add", strlen(query_string)-1))
+        if (http_query_is(query_string, "add"))
         {
             /* Add a new filter to the pending list */
             result = http_submit_filter(http_data);
         }
-        else if (!strncmp(query_string, "remove", strlen(query_string)-1))
+        else if (http_query_is(query_string, "tier"))
+        {
+            /* Add a new keep filter to the tiered catalog */
+            result = http_submit_tier_rule(http_data);
+        }
+        else if (http_query_is(query_string, "arp"))
+        {
+            /* Change the settings of the ARP offload */
+            result = http_submit_arp_settings(http_data);
+        }
+        else if (!strncmp(query_string, PF_REMOVE_QUERY_PREFIX,
+                          strlen(PF_REMOVE_QUERY_PREFIX)))
+        {
+            /* Remove the filter with the given ID from the pending list */
+            const char *number = &query_string[strlen(PF_REMOVE_QUERY_PREFIX)];
+            char *end = NULL;
+            unsigned long id = strtoul(number, &end, 10);
+
+            result = ((end == number) || ('\0' != *end) || (UINT8_MAX < id)) ?
+                     CY_RSLT_TYPE_ERROR : pf_remove_filter((uint8_t)id);
+        }
+        else if (http_query_is(query_string, "remove"))
         {
             /* Remove last added filter from pending list */
             result = remove_last_added_filter();
         }
-        else if (!strncmp(query_string, "restore_defaults", strlen(query_string)-1))
+        else if (http_query_is(query_string, "restore_defaults"))
         {
-            /* Restore default packet filter configs */
-            result = pf_commit_list(true);
+            /* Queue a restore of the default packet filter configs */
+            pf_commit_request(true);
         }
-        else if (!strncmp(query_string, "minimum_filter", strlen(query_string)-1))
+        else if (http_query_is(query_string, "minimum_filter"))
         {
             /* Add minimum required packet filters to the pending list */
             add_minimum_filters();
         }
-        else if (!strncmp(query_string, "apply_filter", strlen(query_string)-1))
+        else if (http_query_is(query_string, "apply_filter"))
+        {
+            /* Queue a commit of the pending list */
+            pf_commit_request(false);
+        }
+        else if (http_query_is(query_string, "clear_host_rules"))
         {
-            result = pf_commit_list(false);
+            /* Remove all the host classifier rules */
+            host_classifier_clear();
+        }
+        else if (http_query_is(query_string, "clear_tier"))
+        {
+            /* Remove all the keep filters of the tiered catalog */
+            pf_tier_clear();
+        }
+        else if (!strncmp(query_string, PF_PROFILE_QUERY_PREFIX,
+                          strlen(PF_PROFILE_QUERY_PREFIX)))
+        {
+            /* Replace the pending list with a precompiled profile */
+            const char *number = &query_string[strlen(PF_PROFILE_QUERY_PREFIX)];
+            char *end = NULL;
+            unsigned long index = strtoul(number, &end, 10);
+
+            result = ((end == number) || ('\0' != *end) || (UINT8_MAX < index)) ?
+                     CY_RSLT_TYPE_ERROR : pf_profile_load((uint8_t)index);
         }
     }
 
@@ -366,15 +577,18 @@ int32_t http_startup_webpage(const char *url_path,
     char http_resp_str_builder[HTTP_RESP_STR_BUFFER_LEN] = {0};
     char parse_query_string[HTTP_QUERY_STR_VALUE_LEN] = {0};
     char build_str[HTTP_BUILD_STR_LEN] = {0};
-    cy_pf_ol_cfg_t *cfg = downloaded;
+    const pf_snapshot_t *snapshot = NULL;
+    const cy_pf_ol_cfg_t *cfg = NULL;
+    const pf_ipv6_attr_t *ipv6 = NULL;
+    pf_snapshot_reader_t reader;
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
+    WAKE_LATENCY_MARK(WAKE_MARK_SOCKET_DELIVERY);
+
     /* Parse URL query string. The possible user actions are
      * Add/Remove/Import/Restore/Apply filters.
      */
-    memcpy(parse_query_string, url_query_string, sizeof(parse_query_string));
-    strtok(parse_query_string, "=");
-    memcpy(parse_query_string, strtok(NULL, "="), sizeof(parse_query_string));
+    http_query_value(url_query_string, parse_query_string, sizeof(parse_query_string));
 
     result = add_remove_restore_filters(parse_query_string, http_data);
     if (CY_RSLT_SUCCESS != result)
@@ -382,10 +596,19 @@ int32_t http_startup_webpage(const char *url_path,
         ERR_INFO(("Failed to perform the user request.\n"));
     }
 
-    /* Return here as the kit will reassociate with AP. */
-    if (!strncmp(parse_query_string, "restore_defaults", strlen(parse_query_string)-1) ||
-        !strncmp(parse_query_string, "apply_filter", strlen(parse_query_string)-1))
+    /* The kit will reassociate with AP. Return a page which polls the
+     * commit status and reloads the home page once the commit is over.
+     */
+    if (http_query_is(parse_query_string, "restore_defaults") ||
+        http_query_is(parse_query_string, "apply_filter"))
     {
+        result = http_write(stream,
+                            http_commit_webpage,
+                            strlen(http_commit_webpage));
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to write HTTP response\r\n"));
+        }
         return result;
     }
 
@@ -394,71 +617,87 @@ int32_t http_startup_webpage(const char *url_path,
      */
     memset(build_str, 0, sizeof(build_str));
     sprintf(build_str, (const char *)&http_text_heading[0], get_max_filter());
-    result = server->http_response_stream_write(stream, build_str, strlen(build_str));
+    result = http_write(stream, build_str, strlen(build_str));
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
     }
 
+    /* Both lists are rendered in place from the snapshots of one read
+     * section. The edits and commits of the other threads do not wait for
+     * this page: while it is written they publish into the free slots, or
+     * stay staged until the section is left.
+     */
+    reader = pf_snapshot_read_lock();
+
     /* Populate active packet filter list. */
-    if (NULL != cfg)
-    {
-        strcat(http_resp_str_builder, http_text_start);
-        strcat(http_resp_str_builder,
-               "<b>Active Packet Filters:</b><br>"
-               "<textarea readonly rows=\"4\" cols=\"50\" "
-               "style=\"background:lightblue; font-size:large; "
-               "height:431px; width:420px\">");
-        while ((NULL != cfg) && (CY_PF_OL_FEAT_LAST != cfg->feature))
+    snapshot = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+    cfg = snapshot->cfgs;
+    strcat(http_resp_str_builder, http_text_start);
+    strcat(http_resp_str_builder,
+           "<b>Active Packet Filters:</b><br>"
+           "<textarea readonly rows=\"4\" cols=\"50\" "
+           "style=\"background:lightblue; font-size:large; "
+           "height:431px; width:420px\">");
+    while (CY_PF_OL_FEAT_LAST != cfg->feature)
+    {
+        memset(build_str, 0, sizeof(build_str));
+        if (CY_PF_OL_FEAT_PORTNUM == cfg->feature)
         {
-            memset(build_str, 0, sizeof(build_str));
-            if (CY_PF_OL_FEAT_PORTNUM == cfg->feature)
-            {
-                sprintf(build_str, "\nID %d[Port Filter]:\n"
-                                   "\tPort = %d,\n"
-                                   "\tAction = %s,\n"
-                                   "\tProtocol = %s,\n"
-                                   "\tDirection = %s",
-                                   (cfg->id),
-                                   (cfg->u.pf.portnum.portnum),
-                                   ((cfg->bits & CY_PF_ACTION_DISCARD)?"Discard":"Keep"),
-                                   ((cfg->u.pf.proto == 1)?"UDP":"TCP"),
-                                   ((cfg->u.pf.portnum.direction == 1)?"Destination Port":"Source Port"));
-                strcat(http_resp_str_builder, build_str);
-            }
-            else if (CY_PF_OL_FEAT_ETHTYPE == cfg->feature)
+            sprintf(build_str, "\nID %d[Port Filter]:\n"
+                               "\tPort = %d,\n"
+                               "\tAction = %s,\n"
+                               "\tProtocol = %s,\n"
+                               "\tDirection = %s",
+                               (cfg->id),
+                               (cfg->u.pf.portnum.portnum),
+                               ((cfg->bits & CY_PF_ACTION_DISCARD)?"Discard":"Keep"),
+                               ((cfg->u.pf.proto == 1)?"UDP":"TCP"),
+                               ((cfg->u.pf.portnum.direction == 1)?"Destination Port":"Source Port"));
+            strcat(http_resp_str_builder, build_str);
+        }
+        else if (CY_PF_OL_FEAT_ETHTYPE == cfg->feature)
+        {
+            sprintf(build_str, "\nID %d[Eth Filter]:\n"
+                               "\tPacket Type = 0x%x,\n"
+                               "\tAction = %s",
+                               (cfg->id),
+                               (cfg->u.eth.eth_type),
+                               ((cfg->bits & CY_PF_ACTION_DISCARD)?"Discard":"Keep"));
+            strcat(http_resp_str_builder, build_str);
+        }
+        else if (CY_PF_OL_FEAT_IPTYPE == cfg->feature)
+        {
+            sprintf(build_str, "\nID %d[IP Filter]:\n"
+                               "\tPacket Type = 0x%x,\n"
+                               "\tAction = %s",
+                               (cfg->id),
+                               (cfg->u.ip.ip_type),
+                               ((cfg->bits & CY_PF_ACTION_DISCARD)?"Discard":"Keep"));
+            strcat(http_resp_str_builder, build_str);
+            ipv6 = pf_list_ipv6_attr(&snapshot->ipv6, cfg);
+            if (ipv6->flags & PF_IPV6_NEXT_HEADER)
             {
-                sprintf(build_str, "\nID %d[Eth Filter]:\n"
-                                   "\tPacket Type = 0x%x,\n"
-                                   "\tAction = %s",
-                                   (cfg->id),
-                                   (cfg->u.eth.eth_type),
-                                   ((cfg->bits & CY_PF_ACTION_DISCARD)?"Discard":"Keep"));
-                strcat(http_resp_str_builder, build_str);
+                strcat(http_resp_str_builder, ",\n\tIP Version = 6");
             }
-            else if (CY_PF_OL_FEAT_IPTYPE == cfg->feature)
+            if (ipv6->flags & PF_IPV6_ICMP6_TYPE)
             {
-                sprintf(build_str, "\nID %d[IP Filter]:\n"
-                                   "\tPacket Type = 0x%x,\n"
-                                   "\tAction = %s",
-                                   (cfg->id),
-                                   (cfg->u.ip.ip_type),
-                                   ((cfg->bits & CY_PF_ACTION_DISCARD)?"Discard":"Keep"));
+                sprintf(build_str, ",\n\tICMPv6 Type = %u", ipv6->icmp6_type);
                 strcat(http_resp_str_builder, build_str);
             }
+        }
 
-            /* Get the next configuration. */
-            cfg++;
-            strcat(http_resp_str_builder, "\n");
-            result = server->http_response_stream_write(stream,
-                                                        http_resp_str_builder,
-                                                        strlen(http_resp_str_builder));
-            if (CY_RSLT_SUCCESS != result)
-            {
-                ERR_INFO(("Failed to write HTTP response\r\n"));
-            }
-            memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
+        /* Get the next configuration. */
+        cfg++;
+        strcat(http_resp_str_builder, "\n");
+        result = http_write(stream,
+                            http_resp_str_builder,
+                            strlen(http_resp_str_builder));
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to write HTTP response\r\n"));
         }
+        memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
     }
 
     strcat(http_resp_str_builder,
@@ -471,8 +710,8 @@ int32_t http_startup_webpage(const char *url_path,
            "</button></div>");
 
     /* Send the populated active packet filters to the client. */
-    result = server->http_response_stream_write(stream, http_resp_str_builder,
-                                               sizeof(http_resp_str_builder));
+    result = http_write(stream, http_resp_str_builder,
+                        strlen(http_resp_str_builder));
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
@@ -487,26 +726,138 @@ int32_t http_startup_webpage(const char *url_path,
            "style=\"background:lightblue;font-size:large; height:431px; width:420px\">");
 
     /* Populate the Pending Packet Filter list. */
-    cfg = get_pending_filter_list();
-    cy_pf_ol_cfg_t *end_cfg = (cfg + MAX_FILTERS);
-    for (; (NULL != cfg) && (cfg->feature != CY_PF_OL_FEAT_LAST) && (cfg < end_cfg); cfg++)
+    snapshot = pf_snapshot_get(reader, PF_SNAPSHOT_PENDING);
+    for (uint8_t i = 0; i < snapshot->count; i++)
     {
-        print_filter(cfg, &http_resp_str_builder[0], &build_str[0], sizeof(build_str));
+        print_filter(&snapshot->cfgs[i], pf_list_ipv6_attr(&snapshot->ipv6, &snapshot->cfgs[i]),
+                     &http_resp_str_builder[0], &build_str[0], sizeof(build_str));
     }
+    pf_snapshot_read_unlock(reader);
     strcat(http_resp_str_builder,
            "</textarea></td><td>"
            "<button class=\"three\" type=\"submit\" formaction=\"configure_filter\">Add Filter</button><br><br>"
            "<button class=\"three\" type=\"submit\" name=\"remove\" value=\"remove\" formaction=\"/?remove\">Remove Last Filter</button><br><br>"
+           "<input id=\"remove_id\" type=\"text\" size=\"3\" onkeypress=\"return (event.keyCode >= 48 && event.keyCode <= 57)\"/> "
+           "<button type=\"submit\" name=\"remove_id\" onclick=\"changeVal(this, "
+           "'" PF_REMOVE_QUERY_PREFIX "' + document.getElementById('remove_id').value, '/?remove_id')\">"
+           "Remove Filter ID</button><br><br>"
            "<button class=\"three\" type=\"submit\" name=\"minimum_filter\" onclick=\"confirm('Add minimum keep packet filters "
            "to the pending list ?')?changeVal(this, 'minimum_filter', '/?minimum_filter'):changeVal(this, '', '')\">Import minimal keep filters</button>"
            "<br><br>"
            "<button class=\"three\" type=\"submit\" name=\"apply_filter\""
            "onclick=\"if(validateBeforeApply()){ changeVal(this, 'apply_filter', '/?apply_filter'); }else{ changeVal(this, '', ''); }\">Apply Filters</button></td></tr></table></div>");
 
+    result = http_write(stream,
+                        http_resp_str_builder,
+                        strlen(http_resp_str_builder));
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    /* Populate the packet filter profiles. Only the names are read from the
+     * profile library; a profile is expanded when loaded.
+     */
+    memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
+    strcat(http_resp_str_builder,
+           "<div><b>Packet Filter Profiles:</b><br>"
+           "<select id=\"profile\" style=\"font-size:large; width:420px\">");
+    for (uint8_t i = 0; i < pf_profile_count(); i++)
+    {
+        snprintf(build_str, sizeof(build_str), "<option value=\"%u\">%s</option>",
+                 (unsigned int)i, pf_profile_name(i));
+        if ((strlen(http_resp_str_builder) + strlen(build_str)) >= sizeof(http_resp_str_builder))
+        {
+            result = http_write(stream,
+                                http_resp_str_builder,
+                                strlen(http_resp_str_builder));
+            if (CY_RSLT_SUCCESS != result)
+            {
+                ERR_INFO(("Failed to write HTTP response\r\n"));
+            }
+            memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
+        }
+        strcat(http_resp_str_builder, build_str);
+    }
+    strcat(http_resp_str_builder,
+           "</select> "
+           "<button class=\"three\" type=\"submit\" name=\"profile\" onclick=\"changeVal(this, "
+           "'" PF_PROFILE_QUERY_PREFIX "' + document.getElementById('profile').value, '/?profile')\">"
+           "Load Profile</button></div><br>");
+
+    result = http_write(stream,
+                        http_resp_str_builder,
+                        strlen(http_resp_str_builder));
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    /* Populate the host classifier rules. */
+    memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
+    strcat(http_resp_str_builder,
+           "<div><b>Host Classifier Rules:</b><table><tr><td>"
+           "<textarea readonly rows=\"4\" cols=\"50\" "
+           "style=\"background:lightyellow;font-size:large; height:200px; width:420px\">");
+    hc_rule_t rule;
+    for (uint8_t i = 0; host_classifier_get_rule(i, &rule); i++)
+    {
+        hc_print_rule(&rule, build_str, sizeof(build_str));
+        if ((strlen(http_resp_str_builder) + strlen(build_str)) >= sizeof(http_resp_str_builder))
+        {
+            result = http_write(stream,
+                                http_resp_str_builder,
+                                strlen(http_resp_str_builder));
+            if (CY_RSLT_SUCCESS != result)
+            {
+                ERR_INFO(("Failed to write HTTP response\r\n"));
+            }
+            memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
+        }
+        strcat(http_resp_str_builder, build_str);
+    }
+    strcat(http_resp_str_builder,
+           "</textarea></td><td>"
+           "<button class=\"three\" type=\"submit\" name=\"clear_host_rules\" onclick=\"confirm('Remove all the host "
+           "classifier rules ?')?changeVal(this, 'clear_host_rules', '/?clear_host_rules'):changeVal(this, '', '')\">Clear Host Rules</button><br><br>"
+           "<button class=\"three\" type=\"submit\" name=\"clear_tier\" onclick=\"confirm('Remove all the tiered "
+           "catalog filters ?')?changeVal(this, 'clear_tier', '/?clear_tier'):changeVal(this, '', '')\">Clear Tiered Catalog</button>"
+           "</td></tr></table></div>");
+
     strcat(http_resp_str_builder, http_text_end);
-    result = server->http_response_stream_write(stream,
-                                                http_resp_str_builder,
-                                                strlen(http_resp_str_builder));
+    result = http_write(stream,
+                        http_resp_str_builder,
+                        strlen(http_resp_str_builder));
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    /* Populate the ARP offload settings. They are posted by a form of their
+     * own, so that their fields are not added to the queries of the buttons
+     * of the main form.
+     */
+    memset(http_resp_str_builder, '\0', sizeof(http_resp_str_builder));
+    snprintf(http_resp_str_builder, sizeof(http_resp_str_builder),
+             "<form method=\"POST\" action=\"/?arp=arp\"><div><b>ARP Offload:</b><br>"
+             "Snoop peers <select name=\"snoop\">"
+             "<option value=\"1\"%s>On</option><option value=\"0\"%s>Off</option></select> "
+             "Reply for peers <select name=\"peer_reply\">"
+             "<option value=\"1\"%s>On</option><option value=\"0\"%s>Off</option></select> "
+             "Peer age <input name=\"peerage\" type=\"text\" size=\"6\" value=\"%lu\" "
+             "onkeypress=\"return (event.keyCode >= 48 && event.keyCode <= 57)\"/> s (0 - %lu) "
+             "<button class=\"three\" type=\"submit\">Save ARP Settings</button><br>"
+             "The settings are applied with the next Apply Filters.</div></form>",
+             arp_offload_get_snoop() ? " selected" : "",
+             arp_offload_get_snoop() ? "" : " selected",
+             arp_offload_get_peer_auto_reply() ? " selected" : "",
+             arp_offload_get_peer_auto_reply() ? "" : " selected",
+             (unsigned long)arp_ol_cfg.peerage,
+             (unsigned long)ARP_OFFLOAD_PEERAGE_MAX_S);
+    strcat(http_resp_str_builder, http_text_close);
+    result = http_write(stream,
+                        http_resp_str_builder,
+                        strlen(http_resp_str_builder));
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
@@ -541,9 +892,11 @@ int32_t http_configure_filter(const char *url_path,
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
-    result = server->http_response_stream_write(stream,
-                                                configure_pkt_filter_webpage,
-                                                sizeof(configure_pkt_filter_webpage));
+    WAKE_LATENCY_MARK(WAKE_MARK_SOCKET_DELIVERY);
+
+    result = http_write(stream,
+                        configure_pkt_filter_webpage,
+                        sizeof(configure_pkt_filter_webpage));
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("Failed to write HTTP response\r\n"));
@@ -553,70 +906,348 @@ int32_t http_configure_filter(const char *url_path,
 }
 
 /******************************************************************************
-* Function Name: parse_webpage_config
+* Function Name: http_wake_latency
 *******************************************************************************
 * Summary:
-*   The function helps to parse the HTTP data string.
+*   This function reports the wake latency histograms of all the stages and
+*   the counters of the host-side filtering as plain text.
 *
 * Parameters:
-*   http_data: Pointer to the HTTP data string.
-*   data_len: HTTP data string length.
-*   config_str[]: Pointer to filter data. The filter data comes from HTTP
-*     server as a string and this variable is used to hold pointer to it.
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
 *
 * Return:
-*   void.
+*   int32_t: Returns error code as defined in cy_rslt_t.
 *
 ******************************************************************************/
-static void parse_webpage_config(char *http_data,
-                                 uint16_t data_len,
-                                 char *config_str[])
+int32_t http_wake_latency(const char *url_path,
+                          const char *url_query_string,
+                          cy_http_response_stream_t *stream,
+                          void *arg,
+                          cy_http_message_body_t *http_data)
 {
-    uint8_t index = 0;
-    char *token = NULL;
+    char report[WAKE_LATENCY_REPORT_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    int len = 0;
 
-    token = strtok(http_data, "&");
+    len = snprintf(report, sizeof(report), "Wakes: %lu\nEarly discards: %lu\n"
+                   "Host classifier drops: %lu\n",
+                   (unsigned long)wake_latency_get_wake_count(),
+                   (unsigned long)emac_rx_hook_get_discard_count(),
+                   (unsigned long)host_classifier_get_drop_count());
+    len += storm_detector_report(&report[len], sizeof(report) - len);
+    result = http_write(stream, report, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+    len = pf_ipv6_report(report, sizeof(report));
+    result = http_write(stream, report, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+    len = tko_offload_report(report, sizeof(report));
 
-    while ((NULL != token) && (MAX_HTTP_CONFIG_NUMBER > index))
+    for (int stage = 0; stage < WAKE_STAGE_MAX; stage++)
     {
-        size_t len = strlen(token) + 1;
-        void *copy = malloc(len);
-        if (NULL == copy)
+        len += wake_latency_report((wake_stage_t)stage, &report[len],
+                                   sizeof(report) - len);
+        if (0 == len)
+        {
+            continue;
+        }
+
+        result = http_write(stream, report, len);
+        if (CY_RSLT_SUCCESS != result)
         {
-            return;
+            ERR_INFO(("Failed to write HTTP response\r\n"));
         }
-        config_str[index] = (char *)memcpy(copy, token, len);
-        token = strtok(NULL, "&");
-        index++;
+        len = 0;
     }
 
-    index = 0;
-    while ((NULL != config_str[index]) && (MAX_HTTP_CONFIG_NUMBER > index))
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_tier_report
+*******************************************************************************
+* Summary:
+*   This function reports the state of the tiered filter manager and the
+*   keep filters of its catalog as plain text.
+*
+* Parameters:
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   int32_t: Returns error code as defined in cy_rslt_t.
+*
+******************************************************************************/
+int32_t http_tier_report(const char *url_path,
+                         const char *url_query_string,
+                         cy_http_response_stream_t *stream,
+                         void *arg,
+                         cy_http_message_body_t *http_data)
+{
+    char report[PF_TIER_REPORT_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint8_t index = 0;
+    int len = 0;
+
+    len = pf_tier_report_summary(report, sizeof(report));
+    while (0 < len)
     {
-        token = strtok(config_str[index], "=");
-        config_str[index] = strtok(NULL, "=");
-        index++;
+        result = http_write(stream, report, len);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to write HTTP response\r\n"));
+        }
+        len = pf_tier_report_rule(index++, report, sizeof(report));
     }
+
+    return result;
 }
 
 /******************************************************************************
-* Function Name: get_entry_id
+* Function Name: http_join_timing
 *******************************************************************************
 * Summary:
-*   This function returns the reference of entry_id static variable, giving
-*   access to other modules in the application to change the entry id
-*   dynamically.
+*   This function reports the duration of each phase of the connects to the
+*   AP, for the full and the directed joins, as plain text.
 *
 * Parameters:
-*   None.
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
 *
 * Return:
-*   int8_t: Returns pointer to entry_id.
+*   int32_t: Returns error code as defined in cy_rslt_t.
 *
 ******************************************************************************/
-int8_t *get_entry_id(void)
+int32_t http_join_timing(const char *url_path,
+                         const char *url_query_string,
+                         cy_http_response_stream_t *stream,
+                         void *arg,
+                         cy_http_message_body_t *http_data)
 {
-    return &entry_id;
+    char report[FAST_JOIN_REPORT_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    int len = 0;
+
+    len = static_cast<FastJoinSTAInterface *>(wifi)->report(report, sizeof(report));
+    result = http_write(stream, report, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_commit_status
+*******************************************************************************
+* Summary:
+*   This function reports the state of the last packet filter commit as plain
+*   text. The first line is the state, polled by the web page after a commit
+*   is queued.
+*
+* Parameters:
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   int32_t: Returns error code as defined in cy_rslt_t.
+*
+******************************************************************************/
+int32_t http_commit_status(const char *url_path,
+                           const char *url_query_string,
+                           cy_http_response_stream_t *stream,
+                           void *arg,
+                           cy_http_message_body_t *http_data)
+{
+    char report[PF_COMMIT_STATUS_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    int len = 0;
+
+    len = pf_commit_status_report(report, sizeof(report));
+    result = http_write(stream, report, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_event_stats
+*******************************************************************************
+* Summary:
+*   This function reports the depth of the application event queue and the
+*   latency and duration of each event as plain text.
+*
+* Parameters:
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   int32_t: Returns error code as defined in cy_rslt_t.
+*
+******************************************************************************/
+int32_t http_event_stats(const char *url_path,
+                         const char *url_query_string,
+                         cy_http_response_stream_t *stream,
+                         void *arg,
+                         cy_http_message_body_t *http_data)
+{
+    char report[APP_EVENTS_REPORT_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    int len = 0;
+
+    len = app_events_report(report, sizeof(report));
+    result = http_write(stream, report, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_arp_offload
+*******************************************************************************
+* Summary:
+*   This function reports the state of the ARP offload as plain text. The
+*   settings are changed from the form of the home page, see
+*   http_submit_arp_settings().
+*
+* Parameters:
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   int32_t: Returns error code as defined in cy_rslt_t.
+*
+******************************************************************************/
+int32_t http_arp_offload(const char *url_path,
+                         const char *url_query_string,
+                         cy_http_response_stream_t *stream,
+                         void *arg,
+                         cy_http_message_body_t *http_data)
+{
+    char report[ARP_OFFLOAD_REPORT_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    int len = 0;
+
+    len = arp_offload_report(report, sizeof(report));
+    result = http_write(stream, report, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to write HTTP response\r\n"));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_handler_stats
+*******************************************************************************
+* Summary:
+*   This function reports the latency, response length, writes and stack
+*   high-water mark of each page handler as plain text.
+*
+* Parameters:
+*   url_path: Pointer to HTTP url path.
+*   url_query_string: Pointer to HTTP url query string.
+*   stream: Pointer to HTTP server stream through which HTTP data sent/received.
+*   arg: Argument as set in callback registration.
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   int32_t: Returns error code as defined in cy_rslt_t.
+*
+******************************************************************************/
+int32_t http_handler_stats(const char *url_path,
+                           const char *url_query_string,
+                           cy_http_response_stream_t *stream,
+                           void *arg,
+                           cy_http_message_body_t *http_data)
+{
+    char report[HTTP_STATS_REPORT_LEN] = {0};
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint8_t index = 0;
+    int len = 0;
+
+    len = http_stats_report(index++, report, sizeof(report));
+    while (0 < len)
+    {
+        result = http_write(stream, report, len);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to write HTTP response\r\n"));
+        }
+        len = http_stats_report(index++, report, sizeof(report));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: parse_webpage_config
+*******************************************************************************
+* Summary:
+*   The function helps to parse the HTTP data string. The HTTP data is not
+*   NUL terminated; it is copied to the given buffer first.
+*
+* Parameters:
+*   http_data: Pointer to HTTP data.
+*   body: Buffer receiving a NUL terminated copy of the HTTP data. The
+*     filter data points into it.
+*   body_len: Length of the buffer.
+*   config_str[]: Pointer to filter data. The filter data comes from HTTP
+*     server as a string and this variable is used to hold pointer to it.
+*
+* Return:
+*   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the HTTP data
+*     is missing or does not fit in the buffer.
+*
+******************************************************************************/
+static cy_rslt_t parse_webpage_config(cy_http_message_body_t *http_data,
+                                      char *body,
+                                      size_t body_len,
+                                      char *config_str[])
+{
+    if ((NULL == http_data) ||
+        (CY_RSLT_SUCCESS != http_form_split((const char *)http_data->data,
+                                            http_data->data_length,
+                                            body, body_len, config_str,
+                                            MAX_HTTP_CONFIG_NUMBER)))
+    {
+        ERR_INFO(("Invalid HTTP data\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
 }
 
 /******************************************************************************
@@ -642,28 +1273,140 @@ int8_t *get_entry_id(void)
 cy_rslt_t http_submit_filter(cy_http_message_body_t *http_data)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
-    char *config_str[7] = {NULL};
+    char *config_str[MAX_HTTP_CONFIG_NUMBER] = {NULL};
+    char body[HTTP_BODY_MAX_LEN];
 
-    if (NULL == http_data || NULL == http_data->data)
+    /* Parse HTTP data string. */
+    if (CY_RSLT_SUCCESS != parse_webpage_config(http_data, body, sizeof(body), config_str))
     {
-        return result;
+        return CY_RSLT_TYPE_ERROR;
     }
 
-    /* Parse HTTP data string. */
-    parse_webpage_config((char *)&http_data->data[0],
-                          http_data->data_length,
-                          config_str);
+    /* Host classifier rules are not part of the packet filter list. */
+    if ((NULL != config_str[PKT_FILTER_TYPE_ID]) &&
+        !strncmp(config_str[PKT_FILTER_TYPE_ID], "HC", PKT_FILTER_ID_STR_LEN))
+    {
+        result = hc_add_to_list(&config_str[0]);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Host classifier add to list failed\n"));
+        }
+        return result;
+    }
 
     /* Add packet filter to list */
-    result = pf_add_to_list(&config_str[0], entry_id);
-    
+    result = pf_add_to_list(&config_str[0]);
     if (CY_RSLT_SUCCESS != result)
     {
         ERR_INFO(("PF add to list failed\n"));
-        entry_id--;
     }
 
-    entry_id++;
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_submit_tier_rule
+*******************************************************************************
+* Summary:
+*   This function adds the keep filter configured in the web page to the
+*   catalog of the tiered filter manager instead of the pending list. The
+*   manager decides which filters of the catalog are offloaded to the WLAN
+*   device and commits the list itself.
+*
+* Parameters:
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   cy_rslt_t: Returns error code as defined in cy_rslt_t.
+*
+******************************************************************************/
+cy_rslt_t http_submit_tier_rule(cy_http_message_body_t *http_data)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    char *config_str[MAX_HTTP_CONFIG_NUMBER] = {NULL};
+    char body[HTTP_BODY_MAX_LEN];
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+
+    /* Parse HTTP data string. */
+    if (CY_RSLT_SUCCESS != parse_webpage_config(http_data, body, sizeof(body), config_str))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memset(&cfg, 0, sizeof(cfg));
+    result = pf_parse_filter(&config_str[0], &cfg, &ipv6);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = pf_tier_add_rule(&cfg, &ipv6);
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Tiered catalog add failed\n"));
+    }
+
+    return result;
+}
+
+/******************************************************************************
+* Function Name: http_submit_arp_settings
+*******************************************************************************
+* Summary:
+*   This function changes the settings of the ARP offload from the form of
+*   the home page: "snoop" and "peer_reply" (0 or 1) and "peerage" (seconds).
+*   The missing fields are left unchanged. The settings are applied to the
+*   WLAN device by the next commit.
+*
+* Parameters:
+*   http_data: Pointer to HTTP data.
+*
+* Return:
+*   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the form data
+*     or a setting is invalid.
+*
+******************************************************************************/
+cy_rslt_t http_submit_arp_settings(cy_http_message_body_t *http_data)
+{
+    char body[HTTP_BODY_MAX_LEN];
+    char value[HTTP_QUERY_STR_VALUE_LEN] = {0};
+    bool snoop = arp_offload_get_snoop();
+    bool peer_auto_reply = arp_offload_get_peer_auto_reply();
+    uint32_t peerage = arp_ol_cfg.peerage;
+    char *end = NULL;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if ((NULL == http_data) || (NULL == http_data->data) ||
+        (http_data->data_length >= sizeof(body)))
+    {
+        ERR_INFO(("Invalid HTTP data\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+    memcpy(body, http_data->data, http_data->data_length);
+    body[http_data->data_length] = '\0';
+
+    if (http_query_param(body, "snoop", value, sizeof(value)))
+    {
+        snoop = ('0' != value[0]);
+    }
+    if (http_query_param(body, "peer_reply", value, sizeof(value)))
+    {
+        peer_auto_reply = ('0' != value[0]);
+    }
+    if (http_query_param(body, "peerage", value, sizeof(value)))
+    {
+        peerage = strtoul(value, &end, 10);
+        if (('\0' == value[0]) || ('\0' != *end))
+        {
+            peerage = ARP_OFFLOAD_PEERAGE_MAX_S + 1;
+        }
+    }
+
+    result = arp_offload_configure(snoop, peer_auto_reply, peerage);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Invalid ARP offload settings\n"));
+    }
 
     return result;
 }
@@ -694,21 +1437,72 @@ void app_http_server_init(WhdSTAInterface *wifi)
     nw_interface.type   = CY_NW_INF_TYPE_WIFI;
 
     /* Initialize HTTP server object. */
-    server = new HTTPServer(&nw_interface, HTTP_PORT, MAX_SOCKETS);
+    server = new (server_storage) HTTPServer(&nw_interface, HTTP_PORT, MAX_SOCKETS);
 
     /* Register HTTP page resources. */
+    http_stats_wrap("/", &test_data);
     result = server->register_resource((uint8_t*)"/",
                                        (uint8_t*)"text/html",
                                        CY_DYNAMIC_URL_CONTENT,
                                        &test_data);
     PRINT_AND_ASSERT(result, "Registering HTTP page resource '/' failed.\n");
 
+    http_stats_wrap("/configure_filter", &http_configure_filter_url);
     result = server->register_resource((uint8_t*)"/configure_filter",
                                        (uint8_t*)"text/html",
                                        CY_DYNAMIC_URL_CONTENT,
                                        &http_configure_filter_url);
     PRINT_AND_ASSERT(result, "Registering HTTP page resource '/configure_filter' failed.\n");
 
+    http_stats_wrap("/wake_latency", &http_wake_latency_url);
+    result = server->register_resource((uint8_t*)"/wake_latency",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_wake_latency_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/wake_latency' failed.\n");
+
+    http_stats_wrap("/tier", &http_tier_url);
+    result = server->register_resource((uint8_t*)"/tier",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_tier_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/tier' failed.\n");
+
+    http_stats_wrap("/join_timing", &http_join_timing_url);
+    result = server->register_resource((uint8_t*)"/join_timing",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_join_timing_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/join_timing' failed.\n");
+
+    http_stats_wrap("/commit_status", &http_commit_status_url);
+    result = server->register_resource((uint8_t*)"/commit_status",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_commit_status_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/commit_status' failed.\n");
+
+    http_stats_wrap("/http_stats", &http_stats_url);
+    result = server->register_resource((uint8_t*)"/http_stats",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_stats_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/http_stats' failed.\n");
+
+    http_stats_wrap("/arp", &http_arp_offload_url);
+    result = server->register_resource((uint8_t*)"/arp",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_arp_offload_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/arp' failed.\n");
+
+    http_stats_wrap("/events", &http_event_stats_url);
+    result = server->register_resource((uint8_t*)"/events",
+                                       (uint8_t*)"text/plain",
+                                       CY_DYNAMIC_URL_CONTENT,
+                                       &http_event_stats_url);
+    PRINT_AND_ASSERT(result, "Registering HTTP page resource '/events' failed.\n");
+
     /* Start HTTP server */
     result = server->start();
     PRINT_AND_ASSERT(result, "Failed to start HTTP server.\n");
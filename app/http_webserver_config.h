@@ -44,25 +44,25 @@
 #include "HTTP_server.hpp"
 #include "WhdSTAInterface.h"
 #include "network_activity_handler.h"
+#include "app_log.h"
+#include "http_query.h"
 
 /******************************************************************************
  *                               MACROS
  *****************************************************************************/
 #define HTTP_RESP_STR_BUFFER_LEN   (2048)
 #define HTTP_BUILD_STR_LEN         (400)
-#define HTTP_QUERY_STR_VALUE_LEN   (50)
 #define HTTP_PORT                  (80u)
+#define PF_REMOVE_QUERY_PREFIX     "remove_id_"
 #define MAX_SOCKETS                (2u)
 
-#define APP_INFO(x)                do { printf("Info: "); printf x; } while(0);
-#define ERR_INFO(x)                do { printf("Error: "); printf x; } while(0);
-
 #define PRINT_AND_ASSERT(result, msg, args...)   \
                                    do                                 \
                                    {                                  \
                                        if (CY_RSLT_SUCCESS != result) \
                                        {                              \
                                            ERR_INFO((msg, ## args));  \
+                                           app_log_flush();           \
                                            MBED_ASSERT(0);            \
                                        }                              \
                                    } while(0);
@@ -80,14 +80,50 @@ int32_t http_configure_filter(const char* url_path,
                               cy_http_response_stream_t* stream,
                               void* arg,
                               cy_http_message_body_t* http_data);
+int32_t http_wake_latency(const char* url_path,
+                          const char* url_query_string,
+                          cy_http_response_stream_t* stream,
+                          void* arg,
+                          cy_http_message_body_t* http_data);
+int32_t http_tier_report(const char* url_path,
+                         const char* url_query_string,
+                         cy_http_response_stream_t* stream,
+                         void* arg,
+                         cy_http_message_body_t* http_data);
+int32_t http_join_timing(const char* url_path,
+                         const char* url_query_string,
+                         cy_http_response_stream_t* stream,
+                         void* arg,
+                         cy_http_message_body_t* http_data);
+int32_t http_commit_status(const char* url_path,
+                           const char* url_query_string,
+                           cy_http_response_stream_t* stream,
+                           void* arg,
+                           cy_http_message_body_t* http_data);
+int32_t http_handler_stats(const char* url_path,
+                           const char* url_query_string,
+                           cy_http_response_stream_t* stream,
+                           void* arg,
+                           cy_http_message_body_t* http_data);
+int32_t http_arp_offload(const char* url_path,
+                         const char* url_query_string,
+                         cy_http_response_stream_t* stream,
+                         void* arg,
+                         cy_http_message_body_t* http_data);
+int32_t http_event_stats(const char* url_path,
+                         const char* url_query_string,
+                         cy_http_response_stream_t* stream,
+                         void* arg,
+                         cy_http_message_body_t* http_data);
 cy_rslt_t app_wl_connect(WhdSTAInterface *wifi,
                          const char *ssid,
                          const char *pwd,
                          nsapi_security_t security);
 cy_rslt_t http_submit_filter(cy_http_message_body_t* http_data);
+cy_rslt_t http_submit_tier_rule(cy_http_message_body_t* http_data);
+cy_rslt_t http_submit_arp_settings(cy_http_message_body_t* http_data);
 void app_wl_disconnect(WhdSTAInterface *wifi);
 void app_http_server_init(WhdSTAInterface *wifi);
-int8_t *get_entry_id(void);
 
 #endif /* #ifndef HTTP_WEBSERVER_CONFIG_H */
 
@@ -45,8 +45,23 @@
  * indemnify Cypress against all liability.
  *****************************************************************************/
 
+#include <new>
 #include "mbed.h"
 #include "http_webserver_config.h"
+#include "emac_rx_hook.h"
+#include "wake_latency.h"
+#include "pf_tier_manager.h"
+#include "storm_detector.h"
+#include "fast_join.h"
+#include "pf_commit_worker.h"
+#include "pf_store.h"
+#include "qspi_xip.h"
+#include "pf_profiles.h"
+#include "http_bench.h"
+#include "ram_report.h"
+#include "arp_offload.h"
+#include "tko_offload.h"
+#include "app_events.h"
 
 /******************************************************************************
  *                           MACROS
@@ -66,14 +81,26 @@
  */
 #define NETWORK_INACTIVE_WINDOW_MS     (250)
 
+/* Stack size in bytes of the thread suspending the network stack. Tune it
+ * with the RAM report, see ram_report.h.
+ */
+#ifndef MBED_CONF_APP_SLEEP_THREAD_STACK_SIZE
+#define MBED_CONF_APP_SLEEP_THREAD_STACK_SIZE  (OS_STACK_SIZE)
+#endif
+
 /******************************************************************************
  *                       GLOBAL VARIABLES
  *****************************************************************************/
 /* Wi-Fi (STA) object handle.*/
 WhdSTAInterface *wifi;
 
+/* Static storage of the Wi-Fi (STA) object. It is constructed once in main()
+ * and never destroyed.
+ */
+alignas(FastJoinSTAInterface) static uint8_t wifi_storage[sizeof(FastJoinSTAInterface)];
+
 /* Thread handle to suspend/resume the host network stack. */
-Thread T1;
+Thread T1(osPriorityNormal, MBED_CONF_APP_SLEEP_THREAD_STACK_SIZE, nullptr, "sleep");
 
 /******************************************************************************
  *                     FUNCTION DEFINITIONS
@@ -215,6 +242,14 @@ cy_rslt_t app_wl_connect(WhdSTAInterface *wifi, const char *ssid,
         APP_INFO(("RSSI\t : %d\n\n", wifi->get_rssi()));
         wifi->get_ip_address(&sock_addr);
         APP_INFO(("IP Addr\t : %s\n\n", sock_addr.get_ip_address()));
+
+        /* The network stack installs its receive callback on every
+         * connect. Hook the receive path again.
+         */
+        emac_rx_hook_attach(wifi);
+
+        /* The IP address may change with each DHCP lease. */
+        arp_offload_set_host_ip(wifi);
     }
     else
     {
@@ -225,6 +260,35 @@ cy_rslt_t app_wl_connect(WhdSTAInterface *wifi, const char *ssid,
     return ret;
 }
 
+/******************************************************************************
+* Function Name: host_wake_event
+*******************************************************************************
+* Summary:
+*   This function is the event posted after each host wake. It runs the work
+*   done while the host is awake anyway, after the events queued before it.
+*
+* Parameters:
+*   void
+*
+* Return:
+*   void
+*
+******************************************************************************/
+static void host_wake_event(void)
+{
+    /* Report the wake latency while the host is awake. */
+    wake_latency_poll();
+
+    /* Rebalance the tiered packet filters while the host is awake. */
+    pf_tier_poll();
+
+    /* Filter or restore after a broadcast/multicast storm. */
+    storm_detector_poll();
+
+    /* Report the stack and heap use while the host is awake. */
+    ram_report_poll();
+}
+
 /******************************************************************************
 * Function Name: host_sleep_action_thread
 *******************************************************************************
@@ -232,7 +296,8 @@ cy_rslt_t app_wl_connect(WhdSTAInterface *wifi, const char *ssid,
 *   This function is responsible for suspending the host network stack. The
 *   network stack resumes when any TX or RX activity detected in the Wi-Fi
 *   driver interface. Suspending the network stack will cause the host MCU to
-*   enter the deep sleep power mode.
+*   enter the deep sleep power mode. The thread only blocks in
+*   wait_net_suspend(); the work of each wake runs from the event queue.
 *
 * Parameters:
 *   void
@@ -245,6 +310,9 @@ void host_sleep_action_thread(void)
 {
     do
     {
+        /* Hand the connection to the collector over to the WLAN device. */
+        tko_offload_suspend(wifi);
+
         /* Configures an emac activity callback to the Wi-Fi interface
          * and suspends the network stack if the network is inactive for
          * a duration of INACTIVE_WINDOW_MS inside an interval of
@@ -256,6 +324,12 @@ void host_sleep_action_thread(void)
                          osWaitForever,
                          NETWORK_INACTIVE_INTERVAL_MS,
                          NETWORK_INACTIVE_WINDOW_MS);
+
+        /* Account the sleep with or without the offloaded connection. */
+        tko_offload_resume();
+
+        /* Hand the work of the wake over to the event queue. */
+        app_events_post(APP_EVENT_WAKE, host_wake_event);
     } while(1);
 }
 
@@ -274,15 +348,46 @@ int main(void)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
+    /* Start the time base of the event statistics. */
+    app_events_init();
+
     /* \x1b[2J\x1b[;H - ANSI ESC sequence to clear screen */
     APP_INFO(("\x1b[2J\x1b[;H"));
     APP_INFO(("=======================================\n"));
     APP_INFO(("PSoC 6 MCU: Packet Filter Offload Demo\n"));
     APP_INFO(("=======================================\n\n"));
 
+    /* Map the external flash holding the packet filter profiles and the
+     * large web pages before anything reads them.
+     */
+    result = qspi_xip_init();
+    PRINT_AND_ASSERT(result, "Failed to map the external QSPI flash.\n");
+    result = pf_profiles_init();
+    PRINT_AND_ASSERT(result, "Program the external QSPI flash along with "
+                     "the application.\n");
+
+    /* Start timestamping the WLAN host wakes. */
+    wake_latency_init();
+
     /* Initializes OLM with packet filter(s) configured
-     * via device configurator. */
-    wifi = new WhdSTAInterface();
+     * via device configurator. The interface reassociates to the last
+     * AP with a directed join after each packet filter commit.
+     */
+    wifi = new (wifi_storage) FastJoinSTAInterface();
+
+    /* Publish the packet filter lists to the threads rendering them. */
+    pf_publish_lists();
+
+    /* Measure the home page render cost while the active packet filter list
+     * can still be replaced without a reassociation.
+     */
+    result = http_bench_run();
+    PRINT_AND_ASSERT(result, "Page render benchmark failed.\n");
+
+    /* Apply the packet filter list committed before the reboot, if any,
+     * so that the first association offloads it.
+     */
+    pf_store_apply();
 
     /* Connect to the configured WiFi AP */
     result = app_wl_connect(wifi, MBED_CONF_APP_WIFI_SSID,
@@ -294,12 +399,25 @@ int main(void)
     /* Initializes and starts HTTP Web Server */
     app_http_server_init(static_cast<WhdSTAInterface*>(wifi));
 
+    /* Start the worker running the packet filter commits requested from
+     * the web page, so that the web server does not block on them.
+     */
+    pf_commit_worker_start();
+
+    /* The boot is over: the application allocates no more heap from here
+     * on. The RAM report flags any growth of the heap past this point.
+     */
+    ram_report_mark_steady();
+
     /* Start application thread.
      * Keep the Host MCU in low power mode by suspending the network
      * stack and resume only when there is any Tx/Rx activity detected.
      */
     T1.start(host_sleep_action_thread);
 
+    /* Run the commits, the work of each wake and the logs on this thread. */
+    app_events_dispatch();
+
     return 0;
 }
 
@@ -0,0 +1,557 @@
+/******************************************************************************
+ * File Name: pf_commit_worker.cpp
+ *
+ * Description:
+ *   This file contains the asynchronous packet filter commit worker. A commit
+ *   disconnects from the AP, restarts OLM and reassociates, which takes
+ *   seconds. The web server queues the commit requests here and returns
+ *   right away; the commit runs on the commit thread, so that the events of
+ *   the application event queue keep running meanwhile, and reports its
+ *   state, which the web page polls once the kit is reconnected. The
+ *   requests arriving before the commit disconnects are served by one
+ *   commit; those arriving later by the next one. The modules building a
+ *   list of their own, such as the tiered filter manager, queue it here too
+ *   and learn the result through a callback.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "pf_commit_worker.h"
+#include "pf_olm_config.h"
+#include "fast_join.h"
+#include "pf_store.h"
+#include "http_webserver_config.h"
+#include "app_events.h"
+
+/******************************************************************************
+ *                              EXTERNS
+ *****************************************************************************/
+extern WhdSTAInterface *wifi;
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* The commit event is queued at most once. */
+#define COMMIT_QUEUE_SIZE          (EVENTS_EVENT_SIZE)
+
+/******************************************************************************
+ *                           FUNCTION PROTOTYPES
+ *****************************************************************************/
+static void commit_event(void);
+static pf_commit_done_t commit_take_request(void);
+static bool commit_queue_request(void);
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Queue of the commit thread, which only runs the commit event. */
+static EventQueue commit_queue(COMMIT_QUEUE_SIZE);
+static Thread commit_thread(osPriorityBelowNormal, MBED_CONF_APP_COMMIT_THREAD_STACK_SIZE,
+                            nullptr, "commit");
+
+/* Serializes the access to the request and the counters. */
+static Mutex request_mutex;
+
+/* Request waiting for the commit event and whether it restores the
+ * defaults. A request arriving during a commit waits for the next one.
+ */
+static bool request_pending = false;
+static bool request_restore = false;
+
+/* List of a request of another module, committed without touching the
+ * pending list, and its completion callback. Unset for the requests of the
+ * web page.
+ */
+static bool request_direct = false;
+static cy_pf_ol_cfg_t request_cfgs[MAX_FILTERS];
+static pf_ipv6_attrs_t request_ipv6;
+static uint8_t request_cfg_count = 0;
+static pf_commit_done_t request_done = nullptr;
+
+/* Copy of the direct list taken by the commit event, used by the commit
+ * thread only.
+ */
+static cy_pf_ol_cfg_t direct_cfgs[MAX_FILTERS];
+static pf_ipv6_attrs_t direct_ipv6;
+
+/* Set while the commit event is queued and has not taken the request. */
+static bool event_queued = false;
+
+/* List committed last by a request of the web page, or whether it restored
+ * the defaults, handed over to the store event under the store mutex. The
+ * commit thread takes the list from pf_commit_list() into commit_cfgs.
+ */
+static Mutex store_mutex;
+static bool store_restore = false;
+static cy_pf_ol_cfg_t store_cfgs[MAX_FILTERS];
+static pf_ipv6_attrs_t store_ipv6;
+static cy_pf_ol_cfg_t commit_cfgs[MAX_FILTERS];
+static pf_ipv6_attrs_t commit_ipv6;
+
+/* Copy of the list taken by the store event, kept off the stack. */
+static cy_pf_ol_cfg_t saved_cfgs[MAX_FILTERS];
+static pf_ipv6_attrs_t saved_ipv6;
+
+/* State of the commit running or run last. A request waiting for the next
+ * commit is kept in request_pending, not in the state.
+ */
+static volatile pf_commit_state_t commit_state = PF_COMMIT_IDLE;
+
+/* Requests received, commits run, and requests coalesced in a commit. */
+static uint32_t request_count = 0;
+static uint32_t run_count = 0;
+static uint32_t coalesced_count = 0;
+
+/* Names of the commit states in the status report. */
+static const char *commit_state_names[] = {
+    "idle", "queued", "disconnecting", "restarting_olm",
+    "reassociating", "dhcp", "done", "failed"
+};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: pf_commit_set_state
+ ******************************************************************************
+ * Summary:
+ *   This function updates the state of the commit in progress. It is called
+ *   by pf_commit_list() at each step of a commit, whether queued here or run
+ *   directly by another module.
+ *
+ * Parameters:
+ *   state: New state.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_commit_set_state(pf_commit_state_t state)
+{
+    commit_state = state;
+}
+
+/******************************************************************************
+ * Function Name: pf_commit_get_state
+ ******************************************************************************
+ * Summary:
+ *   This function returns the state of the commits. A commit in progress
+ *   reports its own state; otherwise a request waiting for the commit
+ *   thread is reported as queued, and else the result of the last commit.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   pf_commit_state_t: State of the commits.
+ *
+ *****************************************************************************/
+pf_commit_state_t pf_commit_get_state(void)
+{
+    pf_commit_state_t state = commit_state;
+
+    if (((PF_COMMIT_IDLE == state) || (PF_COMMIT_DONE == state) || (PF_COMMIT_FAILED == state)) &&
+        request_pending)
+    {
+        return PF_COMMIT_QUEUED;
+    }
+
+    return state;
+}
+
+/******************************************************************************
+ * Function Name: commit_join_phase
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the Wi-Fi interface when a connect reaches a
+ *   new phase. It moves a commit from reassociation to DHCP.
+ *
+ * Parameters:
+ *   phase: Phase reached.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void commit_join_phase(join_phase_t phase)
+{
+    if ((JOIN_PHASE_DHCP == phase) && (PF_COMMIT_REASSOCIATING == commit_state))
+    {
+        commit_state = PF_COMMIT_DHCP;
+    }
+}
+
+/******************************************************************************
+ * Function Name: commit_take_request
+ ******************************************************************************
+ * Summary:
+ *   This function makes room for a new request, called with the request
+ *   mutex held. A request still waiting for the worker is coalesced with the
+ *   new one.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   pf_commit_done_t: Callback of the replaced request of another module,
+ *     to be called once the mutex is released, or nullptr.
+ *
+ *****************************************************************************/
+static pf_commit_done_t commit_take_request(void)
+{
+    pf_commit_done_t replaced = nullptr;
+
+    if (request_pending)
+    {
+        coalesced_count++;
+        if (request_direct)
+        {
+            replaced = request_done;
+        }
+    }
+    request_done = nullptr;
+    request_pending = true;
+    request_count++;
+
+    return replaced;
+}
+
+/******************************************************************************
+ * Function Name: commit_queue_request
+ ******************************************************************************
+ * Summary:
+ *   This function queues the commit event for the request just taken,
+ *   called with the request mutex held. It lets the web server respond and
+ *   further requests arrive. A request arriving before the commit event
+ *   runs is coalesced with it; one arriving during a commit queues the
+ *   event again, to run after it.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: Returns false if the request is dropped for lack of room in the
+ *     queue.
+ *
+ *****************************************************************************/
+static bool commit_queue_request(void)
+{
+    if (!event_queued)
+    {
+        event_queued = (0 != commit_queue.call_in(std::chrono::milliseconds(MBED_CONF_APP_COMMIT_DELAY_MS),
+                                                  commit_event));
+        if (!event_queued)
+        {
+            request_pending = false;
+            request_done = nullptr;
+            commit_state = PF_COMMIT_FAILED;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: pf_commit_request
+ ******************************************************************************
+ * Summary:
+ *   This function queues a commit of the pending list, or a restore of the
+ *   default list, and returns without waiting. A request arriving while
+ *   another one waits for the worker is coalesced with it; the last request
+ *   decides whether the defaults are restored. The state of a commit in
+ *   progress is left unchanged.
+ *
+ * Parameters:
+ *   restore_to_default: True to restore the default packet filter list.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_commit_request(bool restore_to_default)
+{
+    pf_commit_done_t replaced = nullptr;
+
+    request_mutex.lock();
+    replaced = commit_take_request();
+    request_restore = restore_to_default;
+    request_direct = false;
+    commit_queue_request();
+    request_mutex.unlock();
+
+    if (replaced)
+    {
+        replaced(CY_RSLT_TYPE_ERROR, 0);
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_commit_request_cfgs
+ ******************************************************************************
+ * Summary:
+ *   This function queues a commit of a packet filter list built by another
+ *   module, or a restore of the default list, and returns without waiting.
+ *   The list is copied and committed without touching the pending list. As
+ *   for pf_commit_request(), the last request waiting for the worker is the
+ *   one committed; the callback of a replaced request is called with an
+ *   error.
+ *
+ * Parameters:
+ *   cfgs: Array of packet filter configurations, NULL to restore the
+ *     default packet filter list.
+ *   ipv6: IPv6 attributes of the filters by their ID, NULL if none.
+ *   count: Number of packet filter configurations in the array.
+ *   done: Callback called on the commit thread with the result, or nullptr.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_commit_request_cfgs(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                            uint8_t count, pf_commit_done_t done)
+{
+    pf_commit_done_t replaced = nullptr;
+    bool queued = false;
+
+    if ((NULL != cfgs) && (count > get_max_filter()))
+    {
+        ERR_INFO(("Max number of filters %d.\n", get_max_filter()));
+        if (done)
+        {
+            done(CY_RSLT_TYPE_ERROR, 0);
+        }
+        return;
+    }
+
+    request_mutex.lock();
+    replaced = commit_take_request();
+    request_restore = (NULL == cfgs);
+    request_direct = true;
+    if (NULL != cfgs)
+    {
+        memcpy(request_cfgs, cfgs, count * sizeof(cy_pf_ol_cfg_t));
+    }
+    memset(&request_ipv6, 0, sizeof(request_ipv6));
+    if (NULL != ipv6)
+    {
+        request_ipv6 = *ipv6;
+    }
+    request_cfg_count = count;
+    request_done = done;
+    queued = commit_queue_request();
+    request_mutex.unlock();
+
+    if (replaced)
+    {
+        replaced(CY_RSLT_TYPE_ERROR, 0);
+    }
+    if (!queued && done)
+    {
+        done(CY_RSLT_TYPE_ERROR, 0);
+    }
+}
+
+/******************************************************************************
+ * Function Name: commit_store_event
+ ******************************************************************************
+ * Summary:
+ *   This function is the event storing the list committed by the commit
+ *   event for the next boot, or erasing the stored list after a restore of
+ *   the defaults. The lists committed by the other modules are not stored.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void commit_store_event(void)
+{
+    bool restore = false;
+
+    /* A commit ending meanwhile replaces the list as a whole. */
+    store_mutex.lock();
+    restore = store_restore;
+    memcpy(saved_cfgs, store_cfgs, sizeof(saved_cfgs));
+    saved_ipv6 = store_ipv6;
+    store_mutex.unlock();
+
+    if (restore)
+    {
+        /* Boot with the default list again. */
+        pf_store_erase();
+    }
+    else
+    {
+        /* Boot with the list the user committed. */
+        pf_store_save(saved_cfgs, &saved_ipv6);
+    }
+}
+
+/******************************************************************************
+ * Function Name: commit_event
+ ******************************************************************************
+ * Summary:
+ *   This function is the event of the commit thread running the queued
+ *   commit. It takes the request and commits. A list of another module is
+ *   handed back through its callback. A commit of the web page queues the
+ *   storage of the committed list as an event of the application event
+ *   queue, so that the events queued meanwhile run before the flash write.
+ *   A request arriving after the request is taken queues the event again.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void commit_event(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    bool restore_to_default = false;
+    bool direct = false;
+    uint8_t count = 0;
+    pf_commit_done_t done = nullptr;
+    uint32_t before = 0;
+
+    request_mutex.lock();
+    event_queued = false;
+    if (!request_pending)
+    {
+        request_mutex.unlock();
+        return;
+    }
+    request_pending = false;
+    restore_to_default = request_restore;
+    direct = request_direct;
+    if (direct)
+    {
+        count = request_cfg_count;
+        memcpy(direct_cfgs, request_cfgs, count * sizeof(cy_pf_ol_cfg_t));
+        direct_ipv6 = request_ipv6;
+        done = request_done;
+        request_done = nullptr;
+    }
+    run_count++;
+    request_mutex.unlock();
+
+    /* The lists of the other modules are not stored for the next boot. */
+    if (direct)
+    {
+        before = pf_get_commit_count();
+        result = pf_commit_cfgs(restore_to_default ? NULL : direct_cfgs, &direct_ipv6, count);
+        if (done)
+        {
+            done(result, (pf_get_commit_count() == (before + 1)) ? (before + 1) : 0);
+        }
+        return;
+    }
+
+    result = pf_commit_list(restore_to_default, commit_cfgs, &commit_ipv6);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Queued packet filter commit failed\n"));
+    }
+    else
+    {
+        store_mutex.lock();
+        memcpy(store_cfgs, commit_cfgs, sizeof(store_cfgs));
+        store_ipv6 = commit_ipv6;
+        store_restore = restore_to_default;
+        store_mutex.unlock();
+        app_events_post(APP_EVENT_COMMIT_STORE, commit_store_event);
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_commit_worker_start
+ ******************************************************************************
+ * Summary:
+ *   This function starts the commit thread and follows the phases of the
+ *   connects, to report the commit states.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_commit_worker_start(void)
+{
+    commit_thread.start(mbed::callback(&commit_queue, &EventQueue::dispatch_forever));
+    static_cast<FastJoinSTAInterface *>(wifi)->set_phase_callback(mbed::callback(commit_join_phase));
+}
+
+/******************************************************************************
+ * Function Name: pf_commit_status_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the commit status as text. The first word is the
+ *   state, for the web page to poll.
+ *
+ * Parameters:
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int pf_commit_status_report(char *buf, size_t buf_len)
+{
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    request_mutex.lock();
+    len = snprintf(buf, buf_len, "%s\nNext commit queued: %s\nRequests: %lu\nCommits: %lu\nCoalesced: %lu\n",
+                   commit_state_names[pf_commit_get_state()],
+                   request_pending ? "yes" : "no",
+                   (unsigned long)request_count,
+                   (unsigned long)run_count,
+                   (unsigned long)coalesced_count);
+    request_mutex.unlock();
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * File Name: pf_commit_worker.h
+ *
+ * Description:
+ *   This header file contains the types and function declarations of the
+ *   asynchronous packet filter commit worker.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_COMMIT_WORKER_H
+#define PF_COMMIT_WORKER_H
+
+#include <stddef.h>
+#include "mbed.h"
+#include "cy_result.h"
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/*
+ * Delay in milliseconds between a commit request and the disconnect. It lets
+ * the web server send its response and coalesces the requests arriving in
+ * the meantime.
+ */
+#ifndef MBED_CONF_APP_COMMIT_DELAY_MS
+#define MBED_CONF_APP_COMMIT_DELAY_MS      (500)
+#endif
+
+/* Stack size in bytes of the thread running the commits. */
+#ifndef MBED_CONF_APP_COMMIT_THREAD_STACK_SIZE
+#define MBED_CONF_APP_COMMIT_THREAD_STACK_SIZE  (OS_STACK_SIZE)
+#endif
+
+/* Buffer length required to report the commit status as text. */
+#define PF_COMMIT_STATUS_LEN               (128)
+
+/******************************************************************************
+ *                                 ENUMS
+ *****************************************************************************/
+/* States of a packet filter commit. */
+typedef enum
+{
+    PF_COMMIT_IDLE = 0,         /* No commit requested since boot          */
+    PF_COMMIT_QUEUED,           /* Waiting for the commit thread           */
+    PF_COMMIT_DISCONNECTING,    /* Disconnecting from the AP               */
+    PF_COMMIT_RESTARTING_OLM,   /* Restarting OLM with the new list        */
+    PF_COMMIT_REASSOCIATING,    /* Joining the AP                          */
+    PF_COMMIT_DHCP,             /* Obtaining the IP address                */
+    PF_COMMIT_DONE,             /* Last commit succeeded                   */
+    PF_COMMIT_FAILED            /* Last commit failed                      */
+} pf_commit_state_t;
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/*
+ * Called on the commit thread once a list queued by pf_commit_request_cfgs()
+ * is committed, with the result and the commit count it produced. The count
+ * is 0 if the list was not committed, for example when a later request
+ * replaced it before the commit; the list is committed even if the
+ * reassociation failed.
+ */
+typedef mbed::Callback<void(cy_rslt_t result, uint32_t commit)> pf_commit_done_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void pf_commit_worker_start(void);
+void pf_commit_request(bool restore_to_default);
+void pf_commit_request_cfgs(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                            uint8_t count, pf_commit_done_t done);
+void pf_commit_set_state(pf_commit_state_t state);
+pf_commit_state_t pf_commit_get_state(void);
+int pf_commit_status_report(char *buf, size_t buf_len);
+
+#endif /* #ifndef PF_COMMIT_WORKER_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * File Name: pf_default_list.cpp
+ *
+ * Description:
+ *   This file defines the default packet filter list of the Offload Manager,
+ *   shared by all the supported kits. The list comes from the policy file
+ *   through pf_policy.h; it is checked at compile time and placed in flash.
+ *   It replaces the list generated by the Device Configurator for each kit.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "cy_lpa_wifi_ol.h"
+#include "cy_lpa_wifi_ol_common.h"
+#include "cy_lpa_wifi_pf_ol.h"
+#include "pf_dsl.h"
+#include "pf_policy.h"
+#include "pf_ipv6.h"
+#include "arp_offload.h"
+#include "tko_offload.h"
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/*
+ * Default packet filter list of policy/wlan_policy.json: the minimal set of
+ * keep filters of a network application (ARP, 802.1X, DHCP client and DNS
+ * responses) and the port of the web server of this example. The filter IDs
+ * follow the order of the list.
+ */
+static constexpr pf_dsl::filter default_filters[] =
+{
+    PF_POLICY_DEFAULT_FILTERS
+};
+PF_DSL_STATIC_ASSERT_VALID(default_filters);
+/* The LPA reads the default list as it is, without the IPv6 attributes of
+ * its filters, so it must not hold IPv6 filters.
+ */
+static_assert(!pf_dsl::has_ipv6(default_filters),
+              "default_filters: IPv6 packet filters in the default list");
+
+static constexpr pf_dsl::cfg_list<pf_dsl::count(default_filters)> default_list =
+    pf_dsl::build(default_filters);
+
+/* Context of the packet filter offload. */
+static pf_ol_t pf_ol_0;
+
+/* Context of the IPv6 offload. */
+static pf_ipv6_ol_t pf_ipv6_0;
+
+#if MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+/* Context of the ARP offload. */
+static arp_ol_t arp_ol_0;
+#endif
+
+#if MBED_CONF_APP_TKO_ENABLE
+/* Context of the TCP keep-alive offload. */
+static tko_ol_t tko_ol_0;
+#endif
+
+/* Offload list of the Offload Manager, terminated with a NULL entry. */
+static const ol_desc_t ol_list_0[] =
+{
+    { "Pkt_Filter", (void *)&default_list.cfg[0], &pf_ol_fns, &pf_ol_0 },
+    { "PF_IPv6", NULL, &pf_ipv6_ol_fns, &pf_ipv6_0 },
+#if MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+    { "ARP", (void *)&arp_ol_cfg, &arp_ol_fns, &arp_ol_0 },
+#endif
+#if MBED_CONF_APP_TKO_ENABLE
+    { "TKO", (void *)&tko_ol_cfg, &tko_ol_fns, &tko_ol_0 },
+#endif
+    { NULL, NULL, NULL, NULL },
+};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: cycfg_get_default_ol_list
+ ******************************************************************************
+ * Summary:
+ *   This function returns the default offload list. The Offload Manager
+ *   calls it through get_default_ol_list() when the Wi-Fi interface is
+ *   created and when the default packet filters are restored.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   const ol_desc_t *: Default offload list.
+ *
+ *****************************************************************************/
+extern "C" const ol_desc_t *cycfg_get_default_ol_list(void)
+{
+    return &ol_list_0[0];
+}
+
+
+/* [] END OF FILE */
+
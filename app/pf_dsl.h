@@ -0,0 +1,328 @@
+/******************************************************************************
+ * File Name: pf_dsl.h
+ *
+ * Description:
+ *   This header file contains a small constexpr language describing a packet
+ *   filter list. A list written with it is checked at compile time against
+ *   the rules of the WLAN firmware and expanded into a constant array of
+ *   cy_pf_ol_cfg_t, terminated with CY_PF_OL_FEAT_LAST, placed in flash.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_DSL_H
+#define PF_DSL_H
+
+#include <stddef.h>
+#include <utility>
+#include "cy_lpa_wifi_pf_ol.h"
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/*
+ * Checks a list written with the pf_dsl functions. Each rule of the WLAN
+ * firmware fails the build with its own message.
+ */
+#define PF_DSL_STATIC_ASSERT_VALID(list)                                       \
+    static_assert(pf_dsl::count(list) <= (MAX_FILTERS - 1),                    \
+                  #list ": too many packet filters");                          \
+    static_assert(!pf_dsl::has_duplicates(list),                               \
+                  #list ": duplicate packet filters");                         \
+    static_assert(!pf_dsl::mixes_actions(list),                                \
+                  #list ": keep and discard packet filters are mixed");        \
+    static_assert(pf_dsl::discard_count(list) <= 1,                            \
+                  #list ": more than one discard packet filter");              \
+    static_assert(!pf_dsl::has_inactive(list),                                 \
+                  #list ": packet filter never active");                       \
+    static_assert(!pf_dsl::overlaps_ipv6(list),                                \
+                  #list ": IPv6 packet filters next to Ether type 0x86dd")
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+namespace pf_dsl
+{
+
+/* Types of the fields of cy_pf_ol_cfg_t. */
+typedef decltype(((cy_pf_ol_cfg_t *)nullptr)->feature) feature_t;
+typedef decltype(((cy_pf_ol_cfg_t *)nullptr)->u.pf.proto) proto_t;
+typedef decltype(((cy_pf_ol_cfg_t *)nullptr)->u.pf.portnum.direction) direction_t;
+
+/* One packet filter as written in the list. */
+struct filter
+{
+    feature_t feature;      /* Port, EtherType or IP type filter         */
+    bool discard;           /* Discard rather than keep the packets      */
+    proto_t proto;          /* Port filter: TCP or UDP                   */
+    direction_t direction;  /* Port filter: source or destination port   */
+    uint16_t value;         /* Port number, EtherType or IP protocol     */
+    uint32_t active;        /* CY_PF_ACTIVE_SLEEP and/or CY_PF_ACTIVE_WAKE */
+    pf_ipv6_attr_t ipv6;    /* IP type filter: IPv6 attributes, if any    */
+};
+
+/* Expanded list: the filters followed by the CY_PF_OL_FEAT_LAST entry, and
+ * the IPv6 attributes of the filters by their ID.
+ */
+template <size_t N>
+struct cfg_list
+{
+    cy_pf_ol_cfg_t cfg[N + 1];
+    pf_ipv6_attrs_t ipv6;
+};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Filters keeping the packets of a port, an EtherType or an IP protocol,
+ * active both when the host sleeps and when it is awake.
+ */
+constexpr filter keep_port(proto_t proto, direction_t direction, uint16_t port)
+{
+    return filter{ CY_PF_OL_FEAT_PORTNUM, false, proto, direction, port,
+                   CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE, pf_ipv6_attr_t{ 0u, 0u } };
+}
+
+constexpr filter keep_ethtype(uint16_t eth_type)
+{
+    return filter{ CY_PF_OL_FEAT_ETHTYPE, false, proto_t(), direction_t(), eth_type,
+                   CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE, pf_ipv6_attr_t{ 0u, 0u } };
+}
+
+constexpr filter keep_iptype(uint8_t ip_type)
+{
+    return filter{ CY_PF_OL_FEAT_IPTYPE, false, proto_t(), direction_t(), ip_type,
+                   CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE, pf_ipv6_attr_t{ 0u, 0u } };
+}
+
+/* Filters keeping the IPv6 packets of a next header, or the ICMPv6 packets
+ * of one type. They are added to the WLAN device by the IPv6 offload.
+ */
+constexpr filter keep_ip6_next_header(uint8_t next_header)
+{
+    return filter{ CY_PF_OL_FEAT_IPTYPE, false, proto_t(), direction_t(), next_header,
+                   CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE,
+                   pf_ipv6_attr_t{ PF_IPV6_NEXT_HEADER, 0u } };
+}
+
+constexpr filter keep_icmp6(uint8_t icmp6_type)
+{
+    return filter{ CY_PF_OL_FEAT_IPTYPE, false, proto_t(), direction_t(), PF_IP_PROTO_ICMPV6,
+                   CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE,
+                   pf_ipv6_attr_t{ PF_IPV6_NEXT_HEADER | PF_IPV6_ICMP6_TYPE, icmp6_type } };
+}
+
+/* The same filter, discarding the packets it matches. */
+constexpr filter discard(filter f)
+{
+    return filter{ f.feature, true, f.proto, f.direction, f.value, f.active, f.ipv6 };
+}
+
+/* The same filter, active only while the host sleeps or only while it is
+ * awake.
+ */
+constexpr filter sleep_only(filter f)
+{
+    return filter{ f.feature, f.discard, f.proto, f.direction, f.value,
+                   CY_PF_ACTIVE_SLEEP, f.ipv6 };
+}
+
+constexpr filter wake_only(filter f)
+{
+    return filter{ f.feature, f.discard, f.proto, f.direction, f.value,
+                   CY_PF_ACTIVE_WAKE, f.ipv6 };
+}
+
+/* Whether two filters match the same packets, whatever their actions. */
+constexpr bool same_packets(const filter &a, const filter &b)
+{
+    return (a.feature == b.feature) && (a.value == b.value) &&
+           (a.ipv6.flags == b.ipv6.flags) && (a.ipv6.icmp6_type == b.ipv6.icmp6_type) &&
+           ((CY_PF_OL_FEAT_PORTNUM != a.feature) ||
+            ((a.proto == b.proto) && (a.direction == b.direction)));
+}
+
+template <size_t N>
+constexpr size_t count(const filter (&)[N])
+{
+    return N;
+}
+
+template <size_t N>
+constexpr bool has_duplicates(const filter (&list)[N])
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        for (size_t j = i + 1; j < N; j++)
+        {
+            if (same_packets(list[i], list[j]))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+template <size_t N>
+constexpr size_t discard_count(const filter (&list)[N])
+{
+    size_t discards = 0;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        discards += list[i].discard ? 1 : 0;
+    }
+
+    return discards;
+}
+
+template <size_t N>
+constexpr bool has_inactive(const filter (&list)[N])
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        if (0 == (list[i].active & (CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Whether the list holds IPv6 IP type filters next to an Ether type 0x86dd
+ * filter, which already covers their packets (see pf_list_validate()).
+ */
+template <size_t N>
+constexpr bool overlaps_ipv6(const filter (&list)[N])
+{
+    bool eth_ipv6 = false;
+    bool ip_ipv6 = false;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        eth_ipv6 = eth_ipv6 || ((CY_PF_OL_FEAT_ETHTYPE == list[i].feature) &&
+                                (PF_ETH_TYPE_IPV6 == list[i].value));
+        ip_ipv6 = ip_ipv6 || (0u != list[i].ipv6.flags);
+    }
+
+    return eth_ipv6 && ip_ipv6;
+}
+
+/* Whether the list holds IPv6 IP type filters. */
+template <size_t N>
+constexpr bool has_ipv6(const filter (&list)[N])
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        if (0u != list[i].ipv6.flags)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <size_t N>
+constexpr bool mixes_actions(const filter (&list)[N])
+{
+    return (0 != discard_count(list)) && (N != discard_count(list));
+}
+
+/* Flags of a filter: its host states and its action. */
+constexpr uint32_t bits(const filter &f)
+{
+    return f.active | (f.discard ? (uint32_t)CY_PF_ACTION_DISCARD : 0u);
+}
+
+/* Expands one filter into the configuration of the Offload Manager. */
+constexpr cy_pf_ol_cfg_t to_cfg(const filter &f, uint32_t id)
+{
+    if (CY_PF_OL_FEAT_PORTNUM == f.feature)
+    {
+        return cy_pf_ol_cfg_t{ .feature = f.feature,
+                               .bits = bits(f),
+                               .id = id,
+                               .u = { .pf = { .portnum = { .portnum = f.value,
+                                                           .range = 0u,
+                                                           .direction = f.direction },
+                                              .proto = f.proto } } };
+    }
+
+    if (CY_PF_OL_FEAT_ETHTYPE == f.feature)
+    {
+        return cy_pf_ol_cfg_t{ .feature = f.feature,
+                               .bits = bits(f),
+                               .id = id,
+                               .u = { .eth = { .eth_type = f.value } } };
+    }
+
+    return cy_pf_ol_cfg_t{ .feature = f.feature,
+                           .bits = bits(f),
+                           .id = id,
+                           .u = { .ip = { .ip_type = (uint8_t)f.value } } };
+}
+
+template <size_t N, size_t... I>
+constexpr cfg_list<N> build(const filter (&list)[N], std::index_sequence<I...>)
+{
+    static_assert(N <= PF_LIST_MAX_ID, "more packet filters than filter IDs");
+
+    return cfg_list<N>{ { to_cfg(list[I], I)...,
+                          cy_pf_ol_cfg_t{ .feature = CY_PF_OL_FEAT_LAST,
+                                          .bits = 0u,
+                                          .id = 0u,
+                                          .u = {} } },
+                        { { list[I].ipv6... } } };
+}
+
+/*
+ * Expands a list into a constant array of the Offload Manager, with the
+ * filter IDs in list order. Check the list with PF_DSL_STATIC_ASSERT_VALID.
+ */
+template <size_t N>
+constexpr cfg_list<N> build(const filter (&list)[N])
+{
+    return build(list, std::make_index_sequence<N>());
+}
+
+} /* namespace pf_dsl */
+
+#endif /* #ifndef PF_DSL_H */
+
+
+/* [] END OF FILE */
+
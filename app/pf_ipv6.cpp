@@ -0,0 +1,536 @@
+/******************************************************************************
+ * File Name: pf_ipv6.cpp
+ *
+ * Description:
+ *   This file contains the IPv6 offload of the Offload Manager. The LPA
+ *   packet filter offload only matches the protocol of IPv4 packets, so the
+ *   IP type filters on the IPv6 next header are left out of the list handed
+ *   to it. This offload, listed right after it, adds them to the WLAN device
+ *   as pattern filters on the Ether type, the next header of the fixed IPv6
+ *   header and, for ICMPv6, the ICMPv6 type. It also counts the packets
+ *   delivered to the host and the wakes per packet class, to measure the
+ *   effect of the IPv6 filters on a dual-stack network.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "pf_ipv6.h"
+#include "whd_emac.h"
+#include "whd_wifi_api.h"
+#include "app_log.h"
+#include "pf_snapshot.h"
+#include "wake_latency.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Ethernet and IPv6 frame layout. */
+#define IPV6_ETH_HDR_LEN           (14)
+#define IPV6_ETH_TYPE_OFFSET       (12)
+#define IPV6_ETH_TYPE_IPV4         (0x0800)
+#define IPV6_ETH_TYPE_ARP          (0x0806)
+#define IPV6_HDR_LEN               (40)
+#define IPV6_NEXT_HEADER_OFFSET    (6)
+#define IPV6_NEXT_HEADER_HOP       (0)
+
+/*
+ * The pattern filters start at the Ether type: bytes 0-1 hold the Ether
+ * type, byte 8 the next header and byte 42 the ICMPv6 type.
+ */
+#define IPV6_PATTERN_OFFSET        (IPV6_ETH_TYPE_OFFSET)
+#define IPV6_PATTERN_NH_POS        (IPV6_ETH_HDR_LEN - IPV6_ETH_TYPE_OFFSET + \
+                                    IPV6_NEXT_HEADER_OFFSET)
+#define IPV6_PATTERN_ICMP6_POS     (IPV6_ETH_HDR_LEN - IPV6_ETH_TYPE_OFFSET + \
+                                    IPV6_HDR_LEN)
+#define IPV6_PATTERN_MAX_LEN       (IPV6_PATTERN_ICMP6_POS + 1)
+
+/* ICMPv6 neighbor discovery and MLD message types. */
+#define ICMP6_TYPE_MLD_QUERY       (130)
+#define ICMP6_TYPE_MLD_DONE        (132)
+#define ICMP6_TYPE_RS              (133)
+#define ICMP6_TYPE_REDIRECT        (137)
+#define ICMP6_TYPE_MLD2_REPORT     (143)
+
+/* Reads a big-endian 16-bit value from a frame. */
+#define IPV6_READ_BE16(p)          ((uint16_t)(((p)[0] << 8) | (p)[1]))
+
+/******************************************************************************
+ *                                ENUMS
+ *****************************************************************************/
+/* Classes of the packets delivered to the host. */
+typedef enum
+{
+    PKT_CLASS_IPV4 = 0,
+    PKT_CLASS_ARP,
+    PKT_CLASS_IPV6_ND,      /* ICMPv6 router and neighbor discovery       */
+    PKT_CLASS_IPV6_MLD,     /* Hop-by-hop options or ICMPv6 MLD           */
+    PKT_CLASS_IPV6_OTHER,
+    PKT_CLASS_OTHER,
+    PKT_CLASS_MAX
+} pkt_class_t;
+
+/******************************************************************************
+ *                           FUNCTION PROTOTYPES
+ *****************************************************************************/
+static int pf_ipv6_init(void *ol, ol_info_t *info, const void *cfg);
+static void pf_ipv6_deinit(void *ol);
+static void pf_ipv6_pm(ol_pm_st_t st, void *ol);
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+const ol_fns_t pf_ipv6_ol_fns =
+{
+    .init = pf_ipv6_init,
+    .deinit = pf_ipv6_deinit,
+    .pm = pf_ipv6_pm,
+};
+
+static const char *const class_names[PKT_CLASS_MAX] =
+{
+    "IPv4", "ARP", "IPv6 ND", "IPv6 MLD", "IPv6 other", "Other"
+};
+
+/* Packets delivered to the host and wakes, per packet class. */
+static volatile uint32_t class_packets[PKT_CLASS_MAX];
+static volatile uint32_t class_wakes[PKT_CLASS_MAX];
+
+/* Wake count of wake_latency.cpp when the last wake was attributed. */
+static uint32_t counted_wakes;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: pf_ipv6_add_filter
+ ******************************************************************************
+ * Summary:
+ *   This function adds an IPv6 IP type filter to the WLAN device as a
+ *   pattern filter. It is enabled if it is active while the host is awake,
+ *   as the LPA does with its own filters.
+ *
+ * Parameters:
+ *   ifp: WHD interface.
+ *   cfg: IPv6 IP type filter.
+ *   attr: IPv6 attributes of the filter.
+ *
+ * Return:
+ *   whd_result_t: WHD_SUCCESS or the error of the WHD.
+ *
+ *****************************************************************************/
+static whd_result_t pf_ipv6_add_filter(whd_interface_t ifp, const cy_pf_ol_cfg_t *cfg,
+                                       const pf_ipv6_attr_t *attr)
+{
+    uint8_t mask[IPV6_PATTERN_MAX_LEN] = {0};
+    uint8_t pattern[IPV6_PATTERN_MAX_LEN] = {0};
+    whd_packet_filter_t filter;
+    whd_result_t result = WHD_SUCCESS;
+
+    mask[0] = 0xFF;
+    mask[1] = 0xFF;
+    pattern[0] = (uint8_t)(PF_ETH_TYPE_IPV6 >> 8);
+    pattern[1] = (uint8_t)(PF_ETH_TYPE_IPV6 & 0xFF);
+    mask[IPV6_PATTERN_NH_POS] = 0xFF;
+    pattern[IPV6_PATTERN_NH_POS] = cfg->u.ip.ip_type;
+
+    memset(&filter, 0, sizeof(filter));
+    filter.id = cfg->id;
+    filter.rule = WHD_PACKET_FILTER_RULE_POSITIVE_MATCHING;
+    filter.offset = IPV6_PATTERN_OFFSET;
+    filter.mask_size = IPV6_PATTERN_NH_POS + 1;
+    filter.mask = mask;
+    filter.pattern = pattern;
+    filter.enabled_status = (cfg->bits & CY_PF_ACTIVE_WAKE) ? WHD_TRUE : WHD_FALSE;
+
+    if (attr->flags & PF_IPV6_ICMP6_TYPE)
+    {
+        mask[IPV6_PATTERN_ICMP6_POS] = 0xFF;
+        pattern[IPV6_PATTERN_ICMP6_POS] = attr->icmp6_type;
+        filter.mask_size = IPV6_PATTERN_ICMP6_POS + 1;
+    }
+
+    result = whd_pf_add_packet_filter(ifp, &filter);
+    if ((WHD_SUCCESS == result) && (cfg->bits & CY_PF_ACTIVE_WAKE))
+    {
+        result = whd_pf_enable_packet_filter(ifp, (uint8_t)cfg->id);
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_init
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the OLM after the packet filters of the LPA
+ *   are added to the WLAN device. It adds the IPv6 IP type filters of the
+ *   active list and records the ones active in a single host state.
+ *
+ * Parameters:
+ *   ol: Context of the IPv6 offload.
+ *   info: Information of the OLM.
+ *   cfg: Configuration of the offload, unused.
+ *
+ * Return:
+ *   int: 0.
+ *
+ *****************************************************************************/
+static int pf_ipv6_init(void *ol, ol_info_t *info, const void *cfg)
+{
+    pf_ipv6_ol_t *ctxt = (pf_ipv6_ol_t *)ol;
+    whd_interface_t ifp = WHD_EMAC::get_instance().ifp;
+    whd_result_t result = WHD_SUCCESS;
+    uint32_t mode = 0;
+    pf_snapshot_reader_t reader = pf_snapshot_read_lock();
+    const pf_snapshot_t *snapshot = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+
+    (void)info;
+    (void)cfg;
+
+    ctxt->installed = 0;
+    ctxt->sleep_only = 0;
+    ctxt->wake_only = 0;
+    for (uint8_t i = 0; i < snapshot->count; i++)
+    {
+        const cy_pf_ol_cfg_t *filter = &snapshot->cfgs[i];
+
+        if (!PF_IS_IPV6(filter, &snapshot->ipv6))
+        {
+            continue;
+        }
+
+        result = pf_ipv6_add_filter(ifp, filter, pf_list_ipv6_attr(&snapshot->ipv6, filter));
+        if (WHD_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to add IPv6 packet filter %u, error 0x%lx\n",
+                      (unsigned)filter->id, (unsigned long)result));
+            continue;
+        }
+        ctxt->installed |= (1u << filter->id);
+
+        mode = filter->bits & (CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE);
+        if (CY_PF_ACTIVE_SLEEP == mode)
+        {
+            ctxt->sleep_only |= (1u << filter->id);
+        }
+        else if (CY_PF_ACTIVE_WAKE == mode)
+        {
+            ctxt->wake_only |= (1u << filter->id);
+        }
+    }
+    pf_snapshot_read_unlock(reader);
+
+    return 0;
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_deinit
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the OLM when the offload list is replaced. It
+ *   removes the filters it added.
+ *
+ * Parameters:
+ *   ol: Context of the IPv6 offload.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void pf_ipv6_deinit(void *ol)
+{
+    pf_ipv6_ol_t *ctxt = (pf_ipv6_ol_t *)ol;
+    whd_interface_t ifp = WHD_EMAC::get_instance().ifp;
+
+    for (uint8_t id = 0; 0 != ctxt->installed; id++)
+    {
+        if (ctxt->installed & (1u << id))
+        {
+            whd_pf_remove_packet_filter(ifp, id);
+            ctxt->installed &= ~(1u << id);
+        }
+    }
+    ctxt->sleep_only = 0;
+    ctxt->wake_only = 0;
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_switch
+ ******************************************************************************
+ * Summary:
+ *   This function enables and disables IPv6 filters added by the offload.
+ *
+ * Parameters:
+ *   ifp: WHD interface.
+ *   enable: IDs of the filters to enable, bit n for ID n.
+ *   disable: IDs of the filters to disable, bit n for ID n.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void pf_ipv6_switch(whd_interface_t ifp, uint32_t enable, uint32_t disable)
+{
+    whd_result_t result = WHD_SUCCESS;
+
+    for (uint8_t id = 0; (0 != enable) || (0 != disable); id++)
+    {
+        if (enable & (1u << id))
+        {
+            result = whd_pf_enable_packet_filter(ifp, id);
+            enable &= ~(1u << id);
+        }
+        else if (disable & (1u << id))
+        {
+            result = whd_pf_disable_packet_filter(ifp, id);
+            disable &= ~(1u << id);
+        }
+        else
+        {
+            continue;
+        }
+
+        if (WHD_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to switch IPv6 packet filter %u, error 0x%lx\n",
+                      (unsigned)id, (unsigned long)result));
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_pm
+ ******************************************************************************
+ * Summary:
+ *   This function is called by the OLM when the host goes to sleep and when
+ *   it wakes up. The LPA switches its own filters active in a single host
+ *   state; this offload switches the IPv6 ones it added the same way.
+ *
+ * Parameters:
+ *   st: New power state of the host.
+ *   ol: Context of the IPv6 offload.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void pf_ipv6_pm(ol_pm_st_t st, void *ol)
+{
+    pf_ipv6_ol_t *ctxt = (pf_ipv6_ol_t *)ol;
+    whd_interface_t ifp = WHD_EMAC::get_instance().ifp;
+
+    if (OL_PM_ST_GOING_TO_SLEEP == st)
+    {
+        pf_ipv6_switch(ifp, ctxt->sleep_only, ctxt->wake_only);
+    }
+    else if (OL_PM_ST_AWAKE == st)
+    {
+        pf_ipv6_switch(ifp, ctxt->wake_only, ctxt->sleep_only);
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_lpa_list
+ ******************************************************************************
+ * Summary:
+ *   This function copies a packet filter list without its IPv6 IP type
+ *   filters, which the LPA would add as IPv4 protocol filters.
+ *
+ * Parameters:
+ *   cfgs: Packet filter list terminated with CY_PF_OL_FEAT_LAST.
+ *   ipv6: IPv6 attributes of the filters by their ID, NULL if none.
+ *   lpa_cfgs: Array of MAX_FILTERS entries receiving the list of the LPA.
+ *
+ * Return:
+ *   uint8_t: Number of packet filters copied.
+ *
+ *****************************************************************************/
+uint8_t pf_ipv6_lpa_list(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                         cy_pf_ol_cfg_t *lpa_cfgs)
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; (i < (MAX_FILTERS - 1)) && (CY_PF_OL_FEAT_LAST != cfgs[i].feature); i++)
+    {
+        if (!PF_IS_IPV6(&cfgs[i], ipv6))
+        {
+            lpa_cfgs[count++] = cfgs[i];
+        }
+    }
+    memset(&lpa_cfgs[count], 0, sizeof(cy_pf_ol_cfg_t));
+    lpa_cfgs[count].feature = CY_PF_OL_FEAT_LAST;
+
+    return count;
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_classify
+ ******************************************************************************
+ * Summary:
+ *   This function returns the class of a received frame. As in the WLAN
+ *   device, only the next header of the fixed IPv6 header is looked at.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   pkt_class_t: Class of the frame.
+ *
+ *****************************************************************************/
+static pkt_class_t pf_ipv6_classify(const uint8_t *frame, uint32_t len)
+{
+    const uint8_t *ip = &frame[IPV6_ETH_HDR_LEN];
+    uint16_t eth_type = IPV6_READ_BE16(&frame[IPV6_ETH_TYPE_OFFSET]);
+    uint8_t icmp6_type = 0;
+
+    if (IPV6_ETH_TYPE_IPV4 == eth_type)
+    {
+        return PKT_CLASS_IPV4;
+    }
+    if (IPV6_ETH_TYPE_ARP == eth_type)
+    {
+        return PKT_CLASS_ARP;
+    }
+    if ((PF_ETH_TYPE_IPV6 != eth_type) || ((IPV6_ETH_HDR_LEN + IPV6_HDR_LEN) > len))
+    {
+        return PKT_CLASS_OTHER;
+    }
+
+    if (IPV6_NEXT_HEADER_HOP == ip[IPV6_NEXT_HEADER_OFFSET])
+    {
+        return PKT_CLASS_IPV6_MLD;
+    }
+    if ((PF_IP_PROTO_ICMPV6 != ip[IPV6_NEXT_HEADER_OFFSET]) ||
+        ((IPV6_ETH_HDR_LEN + IPV6_HDR_LEN + 1) > len))
+    {
+        return PKT_CLASS_IPV6_OTHER;
+    }
+
+    icmp6_type = ip[IPV6_HDR_LEN];
+    if ((ICMP6_TYPE_RS <= icmp6_type) && (ICMP6_TYPE_REDIRECT >= icmp6_type))
+    {
+        return PKT_CLASS_IPV6_ND;
+    }
+    if (((ICMP6_TYPE_MLD_QUERY <= icmp6_type) && (ICMP6_TYPE_MLD_DONE >= icmp6_type)) ||
+        (ICMP6_TYPE_MLD2_REPORT == icmp6_type))
+    {
+        return PKT_CLASS_IPV6_MLD;
+    }
+
+    return PKT_CLASS_IPV6_OTHER;
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_count_frame
+ ******************************************************************************
+ * Summary:
+ *   This function counts a frame delivered to the host by the WLAN device.
+ *   The first frame after each WLAN host wake, as counted by the wake
+ *   latency measurement, is also counted as the cause of the wake; the
+ *   wakes by a timer or another interrupt are not counted and leave the
+ *   frames received while awake unattributed. It is called in the receive
+ *   path before any host-side drop.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_ipv6_count_frame(const uint8_t *frame, uint32_t len)
+{
+    pkt_class_t pkt_class = PKT_CLASS_OTHER;
+    uint32_t wakes = wake_latency_get_wake_count();
+
+    if ((NULL == frame) || (IPV6_ETH_HDR_LEN > len))
+    {
+        return;
+    }
+
+    pkt_class = pf_ipv6_classify(frame, len);
+    class_packets[pkt_class]++;
+
+    if (wakes != counted_wakes)
+    {
+        counted_wakes = wakes;
+        class_wakes[pkt_class]++;
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_ipv6_report
+ ******************************************************************************
+ * Summary:
+ *   This function prints the packets delivered to the host and the wakes
+ *   per packet class, as counts and per hour since boot. The wakes are only
+ *   counted when the wake latency measurement is enabled.
+ *
+ * Parameters:
+ *   buf: Buffer receiving the report.
+ *   buf_len: Length of the buffer, at least PF_IPV6_REPORT_LEN.
+ *
+ * Return:
+ *   int: Length of the report.
+ *
+ *****************************************************************************/
+int pf_ipv6_report(char *buf, size_t buf_len)
+{
+    uint64_t uptime_ms = Kernel::get_ms_count();
+    int len = 0;
+
+    if (0 == uptime_ms)
+    {
+        uptime_ms = 1;
+    }
+
+    len = snprintf(buf, buf_len, "Packets and wakes per class (per hour):\n");
+    for (int i = 0; (i < PKT_CLASS_MAX) && (len < (int)buf_len); i++)
+    {
+        len += snprintf(&buf[len], buf_len - len,
+                        "  %-10s %8lu (%6lu/h) packets, %8lu (%6lu/h) wakes\n",
+                        class_names[i],
+                        (unsigned long)class_packets[i],
+                        (unsigned long)(class_packets[i] * 3600000ULL / uptime_ms),
+                        (unsigned long)class_wakes[i],
+                        (unsigned long)(class_wakes[i] * 3600000ULL / uptime_ms));
+    }
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
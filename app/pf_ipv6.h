@@ -0,0 +1,84 @@
+/******************************************************************************
+ * File Name: pf_ipv6.h
+ *
+ * Description:
+ *   This header file contains the declarations of the IPv6 offload, which
+ *   adds the IPv6 IP type filters of the packet filter list to the WLAN
+ *   device, and of the wake counts per packet class.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_IPV6_H
+#define PF_IPV6_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_lpa_wifi_ol.h"
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Buffer length required by pf_ipv6_report(). */
+#define PF_IPV6_REPORT_LEN                 (512)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Context of the IPv6 offload. */
+typedef struct
+{
+    uint32_t installed;     /* IDs of the filters added, bit n for ID n   */
+    uint32_t sleep_only;    /* IDs of the filters active while asleep     */
+    uint32_t wake_only;     /* IDs of the filters active while awake      */
+} pf_ipv6_ol_t;
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Callbacks of the IPv6 offload, listed right after the packet filters. */
+extern const ol_fns_t pf_ipv6_ol_fns;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+uint8_t pf_ipv6_lpa_list(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                         cy_pf_ol_cfg_t *lpa_cfgs);
+void pf_ipv6_count_frame(const uint8_t *frame, uint32_t len);
+int pf_ipv6_report(char *buf, size_t buf_len);
+
+#endif /* #ifndef PF_IPV6_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,1219 @@
+/******************************************************************************
+ * File Name: pf_list.cpp
+ *
+ * Description:
+ *   This file contains the packet filter list management: parsing of the
+ *   filters from the HTTP data, validation against the list being edited,
+ *   addition and removal. The lists are passed explicitly; the locking and
+ *   the commit to the offload manager are left to the caller.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pf_list.h"
+#include "app_log.h"
+
+/******************************************************************************
+ *                                ENUMS
+ *****************************************************************************/
+/* Index to packet filter types for identity. */
+enum filter_type
+{
+    PF = 1, /*  Port filter     */
+    ET,     /*  Eth filter      */
+    IT,     /*  IP filter       */
+    HC      /*  Host classifier */
+};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: pf_filter_type
+ ******************************************************************************
+ * Summary:
+ *   This function returns a enum value based on the config string passed.
+ *   Packet Filter(PF) = 1; Eth Type(ET) = 2; IP Type(IT) = 3;
+ *   Host Classifier(HC) = 4.
+ *
+ * Parameters:
+ *   str: A string value from HTTP data. May be NULL.
+ *
+ * Return:
+ *   int: Returns a valid enum value (1 - 4) from packet filter types if the
+ *     HTTP configuration matches. Otherwise, it returns 0.
+ *
+ *****************************************************************************/
+static int pf_filter_type(const char *str)
+{
+    if (NULL == str)
+    {
+        return 0;
+    }
+    if (!strncmp(str, "PF", PKT_FILTER_ID_STR_LEN))
+    {
+        return PF;
+    }
+    if (!strncmp(str, "ET", PKT_FILTER_ID_STR_LEN))
+    {
+        return ET;
+    }
+    if (!strncmp(str, "IT", PKT_FILTER_ID_STR_LEN))
+    {
+        return IT;
+    }
+    if (!strncmp(str, "HC", PKT_FILTER_ID_STR_LEN))
+    {
+        return HC;
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+ * Function Name: parse_number
+ ******************************************************************************
+ * Summary:
+ *   This function converts a field of the HTTP data to a number. Unlike
+ *   atoi(), it rejects empty fields, trailing characters and out of range
+ *   values instead of returning 0 or an undefined value.
+ *
+ * Parameters:
+ *   str: A string value from HTTP data. May be NULL.
+ *   base: Base of the number as for strtoul(); 0 accepts a "0x" prefix.
+ *   max: Largest value accepted.
+ *   value: Pointer to the converted value.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t parse_number(const char *str, int base, uint32_t max, uint32_t *value)
+{
+    char *end = NULL;
+    unsigned long number = 0;
+
+    if ((NULL == str) || ('\0' == *str) || ('-' == *str))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    errno = 0;
+    number = strtoul(str, &end, base);
+    if ((0 != errno) || ('\0' != *end) || (number > max))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    *value = (uint32_t)number;
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: check_filter_fields
+ ******************************************************************************
+ * Summary:
+ *   This function checks that the HTTP data holds all the fields used by its
+ *   packet filter type. A field left empty in the web page, or missing from
+ *   a malformed request, is NULL.
+ *
+ * Parameters:
+ *   config_str[]: Pointer to filter data. The filter data comes from HTTP
+ *     web page as a string and this variable is used to hold pointer to it.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+static cy_rslt_t check_filter_fields(char *config_str[])
+{
+    if ((NULL == config_str) || (NULL == config_str[KEEP_OR_DISCARD_ID]))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    switch (pf_filter_type(config_str[PKT_FILTER_TYPE_ID]))
+    {
+        case PF:
+            if ((NULL == config_str[TCP_OR_UDP_ID]) ||
+                (NULL == config_str[SOURCE_OR_DESTINATION_ID]) ||
+                (NULL == config_str[PORT_NUMBER_ID]))
+            {
+                return CY_RSLT_TYPE_ERROR;
+            }
+            break;
+        case ET:
+            if (NULL == config_str[ETH_TYPE_VALUE_ID])
+            {
+                return CY_RSLT_TYPE_ERROR;
+            }
+            break;
+        case IT:
+            if (NULL == config_str[IP_TYPE_VALUE_ID])
+            {
+                return CY_RSLT_TYPE_ERROR;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: parse_active_mode
+ ******************************************************************************
+ * Summary:
+ *   This function converts the host states selected in the web page into
+ *   the activation flags of a packet filter: "S" while the host sleeps, "W"
+ *   while it is awake, and "A" or no selection in both states.
+ *
+ * Parameters:
+ *   mode_str: Host states selected in the web page. May be NULL.
+ *   active: Receives CY_PF_ACTIVE_SLEEP and/or CY_PF_ACTIVE_WAKE.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+static cy_rslt_t parse_active_mode(const char *mode_str, uint32_t *active)
+{
+    if ((NULL == mode_str) || !strncmp(mode_str, "A", ACTIVE_MODE_ID_LEN))
+    {
+        *active = CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE;
+    }
+    else if (!strncmp(mode_str, "S", ACTIVE_MODE_ID_LEN))
+    {
+        *active = CY_PF_ACTIVE_SLEEP;
+    }
+    else if (!strncmp(mode_str, "W", ACTIVE_MODE_ID_LEN))
+    {
+        *active = CY_PF_ACTIVE_WAKE;
+    }
+    else
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: is_ipv6_ext_header
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether an IPv6 next header value is an extension
+ *   header which is followed by another header. The hop-by-hop options,
+ *   which carry the MLD messages, are not counted: they are the only
+ *   extension header a keep list needs.
+ *
+ * Parameters:
+ *   next_header: IPv6 next header value.
+ *
+ * Return:
+ *   bool: Returns true for an extension header other than hop-by-hop.
+ *
+ *****************************************************************************/
+static bool is_ipv6_ext_header(uint32_t next_header)
+{
+    switch (next_header)
+    {
+        case 43:    /* Routing             */
+        case 44:    /* Fragment            */
+        case 51:    /* Authentication      */
+        case 60:    /* Destination options */
+        case 135:   /* Mobility            */
+        case 139:   /* HIP                 */
+        case 140:   /* Shim6               */
+            return true;
+        default:
+            return false;
+    }
+}
+
+/******************************************************************************
+ * Function Name: parse_ip_version
+ ******************************************************************************
+ * Summary:
+ *   This function reads the IP version and the ICMPv6 type of an IP type
+ *   filter. An IPv4 filter matches the protocol of IPv4 packets. An IPv6
+ *   filter matches the next header of the fixed IPv6 header and, for
+ *   ICMPv6, optionally the ICMPv6 type that follows it. The WLAN device does
+ *   not walk the extension headers, so the next header must be the upper
+ *   layer header, and IPv6 filters can only keep packets.
+ *
+ * Parameters:
+ *   config_str[]: Pointer to filter data. The filter data comes from HTTP
+ *     web page as a string and this variable is used to hold pointer to it.
+ *   cfg: IP type filter with its IP protocol and action already set.
+ *   ipv6: Receives the IPv6 attributes of the filter, none for IPv4.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+static cy_rslt_t parse_ip_version(char *config_str[], const cy_pf_ol_cfg_t *cfg,
+                                  pf_ipv6_attr_t *ipv6)
+{
+    const char *version = config_str[IP_VERSION_ID];
+    uint32_t icmp6_type = 0;
+
+    memset(ipv6, 0, sizeof(*ipv6));
+
+    if ((NULL == version) || !strncmp(version, "4", IP_VERSION_ID_LEN))
+    {
+        if (NULL != config_str[ICMP6_TYPE_ID])
+        {
+            ERR_INFO(("An ICMPv6 type needs IP version 6\n"));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        if (PF_IP_PROTO_ICMPV6 == cfg->u.ip.ip_type)
+        {
+            ERR_INFO(("ICMPv6 is carried by IPv6 only. Select IP version 6.\n"));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        return CY_RSLT_SUCCESS;
+    }
+
+    if (strncmp(version, "6", IP_VERSION_ID_LEN))
+    {
+        ERR_INFO(("Invalid IP version (%s)\n", version));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (cfg->bits & CY_PF_ACTION_DISCARD)
+    {
+        ERR_INFO(("IPv6 IP type filters can only keep packets\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (is_ipv6_ext_header(cfg->u.ip.ip_type))
+    {
+        ERR_INFO(("Next header 0x%x is an extension header. The WLAN device "
+                  "only compares the next header of the fixed IPv6 header.\n",
+                  cfg->u.ip.ip_type));
+        return CY_RSLT_TYPE_ERROR;
+    }
+    ipv6->flags = PF_IPV6_NEXT_HEADER;
+
+    if (NULL != config_str[ICMP6_TYPE_ID])
+    {
+        if (PF_IP_PROTO_ICMPV6 != cfg->u.ip.ip_type)
+        {
+            ERR_INFO(("An ICMPv6 type needs the next header 0x3a (ICMPv6)\n"));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        if (CY_RSLT_SUCCESS != parse_number(config_str[ICMP6_TYPE_ID], 10, 0xFF, &icmp6_type))
+        {
+            ERR_INFO(("Invalid ICMPv6 type (%s). Range is 0 - 255\n",
+                      config_str[ICMP6_TYPE_ID]));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        ipv6->flags |= PF_IPV6_ICMP6_TYPE;
+        ipv6->icmp6_type = (uint8_t)icmp6_type;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: check_filter_type
+ ******************************************************************************
+ * Summary:
+ *   This function checks an error scenario. As per the application design,
+ *   only Keep or only Discard packet filters are allowed. The combination of
+ *   Keep and Discard filter does not make any sense and the filter will not
+ *   get added to the pending list. Also, adding multiple discard filter is not
+ *   supported. The number of discard filters that can be added to pending list
+ *   is limited to 1. This is a retriction from WLAN firmware as per its design.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   new_cfg: Packet filter about to be added.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
+ *     whether the filter is a valid one or not.
+ *****************************************************************************/
+static cy_rslt_t check_filter_type(const pf_list_t *list, const cy_pf_ol_cfg_t *new_cfg)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    /* 
+     * Only one discard packet filter is supported by the WLAN.
+     * And, no more configuration is allowed when the discard filter
+     * is present.
+     */
+    if (list->first->bits & CY_PF_ACTION_DISCARD)
+    {
+        ERR_INFO(("No further configuration is allowed since the list "
+                  "contains a discard filter. Note that only one discard "
+                  "packet filter is allowed\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* Allow only Keep or only Discard packet filter */
+    if (list->first->feature != 0 &&
+        list->first->feature != CY_PF_OL_FEAT_LAST)
+    {
+        if (!(new_cfg->bits & CY_PF_ACTION_DISCARD))
+        {
+            if (list->first->bits & CY_PF_ACTION_DISCARD)
+            {
+                result = CY_RSLT_TYPE_ERROR;
+            }
+        }
+        else
+        {
+            if (!(list->first->bits & CY_PF_ACTION_DISCARD))
+            {
+                result = CY_RSLT_TYPE_ERROR;
+            }
+        }
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_alloc_id
+ ******************************************************************************
+ * Summary:
+ *   This function takes the lowest free filter ID of a packet filter list
+ *   from its ID map, in constant time.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   id: Receives the filter ID.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if all the IDs
+ *     are in use.
+ *
+ *****************************************************************************/
+static cy_rslt_t pf_list_alloc_id(pf_list_t *list, uint8_t *id)
+{
+    uint32_t free_ids = ~list->id_map;
+
+    if (0 == free_ids)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    *id = (uint8_t)__builtin_ctz(free_ids);
+    list->id_map |= (1u << *id);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_free_id
+ ******************************************************************************
+ * Summary:
+ *   This function returns a filter ID to the ID map of a packet filter list.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   id: Filter ID to free.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void pf_list_free_id(pf_list_t *list, uint32_t id)
+{
+    if (PF_LIST_MAX_ID > id)
+    {
+        list->id_map &= ~(1u << id);
+        memset(&list->ipv6.attr[id], 0, sizeof(list->ipv6.attr[id]));
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_list_ipv6_attr
+ ******************************************************************************
+ * Summary:
+ *   This function returns the IPv6 attributes of a filter of a list, from
+ *   the entry of its filter ID. Only IP type filters have any.
+ *
+ * Parameters:
+ *   ipv6: IPv6 attributes of the list, NULL if it has none.
+ *   cfg: Packet filter of the list.
+ *
+ * Return:
+ *   const pf_ipv6_attr_t *: IPv6 attributes of the filter, never NULL.
+ *
+ *****************************************************************************/
+const pf_ipv6_attr_t *pf_list_ipv6_attr(const pf_ipv6_attrs_t *ipv6, const cy_pf_ol_cfg_t *cfg)
+{
+    static const pf_ipv6_attr_t none = { 0, 0 };
+
+    if ((NULL == ipv6) || (CY_PF_OL_FEAT_IPTYPE != cfg->feature) || (PF_LIST_MAX_ID <= cfg->id))
+    {
+        return &none;
+    }
+
+    return &ipv6->attr[cfg->id];
+}
+
+/******************************************************************************
+ * Function Name: pf_list_clear
+ ******************************************************************************
+ * Summary:
+ *   This function empties a packet filter list, resets its current
+ *   position to the beginning, and frees all its filter IDs.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_list_clear(pf_list_t *list)
+{
+    memset(list->first, 0, (list->last - list->first + 1) * sizeof(cy_pf_ol_cfg_t));
+    list->cur = list->first;
+    list->id_map = 0;
+    memset(&list->ipv6, 0, sizeof(list->ipv6));
+}
+
+/******************************************************************************
+ * Function Name: check_filter
+ ******************************************************************************
+ * Summary:
+ *   This function checks a parsed packet filter against the filters of a
+ *   list, before it is added: the action must match the list, only one
+ *   discard filter is allowed, the filter must not be a duplicate, and IPv6
+ *   filters do not go with a filter on the IPv6 Ether type.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   new_cfg: Packet filter about to be added.
+ *   new_ipv6: IPv6 attributes of the packet filter about to be added.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+static cy_rslt_t check_filter(const pf_list_t *list, const cy_pf_ol_cfg_t *new_cfg,
+                              const pf_ipv6_attr_t *new_ipv6)
+{
+    int already_exists = 0;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    /* Check for unique filter action type. It can be only Keep or only
+     * Discard filter type. Combination of Keep and Discard filters are not
+     * allowed.
+     */
+    result = check_filter_type(list, new_cfg);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Either only keep or only discard filters are allowed\n"));
+        return result;
+    }
+
+    /* Check if the filter already exists */
+    for (cy_pf_ol_cfg_t *cfg = list->first; cfg < list->cur; cfg++)
+    {
+        const pf_ipv6_attr_t *ipv6 = pf_list_ipv6_attr(&list->ipv6, cfg);
+
+        if (cfg->feature != new_cfg->feature)
+        {
+            continue;
+        }
+        switch (cfg->feature)
+        {
+            case CY_PF_OL_FEAT_PORTNUM:
+              if ((cfg->u.pf.portnum.portnum != new_cfg->u.pf.portnum.portnum) ||
+                  (cfg->u.pf.portnum.direction != new_cfg->u.pf.portnum.direction) ||
+                  (cfg->u.pf.proto != new_cfg->u.pf.proto))
+              {
+                  continue;
+              }
+              break;
+            case CY_PF_OL_FEAT_ETHTYPE:
+              if (cfg->u.eth.eth_type != new_cfg->u.eth.eth_type)
+              {
+                  continue;
+              }
+              break;
+            case CY_PF_OL_FEAT_IPTYPE:
+              /* An IPv6 filter on any ICMPv6 type covers the ones narrowed
+               * to a single type.
+               */
+              if ((cfg->u.ip.ip_type != new_cfg->u.ip.ip_type) ||
+                  ((ipv6->flags ^ new_ipv6->flags) & PF_IPV6_NEXT_HEADER) ||
+                  ((ipv6->flags & PF_IPV6_ICMP6_TYPE) &&
+                   ((ipv6->flags != new_ipv6->flags) ||
+                    (ipv6->icmp6_type != new_ipv6->icmp6_type))))
+              {
+                  continue;
+              }
+              break;
+            default:
+              ERR_INFO(("Unsupported feature type: %d\n", cfg->feature));
+              break;
+        }
+
+        /* Found duplicate entry */
+        already_exists = 1;
+        break;
+    }
+
+    /* A filter on the IPv6 Ether type already covers all IPv6 packets, so
+     * it cannot be combined with IPv6 filters, whichever is added first.
+     */
+    for (cy_pf_ol_cfg_t *cfg = list->first; (cfg < list->cur) && (!already_exists); cfg++)
+    {
+        if ((CY_PF_OL_FEAT_IPTYPE == new_cfg->feature) &&
+            (new_ipv6->flags & PF_IPV6_NEXT_HEADER) &&
+            (CY_PF_OL_FEAT_ETHTYPE == cfg->feature) &&
+            (PF_ETH_TYPE_IPV6 == cfg->u.eth.eth_type))
+        {
+            ERR_INFO(("IPv6 packets are already covered by Ether type 0x86dd\n"));
+            already_exists = 1;
+        }
+        else if (PF_IS_IPV6(cfg, &list->ipv6) &&
+                 (CY_PF_OL_FEAT_ETHTYPE == new_cfg->feature) &&
+                 (PF_ETH_TYPE_IPV6 == new_cfg->u.eth.eth_type))
+        {
+            ERR_INFO(("Remove the IPv6 filters before Ether type 0x86dd\n"));
+            already_exists = 1;
+        }
+    }
+
+    if (already_exists)
+    {
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_validate
+ *******************************************************************************
+ * Summary:
+ *   This function is used to check if the new filter about to get added in the
+ *   packet filter list differs from all the existing filters present in the
+ *   list. This ensures uniqueness of the filter getting added to the list
+ *   and hence avoids duplicate filters in the list.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   config_str[]: Pointer to filter data. The filter data comes from HTTP
+ *     web page as a string and this variable is used to hold pointer to it.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
+ *     whether the filter is not a duplicate one.
+ ******************************************************************************/
+cy_rslt_t pf_list_validate(const pf_list_t *list, char *config_str[])
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_pf_ol_cfg_t new_cfg;
+    pf_ipv6_attr_t new_ipv6;
+
+    /* Parse the filter once; the checks compare parsed values only. */
+    memset(&new_cfg, 0, sizeof(new_cfg));
+    result = pf_parse_filter(config_str, &new_cfg, &new_ipv6);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    return check_filter(list, &new_cfg, &new_ipv6);
+}
+
+/******************************************************************************
+ * Function Name: pf_parse_filter
+ ******************************************************************************
+ * Summary:
+ *   This function builds a packet filter configuration from the filter data
+ *   of the HTTP server. The filter is active while the host sleeps, while it
+ *   is awake, or both, as selected in the web page.
+ *
+ * Parameters:
+ *   config_str[]: Pointer to filter data. The filter data comes from HTTP
+ *     server as a string and this variable is used to hold pointer to it.
+ *   cfg: Pointer to the packet filter configuration to fill. Its ID is left
+ *     unchanged.
+ *   ipv6: Receives the IPv6 attributes of the filter.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_parse_filter(char *config_str[], cy_pf_ol_cfg_t *cfg, pf_ipv6_attr_t *ipv6)
+{
+    uint32_t active = 0;
+
+    memset(ipv6, 0, sizeof(*ipv6));
+
+    if (CY_RSLT_SUCCESS != check_filter_fields(config_str))
+    {
+        ERR_INFO(("Incomplete packet filter data received\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (CY_RSLT_SUCCESS != parse_active_mode(config_str[ACTIVE_MODE_ID], &active))
+    {
+        ERR_INFO(("Invalid host state (%s)\n", config_str[ACTIVE_MODE_ID]));
+        return CY_RSLT_TYPE_ERROR;
+    }
+    cfg->bits &= ~(CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE);
+    cfg->bits |= active;
+
+    switch(pf_filter_type(config_str[PKT_FILTER_TYPE_ID]))
+    {
+        case PF: //Port Filter
+             uint32_t port_num;
+             cfg->feature = CY_PF_OL_FEAT_PORTNUM;
+             cfg->u.pf.portnum.range = 0;
+             if (CY_RSLT_SUCCESS != parse_number(config_str[PORT_NUMBER_ID], 10,
+                                                 MAX_PORT_NUM, &port_num))
+             {
+                 ERR_INFO(("Invalid port number (%s). Valid range is 0-65535.\n",
+                           config_str[PORT_NUMBER_ID]));
+                 return CY_RSLT_TYPE_ERROR;
+             }
+
+             cfg->u.pf.portnum.portnum = (port_num & 0xFFFF);
+
+             //Keep or Discard packet
+             if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
+                          "K", KEEP_OR_DISCARD_ID_LEN))
+             {
+                 cfg->bits &= ~CY_PF_ACTION_DISCARD;
+             }
+             else
+             {
+                 cfg->bits |= CY_PF_ACTION_DISCARD;
+             }
+             //Source or Destination port
+             if (!strncmp(config_str[SOURCE_OR_DESTINATION_ID],
+                          "SP", SOURCE_OR_DESTINATION_ID_LEN))
+             {
+                 cfg->u.pf.portnum.direction = PF_PN_PORT_SOURCE;
+             }
+             else
+             {
+                 cfg->u.pf.portnum.direction = PF_PN_PORT_DEST;
+             }
+             //Protocol type
+             if (!strncmp(config_str[TCP_OR_UDP_ID],
+                          "T", TCP_OR_UDP_ID_LEN))
+             {
+                 cfg->u.pf.proto = CY_PF_PROTOCOL_TCP;
+             }
+             else
+             {
+                 cfg->u.pf.proto = CY_PF_PROTOCOL_UDP;
+             }
+             break;
+        case ET: //Ether type Filter
+             uint32_t eth_type;
+             cfg->feature = CY_PF_OL_FEAT_ETHTYPE;
+             if ((CY_RSLT_SUCCESS != parse_number(config_str[ETH_TYPE_VALUE_ID], 0,
+                                                  0xFFFF, &eth_type)) ||
+                 (eth_type < 0x800))
+             {
+                 ERR_INFO(("Invalid eth type (%s).  Range is 0x800 - 0xFFFF\n",
+                           config_str[ETH_TYPE_VALUE_ID]));
+                 return CY_RSLT_TYPE_ERROR;
+             }
+             cfg->u.eth.eth_type = (eth_type & 0xFFFF);
+
+             //Keep or Discard packet
+             if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
+                          "K", KEEP_OR_DISCARD_ID_LEN))
+             {
+                 cfg->bits &= ~CY_PF_ACTION_DISCARD;
+             }
+             else
+             {
+                 cfg->bits |= CY_PF_ACTION_DISCARD;
+             }
+             break;
+        case IT: //IP type filter
+             uint32_t ip_proto;
+             cfg->feature = CY_PF_OL_FEAT_IPTYPE;
+             if ((CY_RSLT_SUCCESS != parse_number(config_str[IP_TYPE_VALUE_ID], 0,
+                                                  0xFF, &ip_proto)) ||
+                 !ip_proto)
+             {
+                 ERR_INFO(("Invalid IP protocol (%s).  Range is 1 - 255\n",
+                           config_str[IP_TYPE_VALUE_ID]));
+                 return CY_RSLT_TYPE_ERROR;
+             }
+             cfg->u.ip.ip_type = (ip_proto & 0xFF);
+
+             //Keep or Discard packet
+             if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
+                          "K", KEEP_OR_DISCARD_ID_LEN))
+             {
+                 cfg->bits &= ~CY_PF_ACTION_DISCARD;
+             }
+             else
+             {
+                 cfg->bits |= CY_PF_ACTION_DISCARD;
+             }
+
+             //IPv4 protocol or IPv6 next header
+             if (CY_RSLT_SUCCESS != parse_ip_version(config_str, cfg, ipv6))
+             {
+                 return CY_RSLT_TYPE_ERROR;
+             }
+             break;
+        default:
+             ERR_INFO(("Unknown Packet Filter Type received\n"));
+             return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_add
+ ******************************************************************************
+ * Summary:
+ *   This function adds a new packet filter configuration from HTTP server to
+ *   a packet filter list. It checks for valid packet filter and adds to the
+ *   list only if all the conditions are satisfied. The filter gets the
+ *   lowest filter ID free in the list.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   config_str[]: Pointer to filter data. The filter data comes from HTTP
+ *     server as a string and this variable is used to hold pointer to it.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_list_add(pf_list_t *list, char *config_str[])
+{
+    uint8_t id = 0;
+
+    /* Verify there is room left for the FEATURE_LAST at the end. */
+    if (list->cur >= list->last)
+    {
+        ERR_INFO(("Max number of entries %d.\n", MAX_FILTERS - 1));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+   /* Validate filter before adding to pending list. */
+    if (CY_RSLT_SUCCESS != pf_list_validate(list, config_str))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (CY_RSLT_SUCCESS != pf_list_alloc_id(list, &id))
+    {
+        ERR_INFO(("No free packet filter ID.\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+    list->cur->id = id;
+
+    if (CY_RSLT_SUCCESS != pf_parse_filter(config_str, list->cur, &list->ipv6.attr[id]))
+    {
+        pf_list_free_id(list, id);
+        memset(list->cur, 0, sizeof(cy_pf_ol_cfg_t));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    list->cur++;
+    list->cur->feature = CY_PF_OL_FEAT_LAST;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_set
+ ******************************************************************************
+ * Summary:
+ *   This function replaces the content of a packet filter list with the
+ *   given filters. The filters keep their IDs; an ID out of the range of the
+ *   ID map or already used by a previous filter is replaced with a free one.
+ *   The IPv6 attributes of each filter follow it to its final ID.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   cfgs: Array of packet filter configurations.
+ *   ipv6: IPv6 attributes of the filters by their ID in cfgs, NULL if none.
+ *   count: Number of packet filter configurations in the array.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the list does
+ *     not fit in the list.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_list_set(pf_list_t *list, const cy_pf_ol_cfg_t *cfgs,
+                      const pf_ipv6_attrs_t *ipv6, uint8_t count)
+{
+    cy_pf_ol_cfg_t *cfg = NULL;
+    pf_ipv6_attrs_t attrs;
+    uint8_t id = 0;
+
+    if ((NULL == cfgs && count) || (list->first + count > list->last))
+    {
+        ERR_INFO(("Max number of entries %d.\n", MAX_FILTERS - 1));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* Copied first, as the attributes may be the ones of the list. */
+    memset(&attrs, 0, sizeof(attrs));
+    if (NULL != ipv6)
+    {
+        attrs = *ipv6;
+    }
+
+    pf_list_clear(list);
+
+    for (uint8_t i = 0; i < count; i++, list->cur++)
+    {
+        *list->cur = cfgs[i];
+        if ((PF_LIST_MAX_ID > list->cur->id) &&
+            !(list->id_map & (1u << list->cur->id)))
+        {
+            list->id_map |= (1u << list->cur->id);
+            list->ipv6.attr[list->cur->id] = *pf_list_ipv6_attr(&attrs, &cfgs[i]);
+        }
+        else
+        {
+            list->cur->id = PF_LIST_MAX_ID;
+        }
+    }
+    list->cur->feature = CY_PF_OL_FEAT_LAST;
+
+    /* The list fits in the ID map, so a free ID is always found. */
+    for (cfg = list->first; cfg < list->cur; cfg++)
+    {
+        if ((PF_LIST_MAX_ID == cfg->id) &&
+            (CY_RSLT_SUCCESS == pf_list_alloc_id(list, &id)))
+        {
+            cfg->id = id;
+            list->ipv6.attr[id] = *pf_list_ipv6_attr(&attrs, &cfgs[cfg - list->first]);
+        }
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_set_checked
+ ******************************************************************************
+ * Summary:
+ *   This function replaces the content of a packet filter list as
+ *   pf_list_set() does, but only with filters which pass the checks of the
+ *   filters added from the web page (see pf_list_validate()). It is used for
+ *   the lists read from outside the application, such as the stored list.
+ *   The list is left empty if a filter fails.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   cfgs: Array of packet filter configurations.
+ *   ipv6: IPv6 attributes of the filters by their ID in cfgs, NULL if none.
+ *   count: Number of packet filter configurations in the array.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_list_set_checked(pf_list_t *list, const cy_pf_ol_cfg_t *cfgs,
+                              const pf_ipv6_attrs_t *ipv6, uint8_t count)
+{
+    const cy_pf_ol_cfg_t *cfg = NULL;
+    const pf_ipv6_attr_t *attr = NULL;
+    pf_ipv6_attrs_t attrs;
+
+    if ((NULL == cfgs && count) || (list->first + count > list->last))
+    {
+        ERR_INFO(("Max number of entries %d.\n", MAX_FILTERS - 1));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memset(&attrs, 0, sizeof(attrs));
+    if (NULL != ipv6)
+    {
+        attrs = *ipv6;
+    }
+
+    /* Each filter is checked against the ones before it, as if they were
+     * added one by one.
+     */
+    pf_list_clear(list);
+    list->ipv6 = attrs;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        cfg = &cfgs[i];
+        attr = pf_list_ipv6_attr(&attrs, cfg);
+        if (((CY_PF_OL_FEAT_PORTNUM != cfg->feature) &&
+             (CY_PF_OL_FEAT_ETHTYPE != cfg->feature) &&
+             (CY_PF_OL_FEAT_IPTYPE != cfg->feature)) ||
+            !(cfg->bits & (CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE)) ||
+            (attr->flags & ~(PF_IPV6_NEXT_HEADER | PF_IPV6_ICMP6_TYPE)) ||
+            ((attr->flags & PF_IPV6_ICMP6_TYPE) &&
+             (!(attr->flags & PF_IPV6_NEXT_HEADER) ||
+              (PF_IP_PROTO_ICMPV6 != cfg->u.ip.ip_type))) ||
+            (CY_RSLT_SUCCESS != check_filter(list, cfg, attr)))
+        {
+            ERR_INFO(("Invalid packet filter %d in the list\n", i));
+            pf_list_clear(list);
+            return CY_RSLT_TYPE_ERROR;
+        }
+        *list->cur++ = *cfg;
+    }
+
+    return pf_list_set(list, cfgs, &attrs, count);
+}
+
+/******************************************************************************
+ * Function Name: pf_list_remove
+ ******************************************************************************
+ * Summary:
+ *   This function deletes the filter with the given ID from a packet filter
+ *   list. The following filters are moved down in place, keeping their
+ *   order and their IDs, and the ID is freed.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *   id: ID of the filter to delete.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if no filter of
+ *     the list has the ID.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_list_remove(pf_list_t *list, uint8_t id)
+{
+    cy_pf_ol_cfg_t *cfg = NULL;
+
+    if ((PF_LIST_MAX_ID <= id) || !(list->id_map & (1u << id)))
+    {
+        ERR_INFO(("No packet filter with ID %u.\n", (unsigned int)id));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (cfg = list->first; (cfg < list->cur) && (cfg->id != id); cfg++)
+    {
+    }
+    if (cfg == list->cur)
+    {
+        ERR_INFO(("No packet filter with ID %u.\n", (unsigned int)id));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memmove(cfg, cfg + 1, (list->cur - cfg) * sizeof(cy_pf_ol_cfg_t));
+    memset(list->cur, 0, sizeof(cy_pf_ol_cfg_t));
+    list->cur--;
+    list->cur->feature = CY_PF_OL_FEAT_LAST;
+    pf_list_free_id(list, id);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_list_remove_last
+ ******************************************************************************
+ * Summary:
+ *   This function deletes the last added filter from a packet filter list.
+ *
+ * Parameters:
+ *   list: Packet filter list being edited.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
+ *     whether the entry has been removed successfully or not.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_list_remove_last(pf_list_t *list)
+{
+    /* Check for empty and proceed */
+    if (list->cur == list->first)
+    {
+        ERR_INFO(("Attempt to remove NULL entry. Exit.\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return pf_list_remove(list, (list->cur - 1)->id);
+}
+
+/******************************************************************************
+ * Function Name: print_filter
+ ******************************************************************************
+ * Summary:
+ *   This function builds a string output from the packet filter configuration
+ *   in user readable way. The string output can be directly printed out.
+ *
+ * Parameters:
+ *   cfg: Pointer to packet filter configuration.
+ *   ipv6: IPv6 attributes of the packet filter (see pf_list_ipv6_attr()).
+ *   http_str_builder: Pointer to HTTP response string to be sent to the server.
+ *   build_str: Helper variable to Buffer for storing the formatted string from
+ *              this function.
+ *   build_str_len: Buffer size.
+ *
+ * Return:
+ *   void.
+ *
+ *****************************************************************************/
+void print_filter(const cy_pf_ol_cfg_t *cfg,
+                  const pf_ipv6_attr_t *ipv6,
+                  char *http_str_builder,
+                  char *build_str,
+                  int build_str_len)
+{
+    if (!cfg->feature)
+    {
+        return;
+    }
+
+    sprintf(build_str, "ID %d", cfg->id);
+    strcat(http_str_builder, build_str);
+    switch (cfg->feature)
+    {
+        case CY_PF_OL_FEAT_PORTNUM:
+            strcat(http_str_builder, "[Port Filter]:\n");
+            memset(build_str, '\0', build_str_len);
+            sprintf(build_str, "\tPort = %d,\n", cfg->u.pf.portnum.portnum);
+            strcat(http_str_builder, build_str);
+
+            /* Packet filter type - Keep or Discard packet */
+            if (cfg->bits & CY_PF_ACTION_DISCARD)
+            {
+                strcat(http_str_builder, "\tAction = Discard,\n");
+            }
+            else
+            {
+                strcat(http_str_builder, "\tAction = Keep,\n");
+            }
+
+            /* Protocol TCP or UDP */
+            switch (cfg->u.pf.proto)
+            {
+                case CY_PF_PROTOCOL_TCP:
+                    strcat(http_str_builder, "\tProtocol = TCP,\n");
+                    break;
+                case CY_PF_PROTOCOL_UDP:
+                    strcat(http_str_builder, "\tProtocol = UDP,\n");
+                    break;
+                default:
+                    ERR_INFO(("Unknown IP Protocol used with Port Numbers: %d\n", cfg->u.pf.proto));
+                    break;
+            }
+
+            /* Packet direction - Source or Destination port */
+            if (cfg->u.pf.portnum.direction == PF_PN_PORT_SOURCE)
+            {
+                strcat(http_str_builder, "\tDirection = Source Port\n");
+            }
+            else
+            {
+                strcat(http_str_builder, "\tDirection = Destination Port\n");
+            }
+
+            break;
+
+        case CY_PF_OL_FEAT_ETHTYPE:
+            strcat(http_str_builder, "[Eth Type]:\n");
+            memset(build_str, '\0', build_str_len);
+            sprintf(build_str, "\tPacket Type = 0x%x,\n", cfg->u.eth.eth_type);
+            strcat(http_str_builder, build_str);
+
+            /* Packet filter type - Keep or Discard packet */
+            if (cfg->bits & CY_PF_ACTION_DISCARD)
+            {
+                strcat(http_str_builder, "\tAction = Discard\n");
+            }
+            else
+            {
+                strcat(http_str_builder, "\tAction = Keep\n");
+            }
+
+            break;
+
+        case CY_PF_OL_FEAT_IPTYPE:
+            strcat(http_str_builder, "[IP Type]:\n");
+            memset(build_str, '\0', build_str_len);
+            sprintf(build_str, "\tPacket Type = 0x%x,\n", cfg->u.ip.ip_type);
+            strcat(http_str_builder, build_str);
+            if (ipv6->flags & PF_IPV6_NEXT_HEADER)
+            {
+                strcat(http_str_builder, "\tIP Version = 6,\n");
+            }
+            if (ipv6->flags & PF_IPV6_ICMP6_TYPE)
+            {
+                sprintf(build_str, "\tICMPv6 Type = %u,\n", ipv6->icmp6_type);
+                strcat(http_str_builder, build_str);
+            }
+
+            /* Packet filter type - Keep or Discard packet */
+            if (cfg->bits & CY_PF_ACTION_DISCARD)
+            {
+                strcat(http_str_builder, "\tAction = Discard\n");
+            }
+            else
+            {
+                strcat(http_str_builder, "\tAction = Keep\n");
+            }
+
+            break;
+        default:
+            ERR_INFO(("Unknown feature: %d\n", cfg->feature));
+            break;
+    }
+
+    /* Filters active in both host states are listed as before. */
+    switch (cfg->bits & (CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE))
+    {
+        case CY_PF_ACTIVE_SLEEP:
+            strcat(http_str_builder, "\tActive = Host asleep only\n");
+            break;
+        case CY_PF_ACTIVE_WAKE:
+            strcat(http_str_builder, "\tActive = Host awake only\n");
+            break;
+        default:
+            break;
+    }
+    strcat(http_str_builder, "\n");
+}
+
+
+/* [] END OF FILE */
+
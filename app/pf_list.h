@@ -0,0 +1,196 @@
+/******************************************************************************
+ * File Name: pf_list.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations to build and
+ *   edit packet filter lists. The list management depends neither on the
+ *   Wi-Fi interface nor on the offload manager, so that it can be compiled
+ *   and exercised on a host with stand-ins for the LPA types.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_LIST_H
+#define PF_LIST_H
+
+#include <stdint.h>
+#include "cy_result.h"
+#include "cy_lpa_wifi_pf_ol.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/*
+ * This application sets the maximum allowed packet filters to 10
+ * (MAX_FILTERS-1). The maximum number of filters is ultimately dictated
+ * by the free memory available on the Wi-Fi chipset. More memory will allow
+ * more filters.
+ */
+#define MAX_FILTERS                        (11)
+
+/* Packet filter ID length. */
+#define PKT_FILTER_ID_STR_LEN              (2)
+
+/* HTTP data buffer index for packet filter types identity. */
+#define PKT_FILTER_TYPE_ID                 (0)
+#define PKT_FILTER_TYPE_ID_LEN             (2)
+
+/* HTTP data buffer index for Keep or Discard packet identity. */
+#define KEEP_OR_DISCARD_ID                 (1)
+#define KEEP_OR_DISCARD_ID_LEN             (1)
+
+/* HTTP data buffer for TCP or UDP packet identity. */
+#define TCP_OR_UDP_ID                      (2)
+#define TCP_OR_UDP_ID_LEN                  (1)
+
+/* HTTP data buffer index for Source port or Destination port identity. */
+#define SOURCE_OR_DESTINATION_ID           (3)
+#define SOURCE_OR_DESTINATION_ID_LEN       (2)
+
+/* HTTP data buffer index for Port number identity. */
+#define PORT_NUMBER_ID                     (4)
+
+/* HTTP data buffer index for Eth type value. */
+#define ETH_TYPE_VALUE_ID                  (5)
+
+/* HTTP data buffer index for IP type value. */
+#define IP_TYPE_VALUE_ID                   (6)
+
+/* HTTP data buffer index for host classifier source and destination network. */
+#define SOURCE_NET_ID                      (7)
+#define DESTINATION_NET_ID                 (8)
+
+/* HTTP data buffer index for host classifier TCP flags. */
+#define TCP_FLAGS_ID                       (9)
+
+/* HTTP data buffer index for host classifier multicast only identity. */
+#define MULTICAST_ID                       (10)
+#define MULTICAST_ID_LEN                   (1)
+
+/* HTTP data buffer index for host classifier payload prefix. */
+#define PAYLOAD_PREFIX_ID                  (11)
+
+/* HTTP data buffer index for the host states a filter is active in. */
+#define ACTIVE_MODE_ID                     (12)
+#define ACTIVE_MODE_ID_LEN                 (1)
+
+/* HTTP data buffer index for the IP version of an IP type filter. */
+#define IP_VERSION_ID                      (13)
+#define IP_VERSION_ID_LEN                  (1)
+
+/* HTTP data buffer index for the ICMPv6 type of an IPv6 IP type filter. */
+#define ICMP6_TYPE_ID                      (14)
+
+/*
+ * The LPA IP type filter matches the protocol of IPv4 packets only. An IP
+ * type filter on the next header of IPv6 packets, optionally narrowed to one
+ * ICMPv6 type, is left out of the list handed to the LPA and added to the
+ * WLAN device by the IPv6 offload (see pf_ipv6.cpp). The bits of
+ * cy_pf_ol_cfg_t belong to the LPA, so the IPv6 attributes of the filters
+ * are kept beside each list, in a pf_ipv6_attrs_t indexed by filter ID.
+ */
+#define PF_IPV6_NEXT_HEADER                (1u << 0)
+#define PF_IPV6_ICMP6_TYPE                 (1u << 1)
+
+/* Tells whether a filter of a list is an IPv6 IP type filter. */
+#define PF_IS_IPV6(cfg, ipv6)              (0 != (pf_list_ipv6_attr((ipv6), (cfg))->flags & \
+                                                  PF_IPV6_NEXT_HEADER))
+
+/* IPv6 Ether type and the ICMPv6 next header. */
+#define PF_ETH_TYPE_IPV6                   (0x86DD)
+#define PF_IP_PROTO_ICMPV6                 (58)
+
+/* Maximum value of TCP or UDP port number. */
+#define MAX_PORT_NUM                       (65535)
+
+/* Number of filter IDs of a list, one bit each in its ID map. */
+#define PF_LIST_MAX_ID                     (32)
+
+#if (MAX_FILTERS > PF_LIST_MAX_ID)
+#error "MAX_FILTERS exceeds the IDs of the packet filter list ID map"
+#endif
+
+/* Maximum number of HTTP user data in the query string. */
+#define MAX_HTTP_CONFIG_NUMBER             (15)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* IPv6 attributes of an IP type filter, none for an IPv4 filter. */
+typedef struct
+{
+    uint8_t flags;          /* PF_IPV6_NEXT_HEADER and PF_IPV6_ICMP6_TYPE */
+    uint8_t icmp6_type;     /* ICMPv6 type, with PF_IPV6_ICMP6_TYPE       */
+} pf_ipv6_attr_t;
+
+/* IPv6 attributes of the filters of a list, entry n for filter ID n. */
+typedef struct
+{
+    pf_ipv6_attr_t attr[PF_LIST_MAX_ID];
+} pf_ipv6_attrs_t;
+
+/* Packet filter list being edited, terminated with CY_PF_OL_FEAT_LAST. */
+typedef struct
+{
+    cy_pf_ol_cfg_t *first;  /* Start of buffer */
+    cy_pf_ol_cfg_t *cur;    /* Current position in buffer */
+    cy_pf_ol_cfg_t *last;   /* End of buffer */
+    uint32_t id_map;        /* Filter IDs in use, bit n for ID n */
+    pf_ipv6_attrs_t ipv6;   /* IPv6 attributes of the filters */
+} pf_list_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void pf_list_clear(pf_list_t *list);
+cy_rslt_t pf_list_validate(const pf_list_t *list, char *config_str[]);
+cy_rslt_t pf_list_add(pf_list_t *list, char *config_str[]);
+cy_rslt_t pf_list_set(pf_list_t *list, const cy_pf_ol_cfg_t *cfgs,
+                      const pf_ipv6_attrs_t *ipv6, uint8_t count);
+cy_rslt_t pf_list_set_checked(pf_list_t *list, const cy_pf_ol_cfg_t *cfgs,
+                              const pf_ipv6_attrs_t *ipv6, uint8_t count);
+cy_rslt_t pf_list_remove(pf_list_t *list, uint8_t id);
+cy_rslt_t pf_list_remove_last(pf_list_t *list);
+const pf_ipv6_attr_t *pf_list_ipv6_attr(const pf_ipv6_attrs_t *ipv6, const cy_pf_ol_cfg_t *cfg);
+cy_rslt_t pf_parse_filter(char *config_str[], cy_pf_ol_cfg_t *cfg, pf_ipv6_attr_t *ipv6);
+cy_rslt_t parse_number(const char *str, int base, uint32_t max, uint32_t *value);
+void print_filter(const cy_pf_ol_cfg_t *cfg,
+                  const pf_ipv6_attr_t *ipv6,
+                  char *http_str_builder,
+                  char *build_str,
+                  int build_str_len);
+
+#endif /* #ifndef PF_LIST_H */
+
+
+/* [] END OF FILE */
+
@@ -44,23 +44,18 @@
 #include "WhdOlmInterface.h"
 #include "pf_olm_config.h"
 #include "http_webserver_config.h"
+#include "host_classifier.h"
+#include "pf_commit_worker.h"
+#include "pf_ipv6.h"
+#include "arp_offload.h"
+#include "tko_offload.h"
+#include "pf_snapshot.h"
 
 /******************************************************************************
  *                               EXTERNS
  *****************************************************************************/
 extern WhdSTAInterface *wifi;
 
-/******************************************************************************
- *                                ENUMS
- *****************************************************************************/
-/* Index to packet filter types for identity. */
-enum filter_type
-{
-    PF = 1, /*  Port filter */
-    ET,     /*  Eth filter  */
-    IT      /*  IP filter   */
-};
-
 /******************************************************************************
  *                           GLOBAL VARIABLES
  *****************************************************************************/
@@ -76,24 +71,49 @@ cy_pf_ol_cfg_t pong_tmp_cfgs[MAX_FILTERS];
  * Define the ping-pong buffers. The application will modify the list which is
  * not currently used by the OLM.
  */
-struct ping_pong_t
-{
-    cy_pf_ol_cfg_t *first;  /* Start of buffer */
-    cy_pf_ol_cfg_t *cur;    /* Current position in buffer */
-    cy_pf_ol_cfg_t *last;   /* End of buffer */
-} pongbufs[2] = {
-    { &ping_tmp_cfgs[0], &ping_tmp_cfgs[0], &ping_tmp_cfgs[MAX_FILTERS - 1] },
-    { &pong_tmp_cfgs[0], &pong_tmp_cfgs[0], &pong_tmp_cfgs[MAX_FILTERS - 1] }
+pf_list_t pongbufs[2] = {
+    { &ping_tmp_cfgs[0], &ping_tmp_cfgs[0], &ping_tmp_cfgs[MAX_FILTERS - 1], 0, {} },
+    { &pong_tmp_cfgs[0], &pong_tmp_cfgs[0], &pong_tmp_cfgs[MAX_FILTERS - 1], 0, {} }
 };
 
+/* List committed by pf_commit_cfgs(), which leaves the pending list alone. */
+static cy_pf_ol_cfg_t direct_cfgs[MAX_FILTERS];
+static pf_ipv6_attrs_t direct_ipv6;
+
 cy_pf_ol_cfg_t *downloaded = (cy_pf_ol_cfg_t *)((ol_desc_t *)get_default_ol_list())->cfg;
 
+/* IPv6 attributes of the filters of the active list, by filter ID. NULL for
+ * the default list, which has no IPv6 filters.
+ */
+static const pf_ipv6_attrs_t *downloaded_ipv6 = NULL;
+
+/* List handed to the LPA packet filter offload: the active list without
+ * its IPv6 IP type filters. It is rebuilt while the offloads are stopped.
+ */
+static cy_pf_ol_cfg_t olm_cfgs[MAX_FILTERS];
+
 /* OLM configuration that holds the reference to the packet filter
- * configuration and callback functions.
+ * configuration and callback functions. The packet filter entry must stay
+ * first, its configuration is replaced on each commit. The IPv6 entry
+ * follows it to add the IPv6 filters.
  */
 static pf_ol_t pf_ctxt;
+static pf_ipv6_ol_t ipv6_ctxt;
+#if MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+static arp_ol_t arp_ctxt;
+#endif
+#if MBED_CONF_APP_TKO_ENABLE
+static tko_ol_t tko_ctxt;
+#endif
 ol_desc_t new_olm_list[] = {
     { "Pkt_Filter", downloaded, &pf_ol_fns, &pf_ctxt },
+    { "PF_IPv6", NULL, &pf_ipv6_ol_fns, &ipv6_ctxt },
+#if MBED_CONF_APP_ARP_OFFLOAD_ENABLE
+    { "ARP", &arp_ol_cfg, &arp_ol_fns, &arp_ctxt },
+#endif
+#if MBED_CONF_APP_TKO_ENABLE
+    { "TKO", &tko_ol_cfg, &tko_ol_fns, &tko_ctxt },
+#endif
     { "Last", NULL, NULL, NULL }
 };
 
@@ -101,44 +121,31 @@ ol_desc_t new_olm_list[] = {
 static int cur_pong_idx = 0;
 
 /* Pointer to buffer holding the packet filter configuration */
-static struct ping_pong_t *pong = &pongbufs[cur_pong_idx];
+static pf_list_t *pong = &pongbufs[cur_pong_idx];
+
+/*
+ * Serializes the changes to the lists. The web server, the tiered filter
+ * manager and the storm detector all edit or commit packet filter lists.
+ * A commit holds it only while it swaps the lists, not during the
+ * reassociation, so that the pending list can be edited meanwhile.
+ */
+static Mutex pf_list_mutex;
+
+/*
+ * Serializes the commits. It is held for the whole commit and guards the
+ * active list and the OLM configuration, which only the commits change.
+ */
+static Mutex pf_commit_mutex;
+
+/* The active list is the default list of the device configurator. */
+static bool active_is_default = true;
+
+/* Number of packet filter lists committed to the WLAN device. */
+static volatile uint32_t commit_count = 0;
 
 /******************************************************************************
  *                         FUNCTION DEFINITIONS
  *****************************************************************************/
-/******************************************************************************
- * Function Name: hash_function
- ******************************************************************************
- * Summary:
- *   This function returns a enum value based on the config string passed.
- *   Packet Filter(PF) = 1; Eth Type(ET) = 2; IP Type(IT) = 3.
- *
- * Parameters:
- *   str: A string value from HTTP data.
- *
- * Return:
- *   int: Returns a valid enum value (1 - 3) from packet filter types if the
- *     HTTP configuration matches. Otherwise, it returns 0.
- *
- *****************************************************************************/
-static int hash_function(char *str)
-{
-    if (!strncmp(str, "PF", PKT_FILTER_ID_STR_LEN))
-    {
-        return PF;
-    }
-    if (!strncmp(str, "ET", PKT_FILTER_ID_STR_LEN))
-    {
-        return ET;
-    }
-    if (!strncmp(str, "IT", PKT_FILTER_ID_STR_LEN))
-    {
-        return IT;
-    }
-
-    return 0;
-}
-
 /******************************************************************************
  * Function Name: ping_pong
  *******************************************************************************
@@ -160,220 +167,124 @@ static int hash_function(char *str)
 static void ping_pong(void)
 {
     downloaded = pong->first;
+    downloaded_ipv6 = &pong->ipv6;
 
     /* Switch to other buffer */
     cur_pong_idx = !cur_pong_idx;
     pong = &pongbufs[cur_pong_idx];
 
     /* Clear out new buffer and reset cur pointer to begining */
-    memset(pong->first, 0, sizeof(ping_tmp_cfgs) );
-    pong->cur = pong->first;
+    pf_list_clear(pong);
 
 }
 
 /******************************************************************************
- * Function Name: check_filter_type
+ * Function Name: get_max_filter
  ******************************************************************************
  * Summary:
- *   This function checks an error scenario. As per the application design,
- *   only Keep or only Discard packet filters are allowed. The combination of
- *   Keep and Discard filter does not make any sense and the filter will not
- *   get added to the pending list. Also, adding multiple discard filter is not
- *   supported. The number of discard filters that can be added to pending list
- *   is limited to 1. This is a retriction from WLAN firmware as per its design.
+ *   This function returns integer (MAX_FILTERS-1). The last entry in packet
+ *   filter configuration is reserved for a NULL entry. This function is used
+ *   to check if maximum entry limit has reached before adding new entry.
  *
  * Parameters:
- *   config_str[]: Pointer to filter data. The filter data comes from HTTP
- *     web page as a string and this variable is used to hold pointer to it.
+ *   None
  *
  * Return:
- *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
- *     whether the filter is a valid one or not.
+ *   uint16_t: Returns (MAX_FILTERS-1).
+ *
  *****************************************************************************/
-static cy_rslt_t check_filter_type(char *config_str[])
+uint16_t get_max_filter(void)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    /* 
-     * Only one discard packet filter is supported by the WLAN.
-     * And, no more configuration is allowed when the discard filter
-     * is present.
-     */
-    if (pong->first->bits & CY_PF_ACTION_DISCARD)
-    {
-        ERR_INFO(("No further configuration is allowed since the list "
-                  "contains a discard filter. Note that only one discard "
-                  "packet filter is allowed\n"));
-        return CY_RSLT_TYPE_ERROR;
-    }
-
-    /* Allow only Keep or only Discard packet filter */
-    if (pong->first->feature != 0 &&
-        pong->first->feature != CY_PF_OL_FEAT_LAST)
-    {
-        if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
-                       "K", KEEP_OR_DISCARD_ID_LEN))
-        {
-            if (pong->first->bits & CY_PF_ACTION_DISCARD)
-            {
-                result = CY_RSLT_TYPE_ERROR;
-            }
-        }
-        else
-        {
-            if (!(pong->first->bits & CY_PF_ACTION_DISCARD))
-            {
-                result = CY_RSLT_TYPE_ERROR;
-            }
-        }
-    }
-
-    return result;
+    return (MAX_FILTERS-1);
 }
 
 /******************************************************************************
- * Function Name: validate_filter_before_add
- *******************************************************************************
+ * Function Name: pf_get_commit_count
+ ******************************************************************************
  * Summary:
- *   This function is used to check if the new filter about to get added in the
- *   pending filter list differs from all the existing filters present in the
- *   pending list. This ensures uniqueness of the filter getting added to the
- *   pending filter list and hence avoids duplicate filters in the list.
+ *   This function returns the number of packet filter lists committed to the
+ *   WLAN device. A module which committed a list can tell from it whether
+ *   the list was replaced since.
  *
  * Parameters:
- *   config_str[]: Pointer to filter data. The filter data comes from HTTP
- *     web page as a string and this variable is used to hold pointer to it.
+ *   None
  *
  * Return:
- *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
- *     whether the filter is not a duplicate one.
- ******************************************************************************/
-static cy_rslt_t validate_filter_before_add(char *config_str[])
+ *   uint32_t: Number of commits since boot.
+ *
+ *****************************************************************************/
+uint32_t pf_get_commit_count(void)
 {
-    int already_exists = 0;
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    /* Check for unique filter action type. It can be only Keep or only
-     * Discard filter type. Combination of Keep and Discard filters are not
-     * allowed.
-     */
-    result = check_filter_type(config_str);
-
-    if (CY_RSLT_SUCCESS != result)
-    {
-        ERR_INFO(("Either only keep or only discard filters are allowed\n"));
-        return result;
-    }
-
-    /* Check if the filter already exists */
-    for (cy_pf_ol_cfg_t *cfg = pong->first; cfg < pong->cur; cfg++)
-    {
-        if (cfg->feature != hash_function(config_str[PKT_FILTER_TYPE_ID]))
-        {
-            continue;
-        }
-        switch (cfg->feature)
-        {
-            case CY_PF_OL_FEAT_PORTNUM:
-              if (cfg->u.pf.portnum.portnum != atoi(config_str[PORT_NUMBER_ID]))
-              {
-                  continue;
-              }
-              else
-              {
-                  if (!strncmp(config_str[SOURCE_OR_DESTINATION_ID],
-                               "SP", SOURCE_OR_DESTINATION_ID_LEN) &&
-                      (cfg->u.pf.portnum.direction != PF_PN_PORT_SOURCE))
-                  {
-                      continue;
-                  }
-                  else if (!strncmp(config_str[SOURCE_OR_DESTINATION_ID],
-                               "DP", SOURCE_OR_DESTINATION_ID_LEN) &&
-                           (cfg->u.pf.portnum.direction != PF_PN_PORT_DEST))
-                  {
-                      continue;
-                  }
-
-                  if (!strncmp(config_str[TCP_OR_UDP_ID],
-                               "T", TCP_OR_UDP_ID_LEN) &&
-                      (cfg->u.pf.proto != CY_PF_PROTOCOL_TCP))
-                  {
-                      continue;
-                  }
-                  else if (!strncmp(config_str[TCP_OR_UDP_ID],
-                               "U", TCP_OR_UDP_ID_LEN) &&
-                           (cfg->u.pf.proto != CY_PF_PROTOCOL_UDP))
-                  {
-                      continue;
-                  }
-              }
-              break;
-            case CY_PF_OL_FEAT_ETHTYPE:
-              if (pong->cur->u.eth.eth_type != (uint16_t)strtol(config_str[ETH_TYPE_VALUE_ID], NULL, 16))
-              {
-                  continue;
-              }
-              break;
-            case CY_PF_OL_FEAT_IPTYPE:
-              if (pong->cur->u.ip.ip_type != (uint8_t)atoi(config_str[IP_TYPE_VALUE_ID]))
-              {
-                  continue;
-              }
-              break;
-            default:
-              ERR_INFO(("Unsupported feature type: %d\n", cfg->feature));
-              break;
-        }
-
-        /* Found duplicate entry */
-        already_exists = 1;
-        break;
-    }
-
-    if (already_exists)
-    {
-        result = CY_RSLT_TYPE_ERROR;
-    }
+    return commit_count;
+}
 
-    return result;
+/******************************************************************************
+ * Function Name: publish_pending
+ ******************************************************************************
+ * Summary:
+ *   This function publishes the pending packet filter list to the readers
+ *   of the snapshots. Called with the list mutex held after each change.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void publish_pending(void)
+{
+    pf_snapshot_publish(PF_SNAPSHOT_PENDING, pong->first, &pong->ipv6,
+                        (uint8_t)(pong->cur - pong->first), false);
 }
 
 /******************************************************************************
- * Function Name: get_max_filter
+ * Function Name: publish_active
  ******************************************************************************
  * Summary:
- *   This function returns integer (MAX_FILTERS-1). The last entry in packet
- *   filter configuration is reserved for a NULL entry. This function is used
- *   to check if maximum entry limit has reached before adding new entry.
+ *   This function publishes the packet filter list in use by the OLM to the
+ *   readers of the snapshots. Called with the list mutex held after each
+ *   commit.
  *
  * Parameters:
  *   None
  *
  * Return:
- *   uint16_t: Returns (MAX_FILTERS-1).
+ *   void
  *
  *****************************************************************************/
-uint16_t get_max_filter(void)
+static void publish_active(void)
 {
-    return (MAX_FILTERS-1);
+    uint8_t count = 0;
+
+    while ((count < (MAX_FILTERS - 1)) && (CY_PF_OL_FEAT_LAST != downloaded[count].feature))
+    {
+        count++;
+    }
+    pf_snapshot_publish(PF_SNAPSHOT_ACTIVE, downloaded, downloaded_ipv6, count,
+                        active_is_default);
 }
 
 /******************************************************************************
- * Function Name: get_pending_filter_list
+ * Function Name: pf_publish_lists
  ******************************************************************************
  * Summary:
- *   This function returns the pointer to pending packet filter list.
+ *   This function publishes both packet filter lists to the readers of the
+ *   snapshots. The later changes are published by the functions making them.
  *
  * Parameters:
  *   None
  *
  * Return:
- *   cy_pf_ol_cfg_t*: Pointer to pending packet filter configuration.
+ *   void
  *
  *****************************************************************************/
-cy_pf_ol_cfg_t *get_pending_filter_list(void)
+void pf_publish_lists(void)
 {
-    return pong->first;
+    ScopedMutexLock lock(pf_list_mutex);
+
+    publish_active();
+    publish_pending();
 }
 
 /******************************************************************************
@@ -395,187 +306,156 @@ cy_pf_ol_cfg_t *get_pending_filter_list(void)
  *****************************************************************************/
 void add_minimum_filters(void)
 {
-    int8_t tmp_id = 0;
-    int8_t *entry_id;
+    uint8_t count = 0;
+    ScopedMutexLock lock(pf_list_mutex);
 
     cy_pf_ol_cfg_t *default_filters = (cy_pf_ol_cfg_t *)((ol_desc_t *)get_default_ol_list())->cfg;
 
-    /* Copy default packet filters */
-    memcpy(pong->first, default_filters, sizeof(pong_tmp_cfgs));
-    for (pong->cur = pong->first; pong->cur->feature != CY_PF_OL_FEAT_LAST; pong->cur++)
+    /* Copy default packet filters with their IDs */
+    while ((count < (MAX_FILTERS - 1)) && (CY_PF_OL_FEAT_LAST != default_filters[count].feature))
     {
-         tmp_id = pong->cur->id+1;
+        count++;
     }
+    pf_list_set(pong, default_filters, NULL, count);
+    publish_pending();
+}
 
-    entry_id = get_entry_id();
-    *entry_id = tmp_id;
+/******************************************************************************
+ * Function Name: pf_stage_list
+ ******************************************************************************
+ * Summary:
+ *   This function replaces the pending packet filter list with the given
+ *   filters. It is used by the modules which build a packet filter list on
+ *   their own. As for the filters added from the web page, the list is
+ *   applied to the WLAN device only by pf_commit_list().
+ *
+ * Parameters:
+ *   cfgs: Array of packet filter configurations.
+ *   ipv6: IPv6 attributes of the filters by their ID, NULL if none.
+ *   count: Number of packet filter configurations in the array.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the list does
+ *     not fit in the pending buffer.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_stage_list(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                        uint8_t count)
+{
+    cy_rslt_t result;
+    ScopedMutexLock lock(pf_list_mutex);
+
+    result = pf_list_set(pong, cfgs, ipv6, count);
+    publish_pending();
+
+    return result;
 }
 
 /******************************************************************************
- * Function Name: remove_last_added_filter
+ * Function Name: pf_activate_list
  ******************************************************************************
  * Summary:
- *   This function deletes the last added filter from the pending packet filter
- *   list. Note that, the pending packet filter list is a draft list and it
- *   will get applied to the WLAN device only when Apply Filters option is
- *   clicked.
+ *   This function makes the pending list the active list of OLM without
+ *   reassociating to the AP. It is only valid while the Wi-Fi interface is
+ *   disconnected, such as at boot before the first connect: the list is then
+ *   offloaded by the next connect.
  *
  * Parameters:
- *   None.
+ *   restore_to_default: If TRUE, it will activate the default packet filter
+ *     configuration as selected in device configurator. If FALSE, it will
+ *     activate the pending list.
  *
  * Return:
- *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
- *     whether the entry has been removed successfully or not.
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the Wi-Fi
+ *     interface is connected.
  *
  *****************************************************************************/
-cy_rslt_t remove_last_added_filter(void)
+cy_rslt_t pf_activate_list(bool restore_to_default)
 {
-    cy_pf_ol_cfg_t *cfg = NULL;
-    cy_pf_ol_cfg_t *filter_to_remove = NULL;
-    int8_t *entry_id;
+    ScopedMutexLock commit_lock(pf_commit_mutex);
+    ScopedMutexLock lock(pf_list_mutex);
 
-    /* Check for empty and proceed */
-    if (pong->first->feature == 0 || pong->first->feature == CY_PF_OL_FEAT_LAST)
+    if ((NULL == wifi) || (NSAPI_STATUS_DISCONNECTED != wifi->get_connection_status()))
     {
-        ERR_INFO(("Attempt to remove NULL entry. Exit.\n"));
+        ERR_INFO(("The packet filter list can only be activated while disconnected.\n"));
         return CY_RSLT_TYPE_ERROR;
     }
 
-    /* Go to last entry to remove */
-    for (cfg = pong->first; cfg->feature != CY_PF_OL_FEAT_LAST; cfg++)
-    {
-        filter_to_remove = cfg;
-    }
-
-    /* Mark the entry with CY_PF_OL_FEAT_LAST flag */
-    memset(filter_to_remove, 0, sizeof(cy_pf_ol_cfg_t)*2);
-    pong->cur = filter_to_remove;
+    /* Terminate list with FEAT_LAST */
     pong->cur->feature = CY_PF_OL_FEAT_LAST;
 
-    /* Decrement entry id to be created next as we removed one */
-    entry_id = get_entry_id();
-    if (*entry_id)
+    ping_pong();
+    commit_count++;
+    if (restore_to_default)
     {
-        *entry_id = *entry_id - 1;
+        downloaded = (cy_pf_ol_cfg_t *)((ol_desc_t *)get_default_ol_list())->cfg;
+        downloaded_ipv6 = NULL;
     }
+    active_is_default = restore_to_default;
+    publish_active();
+    publish_pending();
+
+    pf_ipv6_lpa_list(downloaded, downloaded_ipv6, olm_cfgs);
+    new_olm_list[0].cfg = olm_cfgs;
+    cylpa_restart_olm(new_olm_list, wifi);
 
     return CY_RSLT_SUCCESS;
 }
 
 /******************************************************************************
- * Function Name: print_filter
+ * Function Name: remove_last_added_filter
+ ******************************************************************************
+ * Summary:
+ *   This function deletes the last added filter from the pending packet filter
+ *   list. Note that, the pending packet filter list is a draft list and it
+ *   will get applied to the WLAN device only when Apply Filters option is
+ *   clicked.
+ *
+ * Parameters:
+ *   None.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR indicating
+ *     whether the entry has been removed successfully or not.
+ *
+ *****************************************************************************/
+cy_rslt_t remove_last_added_filter(void)
+{
+    cy_rslt_t result;
+    ScopedMutexLock lock(pf_list_mutex);
+
+    result = pf_list_remove_last(pong);
+    publish_pending();
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: pf_remove_filter
  ******************************************************************************
  * Summary:
- *   This function builds a string output from the packet filter configuration
- *   in user readable way. The string output can be directly printed out.
+ *   This function deletes the filter with the given ID from the pending
+ *   packet filter list. The following filters move down in place and keep
+ *   their IDs; the ID is reused by the next filter added. As for the other
+ *   changes, the list is applied only by Apply Filters.
  *
  * Parameters:
- *   cfg: Pointer to packet filter configuration.
- *   http_str_builder: Pointer to HTTP response string to be sent to the server.
- *   build_str: Helper variable to Buffer for storing the formatted string from
- *              this function.
- *   build_str_len: Buffer size.
+ *   id: ID of the filter to delete.
  *
  * Return:
- *   void.
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if no pending
+ *     filter has the ID.
  *
  *****************************************************************************/
-void print_filter(cy_pf_ol_cfg_t *cfg,
-                  char *http_str_builder,
-                  char *build_str,
-                  int build_str_len)
+cy_rslt_t pf_remove_filter(uint8_t id)
 {
-    if (!cfg->feature)
-    {
-        return;
-    }
+    cy_rslt_t result;
+    ScopedMutexLock lock(pf_list_mutex);
 
-    sprintf(build_str, "ID %d", cfg->id);
-    strcat(http_str_builder, build_str);
-    switch (cfg->feature)
-    {
-        case CY_PF_OL_FEAT_PORTNUM:
-            strcat(http_str_builder, "[Port Filter]:\n");
-            memset(build_str, '\0', build_str_len);
-            sprintf(build_str, "\tPort = %d,\n", cfg->u.pf.portnum.portnum);
-            strcat(http_str_builder, build_str);
-
-            /* Packet filter type - Keep or Discard packet */
-            if (cfg->bits & CY_PF_ACTION_DISCARD)
-            {
-                strcat(http_str_builder, "\tAction = Discard,\n");
-            }
-            else
-            {
-                strcat(http_str_builder, "\tAction = Keep,\n");
-            }
-
-            /* Protocol TCP or UDP */
-            switch (cfg->u.pf.proto)
-            {
-                case CY_PF_PROTOCOL_TCP:
-                    strcat(http_str_builder, "\tProtocol = TCP,\n");
-                    break;
-                case CY_PF_PROTOCOL_UDP:
-                    strcat(http_str_builder, "\tProtocol = UDP,\n");
-                    break;
-                default:
-                    ERR_INFO(("Unknown IP Protocol used with Port Numbers: %d\n", cfg->u.pf.proto));
-                    break;
-            }
-
-            /* Packet direction - Source or Destination port */
-            if (cfg->u.pf.portnum.direction == PF_PN_PORT_SOURCE)
-            {
-                strcat(http_str_builder, "\tDirection = Source Port\n");
-            }
-            else
-            {
-                strcat(http_str_builder, "\tDirection = Destination Port\n");
-            }
-
-            break;
-
-        case CY_PF_OL_FEAT_ETHTYPE:
-            strcat(http_str_builder, "[Eth Type]:\n");
-            memset(build_str, '\0', build_str_len);
-            sprintf(build_str, "\tPacket Type = 0x%x,\n", cfg->u.eth.eth_type);
-            strcat(http_str_builder, build_str);
-
-            /* Packet filter type - Keep or Discard packet */
-            if (cfg->bits & CY_PF_ACTION_DISCARD)
-            {
-                strcat(http_str_builder, "\tAction = Discard\n");
-            }
-            else
-            {
-                strcat(http_str_builder, "\tAction = Keep\n");
-            }
-
-            break;
-
-        case CY_PF_OL_FEAT_IPTYPE:
-            strcat(http_str_builder, "[IP Type]:\n");
-            memset(build_str, '\0', build_str_len);
-            sprintf(build_str, "\tPacket Type = 0x%x,\n", cfg->u.ip.ip_type);
-            strcat(http_str_builder, build_str);
-
-            /* Packet filter type - Keep or Discard packet */
-            if (cfg->bits & CY_PF_ACTION_DISCARD)
-            {
-                strcat(http_str_builder, "\tAction = Discard\n");
-            }
-            else
-            {
-                strcat(http_str_builder, "\tAction = Keep\n");
-            }
-
-            break;
-        default:
-            ERR_INFO(("Unknown feature: %d\n", cfg->feature));
-            break;
-    }
-    strcat(http_str_builder, "\n");
+    result = pf_list_remove(pong, id);
+    publish_pending();
+
+    return result;
 }
 
 /******************************************************************************
@@ -584,160 +464,195 @@ void print_filter(cy_pf_ol_cfg_t *cfg,
  * Summary:
  *   This function adds a new packet filter configuration from HTTP server to
  *   the pending filter list. It checks for valid packet filter and adds to the
- *   list only if all the conditions are satisfied.
+ *   list only if all the conditions are satisfied. The filter gets the
+ *   lowest free ID of the list.
+ *
+ * Parameters:
+ *   config_str[]: Pointer to filter data. The filter data comes from HTTP
+ *     server as a string and this variable is used to hold pointer to it.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_add_to_list(char *config_str[])
+{
+    cy_rslt_t result;
+    ScopedMutexLock lock(pf_list_mutex);
+
+    result = pf_list_add(pong, config_str);
+    publish_pending();
+
+    return result;
+}
+
+/******************************************************************************
+ * Function Name: hc_add_to_list
+ ******************************************************************************
+ * Summary:
+ *   This function adds a new host classifier rule from HTTP server to the
+ *   host classifier. Unlike the packet filters, the rule takes effect
+ *   immediately as the classifier runs on the host; no reassociation to the
+ *   AP is needed. Empty fields of the HTTP data match any packet.
  *
  * Parameters:
  *   config_str[]: Pointer to filter data. The filter data comes from HTTP
  *     server as a string and this variable is used to hold pointer to it.
- *   id: This is the index number for that particular packet filter entry.
- *     Each entry in the packet filter list has unique ID assigned.
  *
  * Return:
  *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
  *
  *****************************************************************************/
-cy_rslt_t pf_add_to_list(char *config_str[], uint8_t id)
+cy_rslt_t hc_add_to_list(char *config_str[])
 {
-    /* Verify there is room left for the FEATURE_LAST at the end. */
-    if (pong->cur >= pong->last)
+    hc_rule_t rule;
+    uint32_t ip_proto = 0;
+
+    if ((NULL == config_str[PKT_FILTER_TYPE_ID]) ||
+        strncmp(config_str[PKT_FILTER_TYPE_ID], "HC", PKT_FILTER_ID_STR_LEN))
     {
-        ERR_INFO(("Max number of entries %d.\n", MAX_FILTERS - 1));
         return CY_RSLT_TYPE_ERROR;
     }
 
-   /* Validate filter before adding to pending list. */
-    if (CY_RSLT_SUCCESS != validate_filter_before_add(config_str))
+    memset(&rule, 0, sizeof(rule));
+    rule.id = host_classifier_get_rule_count();
+
+    /* Keep or Discard packet */
+    if ((NULL != config_str[KEEP_OR_DISCARD_ID]) &&
+        strncmp(config_str[KEEP_OR_DISCARD_ID], "K", KEEP_OR_DISCARD_ID_LEN))
     {
-        return CY_RSLT_TYPE_ERROR;
+        rule.action = HC_ACTION_DROP;
     }
 
-    /* Update current buffer index. */
-    pong->cur->id = id;
+    if (NULL != config_str[SOURCE_NET_ID])
+    {
+        if (CY_RSLT_SUCCESS != hc_parse_net(config_str[SOURCE_NET_ID],
+                                            &rule.src_ip, &rule.src_mask))
+        {
+            ERR_INFO(("Invalid source network: %s\n", config_str[SOURCE_NET_ID]));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        rule.match |= HC_MATCH_SRC_NET;
+    }
 
-    /* Setup minimum required defaults. */
-    for (cy_pf_ol_cfg_t *cfg = pong->first; cfg < pong->cur; cfg++)
+    if (NULL != config_str[DESTINATION_NET_ID])
     {
-        if (cfg->id == id)
+        if (CY_RSLT_SUCCESS != hc_parse_net(config_str[DESTINATION_NET_ID],
+                                            &rule.dst_ip, &rule.dst_mask))
         {
-            ERR_INFO(("Filter id %d already in pending list\n", cfg->id));
-            pong->cur->id = pong->cur->id+1;
-            break;
+            ERR_INFO(("Invalid destination network: %s\n", config_str[DESTINATION_NET_ID]));
+            return CY_RSLT_TYPE_ERROR;
         }
+        rule.match |= HC_MATCH_DST_NET;
     }
 
-    pong->cur->bits |= CY_PF_ACTIVE_SLEEP;
-    pong->cur->bits |= CY_PF_ACTIVE_WAKE;
+    /* The IP protocol field is left to "0x" when not used. */
+    if ((NULL != config_str[IP_TYPE_VALUE_ID]) &&
+        strcmp(config_str[IP_TYPE_VALUE_ID], "0x"))
+    {
+        if (CY_RSLT_SUCCESS != parse_number(config_str[IP_TYPE_VALUE_ID], 0,
+                                            0xFF, &ip_proto))
+        {
+            ERR_INFO(("Invalid IP protocol (%s).  Range is 1 - 255\n",
+                      config_str[IP_TYPE_VALUE_ID]));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        if (ip_proto)
+        {
+            rule.ip_proto = (uint8_t)ip_proto;
+            rule.match |= HC_MATCH_IP_PROTO;
+        }
+    }
 
-    switch(hash_function(config_str[PKT_FILTER_TYPE_ID]))
+    if (NULL != config_str[TCP_FLAGS_ID])
     {
-        case PF: //Port Filter
-             uint32_t port_num;
-             pong->cur->feature = CY_PF_OL_FEAT_PORTNUM;
-             pong->cur->u.pf.portnum.range = 0;
-             port_num = atoi(config_str[PORT_NUMBER_ID]);
-
-             if (MAX_PORT_NUM < port_num)
-             {
-                 ERR_INFO(("Invalid port number (%lu). Valid range is 0-65535.\n",
-                              (unsigned long)port_num));
-                 memset(pong->cur, 0, sizeof(cy_pf_ol_cfg_t));
-                 return CY_RSLT_TYPE_ERROR;
-             }
-
-             pong->cur->u.pf.portnum.portnum = (port_num & 0xFFFF);
-
-             //Keep or Discard packet
-             if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
-                          "K", KEEP_OR_DISCARD_ID_LEN))
-             {
-                 pong->cur->bits &= ~CY_PF_ACTION_DISCARD;
-             }
-             else
-             {
-                 pong->cur->bits |= CY_PF_ACTION_DISCARD;
-             }
-             //Source or Destination port
-             if (!strncmp(config_str[SOURCE_OR_DESTINATION_ID],
-                          "SP", SOURCE_OR_DESTINATION_ID_LEN))
-             {
-                 pong->cur->u.pf.portnum.direction = PF_PN_PORT_SOURCE;
-             }
-             else
-             {
-                 pong->cur->u.pf.portnum.direction = PF_PN_PORT_DEST;
-             }
-             //Protocol type
-             if (!strncmp(config_str[TCP_OR_UDP_ID],
-                          "T", TCP_OR_UDP_ID_LEN))
-             {
-                 pong->cur->u.pf.proto = CY_PF_PROTOCOL_TCP;
-             }
-             else
-             {
-                 pong->cur->u.pf.proto = CY_PF_PROTOCOL_UDP;
-             }
-             break;
-        case ET: //Ether type Filter
-             uint32_t eth_type;
-             pong->cur->feature = CY_PF_OL_FEAT_ETHTYPE;
-             eth_type = strtol(config_str[ETH_TYPE_VALUE_ID], NULL, 0);
-
-             if (!eth_type || (eth_type & ~0xFFFF) || (eth_type < 0x800))
-             {
-                 ERR_INFO(("Invalid eth type (0x%lx).  Range is 0x800 - 0xFFFF\n",
-                            (unsigned long)eth_type));
-                 memset(pong->cur, 0, sizeof(cy_pf_ol_cfg_t));
-                 return CY_RSLT_TYPE_ERROR;
-             }
-             pong->cur->u.eth.eth_type = (eth_type & 0xFFFF);
-
-             //Keep or Discard packet
-             if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
-                          "K", KEEP_OR_DISCARD_ID_LEN))
-             {
-                 pong->cur->bits &= ~CY_PF_ACTION_DISCARD;
-             }
-             else
-             {
-                 pong->cur->bits |= CY_PF_ACTION_DISCARD;
-             }
-             break;
-        case IT: //IP type filter
-             uint32_t ip_proto;
-             pong->cur->feature = CY_PF_OL_FEAT_IPTYPE;
-             ip_proto = strtoul(config_str[IP_TYPE_VALUE_ID], NULL, 0);
-
-             if (!ip_proto || ip_proto & ~0xFF)
-             {
-                 ERR_INFO(("Invalid IP protocol (0x%lx).  Range is 1 - 255\n",
-                           (unsigned long)ip_proto));
-                 memset(pong->cur, 0, sizeof(cy_pf_ol_cfg_t));
-                 return CY_RSLT_TYPE_ERROR;
-             }
-             pong->cur->u.ip.ip_type = (ip_proto & 0xFF);
-
-             //Keep or Discard packet
-             if (!strncmp(config_str[KEEP_OR_DISCARD_ID],
-                          "K", KEEP_OR_DISCARD_ID_LEN))
-             {
-                 pong->cur->bits &= ~CY_PF_ACTION_DISCARD;
-             }
-             else
-             {
-                 pong->cur->bits |= CY_PF_ACTION_DISCARD;
-             }
-             break;
-        default:
-             ERR_INFO(("Unknown Packet Filter Type received\n"));
-             break;
+        if (CY_RSLT_SUCCESS != hc_parse_tcp_flags(config_str[TCP_FLAGS_ID],
+                                                  &rule.tcp_flags_value,
+                                                  &rule.tcp_flags_mask))
+        {
+            ERR_INFO(("Invalid TCP flags: %s\n", config_str[TCP_FLAGS_ID]));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        rule.match |= HC_MATCH_TCP_FLAGS;
     }
 
-    pong->cur++;
-    pong->cur->feature = CY_PF_OL_FEAT_LAST;
+    if ((NULL != config_str[MULTICAST_ID]) &&
+        !strncmp(config_str[MULTICAST_ID], "M", MULTICAST_ID_LEN))
+    {
+        rule.match |= HC_MATCH_MCAST;
+    }
+
+    if (NULL != config_str[PAYLOAD_PREFIX_ID])
+    {
+        if (CY_RSLT_SUCCESS != hc_parse_prefix(config_str[PAYLOAD_PREFIX_ID],
+                                               rule.prefix, &rule.prefix_len))
+        {
+            ERR_INFO(("Invalid payload prefix: %s\n", config_str[PAYLOAD_PREFIX_ID]));
+            return CY_RSLT_TYPE_ERROR;
+        }
+        rule.match |= HC_MATCH_PAYLOAD;
+    }
+
+    if (0 == rule.match)
+    {
+        ERR_INFO(("Host classifier rule matching every packet is not allowed\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (CY_RSLT_SUCCESS != host_classifier_add(&rule))
+    {
+        ERR_INFO(("Max number of host classifier rules %d.\n", HC_MAX_RULES));
+        return CY_RSLT_TYPE_ERROR;
+    }
 
     return CY_RSLT_SUCCESS;
 }
 
+/******************************************************************************
+ * Function Name: pf_restart_offloads
+ ******************************************************************************
+ * Summary:
+ *   This function restarts OLM with the active packet filter list and
+ *   reassociates to the AP. It is the end of a commit, called with the
+ *   commit mutex held once the active list is replaced. The list mutex is
+ *   not held, so that the pending list can be edited meanwhile.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+static cy_rslt_t pf_restart_offloads(void)
+{
+    nsapi_error_t nsapi_err;
+
+    /* Update the new packet filter configuration. */
+    pf_ipv6_lpa_list(downloaded, downloaded_ipv6, olm_cfgs);
+    new_olm_list[0].cfg = olm_cfgs;
+
+    /* Restart OLM to use new packet filter configs. */
+    pf_commit_set_state(PF_COMMIT_RESTARTING_OLM);
+    cylpa_restart_olm(new_olm_list, wifi);
+
+    /* Reassociate to AP. */
+    APP_INFO(("Re-associating to Wi-Fi AP.\n"));
+    pf_commit_set_state(PF_COMMIT_REASSOCIATING);
+    nsapi_err = app_wl_connect(wifi, MBED_CONF_APP_WIFI_SSID, 
+                                 MBED_CONF_APP_WIFI_PASSWORD,
+                                MBED_CONF_APP_WIFI_SECURITY);
+    if (NSAPI_ERROR_OK != nsapi_err)
+    {
+        ERR_INFO(("Assocation Failed: %d\n", nsapi_err));
+        pf_commit_set_state(PF_COMMIT_FAILED);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    pf_commit_set_state(PF_COMMIT_DONE);
+    return CY_RSLT_SUCCESS;
+}
+
 /******************************************************************************
  * Function Name: pf_commit_list
  ******************************************************************************
@@ -750,31 +665,46 @@ cy_rslt_t pf_add_to_list(char *config_str[], uint8_t id)
  *   restore_to_default: If TRUE, it will restore the default packet filter
  *     configuration as selected in device configurator. If FALSE, it will
  *     apply the new packet filter configuration to the WLAN device.
+ *   committed: Array of MAX_FILTERS receiving a copy of the list committed,
+ *     terminated by CY_PF_OL_FEAT_LAST, or NULL. It is taken with the list,
+ *     so a commit of another module cannot come in between.
+ *   committed_ipv6: Receives the IPv6 attributes of the list committed, by
+ *     filter ID, or NULL.
  *
  * Return:
  *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
  *
  *****************************************************************************/
-cy_rslt_t pf_commit_list(bool restore_to_default)
+cy_rslt_t pf_commit_list(bool restore_to_default, cy_pf_ol_cfg_t *committed,
+                         pf_ipv6_attrs_t *committed_ipv6)
 {
-    nsapi_error_t nsapi_err;
+    ScopedMutexLock commit_lock(pf_commit_mutex);
+    bool full = false;
+    uint8_t count = 0;
 
     APP_INFO(("Applying new packet filter list\n"));
 
-    if (pong->cur > pong->last)
+    pf_list_mutex.lock();
+    full = (pong->cur > pong->last);
+    pf_list_mutex.unlock();
+    if (full)
     {
         ERR_INFO(("List is full.\n"));
+        pf_commit_set_state(PF_COMMIT_FAILED);
         return CY_RSLT_TYPE_ERROR;
     }
 
-    /* Terminate list with FEAT_LAST */
-    pong->cur->feature = CY_PF_OL_FEAT_LAST;
-
     /* Wifi disconnect is how we cause an offload deinit. */
+    pf_commit_set_state(PF_COMMIT_DISCONNECTING);
     app_wl_disconnect(wifi);
 
-    /* Switch to fresh new buffer so we don't disturb the olm controlled buffer */
+    /* The pending list is taken as it is now. Switch to fresh new buffer so
+     * we don't disturb the olm controlled buffer.
+     */
+    pf_list_mutex.lock();
+    pong->cur->feature = CY_PF_OL_FEAT_LAST;
     ping_pong();
+    commit_count++;
 
     /* Restore to default packet filter configuration defined
      * by the device configurator.
@@ -782,26 +712,99 @@ cy_rslt_t pf_commit_list(bool restore_to_default)
     if (restore_to_default)
     {
         downloaded = (cy_pf_ol_cfg_t *)((ol_desc_t *)get_default_ol_list())->cfg;
+        downloaded_ipv6 = NULL;
     }
+    active_is_default = restore_to_default;
+    publish_active();
+    publish_pending();
+    if (NULL != committed_ipv6)
+    {
+        memset(committed_ipv6, 0, sizeof(*committed_ipv6));
+        if (NULL != downloaded_ipv6)
+        {
+            *committed_ipv6 = *downloaded_ipv6;
+        }
+    }
+    if (NULL != committed)
+    {
+        memset(committed, 0, MAX_FILTERS * sizeof(cy_pf_ol_cfg_t));
+        while ((count < (MAX_FILTERS - 1)) && (CY_PF_OL_FEAT_LAST != downloaded[count].feature))
+        {
+            committed[count] = downloaded[count];
+            count++;
+        }
+        committed[count].feature = CY_PF_OL_FEAT_LAST;
+    }
+    pf_list_mutex.unlock();
 
-    /* Update the new packet filter configuration. */
-    new_olm_list[0].cfg = downloaded;
+    return pf_restart_offloads();
+}
 
-    /* Restart OLM to use new packet filter configs. */
-    cylpa_restart_olm(new_olm_list, wifi);
+/******************************************************************************
+ * Function Name: pf_commit_cfgs
+ ******************************************************************************
+ * Summary:
+ *   This function applies the given packet filter list to the WLAN device,
+ *   or restores the default list, without touching the pending list. It is
+ *   used by the modules which build a packet filter list on their own, so
+ *   that the filters the user is editing are kept. As for pf_commit_list(),
+ *   the WLAN device disconnects and reconnects to the AP.
+ *
+ * Parameters:
+ *   cfgs: Array of packet filter configurations, NULL to restore the
+ *     default packet filter list.
+ *   ipv6: IPv6 attributes of the filters by their ID, NULL if none.
+ *   count: Number of packet filter configurations in the array.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_commit_cfgs(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                         uint8_t count)
+{
+    ScopedMutexLock commit_lock(pf_commit_mutex);
 
-    /* Reassociate to AP. */
-    APP_INFO(("Re-associating to Wi-Fi AP.\n"));
-    nsapi_err = app_wl_connect(wifi, MBED_CONF_APP_WIFI_SSID, 
-                                 MBED_CONF_APP_WIFI_PASSWORD,
-                                MBED_CONF_APP_WIFI_SECURITY);
-    if (NSAPI_ERROR_OK != nsapi_err)
+    APP_INFO(("Applying new packet filter list\n"));
+
+    if ((NULL != cfgs) && (count > get_max_filter()))
     {
-        ERR_INFO(("Assocation Failed: %d\n", nsapi_err));
+        ERR_INFO(("Max number of filters %d.\n", get_max_filter()));
+        pf_commit_set_state(PF_COMMIT_FAILED);
         return CY_RSLT_TYPE_ERROR;
     }
 
-    return CY_RSLT_SUCCESS;
+    /* Wifi disconnect is how we cause an offload deinit. */
+    pf_commit_set_state(PF_COMMIT_DISCONNECTING);
+    app_wl_disconnect(wifi);
+
+    /* The list is copied only now: the previous one may be in use by the
+     * OLM until the disconnect.
+     */
+    pf_list_mutex.lock();
+    if (NULL != cfgs)
+    {
+        memcpy(direct_cfgs, cfgs, count * sizeof(cy_pf_ol_cfg_t));
+        direct_cfgs[count].feature = CY_PF_OL_FEAT_LAST;
+        memset(&direct_ipv6, 0, sizeof(direct_ipv6));
+        if (NULL != ipv6)
+        {
+            direct_ipv6 = *ipv6;
+        }
+        downloaded = direct_cfgs;
+        downloaded_ipv6 = &direct_ipv6;
+    }
+    else
+    {
+        downloaded = (cy_pf_ol_cfg_t *)((ol_desc_t *)get_default_ol_list())->cfg;
+        downloaded_ipv6 = NULL;
+    }
+    commit_count++;
+    active_is_default = (NULL == cfgs);
+    publish_active();
+    pf_list_mutex.unlock();
+
+    return pf_restart_offloads();
 }
 
 
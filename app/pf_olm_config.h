@@ -40,67 +40,29 @@
 #ifndef PF_OLM_CONFIG_H
 #define PF_OLM_CONFIG_H
 
+#include "WhdSTAInterface.h"
 #include "cy_lpa_wifi_pf_ol.h"
-
-/******************************************************************************
- *                                 MACROS
- *****************************************************************************/
-/*
- * This application sets the maximum allowed packet filters to 10
- * (MAX_FILTERS-1). The maximum number of filters is ultimately dictated
- * by the free memory available on the Wi-Fi chipset. More memory will allow
- * more filters.
- */
-#define MAX_FILTERS                        (11)
-
-/* Packet filter ID length. */
-#define PKT_FILTER_ID_STR_LEN              (2)
-
-/* HTTP data buffer index for packet filter types identity. */
-#define PKT_FILTER_TYPE_ID                 (0)
-#define PKT_FILTER_TYPE_ID_LEN             (2)
-
-/* HTTP data buffer index for Keep or Discard packet identity. */
-#define KEEP_OR_DISCARD_ID                 (1)
-#define KEEP_OR_DISCARD_ID_LEN             (1)
-
-/* HTTP data buffer for TCP or UDP packet identity. */
-#define TCP_OR_UDP_ID                      (2)
-#define TCP_OR_UDP_ID_LEN                  (1)
-
-/* HTTP data buffer index for Source port or Destination port identity. */
-#define SOURCE_OR_DESTINATION_ID           (3)
-#define SOURCE_OR_DESTINATION_ID_LEN       (2)
-
-/* HTTP data buffer index for Port number identity. */
-#define PORT_NUMBER_ID                     (4)
-
-/* HTTP data buffer index for Eth type value. */
-#define ETH_TYPE_VALUE_ID                  (5)
-
-/* HTTP data buffer index for IP type value. */
-#define IP_TYPE_VALUE_ID                   (6)
-
-/* Maximum value of TCP or UDP port number. */
-#define MAX_PORT_NUM                       (65535)
-
-/* Maximum number of HTTP user data in the query string. */
-#define MAX_HTTP_CONFIG_NUMBER             (7)
+#include "pf_list.h"
 
 /******************************************************************************
  *                     FUNCTION DECLARATIONS
  *****************************************************************************/
-cy_pf_ol_cfg_t *get_pending_filter_list(void);
-cy_rslt_t pf_add_to_list(char* config_str[], uint8_t id);
-cy_rslt_t pf_commit_list(bool restore_to_default);
+cy_rslt_t pf_add_to_list(char* config_str[]);
+cy_rslt_t pf_stage_list(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                        uint8_t count);
+cy_rslt_t hc_add_to_list(char* config_str[]);
+cy_rslt_t pf_commit_list(bool restore_to_default, cy_pf_ol_cfg_t *committed,
+                         pf_ipv6_attrs_t *committed_ipv6);
+cy_rslt_t pf_commit_cfgs(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                         uint8_t count);
+cy_rslt_t pf_activate_list(bool restore_to_default);
 cy_rslt_t remove_last_added_filter(void);
+cy_rslt_t pf_remove_filter(uint8_t id);
 uint16_t get_max_filter(void);
+uint32_t pf_get_commit_count(void);
 void add_minimum_filters(void);
+void pf_publish_lists(void);
 void app_wl_disconnect(WhdSTAInterface *wifi);
-void print_filter(cy_pf_ol_cfg_t* cfg,
-                  char* http_str_builder,
-                  char* build_str,
-                  int build_str_len);
 
 #endif /* #ifndef PF_OLM_CONFIG_H */
 
@@ -0,0 +1,61 @@
+/******************************************************************************
+ * File Name: pf_policy.h
+ *
+ * Description:
+ *   This header file contains the default packet filter list of all the
+ *   kits. It is generated by tools/gen_policy.py from policy/wlan_policy.json;
+ *   edit the policy and run the generator rather than this file.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_POLICY_H
+#define PF_POLICY_H
+
+#include "pf_dsl.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Entries of the default packet filter list, in filter ID order. */
+#define PF_POLICY_DEFAULT_FILTERS \
+    /* ARP      */ pf_dsl::keep_ethtype(0x0806), \
+    /* 802.1X   */ pf_dsl::keep_ethtype(0x888E), \
+    /* DHCP     */ pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 68), \
+    /* DNS      */ pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_SOURCE, 53), \
+    /* HTTP     */ pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_DEST, 80)
+
+#endif /* #ifndef PF_POLICY_H */
+
+
+/* [] END OF FILE */
+
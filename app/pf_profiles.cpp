@@ -0,0 +1,262 @@
+/******************************************************************************
+ * File Name: pf_profiles.cpp
+ *
+ * Description:
+ *   This file contains the library of precompiled packet filter profiles.
+ *   The library is placed in the external QSPI flash when the XIP is enabled
+ *   and read in place; only the profile being loaded is expanded into the
+ *   pending packet filter list in RAM.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "pf_profiles.h"
+#include "pf_dsl.h"
+#include "qspi_xip.h"
+#include "http_webserver_config.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Keep filters required by an IPv6 host to keep its addresses and resolve
+ * its neighbors: router advertisements, neighbor solicitations and
+ * advertisements. The MLD queries, needed behind switches snooping MLD, come
+ * with hop-by-hop options.
+ */
+#define PF_PROFILE_KEEP_IPV6_ND                                         \
+    pf_dsl::keep_icmp6(134),                                            \
+    pf_dsl::keep_icmp6(135),                                            \
+    pf_dsl::keep_icmp6(136),                                            \
+    pf_dsl::keep_ip6_next_header(0)
+
+/* Keep filters required by every keep list to stay associated and
+ * addressed: ARP, EAPOL, DHCP client and DNS responses.
+ */
+#define PF_PROFILE_KEEP_BASE                                            \
+    pf_dsl::keep_ethtype(0x0806),                                       \
+    pf_dsl::keep_ethtype(0x888E),                                       \
+    pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 68),         \
+    pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_SOURCE, 53)
+
+/*
+ * Defines the packet filters of a profile, checks them as the default list
+ * and expands them at compile time into a constant list of the Offload
+ * Manager, named after the profile.
+ */
+#define PF_PROFILE_DEFINE(list, ...)                                    \
+    static constexpr pf_dsl::filter list##_filters[] = { __VA_ARGS__ }; \
+    PF_DSL_STATIC_ASSERT_VALID(list##_filters);                         \
+    QSPI_XIP_DATA static constexpr                                      \
+    pf_dsl::cfg_list<pf_dsl::count(list##_filters)> list =              \
+        pf_dsl::build(list##_filters)
+
+/* Entry of the profile library for a list defined with PF_PROFILE_DEFINE. */
+#define PF_PROFILE(name, list)                                          \
+    { name, (uint8_t)pf_dsl::count(list##_filters), &list.cfg[0], &list.ipv6 }
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/*
+ * Profiles. The firmware accepts either a list of keep filters or a single
+ * discard filter, so each profile is one or the other.
+ */
+PF_PROFILE_DEFINE(web_server,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_DEST, 80));
+PF_PROFILE_DEFINE(web_server_mdns,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_DEST, 80),
+    pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 5353));
+PF_PROFILE_DEFINE(mqtt_client,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_SOURCE, 1883),
+    pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_SOURCE, 8883));
+PF_PROFILE_DEFINE(web_server_ipv6_nd,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_DEST, 80),
+    PF_PROFILE_KEEP_IPV6_ND);
+PF_PROFILE_DEFINE(web_server_dual_stack,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_TCP, PF_PN_PORT_DEST, 80),
+    PF_PROFILE_KEEP_IPV6_ND,
+    pf_dsl::keep_ip6_next_header(6));
+PF_PROFILE_DEFINE(coap_server,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 5683));
+PF_PROFILE_DEFINE(ntp_client,
+    PF_PROFILE_KEEP_BASE,
+    pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_SOURCE, 123));
+PF_PROFILE_DEFINE(discard_mdns,
+    pf_dsl::discard(pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 5353)));
+PF_PROFILE_DEFINE(discard_ssdp,
+    pf_dsl::discard(pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 1900)));
+PF_PROFILE_DEFINE(discard_llmnr,
+    pf_dsl::discard(pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 5355)));
+PF_PROFILE_DEFINE(discard_netbios,
+    pf_dsl::discard(pf_dsl::keep_port(CY_PF_PROTOCOL_UDP, PF_PN_PORT_DEST, 137)));
+PF_PROFILE_DEFINE(discard_ipv6,
+    pf_dsl::discard(pf_dsl::keep_ethtype(PF_ETH_TYPE_IPV6)));
+PF_PROFILE_DEFINE(discard_icmp,
+    pf_dsl::discard(pf_dsl::keep_iptype(0x01)));
+
+/* Profile library, read in place. */
+QSPI_XIP_DATA static const pf_profile_t profile_list[] =
+{
+    PF_PROFILE("Web server",            web_server),
+    PF_PROFILE("Web server with mDNS",  web_server_mdns),
+    PF_PROFILE("MQTT client",           mqtt_client),
+    PF_PROFILE("Web server IPv6 ND",    web_server_ipv6_nd),
+    PF_PROFILE("Web server dual stack", web_server_dual_stack),
+    PF_PROFILE("CoAP server",           coap_server),
+    PF_PROFILE("NTP and SNTP client",   ntp_client),
+    PF_PROFILE("Discard mDNS",          discard_mdns),
+    PF_PROFILE("Discard SSDP",          discard_ssdp),
+    PF_PROFILE("Discard LLMNR",         discard_llmnr),
+    PF_PROFILE("Discard NetBIOS",       discard_netbios),
+    PF_PROFILE("Discard IPv6",          discard_ipv6),
+    PF_PROFILE("Discard ICMP",          discard_icmp),
+};
+
+/* Read back at boot to check that the XIP region is programmed. */
+QSPI_XIP_DATA static const uint32_t profile_magic = PF_PROFILE_MAGIC;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: pf_profiles_init
+ ******************************************************************************
+ * Summary:
+ *   This function checks that the profile library is readable. When the XIP
+ *   is enabled, it must be called after qspi_xip_init(); it fails if the
+ *   external flash is not mapped or not programmed with the application.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_profiles_init(void)
+{
+    if (PF_PROFILE_MAGIC != profile_magic)
+    {
+        ERR_INFO(("Packet filter profiles not found at 0x%08lx.\n",
+                  (unsigned long)&profile_magic));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    APP_INFO(("%u packet filter profiles at 0x%08lx.\n",
+              (unsigned int)pf_profile_count(), (unsigned long)profile_list));
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_profile_count
+ ******************************************************************************
+ * Summary:
+ *   This function returns the number of profiles of the library.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint8_t: Number of profiles.
+ *
+ *****************************************************************************/
+uint8_t pf_profile_count(void)
+{
+    return (uint8_t)(sizeof(profile_list) / sizeof(profile_list[0]));
+}
+
+/******************************************************************************
+ * Function Name: pf_profile_name
+ ******************************************************************************
+ * Summary:
+ *   This function returns the name of a profile, read in place.
+ *
+ * Parameters:
+ *   index: Index of the profile.
+ *
+ * Return:
+ *   const char *: Name of the profile or NULL if the index is out of range.
+ *
+ *****************************************************************************/
+const char *pf_profile_name(uint8_t index)
+{
+    if (index >= pf_profile_count())
+    {
+        return NULL;
+    }
+
+    return profile_list[index].name;
+}
+
+/******************************************************************************
+ * Function Name: pf_profile_load
+ ******************************************************************************
+ * Summary:
+ *   This function copies a profile, read in place, into the pending packet
+ *   filter list, replacing it. As for the filters added from the web page,
+ *   the list is applied to the WLAN device only by a commit.
+ *
+ * Parameters:
+ *   index: Index of the profile.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the index is
+ *     out of range.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_profile_load(uint8_t index)
+{
+    const pf_profile_t *profile = NULL;
+
+    if (index >= pf_profile_count())
+    {
+        ERR_INFO(("Invalid packet filter profile %u.\n", (unsigned int)index));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    profile = &profile_list[index];
+    APP_INFO(("Loading packet filter profile: %s\n", profile->name));
+
+    return pf_stage_list(profile->cfgs, profile->ipv6, profile->count);
+}
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * File Name: pf_profiles.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations of the
+ *   library of precompiled packet filter profiles.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_PROFILES_H
+#define PF_PROFILES_H
+
+#include "cy_lpa_wifi_pf_ol.h"
+#include "pf_olm_config.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Maximum length of a profile name, including the terminating NUL. */
+#define PF_PROFILE_NAME_LEN                (24)
+
+/* Marks a profile library readable in place. */
+#define PF_PROFILE_MAGIC                   (0x50465052) /* "PFPR" */
+
+/* Prefix of the query string value loading a profile, followed by its index. */
+#define PF_PROFILE_QUERY_PREFIX            "profile_"
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Precompiled packet filter profile, expanded at compile time by pf_dsl. */
+typedef struct
+{
+    char                  name[PF_PROFILE_NAME_LEN];
+    uint8_t               count;    /* Packet filters of the profile    */
+    const cy_pf_ol_cfg_t *cfgs;     /* Offload Manager list, read in place */
+    const pf_ipv6_attrs_t *ipv6;    /* IPv6 attributes by filter ID     */
+} pf_profile_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+cy_rslt_t pf_profiles_init(void);
+uint8_t pf_profile_count(void);
+const char *pf_profile_name(uint8_t index);
+cy_rslt_t pf_profile_load(uint8_t index);
+
+#endif /* #ifndef PF_PROFILES_H */
+
+
+/* [] END OF FILE */
+
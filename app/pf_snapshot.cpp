@@ -0,0 +1,361 @@
+/******************************************************************************
+ * File Name: pf_snapshot.cpp
+ *
+ * Description:
+ *   This file contains the packet filter list snapshots. The writers, which
+ *   edit and commit the lists under the lock of pf_olm_config.cpp, publish a
+ *   copy of each list after each change by swapping an atomic pointer. The
+ *   readers, such as the web page renderer, enter a read section and use the
+ *   published copies without taking any lock; a copy is never modified once
+ *   published. A replaced copy is reused once every reader has left the read
+ *   section it was in at the time of the replacement (epoch-based
+ *   reclamation). Writers never wait for readers: a version which finds no
+ *   reusable copy is kept aside and published when a reader leaves.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "pf_snapshot.h"
+#include "app_log.h"
+
+/******************************************************************************
+ *                               TYPEDEFS
+ *****************************************************************************/
+/* States of a snapshot, only seen by the writers. */
+typedef enum
+{
+    SLOT_FREE = 0,      /* Never published                             */
+    SLOT_PUBLISHED,     /* Returned to the readers                     */
+    SLOT_RETIRED        /* Replaced, may still be held by a reader     */
+} slot_state_t;
+
+/* Snapshots of one list. */
+typedef struct
+{
+    pf_snapshot_t slots[PF_SNAPSHOT_SLOTS];
+    slot_state_t state[PF_SNAPSHOT_SLOTS];
+    uint32_t retire_epoch[PF_SNAPSHOT_SLOTS];
+    pf_snapshot_t staged;           /* Next version, if not published   */
+    bool staged_dirty;
+    uint32_t version;
+} snapshot_set_t;
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+static snapshot_set_t sets[PF_SNAPSHOT_LISTS];
+
+/* Published snapshot of each list, NULL before the first publication. */
+static pf_snapshot_t *volatile published[PF_SNAPSHOT_LISTS];
+
+/* Empty list returned before the first publication. */
+static const pf_snapshot_t empty_snapshot = { 0, 0, false, { { CY_PF_OL_FEAT_LAST, 0, 0, {} } }, {} };
+
+/*
+ * Incremented each time a snapshot is replaced. A reader records it when
+ * entering a read section, 0 when outside of one.
+ */
+static volatile uint32_t global_epoch = 1;
+static volatile uint32_t reader_epoch[PF_SNAPSHOT_MAX_READERS];
+
+/* Serializes the writers; readers only try it. */
+static Mutex publish_mutex;
+
+/*
+ * Read sections without a slot share one: the number of them in the high
+ * word and the epoch of the first one in the low word, 0 when none.
+ */
+#define SHARED_READER_ONE                  (1ULL << 32)
+static volatile uint64_t shared_reader;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: oldest_reader_epoch
+ ******************************************************************************
+ * Summary:
+ *   This function returns the epoch of the oldest read section in progress.
+ *   A snapshot retired at an epoch not above it is held by no reader: the
+ *   readers which entered later load the pointer after the replacement.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint32_t: Oldest reader epoch, UINT32_MAX if no reader.
+ *
+ *****************************************************************************/
+static uint32_t oldest_reader_epoch(void)
+{
+    uint32_t oldest = UINT32_MAX;
+    uint32_t epoch = (uint32_t)core_util_atomic_load_u64(&shared_reader);
+
+    if (0 != epoch)
+    {
+        oldest = epoch;
+    }
+
+    for (uint8_t i = 0; i < PF_SNAPSHOT_MAX_READERS; i++)
+    {
+        epoch = core_util_atomic_load_u32(&reader_epoch[i]);
+        if ((0 != epoch) && (epoch < oldest))
+        {
+            oldest = epoch;
+        }
+    }
+
+    return oldest;
+}
+
+/******************************************************************************
+ * Function Name: flush_staged
+ ******************************************************************************
+ * Summary:
+ *   This function publishes the staged version of a list into a snapshot
+ *   which no reader holds, and retires the replaced one. The version stays
+ *   staged if every snapshot is held. Called with the publish mutex held.
+ *
+ * Parameters:
+ *   set: Snapshots of the list.
+ *   list: List to publish.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void flush_staged(snapshot_set_t *set, pf_snapshot_list_t list)
+{
+    uint32_t oldest = oldest_reader_epoch();
+    pf_snapshot_t *old = published[list];
+    uint8_t i = 0;
+
+    for (i = 0; i < PF_SNAPSHOT_SLOTS; i++)
+    {
+        if ((SLOT_FREE == set->state[i]) ||
+            ((SLOT_RETIRED == set->state[i]) && (set->retire_epoch[i] <= oldest)))
+        {
+            break;
+        }
+    }
+    if (PF_SNAPSHOT_SLOTS == i)
+    {
+        return;
+    }
+
+    set->slots[i] = set->staged;
+    set->state[i] = SLOT_PUBLISHED;
+    core_util_atomic_store_ptr((void *volatile *)&published[list], &set->slots[i]);
+    set->staged_dirty = false;
+
+    if (NULL != old)
+    {
+        set->state[old - &set->slots[0]] = SLOT_RETIRED;
+        set->retire_epoch[old - &set->slots[0]] = core_util_atomic_incr_u32(&global_epoch, 1);
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_snapshot_publish
+ ******************************************************************************
+ * Summary:
+ *   This function publishes a new version of a packet filter list. The
+ *   filters are copied; the caller may change them afterwards. Writers wait
+ *   for each other but never for the readers.
+ *
+ * Parameters:
+ *   list: List to publish.
+ *   cfgs: Packet filters of the list.
+ *   ipv6: IPv6 attributes of the packet filters by their ID, NULL if none.
+ *   count: Number of packet filters, up to MAX_FILTERS - 1.
+ *   is_default: The list is the default list.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_snapshot_publish(pf_snapshot_list_t list, const cy_pf_ol_cfg_t *cfgs,
+                         const pf_ipv6_attrs_t *ipv6, uint8_t count, bool is_default)
+{
+    snapshot_set_t *set = &sets[list];
+    ScopedMutexLock lock(publish_mutex);
+
+    if ((NULL == cfgs) || (count > MAX_FILTERS - 1))
+    {
+        count = 0;
+    }
+
+    memset(&set->staged, 0, sizeof(set->staged));
+    memcpy(set->staged.cfgs, cfgs, count * sizeof(cy_pf_ol_cfg_t));
+    set->staged.cfgs[count].feature = CY_PF_OL_FEAT_LAST;
+    if (NULL != ipv6)
+    {
+        set->staged.ipv6 = *ipv6;
+    }
+    set->staged.count = count;
+    set->staged.is_default = is_default;
+    set->staged.version = ++set->version;
+    set->staged_dirty = true;
+
+    flush_staged(set, list);
+}
+
+/******************************************************************************
+ * Function Name: pf_snapshot_read_lock
+ ******************************************************************************
+ * Summary:
+ *   This function enters a read section. The snapshots returned by
+ *   pf_snapshot_get() stay valid and unchanged until the section is left.
+ *   Get each list once per section and keep the sections short: a version
+ *   published while all the snapshots of its list are held is delayed until
+ *   the section is left. Never blocks. With more readers than
+ *   PF_SNAPSHOT_MAX_READERS, the sections beyond them share one slot,
+ *   which keeps the epoch of the first of them until the last one leaves.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   pf_snapshot_reader_t: Read section to pass to the other functions,
+ *     PF_SNAPSHOT_READER_SHARED if it shares the slot.
+ *
+ *****************************************************************************/
+pf_snapshot_reader_t pf_snapshot_read_lock(void)
+{
+    uint32_t expected = 0;
+    uint64_t shared = 0;
+    uint64_t joined = 0;
+
+    for (uint8_t i = 0; i < PF_SNAPSHOT_MAX_READERS; i++)
+    {
+        expected = 0;
+        if (core_util_atomic_cas_u32(&reader_epoch[i], &expected,
+                                     core_util_atomic_load_u32(&global_epoch)))
+        {
+            return i;
+        }
+    }
+
+    /* More threads than PF_SNAPSHOT_READER_THREADS read at once. A section
+     * joining the shared slot keeps its older epoch: the snapshots retired
+     * since are kept for it too.
+     */
+    shared = core_util_atomic_load_u64(&shared_reader);
+    do
+    {
+        joined = (0 == shared) ? (SHARED_READER_ONE | core_util_atomic_load_u32(&global_epoch))
+                               : (shared + SHARED_READER_ONE);
+    } while (!core_util_atomic_cas_u64(&shared_reader, &shared, joined));
+
+    return PF_SNAPSHOT_READER_SHARED;
+}
+
+/******************************************************************************
+ * Function Name: pf_snapshot_get
+ ******************************************************************************
+ * Summary:
+ *   This function returns the published snapshot of a list.
+ *
+ * Parameters:
+ *   reader: Read section entered with pf_snapshot_read_lock().
+ *   list: List to read.
+ *
+ * Return:
+ *   const pf_snapshot_t *: Snapshot of the list, never NULL.
+ *
+ *****************************************************************************/
+const pf_snapshot_t *pf_snapshot_get(pf_snapshot_reader_t reader, pf_snapshot_list_t list)
+{
+    const pf_snapshot_t *snapshot = NULL;
+
+    (void)reader;
+    MBED_ASSERT((PF_SNAPSHOT_READER_SHARED == reader) || (0 != reader_epoch[reader]));
+    snapshot = (const pf_snapshot_t *)core_util_atomic_load_ptr((void *const volatile *)&published[list]);
+
+    return (NULL != snapshot) ? snapshot : &empty_snapshot;
+}
+
+/******************************************************************************
+ * Function Name: pf_snapshot_read_unlock
+ ******************************************************************************
+ * Summary:
+ *   This function leaves a read section. The snapshots it returned must not
+ *   be used afterwards. If a version is waiting for a snapshot and no writer
+ *   is publishing, it is published now.
+ *
+ * Parameters:
+ *   reader: Read section entered with pf_snapshot_read_lock().
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_snapshot_read_unlock(pf_snapshot_reader_t reader)
+{
+    uint64_t shared = 0;
+    uint64_t left = 0;
+
+    if (PF_SNAPSHOT_READER_SHARED == reader)
+    {
+        shared = core_util_atomic_load_u64(&shared_reader);
+        do
+        {
+            left = ((shared >> 32) > 1) ? (shared - SHARED_READER_ONE) : 0;
+        } while (!core_util_atomic_cas_u64(&shared_reader, &shared, left));
+    }
+    else
+    {
+        core_util_atomic_store_u32(&reader_epoch[reader], 0);
+    }
+
+    if (!sets[PF_SNAPSHOT_ACTIVE].staged_dirty && !sets[PF_SNAPSHOT_PENDING].staged_dirty)
+    {
+        return;
+    }
+
+    if (publish_mutex.trylock())
+    {
+        for (uint8_t list = 0; list < PF_SNAPSHOT_LISTS; list++)
+        {
+            if (sets[list].staged_dirty)
+            {
+                flush_staged(&sets[list], (pf_snapshot_list_t)list);
+            }
+        }
+        publish_mutex.unlock();
+    }
+}
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * File Name: pf_snapshot.h
+ *
+ * Description:
+ *   This header file contains the types and the function declarations of
+ *   the packet filter list snapshots, which publish the active and the
+ *   pending lists to the reader threads without locking.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_SNAPSHOT_H
+#define PF_SNAPSHOT_H
+
+#include <stdint.h>
+#include "cy_lpa_wifi_pf_ol.h"
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/*
+ * Read sections in progress at the same time, one per thread reading the
+ * lists: the HTTP server, main running the event queue, the commit thread,
+ * and the thread running the IPv6 offload callbacks. The read sections
+ * beyond them share one slot, see pf_snapshot_read_lock().
+ */
+#define PF_SNAPSHOT_READER_THREADS         (4)
+#define PF_SNAPSHOT_MAX_READERS            (PF_SNAPSHOT_READER_THREADS)
+
+/* Read section sharing the slot of the sections beyond the others. */
+#define PF_SNAPSHOT_READER_SHARED          (PF_SNAPSHOT_MAX_READERS)
+
+/*
+ * Snapshots of each list: the published one, one held by a slow reader,
+ * and one to write the next version into. A version which finds no free
+ * snapshot is published when the reader holding one leaves.
+ */
+#define PF_SNAPSHOT_SLOTS                  (3)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Packet filter lists published as snapshots. */
+typedef enum
+{
+    PF_SNAPSHOT_ACTIVE = 0,     /* List in use by the OLM                  */
+    PF_SNAPSHOT_PENDING,        /* List edited before the next commit      */
+    PF_SNAPSHOT_LISTS
+} pf_snapshot_list_t;
+
+/* Immutable copy of a packet filter list. */
+typedef struct
+{
+    uint32_t version;           /* Publication number, 0 before the first */
+    uint8_t count;              /* Packet filters before the terminator   */
+    bool is_default;            /* The list is the default list           */
+    cy_pf_ol_cfg_t cfgs[MAX_FILTERS]; /* Terminated with CY_PF_OL_FEAT_LAST */
+    pf_ipv6_attrs_t ipv6;       /* IPv6 attributes by filter ID           */
+} pf_snapshot_t;
+
+/* Read section of a thread, see pf_snapshot_read_lock(). */
+typedef uint8_t pf_snapshot_reader_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void pf_snapshot_publish(pf_snapshot_list_t list, const cy_pf_ol_cfg_t *cfgs,
+                         const pf_ipv6_attrs_t *ipv6, uint8_t count, bool is_default);
+pf_snapshot_reader_t pf_snapshot_read_lock(void);
+const pf_snapshot_t *pf_snapshot_get(pf_snapshot_reader_t reader, pf_snapshot_list_t list);
+void pf_snapshot_read_unlock(pf_snapshot_reader_t reader);
+
+#endif /* #ifndef PF_SNAPSHOT_H */
+
+
+/* [] END OF FILE */
+
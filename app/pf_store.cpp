@@ -0,0 +1,276 @@
+/******************************************************************************
+ * File Name: pf_store.cpp
+ *
+ * Description:
+ *   This file stores the packet filter list committed from the web page in
+ *   KVStore, with a version and a CRC, and applies it at boot before the
+ *   first association so that no extra reassociation is needed.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "kvstore_global_api.h"
+#include "pf_store.h"
+#include "pf_olm_config.h"
+#include "http_webserver_config.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Marks a stored packet filter list record. */
+#define PF_STORE_MAGIC             (0x50464C53) /* "PFLS" */
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Stored packet filter list record. */
+typedef struct
+{
+    uint32_t magic;                         /* PF_STORE_MAGIC                  */
+    uint16_t version;                       /* PF_STORE_VERSION                */
+    uint16_t cfg_size;                      /* sizeof(cy_pf_ol_cfg_t)          */
+    uint32_t count;                         /* Number of packet filters        */
+    cy_pf_ol_cfg_t cfgs[MAX_FILTERS - 1];   /* Packet filters                  */
+    pf_ipv6_attrs_t ipv6;                   /* IPv6 attributes by filter ID    */
+    uint32_t crc;                           /* CRC-32 of the fields above      */
+} pf_store_record_t;
+
+/* Record being written or read, kept off the thread stacks. */
+static pf_store_record_t record;
+static pf_store_record_t stored;
+
+/* List the stored packet filters are checked in. */
+static cy_pf_ol_cfg_t check_cfgs[MAX_FILTERS];
+static pf_list_t check_list = {
+    &check_cfgs[0], &check_cfgs[0], &check_cfgs[MAX_FILTERS - 1], 0, {}
+};
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: pf_store_crc
+ ******************************************************************************
+ * Summary:
+ *   This function computes the CRC-32 of a record, up to its CRC field.
+ *
+ * Parameters:
+ *   rec: Record.
+ *
+ * Return:
+ *   uint32_t: CRC-32 of the record.
+ *
+ *****************************************************************************/
+static uint32_t pf_store_crc(const pf_store_record_t *rec)
+{
+    MbedCRC<POLY_32BIT_ANSI, 32> ct;
+    uint32_t crc = 0;
+
+    ct.compute(rec, offsetof(pf_store_record_t, crc), &crc);
+
+    return crc;
+}
+
+/******************************************************************************
+ * Function Name: pf_store_read
+ ******************************************************************************
+ * Summary:
+ *   This function reads the stored record and checks its version, its CRC
+ *   and its packet filters, with the checks of the filters added from the
+ *   web page.
+ *
+ * Parameters:
+ *   rec: Pointer to the record to fill.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if no valid
+ *     record is stored.
+ *
+ *****************************************************************************/
+static cy_rslt_t pf_store_read(pf_store_record_t *rec)
+{
+    size_t actual_size = 0;
+
+    if ((MBED_SUCCESS != kv_get(PF_STORE_KEY, rec, sizeof(*rec), &actual_size)) ||
+        (sizeof(*rec) != actual_size) ||
+        (PF_STORE_MAGIC != rec->magic) ||
+        (PF_STORE_VERSION != rec->version) ||
+        (sizeof(cy_pf_ol_cfg_t) != rec->cfg_size) ||
+        (get_max_filter() < rec->count) ||
+        (pf_store_crc(rec) != rec->crc))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* The stored filters pass the same checks as the filters added from
+     * the web page before they are applied.
+     */
+    return pf_list_set_checked(&check_list, rec->cfgs, &rec->ipv6, (uint8_t)rec->count);
+}
+
+/******************************************************************************
+ * Function Name: pf_store_save
+ ******************************************************************************
+ * Summary:
+ *   This function stores a committed packet filter list. The flash is not
+ *   written when the same list is already stored.
+ *
+ * Parameters:
+ *   cfgs: Packet filter list, terminated by CY_PF_OL_FEAT_LAST.
+ *   ipv6: IPv6 attributes of the packet filters by their ID, NULL if none.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_store_save(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6)
+{
+#if MBED_CONF_APP_PERSIST_FILTERS_ENABLE
+    int err = MBED_SUCCESS;
+
+    if (NULL == cfgs)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.magic = PF_STORE_MAGIC;
+    record.version = PF_STORE_VERSION;
+    record.cfg_size = sizeof(cy_pf_ol_cfg_t);
+    while ((record.count < get_max_filter()) && (0 != cfgs[record.count].feature) &&
+           (CY_PF_OL_FEAT_LAST != cfgs[record.count].feature))
+    {
+        record.cfgs[record.count] = cfgs[record.count];
+        record.count++;
+    }
+    if (NULL != ipv6)
+    {
+        record.ipv6 = *ipv6;
+    }
+    record.crc = pf_store_crc(&record);
+
+    if ((CY_RSLT_SUCCESS == pf_store_read(&stored)) &&
+        (0 == memcmp(&stored, &record, sizeof(record))))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    err = kv_set(PF_STORE_KEY, &record, sizeof(record), 0);
+    if (MBED_SUCCESS != err)
+    {
+        ERR_INFO(("Failed to store the packet filter list: %d\n", err));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    APP_INFO(("Stored %lu packet filters\n", (unsigned long)record.count));
+#endif /* MBED_CONF_APP_PERSIST_FILTERS_ENABLE */
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_store_erase
+ ******************************************************************************
+ * Summary:
+ *   This function removes the stored packet filter list, so that the
+ *   default list is used at the next boot.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_store_erase(void)
+{
+#if MBED_CONF_APP_PERSIST_FILTERS_ENABLE
+    int err = kv_remove(PF_STORE_KEY);
+
+    if ((MBED_SUCCESS != err) && (MBED_ERROR_ITEM_NOT_FOUND != err))
+    {
+        ERR_INFO(("Failed to remove the stored packet filter list: %d\n", err));
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif /* MBED_CONF_APP_PERSIST_FILTERS_ENABLE */
+
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: pf_store_apply
+ ******************************************************************************
+ * Summary:
+ *   This function applies the stored packet filter list to OLM. It must be
+ *   called before the first connect, so that the first association
+ *   offloads the stored list. The default list is kept when no valid list
+ *   is stored.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS if the stored list was applied.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_store_apply(void)
+{
+#if MBED_CONF_APP_PERSIST_FILTERS_ENABLE
+    cy_rslt_t result = pf_store_read(&stored);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        APP_INFO(("No stored packet filter list, using the default list\n"));
+        return result;
+    }
+
+    result = pf_stage_list(stored.cfgs, &stored.ipv6, (uint8_t)stored.count);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = pf_activate_list(false);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        APP_INFO(("Applied %lu stored packet filters\n", (unsigned long)stored.count));
+    }
+
+    return result;
+#else
+    return CY_RSLT_TYPE_ERROR;
+#endif /* MBED_CONF_APP_PERSIST_FILTERS_ENABLE */
+}
+
+
+/* [] END OF FILE */
+
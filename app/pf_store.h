@@ -0,0 +1,74 @@
+/******************************************************************************
+ * File Name: pf_store.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations to store the
+ *   committed packet filter list in KVStore and apply it at boot.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_STORE_H
+#define PF_STORE_H
+
+#include "cy_lpa_wifi_pf_ol.h"
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Persistent packet filter list is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_PERSIST_FILTERS_ENABLE
+#define MBED_CONF_APP_PERSIST_FILTERS_ENABLE  (0)
+#endif
+
+/* KVStore key of the committed packet filter list. */
+#define PF_STORE_KEY                       "/kv/pf_list"
+
+/*
+ * Version of the stored record. Increment it when the record or the
+ * cy_pf_ol_cfg_t layout changes, so that an old record is ignored.
+ */
+#define PF_STORE_VERSION                   (2)
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+cy_rslt_t pf_store_save(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6);
+cy_rslt_t pf_store_erase(void);
+cy_rslt_t pf_store_apply(void);
+
+#endif /* #ifndef PF_STORE_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,1023 @@
+/******************************************************************************
+ * File Name: pf_tier_manager.cpp
+ *
+ * Description:
+ *   This file contains the tiered packet filter manager. The WLAN device can
+ *   hold only (MAX_FILTERS-1) packet filters. When the catalog of keep filters
+ *   is larger, some filters are demoted to the host: a single cover filter of
+ *   their group (IP protocol UDP or TCP, or Ether type IPv4) takes their
+ *   place in the WLAN device and they are matched on the host instead. The
+ *   packets passed by a cover filter but matching no filter of the catalog
+ *   are wasted wakes; they are counted per group and dropped before lwIP
+ *   input.
+ *
+ *   The manager periodically ranks the filters by their hit rate weighted by
+ *   the wake cost. The busiest filters are promoted to the WLAN device and
+ *   the others are demoted, so as to minimize the host wakes of the demoted
+ *   filters and of the covered groups within the slot budget of the WLAN
+ *   device. A new list is queued on the commit worker only when the
+ *   expected saving outweighs the cost of the reassociation, and not more
+ *   often than the minimum commit interval.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "pf_tier_manager.h"
+#include "pf_olm_config.h"
+#include "http_webserver_config.h"
+#include "wake_latency.h"
+#include "pf_commit_worker.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Ethernet, IPv4 and transport header layout. */
+#define TIER_ETH_HDR_LEN           (14)
+#define TIER_ETH_TYPE_OFFSET       (12)
+#define TIER_ETH_TYPE_IPV4         (0x0800)
+#define TIER_IPV4_MIN_HDR_LEN      (20)
+#define TIER_IPV4_PROTO_OFFSET     (9)
+#define TIER_L4_PORTS_LEN          (4)
+#define TIER_IP_PROTO_TCP          (6)
+#define TIER_IP_PROTO_UDP          (17)
+#define TIER_IPV6_HDR_LEN          (40)
+#define TIER_IPV6_NEXT_HDR_OFFSET  (6)
+
+/* Reads a big-endian 16-bit value from a frame. */
+#define TIER_READ_BE16(p)          ((uint16_t)(((p)[0] << 8) | (p)[1]))
+
+/* Rates are kept in packets per period with 4 fractional bits. */
+#define TIER_RATE_SHIFT            (4)
+
+/* Number of periods within the minimum commit interval. */
+#define TIER_PERIODS_PER_COMMIT    (MBED_CONF_APP_TIER_MIN_COMMIT_INTERVAL_S / \
+                                    MBED_CONF_APP_TIER_PERIOD_S)
+
+/******************************************************************************
+ *                                ENUMS
+ *****************************************************************************/
+/* Groups of keep filters which can be replaced by a single cover filter. */
+enum tier_group
+{
+    TIER_GROUP_UDP = 0,     /* UDP port filters, covered by IP protocol UDP  */
+    TIER_GROUP_TCP,         /* TCP port filters, covered by IP protocol TCP  */
+    TIER_GROUP_IP,          /* IP protocol filters, covered by IPv4 Eth type */
+    TIER_GROUP_MAX,
+    TIER_GROUP_NONE = TIER_GROUP_MAX    /* Ether type and IPv6 filters, never covered */
+};
+
+/* Bit masks of the covered groups. Covering IPv4 also covers UDP and TCP. */
+#define TIER_COVER_UDP             (1u << TIER_GROUP_UDP)
+#define TIER_COVER_TCP             (1u << TIER_GROUP_TCP)
+#define TIER_COVER_IP              (TIER_COVER_UDP | TIER_COVER_TCP | (1u << TIER_GROUP_IP))
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Catalog entry. */
+typedef struct
+{
+    cy_pf_ol_cfg_t cfg;     /* Keep filter                              */
+    pf_ipv6_attr_t ipv6;    /* IPv6 attributes of the keep filter       */
+    uint32_t hits;          /* Packets matched in the current period    */
+    uint32_t hit_rate;      /* Average packets matched per period       */
+} pf_tier_rule_t;
+
+/* Placement of the catalog in the WLAN device. */
+typedef struct
+{
+    uint32_t wlan_rules;    /* Bit mask of the entries in the WLAN device */
+    uint8_t covered;        /* Bit mask of the covered groups             */
+} tier_plan_t;
+
+/*
+ * Catalog of keep filters. The web server thread is the only writer: an
+ * entry is written before the entry count is incremented, so the receive
+ * path never sees a partially written entry.
+ */
+static pf_tier_rule_t catalog[PF_TIER_MAX_RULES];
+static volatile uint8_t catalog_count = 0;
+
+/* Set when the catalog changed since the last commit. */
+static volatile bool catalog_dirty = false;
+
+/*
+ * Placement committed last by the manager and the commit count it produced.
+ * The placement is in force only while no other list was committed since;
+ * covered_groups is read by the receive path.
+ */
+static volatile bool plan_committed = false;
+static volatile uint32_t plan_commit = 0;
+static volatile uint32_t wlan_rules = 0;
+static volatile uint8_t covered_groups = 0;
+
+/* Wasted wakes per group in the current period and their average rate. */
+static uint32_t wasted[TIER_GROUP_MAX];
+static uint32_t wasted_rate[TIER_GROUP_MAX];
+
+/* Time of the last period update and of the last commit. */
+static uint64_t last_period_ms = 0;
+static uint64_t last_commit_ms = 0;
+
+/* List staged for commit and the IPv6 attributes of its filters. */
+static cy_pf_ol_cfg_t tier_list[MAX_FILTERS];
+static pf_ipv6_attrs_t tier_ipv6;
+
+/* Placement queued on the commit worker, and set until its commit is done. */
+static tier_plan_t queued_plan;
+static volatile bool plan_queued = false;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: tier_rule_group
+ ******************************************************************************
+ * Summary:
+ *   This function returns the group a keep filter belongs to.
+ *
+ * Parameters:
+ *   cfg: Keep filter.
+ *   ipv6: IPv6 attributes of the keep filter.
+ *
+ * Return:
+ *   int: Group of the filter, TIER_GROUP_NONE for the Ether type and the
+ *     IPv6 IP type filters.
+ *
+ *****************************************************************************/
+static int tier_rule_group(const cy_pf_ol_cfg_t *cfg, const pf_ipv6_attr_t *ipv6)
+{
+    switch (cfg->feature)
+    {
+        case CY_PF_OL_FEAT_PORTNUM:
+            return (CY_PF_PROTOCOL_TCP == cfg->u.pf.proto) ? TIER_GROUP_TCP : TIER_GROUP_UDP;
+        case CY_PF_OL_FEAT_IPTYPE:
+            return (ipv6->flags & PF_IPV6_NEXT_HEADER) ? TIER_GROUP_NONE : TIER_GROUP_IP;
+        default:
+            return TIER_GROUP_NONE;
+    }
+}
+
+/******************************************************************************
+ * Function Name: tier_plan_is_active
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether the list committed last by the manager is
+ *   still the list of the WLAN device. A list committed since by the user or
+ *   by another module replaces it, and its covered groups must not be
+ *   dropped any more.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: Returns true if the placement of the manager is in force.
+ *
+ *****************************************************************************/
+static bool tier_plan_is_active(void)
+{
+    return plan_committed && (pf_get_commit_count() == plan_commit);
+}
+
+/******************************************************************************
+ * Function Name: tier_active_covered
+ ******************************************************************************
+ * Summary:
+ *   This function returns the groups covered by the list of the WLAN device.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint8_t: Bit mask of the covered groups, 0 if the list committed by the
+ *     manager was replaced.
+ *
+ *****************************************************************************/
+static uint8_t tier_active_covered(void)
+{
+    return tier_plan_is_active() ? covered_groups : 0;
+}
+
+/******************************************************************************
+ * Function Name: tier_plan_cover
+ ******************************************************************************
+ * Summary:
+ *   This function sets the groups to cover for the entries of the catalog
+ *   which are not in the WLAN device. A demoted IP protocol filter needs the
+ *   IPv4 cover, which also covers the UDP and TCP port filters.
+ *
+ * Parameters:
+ *   plan: Placement whose wlan_rules is set; its covered groups are filled.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void tier_plan_cover(tier_plan_t *plan)
+{
+    uint8_t count = catalog_count;
+
+    plan->covered = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int group = tier_rule_group(&catalog[i].cfg, &catalog[i].ipv6);
+        if ((TIER_GROUP_NONE != group) && !(plan->wlan_rules & (1u << i)))
+        {
+            plan->covered |= (TIER_GROUP_IP == group) ? TIER_COVER_IP : (1u << group);
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: tier_plan_slots
+ ******************************************************************************
+ * Summary:
+ *   This function returns the number of WLAN device slots used by a
+ *   placement: one slot per filter kept in the WLAN device and one slot per
+ *   cover filter.
+ *
+ * Parameters:
+ *   plan: Placement of the catalog.
+ *
+ * Return:
+ *   uint32_t: Number of slots.
+ *
+ *****************************************************************************/
+static uint32_t tier_plan_slots(const tier_plan_t *plan)
+{
+    uint32_t slots = __builtin_popcount(plan->wlan_rules);
+
+    if (TIER_COVER_IP == plan->covered)
+    {
+        return slots + 1;
+    }
+
+    return slots + ((plan->covered & TIER_COVER_UDP) ? 1 : 0) +
+           ((plan->covered & TIER_COVER_TCP) ? 1 : 0);
+}
+
+/******************************************************************************
+ * Function Name: tier_plan_cost
+ ******************************************************************************
+ * Summary:
+ *   This function returns the expected host cost of a placement: the hits of
+ *   the demoted filters and the wasted wakes of the covered groups, using
+ *   their last measured rates, weighted by the wake cost.
+ *
+ * Parameters:
+ *   plan: Placement of the catalog.
+ *   wake_cost_us: Cost of a wake in microseconds.
+ *
+ * Return:
+ *   uint64_t: Cost in microseconds per period, with TIER_RATE_SHIFT
+ *     fractional bits.
+ *
+ *****************************************************************************/
+static uint64_t tier_plan_cost(const tier_plan_t *plan, uint64_t wake_cost_us)
+{
+    uint8_t count = catalog_count;
+    uint64_t rate = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!(plan->wlan_rules & (1u << i)))
+        {
+            rate += catalog[i].hit_rate;
+        }
+    }
+
+    for (int group = 0; group < TIER_GROUP_MAX; group++)
+    {
+        if (plan->covered & (1u << group))
+        {
+            rate += wasted_rate[group];
+        }
+    }
+
+    return rate * wake_cost_us;
+}
+
+/******************************************************************************
+ * Function Name: tier_select_plan
+ ******************************************************************************
+ * Summary:
+ *   This function ranks the filters of the catalog by their hit rate
+ *   weighted by the wake cost and selects the cheapest placement which fits
+ *   in the WLAN device. The Ether type and IPv6 filters are always kept in
+ *   the WLAN device; of the others, the highest ranked are promoted and the
+ *   rest are demoted behind the cover filters of their groups.
+ *
+ * Parameters:
+ *   wake_cost_us: Cost of a wake in microseconds.
+ *   plan: Pointer to the placement to fill.
+ *   cost: Pointer to the cost of the placement, see tier_plan_cost().
+ *
+ * Return:
+ *   bool: Returns false if no placement fits in the WLAN device.
+ *
+ *****************************************************************************/
+static bool tier_select_plan(uint64_t wake_cost_us, tier_plan_t *plan, uint64_t *cost)
+{
+    uint8_t count = catalog_count;
+    uint8_t order[PF_TIER_MAX_RULES];
+    uint64_t score[PF_TIER_MAX_RULES];
+    uint32_t fixed = 0;
+    uint8_t ranked = 0;
+    uint8_t pos = 0;
+    bool found = false;
+
+    /* Rank the filters which can be demoted, busiest first. */
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (TIER_GROUP_NONE == tier_rule_group(&catalog[i].cfg, &catalog[i].ipv6))
+        {
+            fixed |= (1u << i);
+            continue;
+        }
+
+        score[i] = (uint64_t)catalog[i].hit_rate * wake_cost_us;
+        pos = ranked++;
+        while ((pos > 0) && (score[order[pos - 1]] < score[i]))
+        {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+
+    /* Promote the k highest ranked filters, from all of them down to none. */
+    for (int k = ranked; k >= 0; k--)
+    {
+        tier_plan_t candidate = { fixed, 0 };
+        uint64_t candidate_cost = 0;
+
+        for (int j = 0; j < k; j++)
+        {
+            candidate.wlan_rules |= (1u << order[j]);
+        }
+        tier_plan_cover(&candidate);
+
+        if (tier_plan_slots(&candidate) > get_max_filter())
+        {
+            continue;
+        }
+
+        candidate_cost = tier_plan_cost(&candidate, wake_cost_us);
+        if (!found || (candidate_cost < *cost))
+        {
+            *plan = candidate;
+            *cost = candidate_cost;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/******************************************************************************
+ * Function Name: tier_cover_filter
+ ******************************************************************************
+ * Summary:
+ *   This function builds the cover filter of a group.
+ *
+ * Parameters:
+ *   group: Group to cover.
+ *   cfg: Pointer to the packet filter configuration to fill.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void tier_cover_filter(int group, cy_pf_ol_cfg_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->bits = CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE;
+
+    if (TIER_GROUP_IP == group)
+    {
+        cfg->feature = CY_PF_OL_FEAT_ETHTYPE;
+        cfg->u.eth.eth_type = TIER_ETH_TYPE_IPV4;
+    }
+    else
+    {
+        cfg->feature = CY_PF_OL_FEAT_IPTYPE;
+        cfg->u.ip.ip_type = (TIER_GROUP_TCP == group) ? TIER_IP_PROTO_TCP : TIER_IP_PROTO_UDP;
+    }
+}
+
+/******************************************************************************
+ * Function Name: tier_commit_done
+ ******************************************************************************
+ * Summary:
+ *   This function is called on the commit thread once the list of the
+ *   queued placement is committed. The list is in the WLAN device once
+ *   committed, even if the reassociation failed. A commit of another module
+ *   after it leaves the placement inactive.
+ *
+ * Parameters:
+ *   result: Result of the commit.
+ *   commit: Commit count of the list, 0 if it was not committed.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void tier_commit_done(cy_rslt_t result, uint32_t commit)
+{
+    if (0 != commit)
+    {
+        wlan_rules = queued_plan.wlan_rules;
+        covered_groups = queued_plan.covered;
+        plan_commit = commit;
+        plan_committed = true;
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Tiered filters: Failed to commit the packet filter list\n"));
+    }
+
+    plan_queued = false;
+}
+
+/******************************************************************************
+ * Function Name: tier_commit_plan
+ ******************************************************************************
+ * Summary:
+ *   This function builds the packet filter list of a placement and queues
+ *   its commit on the commit worker, so that the reassociation does not
+ *   stall the event queue. The pending list of the user is left unchanged.
+ *
+ * Parameters:
+ *   plan: Placement of the catalog.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void tier_commit_plan(const tier_plan_t *plan)
+{
+    uint8_t count = catalog_count;
+    uint8_t n = 0;
+
+    /* Promoted filters stay in the WLAN device. */
+    memset(&tier_ipv6, 0, sizeof(tier_ipv6));
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (plan->wlan_rules & (1u << i))
+        {
+            tier_list[n] = catalog[i].cfg;
+            tier_list[n].id = n;
+            tier_ipv6.attr[n] = catalog[i].ipv6;
+            n++;
+        }
+    }
+
+    if (TIER_COVER_IP == plan->covered)
+    {
+        tier_cover_filter(TIER_GROUP_IP, &tier_list[n]);
+        tier_list[n].id = n;
+        n++;
+    }
+    else
+    {
+        for (int group = TIER_GROUP_UDP; group <= TIER_GROUP_TCP; group++)
+        {
+            if (plan->covered & (1u << group))
+            {
+                tier_cover_filter(group, &tier_list[n]);
+                tier_list[n].id = n;
+                n++;
+            }
+        }
+    }
+
+    APP_INFO(("Tiered filters: %d in WLAN device, covered groups 0x%x\n", n, plan->covered));
+
+    /* Nothing is dropped until the new list is in force. */
+    plan_committed = false;
+    queued_plan = *plan;
+    plan_queued = true;
+    pf_commit_request_cfgs(tier_list, &tier_ipv6, n, mbed::callback(tier_commit_done));
+}
+
+/******************************************************************************
+ * Function Name: tier_update_rates
+ ******************************************************************************
+ * Summary:
+ *   This function closes the current measurement period. The wasted wake
+ *   rate of a group is measurable only while the group is covered; the
+ *   rates of the other groups keep their last measured value.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void tier_update_rates(void)
+{
+    uint8_t count = catalog_count;
+    uint8_t covered = tier_active_covered();
+    uint32_t sample = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        sample = core_util_atomic_exchange_u32(&catalog[i].hits, 0) << TIER_RATE_SHIFT;
+        catalog[i].hit_rate = (3 * catalog[i].hit_rate + sample) / 4;
+    }
+
+    for (int group = 0; group < TIER_GROUP_MAX; group++)
+    {
+        sample = core_util_atomic_exchange_u32(&wasted[group], 0) << TIER_RATE_SHIFT;
+        if (covered & (1u << group))
+        {
+            wasted_rate[group] = (3 * wasted_rate[group] + sample) / 4;
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_poll
+ ******************************************************************************
+ * Summary:
+ *   This function runs the periodic work of the manager. It is called from
+ *   the wake event of the event queue, when the host is awake anyway;
+ *   a period elapsed while the host slept is closed on the next wake. At the
+ *   end of each period, it selects the cheapest placement of the catalog
+ *   which fits in the WLAN device and commits it if the saving over the
+ *   minimum commit interval outweighs the commit cost. A change of the
+ *   catalog is committed at the end of the period, so that a burst of
+ *   changes costs a single commit. Once another list is committed, the
+ *   manager waits for the next change of the catalog.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_tier_poll(void)
+{
+#if MBED_CONF_APP_TIER_ENABLE
+    uint64_t now_ms = Kernel::get_ms_count();
+    tier_plan_t best_plan;
+    tier_plan_t active_plan;
+    uint64_t best_cost = 0;
+    uint64_t active_cost = 0;
+    uint64_t wake_cost_us = 0;
+    uint64_t saving_us = 0;
+
+    if ((0 == catalog_count) ||
+        ((now_ms - last_period_ms) < (MBED_CONF_APP_TIER_PERIOD_S * 1000ull)))
+    {
+        return;
+    }
+
+    last_period_ms = now_ms;
+    tier_update_rates();
+
+    /* A placement waits for the commit of the previous one. */
+    if (plan_queued)
+    {
+        return;
+    }
+
+    if (plan_committed && !tier_plan_is_active())
+    {
+        APP_INFO(("Tiered filters: Packet filter list replaced by another commit\n"));
+        plan_committed = false;
+    }
+
+    wake_cost_us = wake_latency_get_avg_us(WAKE_STAGE_TOTAL);
+    if (0 == wake_cost_us)
+    {
+        wake_cost_us = MBED_CONF_APP_TIER_DEFAULT_WAKE_COST_US;
+    }
+
+    if (!tier_select_plan(wake_cost_us, &best_plan, &best_cost))
+    {
+        ERR_INFO(("Tiered filters: Ether type filters exceed the %d slots\n",
+                  get_max_filter()));
+        return;
+    }
+
+    if (!catalog_dirty)
+    {
+        if (!plan_committed ||
+            ((now_ms - last_commit_ms) < (MBED_CONF_APP_TIER_MIN_COMMIT_INTERVAL_S * 1000ull)))
+        {
+            return;
+        }
+
+        active_plan.wlan_rules = wlan_rules;
+        active_plan.covered = covered_groups;
+        if ((best_plan.wlan_rules == active_plan.wlan_rules) &&
+            (best_plan.covered == active_plan.covered))
+        {
+            return;
+        }
+
+        /* Saving over the minimum commit interval against the commit cost. */
+        active_cost = tier_plan_cost(&active_plan, wake_cost_us);
+        if (active_cost <= best_cost)
+        {
+            return;
+        }
+        saving_us = ((active_cost - best_cost) * TIER_PERIODS_PER_COMMIT) >> TIER_RATE_SHIFT;
+        if (saving_us <= (MBED_CONF_APP_TIER_COMMIT_COST_MS * 1000ull))
+        {
+            return;
+        }
+    }
+
+    catalog_dirty = false;
+    last_commit_ms = now_ms;
+    tier_commit_plan(&best_plan);
+#endif /* MBED_CONF_APP_TIER_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_host_match
+ ******************************************************************************
+ * Summary:
+ *   This function is the host-side matcher. It is called in the receive path
+ *   for every frame. Frames matching a filter of the catalog are counted as
+ *   hits. IPv4 frames of a covered group matching no filter of the catalog
+ *   are counted as wasted wakes and must be dropped. As in the WLAN device,
+ *   an IPv6 IP type filter compares the next header of the fixed IPv6 header
+ *   and the ICMPv6 type which directly follows it.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   bool: Returns false if the frame must be dropped, true otherwise.
+ *
+ *****************************************************************************/
+bool pf_tier_host_match(const uint8_t *frame, uint32_t len)
+{
+    const uint8_t *ip = &frame[TIER_ETH_HDR_LEN];
+    const uint8_t *l4 = NULL;
+    uint8_t count = catalog_count;
+    uint16_t eth_type = 0;
+    uint16_t src_port = 0;
+    uint16_t dst_port = 0;
+    uint8_t ip_proto = 0;
+    uint32_t ip_hdr_len = 0;
+    int group = TIER_GROUP_NONE;
+    uint8_t covered = 0;
+    bool ipv6 = false;
+    int icmp6_type = -1;
+
+    if ((0 == count) || (NULL == frame) || (TIER_ETH_HDR_LEN > len))
+    {
+        return true;
+    }
+
+    eth_type = TIER_READ_BE16(&frame[TIER_ETH_TYPE_OFFSET]);
+    if ((TIER_ETH_TYPE_IPV4 == eth_type) && ((TIER_ETH_HDR_LEN + TIER_IPV4_MIN_HDR_LEN) <= len))
+    {
+        ip_proto = ip[TIER_IPV4_PROTO_OFFSET];
+        ip_hdr_len = (ip[0] & 0x0F) * 4;
+        group = TIER_GROUP_IP;
+        if (((TIER_IP_PROTO_TCP == ip_proto) || (TIER_IP_PROTO_UDP == ip_proto)) &&
+            ((TIER_ETH_HDR_LEN + ip_hdr_len + TIER_L4_PORTS_LEN) <= len))
+        {
+            l4 = &ip[ip_hdr_len];
+            src_port = TIER_READ_BE16(&l4[0]);
+            dst_port = TIER_READ_BE16(&l4[2]);
+            group = (TIER_IP_PROTO_TCP == ip_proto) ? TIER_GROUP_TCP : TIER_GROUP_UDP;
+        }
+    }
+    else if ((PF_ETH_TYPE_IPV6 == eth_type) && ((TIER_ETH_HDR_LEN + TIER_IPV6_HDR_LEN) <= len))
+    {
+        ipv6 = true;
+        ip_proto = ip[TIER_IPV6_NEXT_HDR_OFFSET];
+        if ((PF_IP_PROTO_ICMPV6 == ip_proto) &&
+            ((TIER_ETH_HDR_LEN + TIER_IPV6_HDR_LEN + 1) <= len))
+        {
+            icmp6_type = ip[TIER_IPV6_HDR_LEN];
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const cy_pf_ol_cfg_t *cfg = &catalog[i].cfg;
+        const pf_ipv6_attr_t *attr = &catalog[i].ipv6;
+        bool match = false;
+
+        switch (cfg->feature)
+        {
+            case CY_PF_OL_FEAT_ETHTYPE:
+                match = (cfg->u.eth.eth_type == eth_type);
+                break;
+            case CY_PF_OL_FEAT_IPTYPE:
+                if (attr->flags & PF_IPV6_NEXT_HEADER)
+                {
+                    match = ipv6 && (cfg->u.ip.ip_type == ip_proto) &&
+                            (!(attr->flags & PF_IPV6_ICMP6_TYPE) ||
+                             (attr->icmp6_type == icmp6_type));
+                }
+                else
+                {
+                    match = (TIER_GROUP_NONE != group) && (cfg->u.ip.ip_type == ip_proto);
+                }
+                break;
+            case CY_PF_OL_FEAT_PORTNUM:
+                match = (NULL != l4) &&
+                        (((CY_PF_PROTOCOL_TCP == cfg->u.pf.proto) ? TIER_IP_PROTO_TCP :
+                                                                    TIER_IP_PROTO_UDP) == ip_proto) &&
+                        (cfg->u.pf.portnum.portnum ==
+                         ((PF_PN_PORT_SOURCE == cfg->u.pf.portnum.direction) ? src_port : dst_port));
+                break;
+            default:
+                break;
+        }
+
+        if (match)
+        {
+            core_util_atomic_incr_u32(&catalog[i].hits, 1);
+            return true;
+        }
+    }
+
+    /* Only the packets passed by a cover filter are wasted wakes. */
+    covered = tier_active_covered();
+    if ((TIER_GROUP_NONE != group) && (covered & (1u << group)))
+    {
+        core_util_atomic_incr_u32(&wasted[group], 1);
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_add_rule
+ ******************************************************************************
+ * Summary:
+ *   This function adds a keep filter to the catalog. The catalog is
+ *   committed to the WLAN device at the end of the current period.
+ *
+ * Parameters:
+ *   cfg: Keep filter to add.
+ *   ipv6: IPv6 attributes of the keep filter, NULL if none.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the catalog
+ *     is full, the filter is a discard filter or a duplicate.
+ *
+ *****************************************************************************/
+cy_rslt_t pf_tier_add_rule(const cy_pf_ol_cfg_t *cfg, const pf_ipv6_attr_t *ipv6)
+{
+#if MBED_CONF_APP_TIER_ENABLE
+    static const pf_ipv6_attr_t none = { 0, 0 };
+    uint8_t count = catalog_count;
+
+    if ((NULL == cfg) || (cfg->bits & CY_PF_ACTION_DISCARD))
+    {
+        ERR_INFO(("Only keep filters can be added to the tiered catalog\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if ((NULL == ipv6) || (CY_PF_OL_FEAT_IPTYPE != cfg->feature))
+    {
+        ipv6 = &none;
+    }
+
+    if (PF_TIER_MAX_RULES <= count)
+    {
+        ERR_INFO(("Max number of tiered catalog entries %d.\n", PF_TIER_MAX_RULES));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if ((catalog[i].cfg.feature == cfg->feature) &&
+            (catalog[i].ipv6.flags == ipv6->flags) &&
+            (catalog[i].ipv6.icmp6_type == ipv6->icmp6_type) &&
+            (0 == memcmp(&catalog[i].cfg.u, &cfg->u, sizeof(cfg->u))))
+        {
+            ERR_INFO(("Filter already in the tiered catalog\n"));
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+
+    memset(&catalog[count], 0, sizeof(catalog[count]));
+    catalog[count].cfg = *cfg;
+    catalog[count].cfg.id = count;
+    catalog[count].ipv6 = *ipv6;
+    catalog_count = count + 1;
+    catalog_dirty = true;
+
+    return CY_RSLT_SUCCESS;
+#else
+    return CY_RSLT_TYPE_ERROR;
+#endif /* MBED_CONF_APP_TIER_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_clear
+ ******************************************************************************
+ * Summary:
+ *   This function empties the catalog. The packet filter list committed to
+ *   the WLAN device is left unchanged, but no packet is dropped by the
+ *   host-side matcher any more.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void pf_tier_clear(void)
+{
+    catalog_count = 0;
+    plan_committed = false;
+    wlan_rules = 0;
+    covered_groups = 0;
+    catalog_dirty = false;
+    memset(wasted_rate, 0, sizeof(wasted_rate));
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_is_active
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether the manager owns the packet filter list of
+ *   the WLAN device, that is whether its catalog is not empty.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: Returns true if the catalog is not empty.
+ *
+ *****************************************************************************/
+bool pf_tier_is_active(void)
+{
+    return (0 != catalog_count);
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_report_summary
+ ******************************************************************************
+ * Summary:
+ *   This function formats the state of the manager as text.
+ *
+ * Parameters:
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int pf_tier_report_summary(char *buf, size_t buf_len)
+{
+    tier_plan_t plan = { 0, 0 };
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    if (tier_plan_is_active())
+    {
+        plan.wlan_rules = wlan_rules;
+        plan.covered = covered_groups;
+    }
+
+    len = snprintf(buf, buf_len, "Catalog: %d filters, %lu slots used of %d\n"
+                   "Covered: UDP=%s TCP=%s IPv4=%s\n"
+                   "Wasted wakes/period: UDP=%lu TCP=%lu IPv4=%lu\n",
+                   catalog_count,
+                   (unsigned long)tier_plan_slots(&plan),
+                   get_max_filter(),
+                   (plan.covered & TIER_COVER_UDP) ? "yes" : "no",
+                   (plan.covered & TIER_COVER_TCP) ? "yes" : "no",
+                   (TIER_COVER_IP == plan.covered) ? "yes" : "no",
+                   (unsigned long)(wasted_rate[TIER_GROUP_UDP] >> TIER_RATE_SHIFT),
+                   (unsigned long)(wasted_rate[TIER_GROUP_TCP] >> TIER_RATE_SHIFT),
+                   (unsigned long)(wasted_rate[TIER_GROUP_IP] >> TIER_RATE_SHIFT));
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+/******************************************************************************
+ * Function Name: pf_tier_report_rule
+ ******************************************************************************
+ * Summary:
+ *   This function formats one catalog entry as text.
+ *
+ * Parameters:
+ *   index: Index of the entry in the catalog.
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer, 0 past the last entry.
+ *
+ *****************************************************************************/
+int pf_tier_report_rule(uint8_t index, char *buf, size_t buf_len)
+{
+    const cy_pf_ol_cfg_t *cfg = NULL;
+    const pf_ipv6_attr_t *ipv6 = NULL;
+    const char *place = "-";
+    int group = TIER_GROUP_NONE;
+    int len = 0;
+
+    if ((index >= catalog_count) || (NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    cfg = &catalog[index].cfg;
+    ipv6 = &catalog[index].ipv6;
+    group = tier_rule_group(cfg, ipv6);
+
+    /* A filter added since the last commit is in neither place. */
+    if (tier_plan_is_active())
+    {
+        if (wlan_rules & (1u << index))
+        {
+            place = "WLAN";
+        }
+        else if ((TIER_GROUP_NONE != group) && (covered_groups & (1u << group)))
+        {
+            place = "Host";
+        }
+    }
+
+    len = snprintf(buf, buf_len, "ID %d %-4s %-6s ",
+                   index,
+                   place,
+                   (CY_PF_OL_FEAT_PORTNUM == cfg->feature) ? "Port" :
+                   (ipv6->flags & PF_IPV6_NEXT_HEADER) ? "IPv6" :
+                   (CY_PF_OL_FEAT_IPTYPE == cfg->feature) ? "IP" : "Eth");
+
+    if (CY_PF_OL_FEAT_PORTNUM == cfg->feature)
+    {
+        len += snprintf(&buf[len], buf_len - len, "%s %s %d",
+                        (CY_PF_PROTOCOL_TCP == cfg->u.pf.proto) ? "TCP" : "UDP",
+                        (PF_PN_PORT_SOURCE == cfg->u.pf.portnum.direction) ? "src" : "dst",
+                        cfg->u.pf.portnum.portnum);
+    }
+    else if (CY_PF_OL_FEAT_IPTYPE == cfg->feature)
+    {
+        len += snprintf(&buf[len], buf_len - len, "0x%x", cfg->u.ip.ip_type);
+        if (ipv6->flags & PF_IPV6_ICMP6_TYPE)
+        {
+            len += snprintf(&buf[len], buf_len - len, " type %u", ipv6->icmp6_type);
+        }
+    }
+    else
+    {
+        len += snprintf(&buf[len], buf_len - len, "0x%x", cfg->u.eth.eth_type);
+    }
+
+    len += snprintf(&buf[len], buf_len - len, " hits/period=%lu\n",
+                    (unsigned long)(catalog[index].hit_rate >> TIER_RATE_SHIFT));
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
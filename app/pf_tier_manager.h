@@ -0,0 +1,96 @@
+/******************************************************************************
+ * File Name: pf_tier_manager.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations of the tiered
+ *   packet filter manager, which splits a catalog of keep filters larger than
+ *   the WLAN device can hold between the WLAN device and the host.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef PF_TIER_MANAGER_H
+#define PF_TIER_MANAGER_H
+
+#include "cy_lpa_wifi_pf_ol.h"
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Tiered filter manager is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_TIER_ENABLE
+#define MBED_CONF_APP_TIER_ENABLE          (0)
+#endif
+
+/* Period in seconds over which the hit and wasted wake rates are measured. */
+#ifndef MBED_CONF_APP_TIER_PERIOD_S
+#define MBED_CONF_APP_TIER_PERIOD_S        (60)
+#endif
+
+/* Minimum interval in seconds between two commits of the manager. */
+#ifndef MBED_CONF_APP_TIER_MIN_COMMIT_INTERVAL_S
+#define MBED_CONF_APP_TIER_MIN_COMMIT_INTERVAL_S  (600)
+#endif
+
+/* Cost of a commit (disconnect, OLM restart, reconnect) in milliseconds. */
+#ifndef MBED_CONF_APP_TIER_COMMIT_COST_MS
+#define MBED_CONF_APP_TIER_COMMIT_COST_MS  (5000)
+#endif
+
+/* Cost of a wake in microseconds when the wake latency is not measured. */
+#ifndef MBED_CONF_APP_TIER_DEFAULT_WAKE_COST_US
+#define MBED_CONF_APP_TIER_DEFAULT_WAKE_COST_US  (10000)
+#endif
+
+/* Maximum number of keep filters in the catalog. */
+#define PF_TIER_MAX_RULES                  (32)
+
+/* Buffer length required to report one catalog entry as text. */
+#define PF_TIER_REPORT_LEN                 (160)
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+cy_rslt_t pf_tier_add_rule(const cy_pf_ol_cfg_t *cfg, const pf_ipv6_attr_t *ipv6);
+void pf_tier_clear(void);
+bool pf_tier_is_active(void);
+bool pf_tier_host_match(const uint8_t *frame, uint32_t len);
+void pf_tier_poll(void);
+int pf_tier_report_summary(char *buf, size_t buf_len);
+int pf_tier_report_rule(uint8_t index, char *buf, size_t buf_len);
+
+#endif /* #ifndef PF_TIER_MANAGER_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * File Name: qspi_xip.cpp
+ *
+ * Description:
+ *   This file initializes the SMIF block with the memory configuration of
+ *   the QSPI Configurator and switches it to the memory mode, in which the
+ *   external flash is read through the XIP address space.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "cyhal_qspi.h"
+#include "cycfg_qspi_memslot.h"
+#include "qspi_xip.h"
+#include "http_webserver_config.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Time in microseconds to wait for the flash after enabling the quad mode. */
+#define QSPI_XIP_BUSY_TIMEOUT_US   (100000)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* QSPI object, kept for the lifetime of the application. */
+static cyhal_qspi_t qspi;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: qspi_xip_init
+ ******************************************************************************
+ * Summary:
+ *   This function initializes the QSPI interface and the memory slot of the
+ *   external flash, enables its quad mode and maps it in the XIP address
+ *   space. It must be called before any constant placed with QSPI_XIP_DATA
+ *   is read. It does nothing when the XIP is disabled.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or the error of the HAL or SMIF
+ *     driver.
+ *
+ *****************************************************************************/
+cy_rslt_t qspi_xip_init(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t wait_us = 0;
+
+    if (!MBED_CONF_APP_QSPI_XIP_ENABLE)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    result = cyhal_qspi_init(&qspi, QSPI_FLASH1_IO0, QSPI_FLASH1_IO1,
+                             QSPI_FLASH1_IO2, QSPI_FLASH1_IO3, NC, NC, NC, NC,
+                             QSPI_FLASH1_SCK, QSPI_FLASH1_CSN,
+                             QSPI_XIP_FREQ_HZ, 0);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to initialize the QSPI interface.\n"));
+        return result;
+    }
+
+    result = (cy_rslt_t)Cy_SMIF_Memslot_Init(qspi.base,
+                                             (cy_stc_smif_block_config_t *)&smifBlockConfig,
+                                             &qspi.context);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to initialize the QSPI memory slot.\n"));
+        cyhal_qspi_free(&qspi);
+        return result;
+    }
+
+    /* The read command of the memory slot transfers the data on 4 lines. */
+    Cy_SMIF_SetMode(qspi.base, CY_SMIF_NORMAL);
+    result = (cy_rslt_t)Cy_SMIF_Memslot_QuadEnable(qspi.base,
+                                                   (cy_stc_smif_mem_config_t *)smifMemConfigs[0],
+                                                   &qspi.context);
+    while ((CY_RSLT_SUCCESS == result) &&
+           Cy_SMIF_Memslot_IsBusy(qspi.base,
+                                  (cy_stc_smif_mem_config_t *)smifMemConfigs[0],
+                                  &qspi.context))
+    {
+        if (QSPI_XIP_BUSY_TIMEOUT_US <= wait_us)
+        {
+            result = CY_RSLT_TYPE_ERROR;
+            break;
+        }
+        Cy_SysLib_DelayUs(1);
+        wait_us++;
+    }
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to enable the quad mode of the QSPI flash.\n"));
+        cyhal_qspi_free(&qspi);
+        return result;
+    }
+
+    Cy_SMIF_SetMode(qspi.base, CY_SMIF_MEMORY);
+    APP_INFO(("QSPI flash mapped at 0x%08lx.\n",
+              (unsigned long)smifMemConfigs[0]->baseAddress));
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * File Name: qspi_xip.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations to map the
+ *   external QSPI flash in the memory space of the MCU (XIP) so that the
+ *   constant data placed in it is read in place.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef QSPI_XIP_H
+#define QSPI_XIP_H
+
+#include "cy_result.h"
+#include "cy_syslib.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Constant data stays in the internal flash unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_QSPI_XIP_ENABLE
+#define MBED_CONF_APP_QSPI_XIP_ENABLE      (0)
+#endif
+
+/* SPI clock of the external QSPI flash. */
+#define QSPI_XIP_FREQ_HZ                   (50000000UL)
+
+/*
+ * Places a constant in the external QSPI flash. The linker script maps the
+ * .cy_xip section at the XIP base address; the section is written by the
+ * programmer along with the internal flash.
+ */
+#if MBED_CONF_APP_QSPI_XIP_ENABLE
+#define QSPI_XIP_DATA                      CY_SECTION(".cy_xip")
+#else
+#define QSPI_XIP_DATA
+#endif
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+cy_rslt_t qspi_xip_init(void);
+
+#endif /* #ifndef QSPI_XIP_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,279 @@
+/******************************************************************************
+ * File Name: ram_report.cpp
+ *
+ * Description:
+ *   This file reports the RAM used by the application on the serial terminal:
+ *   the reserved stack and the stack high-water mark of every thread, with a
+ *   suggested stack size, and the current and peak heap use. The
+ *   fragmentation of the free heap is estimated by probing the largest block
+ *   that can be allocated. The heap allocations made after the boot are
+ *   counted against the steady state, in which the application allocates
+ *   nothing.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "ram_report.h"
+#include "mbed_stats.h"
+#include "app_log.h"
+
+#if MBED_CONF_APP_RAM_REPORT_ENABLE
+#if !defined(MBED_STACK_STATS_ENABLED) || !defined(MBED_HEAP_STATS_ENABLED)
+#error "ram-report-enable requires platform.stack-stats-enabled and platform.heap-stats-enabled in mbed_app.json"
+#endif
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+static mbed_stats_stack_t stack_stats[RAM_REPORT_MAX_THREADS];
+
+/* Time of the last report, in milliseconds since boot. */
+static uint64_t last_report_ms;
+static bool reported = false;
+
+/* Heap statistics at the end of the boot. */
+static mbed_stats_heap_t steady_heap;
+static bool steady = false;
+
+/* Bytes allocated by the largest block probes, not counted as allocations. */
+static uint64_t probe_bytes;
+
+/*
+ * Peak heap use of the application. The probes raise the peak recorded by
+ * Mbed OS; it is only used while an allocation of the application has
+ * exceeded the peak left by the last probe. The current use is sampled
+ * otherwise.
+ */
+static uint32_t heap_peak;
+static uint32_t probe_peak;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: ram_report_largest_block
+ ******************************************************************************
+ * Summary:
+ *   This function finds the largest block the heap can allocate, by a
+ *   binary search with malloc() and free().
+ *
+ * Parameters:
+ *   limit: Upper bound of the search, the free heap in bytes.
+ *
+ * Return:
+ *   uint32_t: Size of the largest block in bytes, within 8 bytes.
+ *
+ *****************************************************************************/
+static uint32_t ram_report_largest_block(uint32_t limit)
+{
+    uint32_t low = 0;
+    uint32_t high = limit;
+
+    while (high - low > 8)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        void *block = malloc(mid);
+
+        if (NULL != block)
+        {
+            free(block);
+            probe_bytes += mid;
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/******************************************************************************
+ * Function Name: ram_report_mark_steady
+ ******************************************************************************
+ * Summary:
+ *   This function records the heap use at the end of the boot. From then on,
+ *   the report counts the heap allocations made and reports an error if the
+ *   heap use has grown.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void ram_report_mark_steady(void)
+{
+    mbed_stats_heap_get(&steady_heap);
+    probe_bytes = 0;
+    steady = true;
+}
+
+/******************************************************************************
+ * Function Name: ram_report_print
+ ******************************************************************************
+ * Summary:
+ *   This function prints the stack use of every thread and the heap use.
+ *   The suggested stack size of a thread is its high-water mark plus
+ *   RAM_REPORT_STACK_MARGIN_PCT, rounded up to RAM_REPORT_STACK_ALIGN.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void ram_report_print(void)
+{
+    mbed_stats_heap_t heap;
+    mbed_stats_heap_t after_probe;
+    uint64_t probed = 0;
+    uint32_t reserved = 0;
+    uint32_t used = 0;
+    uint32_t free_heap = 0;
+    uint32_t largest = 0;
+    size_t count = mbed_stats_stack_get_each(stack_stats, RAM_REPORT_MAX_THREADS);
+
+    APP_INFO(("RAM report: %u threads\n", (unsigned int)count));
+    APP_INFO(("  %-16s %8s %8s %8s\n", "thread", "reserved", "max used", "suggest"));
+    for (size_t i = 0; i < count; i++)
+    {
+        const char *name = osThreadGetName((osThreadId_t)stack_stats[i].thread_id);
+        uint32_t suggest = stack_stats[i].max_size * (100 + RAM_REPORT_STACK_MARGIN_PCT) / 100;
+
+        suggest = (suggest + RAM_REPORT_STACK_ALIGN - 1) & ~(RAM_REPORT_STACK_ALIGN - 1);
+        reserved += stack_stats[i].reserved_size;
+        used += stack_stats[i].max_size;
+        APP_INFO(("  %-16s %8lu %8lu %8lu\n",
+                  (NULL != name) ? name : "?",
+                  (unsigned long)stack_stats[i].reserved_size,
+                  (unsigned long)stack_stats[i].max_size,
+                  (unsigned long)suggest));
+    }
+    APP_INFO(("  %-16s %8lu %8lu\n", "total", (unsigned long)reserved, (unsigned long)used));
+
+    /* One log per thread: drain the log ring before the heap lines. */
+    app_log_flush();
+
+    /* Read the statistics before the probe, which makes failed allocations. */
+    mbed_stats_heap_get(&heap);
+    if (heap.max_size > probe_peak)
+    {
+        heap_peak = heap.max_size;
+    }
+    else if (heap.current_size > heap_peak)
+    {
+        heap_peak = heap.current_size;
+    }
+
+    free_heap = heap.reserved_size - heap.current_size;
+    probed = probe_bytes;
+    largest = ram_report_largest_block(free_heap);
+    mbed_stats_heap_get(&after_probe);
+    probe_peak = after_probe.max_size;
+
+    APP_INFO(("  heap: reserved %lu current %lu peak %lu overhead %lu allocs %lu failed %lu\n",
+              (unsigned long)heap.reserved_size,
+              (unsigned long)heap.current_size,
+              (unsigned long)heap_peak,
+              (unsigned long)heap.overhead_size,
+              (unsigned long)heap.alloc_cnt,
+              (unsigned long)heap.alloc_fail_cnt));
+    APP_INFO(("  heap: free %lu largest block %lu fragmentation %lu%%\n",
+              (unsigned long)free_heap,
+              (unsigned long)largest,
+              (unsigned long)(free_heap ? 100 - ((uint64_t)largest * 100 / free_heap) : 0)));
+
+    if (steady)
+    {
+        APP_INFO(("  heap since boot: allocated %lu bytes, in use %+ld bytes\n",
+                  (unsigned long)(heap.total_size - steady_heap.total_size - probed),
+                  (long)heap.current_size - (long)steady_heap.current_size));
+        if (heap.current_size > steady_heap.current_size)
+        {
+            ERR_INFO(("Heap use grew by %lu bytes since the boot.\n",
+                      (unsigned long)(heap.current_size - steady_heap.current_size)));
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: ram_report_poll
+ ******************************************************************************
+ * Summary:
+ *   This function prints the RAM report at most once every
+ *   MBED_CONF_APP_RAM_REPORT_INTERVAL_S seconds. It is called while the host
+ *   is awake.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void ram_report_poll(void)
+{
+    uint64_t now_ms = Kernel::get_ms_count();
+
+    if (reported && ((now_ms - last_report_ms) < (MBED_CONF_APP_RAM_REPORT_INTERVAL_S * 1000ull)))
+    {
+        return;
+    }
+
+    reported = true;
+    last_report_ms = now_ms;
+    ram_report_print();
+}
+
+#else /* MBED_CONF_APP_RAM_REPORT_ENABLE */
+
+void ram_report_mark_steady(void)
+{
+}
+
+void ram_report_print(void)
+{
+}
+
+void ram_report_poll(void)
+{
+}
+
+#endif /* MBED_CONF_APP_RAM_REPORT_ENABLE */
+
+
+/* [] END OF FILE */
+
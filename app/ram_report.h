@@ -0,0 +1,80 @@
+/******************************************************************************
+ * File Name: ram_report.h
+ *
+ * Description:
+ *   This header file contains the macros and the function declarations of
+ *   the RAM report: stack high-water mark of every thread and peak heap use
+ *   with fragmentation.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef RAM_REPORT_H
+#define RAM_REPORT_H
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* RAM report is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_RAM_REPORT_ENABLE
+#define MBED_CONF_APP_RAM_REPORT_ENABLE    (0)
+#endif
+
+/* Minimum interval in seconds between two reports. */
+#ifndef MBED_CONF_APP_RAM_REPORT_INTERVAL_S
+#define MBED_CONF_APP_RAM_REPORT_INTERVAL_S (60)
+#endif
+
+/* Maximum number of threads reported. */
+#define RAM_REPORT_MAX_THREADS             (16)
+
+/*
+ * Margin in percent added to the stack high-water mark of a thread for the
+ * suggested stack size, which is also rounded up to RAM_REPORT_STACK_ALIGN.
+ */
+#define RAM_REPORT_STACK_MARGIN_PCT        (25)
+#define RAM_REPORT_STACK_ALIGN             (256)
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void ram_report_mark_steady(void);
+void ram_report_print(void);
+void ram_report_poll(void);
+
+#endif /* #ifndef RAM_REPORT_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,680 @@
+/******************************************************************************
+ * File Name: storm_detector.cpp
+ *
+ * Description:
+ *   This file contains the broadcast/multicast storm detector. It counts the
+ *   broadcast and multicast frames delivered to the host per kind (UDP
+ *   destination port, IP protocol or Ether type) in a fixed-size table, with
+ *   constant work per frame. When one kind exceeds the storm threshold, the
+ *   packet filter list of the WLAN device is changed to stop the storm: a
+ *   discard filter is added to an empty list, or the keep filter letting the
+ *   storm through is removed from a keep list. The previous list is restored
+ *   after a cool-down.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "mbed.h"
+#include "cy_lpa_wifi_ol.h"
+#include "WhdOlmInterface.h"
+#include "storm_detector.h"
+#include "pf_olm_config.h"
+#include "pf_tier_manager.h"
+#include "http_webserver_config.h"
+#include "pf_snapshot.h"
+#include "pf_commit_worker.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Ethernet, IPv4 and UDP header layout. */
+#define STORM_ETH_HDR_LEN          (14)
+#define STORM_ETH_TYPE_OFFSET      (12)
+#define STORM_ETH_TYPE_IPV4        (0x0800)
+#define STORM_ETH_TYPE_ARP         (0x0806)
+#define STORM_ETH_TYPE_EAPOL       (0x888E)
+#define STORM_IPV4_MIN_HDR_LEN     (20)
+#define STORM_IPV4_FRAG_OFFSET     (6)
+#define STORM_IPV4_FRAG_MASK       (0x1FFF)
+#define STORM_IPV4_PROTO_OFFSET    (9)
+#define STORM_IP_PROTO_TCP         (6)
+#define STORM_IP_PROTO_UDP         (17)
+#define STORM_UDP_DST_PORT_OFFSET  (2)
+#define STORM_UDP_PORT_DHCP_SERVER (67)
+#define STORM_UDP_PORT_DHCP_CLIENT (68)
+
+/* Reads a big-endian 16-bit value from a frame. */
+#define STORM_READ_BE16(p)         ((uint16_t)(((p)[0] << 8) | (p)[1]))
+
+/* A packet kind is encoded as its type in the upper half and its value. */
+#define STORM_KEY(kind, value)     (((uint32_t)(kind) << 16) | (uint16_t)(value))
+#define STORM_KEY_KIND(key)        ((key) >> 16)
+#define STORM_KEY_VALUE(key)       ((uint16_t)(key))
+
+/* Frames of one kind within a window considered a storm. */
+#define STORM_THRESHOLD            ((MBED_CONF_APP_STORM_THRESHOLD_PPS * \
+                                     MBED_CONF_APP_STORM_WINDOW_MS + 999) / 1000)
+
+/* The cool-down doubles when a storm resumes after a restore, up to 8 times. */
+#define STORM_COOLDOWN_MS          (MBED_CONF_APP_STORM_COOLDOWN_S * 1000ull)
+#define STORM_MAX_COOLDOWN_MS      (8 * STORM_COOLDOWN_MS)
+
+/******************************************************************************
+ *                                ENUMS
+ *****************************************************************************/
+/* Kinds of broadcast/multicast packets. */
+enum storm_kind
+{
+    STORM_KIND_NONE = 0,
+    STORM_KIND_ETH_TYPE,    /* Non-IPv4 Ether type      */
+    STORM_KIND_IP_TYPE,     /* IPv4 protocol but UDP    */
+    STORM_KIND_UDP_PORT     /* UDP destination port     */
+};
+
+/* State of the storm mitigation. */
+enum storm_state
+{
+    STORM_STATE_IDLE = 0,   /* No storm mitigated                      */
+    STORM_STATE_MITIGATED   /* Storm filtered, waiting for the restore */
+};
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Frame counter of one packet kind. */
+typedef struct
+{
+    uint32_t key;           /* Packet kind, 0 if the entry is free      */
+    uint32_t count;         /* Frames counted in the current window     */
+    uint32_t window_ms;     /* Start of the current window              */
+} storm_entry_t;
+
+/* Table of the packet kinds, indexed by a hash of the kind. */
+static storm_entry_t storm_table[STORM_TABLE_SIZE];
+
+/* Packet kind detected as a storm, 0 if none. */
+static volatile uint32_t storm_key = 0;
+
+/* Packet kind which cannot be filtered with the committed list. */
+static volatile uint32_t ignored_key = 0;
+static uint32_t ignored_commit = 0;
+
+static volatile uint8_t state = STORM_STATE_IDLE;
+static uint32_t mitigated_key = 0;
+static uint32_t mitigation_count = 0;
+
+/* Commit of the mitigation list, to detect a commit by another module. */
+static uint32_t mitigation_commit = 0;
+
+/* End of the current cool-down, its duration and the time of the restore. */
+static uint64_t cooldown_end_ms = 0;
+static uint64_t cooldown_ms = STORM_COOLDOWN_MS;
+static uint64_t restore_ms = 0;
+
+/* Packet filter list in use before the mitigation. */
+static cy_pf_ol_cfg_t saved_list[MAX_FILTERS];
+static pf_ipv6_attrs_t saved_ipv6;
+static uint8_t saved_count = 0;
+static bool saved_default = false;
+
+/* Mitigation list. */
+static cy_pf_ol_cfg_t storm_list[MAX_FILTERS];
+static pf_ipv6_attrs_t storm_ipv6;
+
+/* Set while a list of the detector waits for the commit thread, and the
+ * packet kind its mitigation list filters.
+ */
+static volatile bool commit_queued = false;
+static uint32_t queued_key = 0;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: storm_frame_key
+ ******************************************************************************
+ * Summary:
+ *   This function returns the packet kind of a broadcast or multicast frame.
+ *   The most specific kind is used: the UDP destination port for UDP, the IP
+ *   protocol for other IPv4 packets and the Ether type otherwise. The kinds
+ *   needed to keep the connection to the AP (ARP, EAPOL and DHCP) are never
+ *   reported.
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   uint32_t: Packet kind, 0 for unicast or ignored frames.
+ *
+ *****************************************************************************/
+static uint32_t storm_frame_key(const uint8_t *frame, uint32_t len)
+{
+    const uint8_t *ip = &frame[STORM_ETH_HDR_LEN];
+    uint16_t eth_type = 0;
+    uint16_t port = 0;
+    uint32_t ip_hdr_len = 0;
+
+    /* Only the group addressed frames are counted. */
+    if ((STORM_ETH_HDR_LEN > len) || !(frame[0] & 0x01))
+    {
+        return 0;
+    }
+
+    eth_type = STORM_READ_BE16(&frame[STORM_ETH_TYPE_OFFSET]);
+    if ((STORM_ETH_TYPE_ARP == eth_type) || (STORM_ETH_TYPE_EAPOL == eth_type))
+    {
+        return 0;
+    }
+    if (STORM_ETH_TYPE_IPV4 != eth_type)
+    {
+        return STORM_KEY(STORM_KIND_ETH_TYPE, eth_type);
+    }
+
+    /* Non-first fragments carry no port; filtering their protocol would
+     * filter every packet of that protocol.
+     */
+    if (((STORM_ETH_HDR_LEN + STORM_IPV4_MIN_HDR_LEN) > len) ||
+        (STORM_READ_BE16(&ip[STORM_IPV4_FRAG_OFFSET]) & STORM_IPV4_FRAG_MASK))
+    {
+        return 0;
+    }
+
+    switch (ip[STORM_IPV4_PROTO_OFFSET])
+    {
+        case STORM_IP_PROTO_TCP:
+            return 0;
+        case STORM_IP_PROTO_UDP:
+            ip_hdr_len = (ip[0] & 0x0F) * 4;
+            if ((STORM_ETH_HDR_LEN + ip_hdr_len + STORM_UDP_DST_PORT_OFFSET + 2) > len)
+            {
+                return 0;
+            }
+            port = STORM_READ_BE16(&ip[ip_hdr_len + STORM_UDP_DST_PORT_OFFSET]);
+            if ((STORM_UDP_PORT_DHCP_SERVER == port) || (STORM_UDP_PORT_DHCP_CLIENT == port))
+            {
+                return 0;
+            }
+            return STORM_KEY(STORM_KIND_UDP_PORT, port);
+        default:
+            return STORM_KEY(STORM_KIND_IP_TYPE, ip[STORM_IPV4_PROTO_OFFSET]);
+    }
+}
+
+/******************************************************************************
+ * Function Name: storm_detector_input
+ ******************************************************************************
+ * Summary:
+ *   This function counts a frame delivered to the host. It is called in the
+ *   receive path for every frame and does a constant amount of work: the
+ *   packet kind is counted in one entry of the table, selected by a hash of
+ *   the kind. A kind colliding with the kind counted in the entry decrements
+ *   its count and takes the entry over when the count drops to zero, so that
+ *   a storm displaces the background traffic. The first kind reaching the
+ *   threshold within a window is reported to storm_detector_poll().
+ *
+ * Parameters:
+ *   frame: Pointer to the start of the Ethernet frame.
+ *   len: Length of the frame.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void storm_detector_input(const uint8_t *frame, uint32_t len)
+{
+#if MBED_CONF_APP_STORM_DETECTOR_ENABLE
+    uint32_t key = 0;
+    uint32_t now_ms = 0;
+    storm_entry_t *entry = NULL;
+
+    if (NULL == frame)
+    {
+        return;
+    }
+
+    key = storm_frame_key(frame, len);
+    if (0 == key)
+    {
+        return;
+    }
+
+    now_ms = (uint32_t)Kernel::get_ms_count();
+    entry = &storm_table[((key * 2654435761u) >> 16) & (STORM_TABLE_SIZE - 1)];
+
+    /* Start a new window when the current one has expired. */
+    if ((now_ms - entry->window_ms) >= MBED_CONF_APP_STORM_WINDOW_MS)
+    {
+        entry->window_ms = now_ms;
+        entry->count = 0;
+    }
+
+    if (entry->key != key)
+    {
+        if (0 != entry->count)
+        {
+            entry->count--;
+            return;
+        }
+        entry->key = key;
+    }
+
+    entry->count++;
+    if ((STORM_THRESHOLD == entry->count) && (STORM_STATE_IDLE == state) &&
+        (0 == storm_key) && (ignored_key != key))
+    {
+        storm_key = key;
+    }
+#endif /* MBED_CONF_APP_STORM_DETECTOR_ENABLE */
+}
+
+#if MBED_CONF_APP_STORM_DETECTOR_ENABLE
+/******************************************************************************
+ * Function Name: storm_filter_matches
+ ******************************************************************************
+ * Summary:
+ *   This function tells whether a packet filter matches exactly one packet
+ *   kind.
+ *
+ * Parameters:
+ *   cfg: Packet filter configuration.
+ *   key: Packet kind.
+ *
+ * Return:
+ *   bool: Returns true if the filter matches the packet kind.
+ *
+ *****************************************************************************/
+static bool storm_filter_matches(const cy_pf_ol_cfg_t *cfg, uint32_t key)
+{
+    switch (STORM_KEY_KIND(key))
+    {
+        case STORM_KIND_UDP_PORT:
+            return (CY_PF_OL_FEAT_PORTNUM == cfg->feature) &&
+                   (CY_PF_PROTOCOL_UDP == cfg->u.pf.proto) &&
+                   (PF_PN_PORT_DEST == cfg->u.pf.portnum.direction) &&
+                   (STORM_KEY_VALUE(key) == cfg->u.pf.portnum.portnum);
+        case STORM_KIND_IP_TYPE:
+            return (CY_PF_OL_FEAT_IPTYPE == cfg->feature) &&
+                   (STORM_KEY_VALUE(key) == cfg->u.ip.ip_type);
+        case STORM_KIND_ETH_TYPE:
+            return (CY_PF_OL_FEAT_ETHTYPE == cfg->feature) &&
+                   (STORM_KEY_VALUE(key) == cfg->u.eth.eth_type);
+        default:
+            return false;
+    }
+}
+
+/******************************************************************************
+ * Function Name: storm_discard_filter
+ ******************************************************************************
+ * Summary:
+ *   This function builds the discard filter of a packet kind.
+ *
+ * Parameters:
+ *   key: Packet kind.
+ *   cfg: Pointer to the packet filter configuration to fill.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void storm_discard_filter(uint32_t key, cy_pf_ol_cfg_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->bits = CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE | CY_PF_ACTION_DISCARD;
+
+    switch (STORM_KEY_KIND(key))
+    {
+        case STORM_KIND_UDP_PORT:
+            cfg->feature = CY_PF_OL_FEAT_PORTNUM;
+            cfg->u.pf.proto = CY_PF_PROTOCOL_UDP;
+            cfg->u.pf.portnum.direction = PF_PN_PORT_DEST;
+            cfg->u.pf.portnum.portnum = STORM_KEY_VALUE(key);
+            break;
+        case STORM_KIND_IP_TYPE:
+            cfg->feature = CY_PF_OL_FEAT_IPTYPE;
+            cfg->u.ip.ip_type = (uint8_t)STORM_KEY_VALUE(key);
+            break;
+        default:
+            cfg->feature = CY_PF_OL_FEAT_ETHTYPE;
+            cfg->u.eth.eth_type = STORM_KEY_VALUE(key);
+            break;
+    }
+}
+
+/******************************************************************************
+ * Function Name: storm_copy_list
+ ******************************************************************************
+ * Summary:
+ *   This function copies a packet filter list up to its terminating entry.
+ *
+ * Parameters:
+ *   src: Packet filter list to copy.
+ *   dst: Array of MAX_FILTERS entries to copy the list into.
+ *
+ * Return:
+ *   uint8_t: Number of packet filters copied.
+ *
+ *****************************************************************************/
+static uint8_t storm_copy_list(const cy_pf_ol_cfg_t *src, cy_pf_ol_cfg_t *dst)
+{
+    uint8_t count = 0;
+
+    while ((count < get_max_filter()) && (0 != src[count].feature) &&
+           (CY_PF_OL_FEAT_LAST != src[count].feature))
+    {
+        dst[count] = src[count];
+        count++;
+    }
+
+    return count;
+}
+
+/******************************************************************************
+ * Function Name: storm_build_list
+ ******************************************************************************
+ * Summary:
+ *   This function builds the list which stops a storm from the active list.
+ *   The WLAN device accepts either keep filters or a single discard filter.
+ *   With keep filters, the keep filter matching the storm is removed. With
+ *   no filter, a discard filter for the storm is added.
+ *
+ * Parameters:
+ *   key: Packet kind of the storm.
+ *   count: Pointer to hold the number of filters of the list.
+ *
+ * Return:
+ *   cy_rslt_t: Returns CY_RSLT_SUCCESS or CY_RSLT_TYPE_ERROR if the storm
+ *     cannot be stopped by changing the active list.
+ *
+ *****************************************************************************/
+static cy_rslt_t storm_build_list(uint32_t key, uint8_t *count)
+{
+    uint8_t removed = 0;
+    uint8_t n = 0;
+
+    *count = 0;
+    memset(&storm_ipv6, 0, sizeof(storm_ipv6));
+
+    if (0 == saved_count)
+    {
+        storm_discard_filter(key, &storm_list[0]);
+        *count = 1;
+        return CY_RSLT_SUCCESS;
+    }
+
+    if (saved_list[0].bits & CY_PF_ACTION_DISCARD)
+    {
+        ERR_INFO(("Storm: The WLAN device accepts a single discard filter\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (uint8_t i = 0; i < saved_count; i++)
+    {
+        if (storm_filter_matches(&saved_list[i], key))
+        {
+            removed++;
+            continue;
+        }
+        storm_list[n] = saved_list[i];
+        storm_list[n].id = n;
+        storm_ipv6.attr[n] = *pf_list_ipv6_attr(&saved_ipv6, &saved_list[i]);
+        n++;
+    }
+
+    if ((0 == removed) || (0 == n))
+    {
+        ERR_INFO(("Storm: No keep filter to narrow the list\n"));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    *count = n;
+    return CY_RSLT_SUCCESS;
+}
+
+/******************************************************************************
+ * Function Name: storm_mitigation_done
+ ******************************************************************************
+ * Summary:
+ *   This function is called on the commit thread once the mitigation list
+ *   is committed. The cool-down starts once the list is in force. A
+ *   mitigation whose commit failed is not counted and nothing is restored
+ *   for it; the storm is handled again when it is detected again.
+ *
+ * Parameters:
+ *   result: Result of the commit.
+ *   commit: Commit count of the list, 0 if it was not committed.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void storm_mitigation_done(cy_rslt_t result, uint32_t commit)
+{
+    if ((CY_RSLT_SUCCESS != result) || (0 == commit))
+    {
+        ERR_INFO(("Storm: Failed to commit the packet filter list\n"));
+    }
+    else
+    {
+        mitigated_key = queued_key;
+        mitigation_count++;
+        mitigation_commit = commit;
+        cooldown_end_ms = Kernel::get_ms_count() + cooldown_ms;
+        state = STORM_STATE_MITIGATED;
+    }
+
+    commit_queued = false;
+}
+
+/******************************************************************************
+ * Function Name: storm_restore_done
+ ******************************************************************************
+ * Summary:
+ *   This function is called on the commit thread once the list in use
+ *   before the mitigation is restored.
+ *
+ * Parameters:
+ *   result: Result of the commit.
+ *   commit: Commit count of the list, 0 if it was not committed.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void storm_restore_done(cy_rslt_t result, uint32_t commit)
+{
+    (void)commit;
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Storm: Failed to restore the packet filter list\n"));
+    }
+
+    commit_queued = false;
+}
+#endif /* MBED_CONF_APP_STORM_DETECTOR_ENABLE */
+
+/******************************************************************************
+ * Function Name: storm_detector_poll
+ ******************************************************************************
+ * Summary:
+ *   This function applies and lifts the storm mitigation. It is called from
+ *   the wake event of the event queue. A detected storm is stopped by
+ *   queuing a new list on the commit worker, so that the reassociation does
+ *   not stall the event queue; the previous list is restored the same way
+ *   at the end of the cool-down, unless another list was committed
+ *   meanwhile. Nothing is done while a list of the detector is queued. The cool-down
+ *   doubles each time a storm is detected again within one cool-down of the
+ *   restore. Nothing is done while the tiered filter manager owns the list.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void storm_detector_poll(void)
+{
+#if MBED_CONF_APP_STORM_DETECTOR_ENABLE
+    uint64_t now_ms = Kernel::get_ms_count();
+    uint32_t key = storm_key;
+    uint8_t count = 0;
+    pf_snapshot_reader_t reader;
+    const pf_snapshot_t *snapshot = NULL;
+
+    if (commit_queued)
+    {
+        return;
+    }
+
+    if (STORM_STATE_MITIGATED == state)
+    {
+        if (now_ms < cooldown_end_ms)
+        {
+            return;
+        }
+
+        state = STORM_STATE_IDLE;
+        restore_ms = now_ms;
+        if (pf_get_commit_count() != mitigation_commit)
+        {
+            APP_INFO(("Storm: Packet filter list replaced, not restored\n"));
+            return;
+        }
+
+        APP_INFO(("Storm: Cool-down over, restoring the packet filter list\n"));
+        commit_queued = true;
+        pf_commit_request_cfgs(saved_default ? NULL : saved_list, &saved_ipv6, saved_count,
+                               mbed::callback(storm_restore_done));
+        return;
+    }
+
+    /* A new list may stop a storm the previous one could not. */
+    if ((0 != ignored_key) && (pf_get_commit_count() != ignored_commit))
+    {
+        ignored_key = 0;
+    }
+
+    if (0 == key)
+    {
+        return;
+    }
+    storm_key = 0;
+
+    if (pf_tier_is_active())
+    {
+        return;
+    }
+
+    reader = pf_snapshot_read_lock();
+    snapshot = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+    saved_default = snapshot->is_default;
+    saved_count = storm_copy_list(snapshot->cfgs, saved_list);
+    saved_ipv6 = snapshot->ipv6;
+    pf_snapshot_read_unlock(reader);
+
+    APP_INFO(("Storm: %s %u above %d packets/s\n",
+              (STORM_KIND_UDP_PORT == STORM_KEY_KIND(key)) ? "UDP port" :
+              (STORM_KIND_IP_TYPE == STORM_KEY_KIND(key)) ? "IP type" : "Ether type",
+              STORM_KEY_VALUE(key), MBED_CONF_APP_STORM_THRESHOLD_PPS));
+
+    if (CY_RSLT_SUCCESS != storm_build_list(key, &count))
+    {
+        ignored_key = key;
+        ignored_commit = pf_get_commit_count();
+        return;
+    }
+
+    if ((0 != restore_ms) && ((now_ms - restore_ms) < cooldown_ms))
+    {
+        cooldown_ms = (2 * cooldown_ms < STORM_MAX_COOLDOWN_MS) ? 2 * cooldown_ms :
+                                                                  STORM_MAX_COOLDOWN_MS;
+    }
+    else
+    {
+        cooldown_ms = STORM_COOLDOWN_MS;
+    }
+
+    /* The list is committed without touching the pending list of the
+     * user. The mitigation is in force once its commit is done.
+     */
+    queued_key = key;
+    commit_queued = true;
+    pf_commit_request_cfgs(storm_list, &storm_ipv6, count, mbed::callback(storm_mitigation_done));
+#endif /* MBED_CONF_APP_STORM_DETECTOR_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: storm_detector_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the state of the storm detector as text.
+ *
+ * Parameters:
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int storm_detector_report(char *buf, size_t buf_len)
+{
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    if (STORM_STATE_MITIGATED == state)
+    {
+        len = snprintf(buf, buf_len, "Storm mitigations: %lu, filtering %s %u\n",
+                       (unsigned long)mitigation_count,
+                       (STORM_KIND_UDP_PORT == STORM_KEY_KIND(mitigated_key)) ? "UDP port" :
+                       (STORM_KIND_IP_TYPE == STORM_KEY_KIND(mitigated_key)) ? "IP type" : "Ether type",
+                       STORM_KEY_VALUE(mitigated_key));
+    }
+    else
+    {
+        len = snprintf(buf, buf_len, "Storm mitigations: %lu\n",
+                       (unsigned long)mitigation_count);
+    }
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+
+/* [] END OF FILE */
+
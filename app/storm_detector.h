@@ -0,0 +1,86 @@
+/******************************************************************************
+ * File Name: storm_detector.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations of the
+ *   broadcast/multicast storm detector.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef STORM_DETECTOR_H
+#define STORM_DETECTOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Storm detector is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_STORM_DETECTOR_ENABLE
+#define MBED_CONF_APP_STORM_DETECTOR_ENABLE  (0)
+#endif
+
+/* Broadcast/multicast packets per second of one kind considered a storm. */
+#ifndef MBED_CONF_APP_STORM_THRESHOLD_PPS
+#define MBED_CONF_APP_STORM_THRESHOLD_PPS  (50)
+#endif
+
+/* Window in milliseconds over which the packet rate is measured. */
+#ifndef MBED_CONF_APP_STORM_WINDOW_MS
+#define MBED_CONF_APP_STORM_WINDOW_MS      (1000)
+#endif
+
+/* Time in seconds before the packet filter list is restored. */
+#ifndef MBED_CONF_APP_STORM_COOLDOWN_S
+#define MBED_CONF_APP_STORM_COOLDOWN_S     (300)
+#endif
+
+/* Number of packet kinds tracked at the same time. Must be a power of 2. */
+#define STORM_TABLE_SIZE                   (16)
+
+/* Buffer length required to report the detector state as text. */
+#define STORM_REPORT_LEN                   (128)
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void storm_detector_input(const uint8_t *frame, uint32_t len);
+void storm_detector_poll(void);
+int storm_detector_report(char *buf, size_t buf_len);
+
+#endif /* #ifndef STORM_DETECTOR_H */
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,430 @@
+/******************************************************************************
+ * File Name: tko_offload.cpp
+ *
+ * Description:
+ *   This file contains the TCP keep-alive offload of the Offload Manager. The
+ *   application holds a TCP connection to a collector. Before each network
+ *   stack suspension, the 4-tuple of the connection is set in the offload
+ *   configuration; the Offload Manager reads the sequence numbers from the
+ *   network stack and the WLAN device sends the keep-alives while the host
+ *   sleeps. On resume, the network stack sends them again. The wakes per hour
+ *   with and without the offloaded connection are measured for comparison.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "tko_offload.h"
+#include "wake_latency.h"
+#include "app_events.h"
+#include "app_log.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Timeout in milliseconds of the connect to the collector. */
+#define TKO_CONNECT_TIMEOUT_MS             (5000)
+
+/* Interval in milliseconds between two polls of a connect in progress. */
+#define TKO_CONNECT_POLL_MS                (100)
+
+/* Minimum interval in milliseconds between two connect attempts. */
+#define TKO_RECONNECT_INTERVAL_MS          (MBED_CONF_APP_TKO_INTERVAL_S * 1000)
+
+/* Length of the buffer draining the data sent by the collector. */
+#define TKO_DRAIN_LEN                      (64)
+
+/******************************************************************************
+ *                               TYPEDEFS
+ *****************************************************************************/
+/* Time slept and wakes counted over the suspensions of one kind. */
+typedef struct
+{
+    uint64_t ms;
+    uint32_t wakes;
+    uint32_t suspends;
+} tko_wake_stats_t;
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Only the first connection is used; no connection is offloaded while its
+ * remote port is 0.
+ */
+cy_tko_ol_cfg_t tko_ol_cfg =
+{
+    .interval = MBED_CONF_APP_TKO_INTERVAL_S,
+    .retry_interval = MBED_CONF_APP_TKO_RETRY_INTERVAL_S,
+    .retry_count = MBED_CONF_APP_TKO_RETRY_COUNT,
+    .ports = {},
+};
+
+#if MBED_CONF_APP_TKO_ENABLE
+/* The socket is only used from the event queue; the thread suspending the
+ * network stack only reads tko_connected.
+ */
+static TCPSocket tko_socket;
+static NetworkInterface *volatile tko_iface;
+static volatile bool tko_connected;
+static bool tko_connecting;
+static bool tko_attempted;
+static uint64_t tko_connect_ms;
+static uint32_t tko_connect_count;
+
+/* Statistics without [0] and with [1] an offloaded connection. */
+static tko_wake_stats_t tko_stats[2];
+static bool tko_offloaded;
+static uint64_t tko_suspend_ms;
+static uint32_t tko_suspend_wakes;
+#endif /* MBED_CONF_APP_TKO_ENABLE */
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+#if MBED_CONF_APP_TKO_ENABLE
+/******************************************************************************
+ * Function Name: tko_connect_start
+ ******************************************************************************
+ * Summary:
+ *   This function opens the socket to the collector from the fixed local
+ *   port and starts a non-blocking connect. The network stack sends the
+ *   keep-alives while the host is awake.
+ *
+ * Parameters:
+ *   iface: Connected network interface.
+ *
+ * Return:
+ *   nsapi_error_t: NSAPI_ERROR_IN_PROGRESS while the connect runs, else the
+ *     result of the connect.
+ *
+ *****************************************************************************/
+static nsapi_error_t tko_connect_start(NetworkInterface *iface)
+{
+    SocketAddress remote(MBED_CONF_APP_TKO_REMOTE_IP, MBED_CONF_APP_TKO_REMOTE_PORT);
+    int keepalive_ms = MBED_CONF_APP_TKO_INTERVAL_S * 1000;
+    int enable = 1;
+    nsapi_error_t err = NSAPI_ERROR_OK;
+
+    err = tko_socket.open(iface);
+    if (NSAPI_ERROR_OK != err)
+    {
+        ERR_INFO(("TKO: Failed to open the socket, error %d\n", err));
+        return err;
+    }
+
+    /* The previous connection may still hold the local port. */
+    tko_socket.setsockopt(NSAPI_SOCKET, NSAPI_REUSEADDR, &enable, sizeof(enable));
+    tko_socket.setsockopt(NSAPI_SOCKET, NSAPI_KEEPALIVE, &enable, sizeof(enable));
+    tko_socket.setsockopt(NSAPI_SOCKET, NSAPI_KEEPIDLE, &keepalive_ms, sizeof(keepalive_ms));
+    tko_socket.setsockopt(NSAPI_SOCKET, NSAPI_KEEPINTVL, &keepalive_ms, sizeof(keepalive_ms));
+
+    err = tko_socket.bind(MBED_CONF_APP_TKO_LOCAL_PORT);
+    if (NSAPI_ERROR_OK == err)
+    {
+        tko_socket.set_blocking(false);
+        err = tko_socket.connect(remote);
+    }
+
+    return err;
+}
+
+/******************************************************************************
+ * Function Name: tko_connect_poll
+ ******************************************************************************
+ * Summary:
+ *   This function polls the connect in progress to the collector.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   nsapi_error_t: NSAPI_ERROR_IN_PROGRESS while the connect runs, else the
+ *     result of the connect.
+ *
+ *****************************************************************************/
+static nsapi_error_t tko_connect_poll(void)
+{
+    SocketAddress remote(MBED_CONF_APP_TKO_REMOTE_IP, MBED_CONF_APP_TKO_REMOTE_PORT);
+    nsapi_error_t err = tko_socket.connect(remote);
+
+    if (NSAPI_ERROR_IS_CONNECTED == err)
+    {
+        return NSAPI_ERROR_OK;
+    }
+    if (NSAPI_ERROR_ALREADY == err)
+    {
+        return NSAPI_ERROR_IN_PROGRESS;
+    }
+
+    return err;
+}
+
+/******************************************************************************
+ * Function Name: tko_alive
+ ******************************************************************************
+ * Summary:
+ *   This function drains the data sent by the collector and tells whether
+ *   the connection is still open. A connection given up by the WLAN device
+ *   while the host slept is reset or closed by the collector.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: true if the connection is open.
+ *
+ *****************************************************************************/
+static bool tko_alive(void)
+{
+    uint8_t drain[TKO_DRAIN_LEN];
+    nsapi_size_or_error_t ret = 0;
+
+    do
+    {
+        ret = tko_socket.recv(drain, sizeof(drain));
+        if (0 < ret)
+        {
+            WAKE_LATENCY_MARK(WAKE_MARK_SOCKET_DELIVERY);
+        }
+    } while (0 < ret);
+
+    return NSAPI_ERROR_WOULD_BLOCK == ret;
+}
+
+/******************************************************************************
+ * Function Name: tko_connect_event
+ ******************************************************************************
+ * Summary:
+ *   This function is the event checking the connection to the collector
+ *   while the host is awake. It closes a lost connection and opens it again
+ *   at most every TKO_RECONNECT_INTERVAL_MS. The connect never blocks: the
+ *   event polls it again until it completes or times out. A connection
+ *   established is offloaded from the next suspension on.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void tko_connect_event(void)
+{
+    uint64_t now_ms = Kernel::get_ms_count();
+    nsapi_error_t err = NSAPI_ERROR_OK;
+
+    if (tko_connected)
+    {
+        if (tko_alive())
+        {
+            return;
+        }
+        APP_INFO(("TKO: Connection to the collector lost\n"));
+        tko_connected = false;
+        tko_socket.close();
+        tko_connect_ms = now_ms;
+    }
+
+    if (tko_connecting)
+    {
+        err = tko_connect_poll();
+        if ((NSAPI_ERROR_IN_PROGRESS == err) &&
+            (now_ms - tko_connect_ms >= TKO_CONNECT_TIMEOUT_MS))
+        {
+            err = NSAPI_ERROR_TIMEOUT;
+        }
+    }
+    else if ((0 != MBED_CONF_APP_TKO_REMOTE_PORT) && (NULL != tko_iface) &&
+             (!tko_attempted || (now_ms - tko_connect_ms >= TKO_RECONNECT_INTERVAL_MS)))
+    {
+        tko_attempted = true;
+        tko_connecting = true;
+        tko_connect_ms = now_ms;
+        err = tko_connect_start(tko_iface);
+    }
+    else
+    {
+        return;
+    }
+
+    if (NSAPI_ERROR_IN_PROGRESS == err)
+    {
+        app_events_post_in(APP_EVENT_TKO, TKO_CONNECT_POLL_MS, tko_connect_event);
+        return;
+    }
+
+    tko_connecting = false;
+    if (NSAPI_ERROR_OK != err)
+    {
+        ERR_INFO(("TKO: Failed to connect to %s:%u, error %d\n",
+                  MBED_CONF_APP_TKO_REMOTE_IP, MBED_CONF_APP_TKO_REMOTE_PORT, err));
+        tko_socket.close();
+        return;
+    }
+
+    tko_connect_count++;
+    tko_connected = true;
+    APP_INFO(("TKO: Connected to %s:%u from port %u\n", MBED_CONF_APP_TKO_REMOTE_IP,
+              MBED_CONF_APP_TKO_REMOTE_PORT, MBED_CONF_APP_TKO_LOCAL_PORT));
+}
+#endif /* MBED_CONF_APP_TKO_ENABLE */
+
+/******************************************************************************
+ * Function Name: tko_offload_suspend
+ ******************************************************************************
+ * Summary:
+ *   This function sets the connection to the collector in the offload
+ *   configuration before the network stack is suspended, if it is
+ *   established. The Offload Manager reads the configuration and the
+ *   sequence numbers of the connection when the host goes to sleep. It is
+ *   called from the thread suspending the network stack and never blocks:
+ *   the connection is opened from the event queue, first posted here.
+ *
+ * Parameters:
+ *   iface: Connected network interface.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void tko_offload_suspend(NetworkInterface *iface)
+{
+#if MBED_CONF_APP_TKO_ENABLE
+    bool connected = tko_connected;
+
+    if (NULL == tko_iface)
+    {
+        tko_iface = iface;
+        app_events_post(APP_EVENT_TKO, tko_connect_event);
+    }
+
+    memset(&tko_ol_cfg.ports[0], 0, sizeof(tko_ol_cfg.ports[0]));
+    if (connected)
+    {
+        tko_ol_cfg.ports[0].local_port = MBED_CONF_APP_TKO_LOCAL_PORT;
+        tko_ol_cfg.ports[0].remote_port = MBED_CONF_APP_TKO_REMOTE_PORT;
+        strncpy(tko_ol_cfg.ports[0].remote_ip, MBED_CONF_APP_TKO_REMOTE_IP,
+                sizeof(tko_ol_cfg.ports[0].remote_ip) - 1);
+    }
+
+    tko_offloaded = connected;
+    tko_suspend_ms = Kernel::get_ms_count();
+    tko_suspend_wakes = wake_latency_get_wake_count();
+#else
+    (void)iface;
+#endif /* MBED_CONF_APP_TKO_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: tko_offload_resume
+ ******************************************************************************
+ * Summary:
+ *   This function accounts the time and the wakes since the network stack
+ *   was suspended to the statistics with or without an offloaded connection.
+ *   The Offload Manager has already handed the connection back to the
+ *   network stack. It then posts the check of the connection, which runs
+ *   while the host is awake. It is called from the thread suspending the
+ *   network stack, after the resume.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void tko_offload_resume(void)
+{
+#if MBED_CONF_APP_TKO_ENABLE
+    tko_wake_stats_t *stats = &tko_stats[tko_offloaded ? 1 : 0];
+
+    stats->ms += Kernel::get_ms_count() - tko_suspend_ms;
+    stats->wakes += wake_latency_get_wake_count() - tko_suspend_wakes;
+    stats->suspends++;
+
+    app_events_post(APP_EVENT_TKO, tko_connect_event);
+#endif /* MBED_CONF_APP_TKO_ENABLE */
+}
+
+/******************************************************************************
+ * Function Name: tko_offload_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the state of the connection to the collector and
+ *   the wakes per hour with and without the offloaded connection as text.
+ *
+ * Parameters:
+ *   buf: Buffer receiving the text.
+ *   buf_len: Length of the buffer.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int tko_offload_report(char *buf, size_t buf_len)
+{
+#if MBED_CONF_APP_TKO_ENABLE
+    uint32_t per_hour[2] = {0};
+    int len = 0;
+
+    if ((NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (0 != tko_stats[i].ms)
+        {
+            per_hour[i] = (uint32_t)((uint64_t)tko_stats[i].wakes * 3600000u / tko_stats[i].ms);
+        }
+    }
+
+    len = snprintf(buf, buf_len, "TKO: %s %s:%u, connects %lu\n"
+                   "TKO wakes/hour: offloaded %lu (%lu suspends), "
+                   "not offloaded %lu (%lu suspends)\n",
+                   tko_connected ? "connected to" : "not connected to",
+                   MBED_CONF_APP_TKO_REMOTE_IP, MBED_CONF_APP_TKO_REMOTE_PORT,
+                   (unsigned long)tko_connect_count,
+                   (unsigned long)per_hour[1], (unsigned long)tko_stats[1].suspends,
+                   (unsigned long)per_hour[0], (unsigned long)tko_stats[0].suspends);
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+#else
+    (void)buf;
+    (void)buf_len;
+    return 0;
+#endif /* MBED_CONF_APP_TKO_ENABLE */
+}
+
+
+/* [] END OF FILE */
+
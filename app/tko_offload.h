@@ -0,0 +1,107 @@
+/******************************************************************************
+ * File Name: tko_offload.h
+ *
+ * Description:
+ *   This header file contains the macros and the function declarations of
+ *   the TCP keep-alive offload, which lets the WLAN device send the TCP
+ *   keep-alives of a connection to a collector while the host sleeps.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef TKO_OFFLOAD_H
+#define TKO_OFFLOAD_H
+
+#include "mbed.h"
+#include "cy_lpa_wifi_tko_ol.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* TCP keep-alive offload is disabled unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_TKO_ENABLE
+#define MBED_CONF_APP_TKO_ENABLE           (0)
+#endif
+
+/* IPv4 address of the collector the connection is held to. */
+#ifndef MBED_CONF_APP_TKO_REMOTE_IP
+#define MBED_CONF_APP_TKO_REMOTE_IP        ""
+#endif
+
+/* TCP port of the collector. */
+#ifndef MBED_CONF_APP_TKO_REMOTE_PORT
+#define MBED_CONF_APP_TKO_REMOTE_PORT      (0)
+#endif
+
+/* Local TCP port of the connection, fixed so the 4-tuple is known. */
+#ifndef MBED_CONF_APP_TKO_LOCAL_PORT
+#define MBED_CONF_APP_TKO_LOCAL_PORT       (50007)
+#endif
+
+/* Interval in seconds between two keep-alives. */
+#ifndef MBED_CONF_APP_TKO_INTERVAL_S
+#define MBED_CONF_APP_TKO_INTERVAL_S       (20)
+#endif
+
+/* Interval in seconds between two retries of an unanswered keep-alive. */
+#ifndef MBED_CONF_APP_TKO_RETRY_INTERVAL_S
+#define MBED_CONF_APP_TKO_RETRY_INTERVAL_S (3)
+#endif
+
+/* Unanswered keep-alives after which the connection is given up. */
+#ifndef MBED_CONF_APP_TKO_RETRY_COUNT
+#define MBED_CONF_APP_TKO_RETRY_COUNT      (3)
+#endif
+
+/* Buffer length required to report the offload state as text. */
+#define TKO_OFFLOAD_REPORT_LEN             (192)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Configuration of the TCP keep-alive offload referenced by the offload
+ * lists.
+ */
+extern cy_tko_ol_cfg_t tko_ol_cfg;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void tko_offload_suspend(NetworkInterface *iface);
+void tko_offload_resume(void);
+int tko_offload_report(char *buf, size_t buf_len);
+
+#endif /* #ifndef TKO_OFFLOAD_H */
+
+
+/* [] END OF FILE */
+
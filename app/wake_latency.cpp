@@ -0,0 +1,589 @@
+/******************************************************************************
+ * File Name: wake_latency.cpp
+ *
+ * Description:
+ *   This file contains the wake latency instrumentation. It timestamps each
+ *   stage from the return from deep sleep to the delivery of the first data
+ *   to an application socket with the DWT cycle counter and accumulates the
+ *   results in fixed-size histograms which can be reported on the console or
+ *   over HTTP. Only the wakes caused by the WLAN host wake interrupt are
+ *   measured.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include "wake_latency.h"
+#include "cybsp.h"
+#include "cyhal_syspm.h"
+#include "http_webserver_config.h"
+
+#if MBED_CONF_APP_WAKE_LATENCY_ENABLE
+/******************************************************************************
+ *                                ENUMS
+ *****************************************************************************/
+/* Progress of the wake currently being measured. */
+enum wake_state
+{
+    WAKE_STATE_IDLE = 0,    /* No wake pending, or wake abandoned */
+    WAKE_STATE_RESUMED,     /* WFI returned, host wake pending    */
+    WAKE_STATE_WOKEN,       /* WLAN host wake interrupt serviced  */
+    WAKE_STATE_EMAC_RX,     /* First frame reached the EMAC       */
+    WAKE_STATE_STACK_INPUT  /* First frame handed over to lwIP    */
+};
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* Latency histogram of one stage. All values are in microseconds. */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[WAKE_LATENCY_BUCKETS];
+} wake_histogram_t;
+
+static wake_histogram_t histograms[WAKE_STAGE_MAX];
+
+static const char *stage_names[WAKE_STAGE_MAX] = {
+    "Deep sleep",
+    "SDIO resume",
+    "WHD RX",
+    "lwIP",
+    "Total"
+};
+
+/*
+ * DWT cycle count at each timestamp of the current wake. The counter stops
+ * in deep sleep, but every stage is measured once the CPU runs again: from
+ * the return of the WFI, seen by the deep sleep callback, on.
+ */
+static volatile uint32_t resume_cycles;
+static volatile uint32_t wake_cycles;
+static volatile uint32_t emac_rx_cycles;
+static volatile uint32_t stack_input_cycles;
+static volatile uint8_t state = WAKE_STATE_IDLE;
+
+#if defined(CYBSP_WIFI_HOST_WAKE_PORT)
+/* Interrupt of the GPIO port of the host wake pin, and the handler of the
+ * HAL it is serviced by.
+ */
+#define HOST_WAKE_IRQN   ((IRQn_Type)(ioss_interrupts_gpio_0_IRQn + CYHAL_GET_PORT(CYBSP_WIFI_HOST_WAKE)))
+static cy_israddress host_wake_handler;
+#endif /* defined(CYBSP_WIFI_HOST_WAKE_PORT) */
+
+/* Number of WLAN host wakes and number of wakes already reported. */
+static volatile uint32_t wake_count;
+static uint32_t reported_wake_count;
+
+static cyhal_syspm_callback_data_t syspm_cb_data;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/******************************************************************************
+ * Function Name: record_sample
+ ******************************************************************************
+ * Summary:
+ *   This function adds a sample to the histogram of the given stage.
+ *
+ * Parameters:
+ *   stage: Stage the sample belongs to.
+ *   us: Duration of the stage in microseconds.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void record_sample(wake_stage_t stage, uint32_t us)
+{
+    wake_histogram_t *hist = &histograms[stage];
+    uint32_t bucket = (us < 2u) ? 0u : (31u - __CLZ(us));
+
+    if (WAKE_LATENCY_BUCKETS <= bucket)
+    {
+        bucket = WAKE_LATENCY_BUCKETS - 1;
+    }
+
+    core_util_critical_section_enter();
+    if ((0 == hist->count) || (us < hist->min_us))
+    {
+        hist->min_us = us;
+    }
+    if (us > hist->max_us)
+    {
+        hist->max_us = us;
+    }
+    hist->count++;
+    hist->sum_us += us;
+    hist->buckets[bucket]++;
+    core_util_critical_section_exit();
+}
+
+/******************************************************************************
+ * Function Name: record_cycles
+ ******************************************************************************
+ * Summary:
+ *   This function converts a cycle count to microseconds and adds it to the
+ *   histogram of the given stage.
+ *
+ * Parameters:
+ *   stage: Stage the sample belongs to.
+ *   cycles: Duration of the stage in CPU cycles.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void record_cycles(wake_stage_t stage, uint32_t cycles)
+{
+    record_sample(stage, cycles / (SystemCoreClock / 1000000u));
+}
+
+#if defined(CYBSP_WIFI_HOST_WAKE_PORT)
+/******************************************************************************
+ * Function Name: wake_latency_host_wake_isr
+ ******************************************************************************
+ * Summary:
+ *   This is the handler of the GPIO port interrupt of the host wake pin, in
+ *   front of the one of the HAL. It timestamps the WLAN host wake when the
+ *   interrupt is serviced, then runs the handler of the HAL.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+static void wake_latency_host_wake_isr(void)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    if (WAKE_STATE_RESUMED == state)
+    {
+        wake_cycles = now;
+        state = WAKE_STATE_WOKEN;
+        record_cycles(WAKE_STAGE_DEEPSLEEP_EXIT, now - resume_cycles);
+    }
+
+    host_wake_handler();
+}
+#endif /* defined(CYBSP_WIFI_HOST_WAKE_PORT) */
+
+/******************************************************************************
+ * Function Name: wake_latency_syspm_cb
+ ******************************************************************************
+ * Summary:
+ *   This is the deep sleep callback. After the transition it timestamps the
+ *   return of the WFI, the first point of the wake the CPU can time. A wake
+ *   is measured only if the WLAN host wake interrupt is pending; the other
+ *   wakes, for example by a timer, are not counted. Before the transition,
+ *   it abandons the wake in progress and puts its handler in front of the
+ *   host wake interrupt handler of the HAL, which the WHD may have set again
+ *   since the last deep sleep.
+ *
+ * Parameters:
+ *   syspm_state: Power state for which the callback is invoked.
+ *   mode: Transition mode of the power state.
+ *   callback_arg: Argument as set in callback registration.
+ *
+ * Return:
+ *   bool: Always returns true to allow the transition.
+ *
+ *****************************************************************************/
+static bool wake_latency_syspm_cb(cyhal_syspm_callback_state_t syspm_state,
+                                  cyhal_syspm_callback_mode_t mode,
+                                  void *callback_arg)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    if (CYHAL_SYSPM_BEFORE_TRANSITION == mode)
+    {
+        /* A wake that did not deliver any packet is abandoned here. */
+        state = WAKE_STATE_IDLE;
+#if defined(CYBSP_WIFI_HOST_WAKE_PORT)
+        if (Cy_SysInt_GetVector(HOST_WAKE_IRQN) != wake_latency_host_wake_isr)
+        {
+            host_wake_handler = Cy_SysInt_SetVector(HOST_WAKE_IRQN, wake_latency_host_wake_isr);
+        }
+#endif /* defined(CYBSP_WIFI_HOST_WAKE_PORT) */
+    }
+    else if ((CYHAL_SYSPM_AFTER_TRANSITION == mode) &&
+             wake_latency_host_wake_pending())
+    {
+        resume_cycles = now;
+        wake_count++;
+#if defined(CYBSP_WIFI_HOST_WAKE_PORT)
+        state = WAKE_STATE_RESUMED;
+#else
+        /* Without a host wake pin, the wake is the return of the WFI. */
+        wake_cycles = now;
+        state = WAKE_STATE_WOKEN;
+#endif /* defined(CYBSP_WIFI_HOST_WAKE_PORT) */
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_init
+ ******************************************************************************
+ * Summary:
+ *   This function enables the DWT cycle counter and registers the deep sleep
+ *   callback used to timestamp the wake from deep sleep.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_latency_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    syspm_cb_data.callback = wake_latency_syspm_cb;
+    syspm_cb_data.states = CYHAL_SYSPM_CB_CPU_DEEPSLEEP;
+    syspm_cb_data.ignore_modes = (cyhal_syspm_callback_mode_t)
+                                 (CYHAL_SYSPM_CHECK_READY | CYHAL_SYSPM_CHECK_FAIL);
+    syspm_cb_data.args = NULL;
+    syspm_cb_data.next = NULL;
+    cyhal_syspm_register_callback(&syspm_cb_data);
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_mark
+ ******************************************************************************
+ * Summary:
+ *   This function takes a timestamp at the given point of the wake path. Only
+ *   the first packet after a WLAN host wake is measured; the marks of the
+ *   following packets are ignored until the next wake. The wake completes
+ *   when data is first received from an application socket: a request of
+ *   the web server or data of the keep-alive collector. A wake whose frames
+ *   reach no socket before the next deep sleep is abandoned after the WHD
+ *   RX stage.
+ *
+ * Parameters:
+ *   mark: Point of the wake path that has been reached.
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_latency_mark(wake_mark_t mark)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    switch (mark)
+    {
+        case WAKE_MARK_EMAC_RX:
+            if (WAKE_STATE_WOKEN == state)
+            {
+                emac_rx_cycles = now;
+                state = WAKE_STATE_EMAC_RX;
+                record_cycles(WAKE_STAGE_SDIO_RESUME, now - wake_cycles);
+            }
+            break;
+        case WAKE_MARK_STACK_INPUT:
+            if (WAKE_STATE_EMAC_RX == state)
+            {
+                stack_input_cycles = now;
+                state = WAKE_STATE_STACK_INPUT;
+                record_cycles(WAKE_STAGE_WHD_RX, now - emac_rx_cycles);
+            }
+            break;
+        case WAKE_MARK_SOCKET_DELIVERY:
+            if (WAKE_STATE_STACK_INPUT == state)
+            {
+                state = WAKE_STATE_IDLE;
+                record_cycles(WAKE_STAGE_LWIP, now - stack_input_cycles);
+                record_cycles(WAKE_STAGE_TOTAL, now - resume_cycles);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_get_wake_count
+ ******************************************************************************
+ * Summary:
+ *   This function returns the number of wakes from deep sleep caused by the
+ *   WLAN host wake interrupt.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint32_t: Number of WLAN host wakes since boot.
+ *
+ *****************************************************************************/
+uint32_t wake_latency_get_wake_count(void)
+{
+    return wake_count;
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_get_avg_us
+ ******************************************************************************
+ * Summary:
+ *   This function returns the average latency of one stage.
+ *
+ * Parameters:
+ *   stage: Stage to query.
+ *
+ * Return:
+ *   uint32_t: Average latency in microseconds, 0 if no sample was taken.
+ *
+ *****************************************************************************/
+uint32_t wake_latency_get_avg_us(wake_stage_t stage)
+{
+    uint32_t avg_us = 0;
+
+    if (WAKE_STAGE_MAX <= stage)
+    {
+        return 0;
+    }
+
+    core_util_critical_section_enter();
+    if (0 != histograms[stage].count)
+    {
+        avg_us = (uint32_t)(histograms[stage].sum_us / histograms[stage].count);
+    }
+    core_util_critical_section_exit();
+
+    return avg_us;
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_report
+ ******************************************************************************
+ * Summary:
+ *   This function formats the histogram of one stage as text. Only the
+ *   buckets holding samples are reported.
+ *
+ * Parameters:
+ *   stage: Stage to report.
+ *   buf: Buffer to hold the report.
+ *   buf_len: Buffer size. WAKE_LATENCY_REPORT_LEN is always large enough.
+ *
+ * Return:
+ *   int: Number of characters written to the buffer.
+ *
+ *****************************************************************************/
+int wake_latency_report(wake_stage_t stage, char *buf, size_t buf_len)
+{
+    wake_histogram_t hist;
+    int len = 0;
+
+    if ((WAKE_STAGE_MAX <= stage) || (NULL == buf) || (0 == buf_len))
+    {
+        return 0;
+    }
+
+    /* Report a consistent copy of the histogram. */
+    core_util_critical_section_enter();
+    hist = histograms[stage];
+    core_util_critical_section_exit();
+
+    len = snprintf(buf, buf_len, "%-12s n=%lu min=%lu avg=%lu max=%lu us\n",
+                   stage_names[stage],
+                   (unsigned long)hist.count,
+                   (unsigned long)hist.min_us,
+                   (unsigned long)(hist.count ? (hist.sum_us / hist.count) : 0),
+                   (unsigned long)hist.max_us);
+
+    for (int i = 0; (i < WAKE_LATENCY_BUCKETS) && (len < (int)buf_len); i++)
+    {
+        if (0 == hist.buckets[i])
+        {
+            continue;
+        }
+        len += snprintf(&buf[len], buf_len - len, "\t%s%lu us: %lu\n",
+                        (i == WAKE_LATENCY_BUCKETS - 1) ? ">=" : "<",
+                        (i == WAKE_LATENCY_BUCKETS - 1) ? (1ul << i) : (2ul << i),
+                        (unsigned long)hist.buckets[i]);
+    }
+
+    return (len < (int)buf_len) ? len : (int)buf_len - 1;
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_print
+ ******************************************************************************
+ * Summary:
+ *   This function prints the histograms of all the stages on the console
+ *   through the application log.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_latency_print(void)
+{
+    wake_histogram_t hist;
+
+    APP_INFO(("Wake latency after %lu wakes:\n", (unsigned long)wake_count));
+    for (int stage = 0; stage < WAKE_STAGE_MAX; stage++)
+    {
+        core_util_critical_section_enter();
+        hist = histograms[stage];
+        core_util_critical_section_exit();
+
+        APP_INFO(("%-12s n=%lu min=%lu avg=%lu max=%lu us\n",
+                  stage_names[stage],
+                  (unsigned long)hist.count,
+                  (unsigned long)hist.min_us,
+                  (unsigned long)(hist.count ? (hist.sum_us / hist.count) : 0),
+                  (unsigned long)hist.max_us));
+
+        for (int i = 0; i < WAKE_LATENCY_BUCKETS; i++)
+        {
+            if (0 == hist.buckets[i])
+            {
+                continue;
+            }
+            APP_INFO(("\t%s%lu us: %lu\n",
+                      (i == WAKE_LATENCY_BUCKETS - 1) ? ">=" : "<",
+                      (i == WAKE_LATENCY_BUCKETS - 1) ? (1ul << i) : (2ul << i),
+                      (unsigned long)hist.buckets[i]));
+        }
+
+        /* Up to one log per bucket: drain the log ring after each stage. */
+        app_log_flush();
+    }
+}
+
+/******************************************************************************
+ * Function Name: wake_latency_poll
+ ******************************************************************************
+ * Summary:
+ *   This function prints the histograms on the console once every
+ *   MBED_CONF_APP_WAKE_LATENCY_REPORT_INTERVAL wakes. It is called from the
+ *   wake event of the event queue, when the host is awake anyway.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   void
+ *
+ *****************************************************************************/
+void wake_latency_poll(void)
+{
+    if ((0 != MBED_CONF_APP_WAKE_LATENCY_REPORT_INTERVAL) &&
+        ((wake_count - reported_wake_count) >= MBED_CONF_APP_WAKE_LATENCY_REPORT_INTERVAL))
+    {
+        reported_wake_count = wake_count;
+        wake_latency_print();
+    }
+}
+
+#else /* MBED_CONF_APP_WAKE_LATENCY_ENABLE */
+
+void wake_latency_init(void)
+{
+}
+
+void wake_latency_mark(wake_mark_t mark)
+{
+}
+
+void wake_latency_poll(void)
+{
+}
+
+uint32_t wake_latency_get_wake_count(void)
+{
+    return 0;
+}
+
+uint32_t wake_latency_get_avg_us(wake_stage_t stage)
+{
+    return 0;
+}
+
+int wake_latency_report(wake_stage_t stage, char *buf, size_t buf_len)
+{
+    if ((NULL == buf) || (0 == buf_len) || (WAKE_STAGE_DEEPSLEEP_EXIT != stage))
+    {
+        return 0;
+    }
+
+    return snprintf(buf, buf_len, "Wake latency measurement is disabled. "
+                    "Set wake-latency-enable to 1 in mbed_app.json.\n");
+}
+
+void wake_latency_print(void)
+{
+}
+
+#endif /* MBED_CONF_APP_WAKE_LATENCY_ENABLE */
+
+/******************************************************************************
+ * Function Name: wake_latency_host_wake_pending
+ ******************************************************************************
+ * Summary:
+ *   This function checks whether the WLAN host wake interrupt is pending.
+ *   Called from a deep sleep callback after the transition, before the
+ *   interrupt is serviced, it tells whether the WLAN device woke the host.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   bool: Returns true if the WLAN host wake interrupt is pending. Always
+ *     true on a target without a host wake pin.
+ *
+ *****************************************************************************/
+bool wake_latency_host_wake_pending(void)
+{
+#if defined(CYBSP_WIFI_HOST_WAKE_PORT)
+    return (0u != Cy_GPIO_GetInterruptStatusMasked(CYBSP_WIFI_HOST_WAKE_PORT,
+                                                   CYBSP_WIFI_HOST_WAKE_PIN));
+#else
+    return true;
+#endif /* defined(CYBSP_WIFI_HOST_WAKE_PORT) */
+}
+
+
+/* [] END OF FILE */
+
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * File Name: wake_latency.h
+ *
+ * Description:
+ *   This header file contains macros and function declarations to measure the
+ *   latency from a WLAN host wake to the delivery of the packet to lwIP.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef WAKE_LATENCY_H
+#define WAKE_LATENCY_H
+
+#include "mbed.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Wake latency measurement is compiled out unless enabled in mbed_app.json. */
+#ifndef MBED_CONF_APP_WAKE_LATENCY_ENABLE
+#define MBED_CONF_APP_WAKE_LATENCY_ENABLE  (0)
+#endif
+
+/* Number of wakes between two console reports. 0 disables console reports. */
+#ifndef MBED_CONF_APP_WAKE_LATENCY_REPORT_INTERVAL
+#define MBED_CONF_APP_WAKE_LATENCY_REPORT_INTERVAL  (0)
+#endif
+
+/*
+ * Number of histogram buckets per stage. Bucket 'n' counts the samples in the
+ * range [2^n, 2^(n+1)) microseconds; the last bucket also holds all the
+ * samples beyond its upper bound.
+ */
+#define WAKE_LATENCY_BUCKETS               (20)
+
+/* Buffer length required to report one stage as text. */
+#define WAKE_LATENCY_REPORT_LEN            (512)
+
+#if MBED_CONF_APP_WAKE_LATENCY_ENABLE
+#define WAKE_LATENCY_MARK(stage_mark)      wake_latency_mark(stage_mark)
+#else
+#define WAKE_LATENCY_MARK(stage_mark)      do { } while(0)
+#endif
+
+/******************************************************************************
+ *                                 ENUMS
+ *****************************************************************************/
+/* Points on the wake path where a timestamp is taken. */
+typedef enum
+{
+    WAKE_MARK_EMAC_RX = 0,      /* Frame handed by WHD to the EMAC RX hook */
+    WAKE_MARK_STACK_INPUT,      /* Frame delivered to the lwIP input       */
+    WAKE_MARK_SOCKET_DELIVERY   /* Data received from an application socket */
+} wake_mark_t;
+
+/* Stages of the wake path, each with its own histogram. */
+typedef enum
+{
+    WAKE_STAGE_DEEPSLEEP_EXIT = 0, /* WFI return -> WLAN host wake IRQ          */
+    WAKE_STAGE_SDIO_RESUME,        /* Host wake IRQ -> frame read over SDIO     */
+    WAKE_STAGE_WHD_RX,             /* EMAC RX hook -> frame handed to lwIP      */
+    WAKE_STAGE_LWIP,               /* Frame handed to lwIP -> socket delivery   */
+    WAKE_STAGE_TOTAL,              /* WFI return -> socket delivery             */
+    WAKE_STAGE_MAX
+} wake_stage_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void wake_latency_init(void);
+void wake_latency_mark(wake_mark_t mark);
+void wake_latency_poll(void);
+uint32_t wake_latency_get_wake_count(void);
+bool wake_latency_host_wake_pending(void);
+uint32_t wake_latency_get_avg_us(wake_stage_t stage);
+int wake_latency_report(wake_stage_t stage, char *buf, size_t buf_len);
+void wake_latency_print(void);
+
+#endif /* #ifndef WAKE_LATENCY_H */
+
+
+/* [] END OF FILE */
+
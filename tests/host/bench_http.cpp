@@ -0,0 +1,131 @@
+/******************************************************************************
+ * File Name: bench_http.cpp
+ *
+ * Description:
+ *   Host run of the page render benchmark of app/http_bench.cpp through the
+ *   HTTP shim (see shim/http_shim.cpp): the home page is rendered by the
+ *   page handler of the application for 0 to MAX_FILTERS - 1 packet filters
+ *   and the report is printed in the format of the kit, read by
+ *   tools/http_bench.py. The cycles are nanoseconds of the steady clock.
+ *   The benchmark is run once over the default list and once over another
+ *   list, and must restore each of them as it was.
+ *
+ *   Usage: bench_http | python3 tools/http_bench.py
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "rtx_os.h"
+#include "http_bench.h"
+#include "pf_olm_config.h"
+#include "pf_snapshot.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Stack of the thread running the benchmark, as the HTTP server thread. */
+#define BENCH_HTTP_STACK_SIZE              (64 * 1024)
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+static cy_rslt_t bench_result;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void bench_http_entry(void *arg)
+{
+    (void)arg;
+    bench_result = http_bench_run();
+}
+
+/* Runs the benchmark and checks that the active list is restored. */
+static bool bench_http_run(void)
+{
+    pf_snapshot_t before;
+    pf_snapshot_t after;
+    pf_snapshot_reader_t reader = pf_snapshot_read_lock();
+
+    before = *pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+    pf_snapshot_read_unlock(reader);
+
+    if ((0 != host_thread_run(bench_http_entry, NULL, BENCH_HTTP_STACK_SIZE)) ||
+        (CY_RSLT_SUCCESS != bench_result))
+    {
+        fprintf(stderr, "bench_http: the benchmark failed\n");
+        return false;
+    }
+
+    reader = pf_snapshot_read_lock();
+    after = *pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+    pf_snapshot_read_unlock(reader);
+
+    if ((before.is_default != after.is_default) || (before.count != after.count) ||
+        (0 != memcmp(before.cfgs, after.cfgs, before.count * sizeof(before.cfgs[0]))))
+    {
+        fprintf(stderr, "bench_http: the active list is not restored\n");
+        return false;
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    cy_pf_ol_cfg_t cfg;
+
+    pf_publish_lists();
+    if (!bench_http_run())
+    {
+        return 1;
+    }
+
+    /* The same over a list which is not the default list. */
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.feature = CY_PF_OL_FEAT_ETHTYPE;
+    cfg.bits = CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE;
+    cfg.u.eth.eth_type = 0x0806;
+    if ((CY_RSLT_SUCCESS != pf_stage_list(&cfg, NULL, 1)) ||
+        (CY_RSLT_SUCCESS != pf_activate_list(false)))
+    {
+        fprintf(stderr, "bench_http: the list could not be activated\n");
+        return 1;
+    }
+
+    return bench_http_run() ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * File Name: bench_parsers.cpp
+ *
+ * Description:
+ *   Host benchmark of the parsers of the web page input. It times the
+ *   splitting and parsing of the form data posted by the "Add Filter" page
+ *   and the parsing of the URL query strings, and prints the mean time per
+ *   request and the throughput.
+ *
+ *   Usage: bench_parsers [iterations]
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "http_query.h"
+#include "pf_list.h"
+#include "host_classifier.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+#define BENCH_DEFAULT_ITERATIONS           (200000)
+#define ARRAY_SIZE(a)                      (sizeof(a) / sizeof((a)[0]))
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+/* Form data as posted by a browser, see tools/http_load.py. */
+static const char *const forms[] = {
+    "filter_type=PF&action=K&protocol=T&direction=DP&port_number=80&ether_type=0x"
+    "&ip_proto=0x&src_net=&dst_net=&tcp_flags=&mcast=A&payload=&active=A"
+    "&ip_version=4&icmp6_type=",
+    "filter_type=ET&action=K&protocol=T&direction=DP&port_number=&ether_type=0x0806"
+    "&ip_proto=0x&src_net=&dst_net=&tcp_flags=&mcast=A&payload=&active=A"
+    "&ip_version=4&icmp6_type=",
+    "filter_type=IT&action=K&protocol=T&direction=DP&port_number=&ether_type=0x"
+    "&ip_proto=0x3a&src_net=&dst_net=&tcp_flags=&mcast=A&payload=&active=S"
+    "&ip_version=6&icmp6_type=135",
+    "filter_type=HC&action=D&protocol=U&direction=DP&port_number=1900&ether_type=0x"
+    "&ip_proto=0x&src_net=192.168.1.0%2F24&dst_net=239.255.255.250%2F32&tcp_flags=Sa"
+    "&mcast=M&payload=4d2d5345&active=A&ip_version=4&icmp6_type=",
+};
+
+static const char *const queries[] = {
+    "apply_filter=apply_filter",
+    "remove_id=remove_id_3",
+    "snoop=1&peer_reply=1&peerage=600&apply=1",
+};
+
+/* Keeps the compiler from dropping the timed calls. */
+static volatile uint32_t sink;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void parse_form(const char *data, size_t len)
+{
+    char *config_str[MAX_HTTP_CONFIG_NUMBER] = {NULL};
+    char body[HTTP_BODY_MAX_LEN];
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+    hc_rule_t rule;
+
+    sink += http_form_split(data, len, body, sizeof(body),
+                            config_str, MAX_HTTP_CONFIG_NUMBER);
+    if (strcmp(config_str[PKT_FILTER_TYPE_ID], "HC"))
+    {
+        memset(&cfg, 0, sizeof(cfg));
+        sink += pf_parse_filter(config_str, &cfg, &ipv6);
+        return;
+    }
+    sink += hc_parse_net(config_str[SOURCE_NET_ID], &rule.src_ip, &rule.src_mask);
+    sink += hc_parse_net(config_str[DESTINATION_NET_ID], &rule.dst_ip, &rule.dst_mask);
+    sink += hc_parse_tcp_flags(config_str[TCP_FLAGS_ID], &rule.tcp_flags_value,
+                               &rule.tcp_flags_mask);
+    sink += hc_parse_prefix(config_str[PAYLOAD_PREFIX_ID], rule.prefix, &rule.prefix_len);
+}
+
+static void parse_query(const char *query)
+{
+    char value[HTTP_QUERY_STR_VALUE_LEN];
+
+    http_query_value(query, value, sizeof(value));
+    sink += http_query_is(value, "apply_filter") ? 0 : 1;
+    sink += http_query_param(query, "peerage", value, sizeof(value)) ? 0 : 1;
+}
+
+static void report(const char *name, std::chrono::steady_clock::duration elapsed,
+                   unsigned long ops, unsigned long bytes)
+{
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+
+    printf("%-28s %10.1f ns/request %8.1f MB/s\n", name, ns / ops, bytes * 1e3 / ns);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long iterations = BENCH_DEFAULT_ITERATIONS;
+    size_t form_len[ARRAY_SIZE(forms)];
+    unsigned long bytes = 0;
+    std::chrono::steady_clock::time_point start;
+
+    if (argc > 1)
+    {
+        iterations = strtoul(argv[1], NULL, 0);
+    }
+    if (0 == iterations)
+    {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(forms); i++)
+    {
+        form_len[i] = strlen(forms[i]);
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        size_t n = i % ARRAY_SIZE(forms);
+
+        parse_form(forms[n], form_len[n]);
+        bytes += form_len[n];
+    }
+    report("form split + filter parse", std::chrono::steady_clock::now() - start,
+           iterations, bytes);
+
+    bytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        size_t n = i % ARRAY_SIZE(queries);
+
+        parse_query(queries[n]);
+        bytes += strlen(queries[n]);
+    }
+    report("query value + param", std::chrono::steady_clock::now() - start,
+           iterations, bytes);
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
+
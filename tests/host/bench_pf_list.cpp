@@ -0,0 +1,174 @@
+/******************************************************************************
+ * File Name: bench_pf_list.cpp
+ *
+ * Description:
+ *   Host benchmark of the packet filter list management. It times the
+ *   parsing of a filter, the validation of a filter against a full list,
+ *   filling a list, removing filters by ID and replacing a list, and prints
+ *   the mean time of each operation in nanoseconds.
+ *
+ *   Usage: bench_pf_list [iterations]
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pf_list.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+#define BENCH_DEFAULT_ITERATIONS           (200000)
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+static cy_pf_ol_cfg_t cfgs[MAX_FILTERS];
+static pf_list_t list = { cfgs, cfgs, &cfgs[MAX_FILTERS - 1], 0, {} };
+
+/* Port filters 1000 - 1009 as split from the HTTP query string. */
+static char ports[MAX_FILTERS - 1][8];
+static char *forms[MAX_FILTERS - 1][MAX_HTTP_CONFIG_NUMBER];
+
+/* Keeps the compiler from dropping the timed calls. */
+static volatile uint32_t sink;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void forms_init(void)
+{
+    for (int i = 0; i < MAX_FILTERS - 1; i++)
+    {
+        snprintf(ports[i], sizeof(ports[i]), "%d", 1000 + i);
+        forms[i][PKT_FILTER_TYPE_ID] = (char *)"PF";
+        forms[i][KEEP_OR_DISCARD_ID] = (char *)"K";
+        forms[i][TCP_OR_UDP_ID] = (char *)"U";
+        forms[i][SOURCE_OR_DESTINATION_ID] = (char *)"DP";
+        forms[i][PORT_NUMBER_ID] = ports[i];
+    }
+}
+
+static void list_fill(void)
+{
+    pf_list_clear(&list);
+    for (int i = 0; i < MAX_FILTERS - 1; i++)
+    {
+        sink += pf_list_add(&list, forms[i]);
+    }
+}
+
+static void report(const char *name, std::chrono::steady_clock::duration elapsed,
+                   unsigned long ops)
+{
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+
+    printf("%-36s %10.1f ns/op\n", name, ns / ops);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long iterations = BENCH_DEFAULT_ITERATIONS;
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+    cy_pf_ol_cfg_t saved[MAX_FILTERS];
+    std::chrono::steady_clock::time_point start;
+
+    if (argc > 1)
+    {
+        iterations = strtoul(argv[1], NULL, 0);
+    }
+    if (0 == iterations)
+    {
+        iterations = BENCH_DEFAULT_ITERATIONS;
+    }
+    forms_init();
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        memset(&cfg, 0, sizeof(cfg));
+        sink += pf_parse_filter(forms[i % (MAX_FILTERS - 1)], &cfg, &ipv6);
+    }
+    report("pf_parse_filter", std::chrono::steady_clock::now() - start, iterations);
+
+    /* The last filter is checked against all the others. */
+    list_fill();
+    pf_list_remove_last(&list);
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        sink += pf_list_validate(&list, forms[MAX_FILTERS - 2]);
+    }
+    report("pf_list_validate (9 filters)", std::chrono::steady_clock::now() - start,
+           iterations);
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations / 10; i++)
+    {
+        list_fill();
+    }
+    report("pf_list_add (fill of 10 filters)", std::chrono::steady_clock::now() - start,
+           (iterations / 10) * (MAX_FILTERS - 1));
+
+    /* Remove the first filter, the worst case of the move down, and add it back. */
+    list_fill();
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        uint8_t id = (uint8_t)list.first->id;
+
+        sink += pf_list_remove(&list, id);
+        sink += pf_list_add(&list, forms[id]);
+    }
+    report("pf_list_remove + pf_list_add", std::chrono::steady_clock::now() - start,
+           iterations);
+
+    list_fill();
+    memcpy(saved, cfgs, sizeof(saved));
+    start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        sink += pf_list_set(&list, saved, NULL, MAX_FILTERS - 1);
+    }
+    report("pf_list_set (10 filters)", std::chrono::steady_clock::now() - start,
+           iterations);
+
+    return (0 == sink) ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
+
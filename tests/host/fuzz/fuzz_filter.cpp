@@ -0,0 +1,139 @@
+/******************************************************************************
+ * File Name: fuzz_filter.cpp
+ *
+ * Description:
+ *   libFuzzer entry point for the filter form parsers. The input is the
+ *   form data posted by the "Add Filter" web page. It is split into its
+ *   fields and parsed as a packet filter, added to a list, printed as on
+ *   the home page, and parsed as a host classifier rule.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "http_query.h"
+#include "pf_list.h"
+#include "host_classifier.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Buffers of the home page, see http_webserver_config.h. */
+#define FUZZ_RESP_STR_LEN                  (2048)
+#define FUZZ_BUILD_STR_LEN                 (400)
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+/* The list is kept across inputs, as the pending list is across requests. */
+static cy_pf_ol_cfg_t cfgs[MAX_FILTERS];
+static pf_list_t list = { cfgs, cfgs, &cfgs[MAX_FILTERS - 1], 0, {} };
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void fuzz_host_rule(char *config_str[])
+{
+    hc_rule_t rule;
+    char text[FUZZ_BUILD_STR_LEN];
+
+    memset(&rule, 0, sizeof(rule));
+    if ((NULL != config_str[SOURCE_NET_ID]) &&
+        (CY_RSLT_SUCCESS != hc_parse_net(config_str[SOURCE_NET_ID],
+                                         &rule.src_ip, &rule.src_mask)))
+    {
+        return;
+    }
+    if ((NULL != config_str[DESTINATION_NET_ID]) &&
+        (CY_RSLT_SUCCESS != hc_parse_net(config_str[DESTINATION_NET_ID],
+                                         &rule.dst_ip, &rule.dst_mask)))
+    {
+        return;
+    }
+    if ((NULL != config_str[TCP_FLAGS_ID]) &&
+        (CY_RSLT_SUCCESS != hc_parse_tcp_flags(config_str[TCP_FLAGS_ID],
+                                               &rule.tcp_flags_value,
+                                               &rule.tcp_flags_mask)))
+    {
+        return;
+    }
+    if ((NULL != config_str[PAYLOAD_PREFIX_ID]) &&
+        (CY_RSLT_SUCCESS != hc_parse_prefix(config_str[PAYLOAD_PREFIX_ID],
+                                            rule.prefix, &rule.prefix_len)))
+    {
+        return;
+    }
+    rule.match = 0xFF;
+    (void)hc_print_rule(&rule, text, sizeof(text));
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *config_str[MAX_HTTP_CONFIG_NUMBER] = {NULL};
+    char body[HTTP_BODY_MAX_LEN];
+    char resp[FUZZ_RESP_STR_LEN];
+    char build_str[FUZZ_BUILD_STR_LEN];
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+
+    if (CY_RSLT_SUCCESS != http_form_split((const char *)data, size, body, sizeof(body),
+                                           config_str, MAX_HTTP_CONFIG_NUMBER))
+    {
+        return 0;
+    }
+
+    fuzz_host_rule(config_str);
+
+    memset(&cfg, 0, sizeof(cfg));
+    if (CY_RSLT_SUCCESS == pf_parse_filter(config_str, &cfg, &ipv6))
+    {
+        resp[0] = '\0';
+        print_filter(&cfg, &ipv6, resp, build_str, sizeof(build_str));
+    }
+
+    /* A full list is emptied from the front, as filters are removed by ID. */
+    if (list.cur >= list.last)
+    {
+        (void)pf_list_remove(&list, (uint8_t)list.first->id);
+    }
+    (void)pf_list_add(&list, config_str);
+    if (list.first->bits & CY_PF_ACTION_DISCARD)
+    {
+        (void)pf_list_remove_last(&list);
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
+
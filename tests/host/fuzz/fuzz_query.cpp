@@ -0,0 +1,94 @@
+/******************************************************************************
+ * File Name: fuzz_query.cpp
+ *
+ * Description:
+ *   libFuzzer entry point for the URL query string parsers. The input is
+ *   the query string of a request; it is parsed as the home page and the
+ *   ARP offload page do.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "http_query.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Longest query string tried; the HTTP server limits the request size. */
+#define FUZZ_QUERY_MAX_LEN                 (1024)
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static const char *const actions[] = {
+        "add", "tier", "remove", "restore_defaults", "minimum_filter",
+        "apply_filter", "clear_host_rules", "clear_tier"
+    };
+    static const char *const params[] = { "snoop", "peer_reply", "peerage", "apply" };
+    char query[FUZZ_QUERY_MAX_LEN + 1];
+    char value[HTTP_QUERY_STR_VALUE_LEN];
+    char small[2];
+
+    if (size > FUZZ_QUERY_MAX_LEN)
+    {
+        return 0;
+    }
+    memcpy(query, data, size);
+    query[size] = '\0';
+
+    http_query_value(query, value, sizeof(value));
+    for (size_t i = 0; i < sizeof(actions) / sizeof(actions[0]); i++)
+    {
+        (void)http_query_is(value, actions[i]);
+    }
+    http_query_value(query, small, sizeof(small));
+    (void)http_query_is(small, "add");
+
+    for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++)
+    {
+        if (http_query_param(query, params[i], value, sizeof(value)))
+        {
+            (void)strtoul(value, NULL, 10);
+        }
+        (void)http_query_param(query, params[i], small, sizeof(small));
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
+
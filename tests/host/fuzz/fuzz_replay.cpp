@@ -0,0 +1,134 @@
+/******************************************************************************
+ * File Name: fuzz_replay.cpp
+ *
+ * Description:
+ *   Stand-alone driver of the libFuzzer entry points, for compilers without
+ *   libFuzzer. It runs each file given, or each file of each directory
+ *   given, through LLVMFuzzerTestOneInput once. Options starting with '-',
+ *   such as the -runs=0 passed to libFuzzer by ctest, are ignored.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static bool replay_file(const std::string &path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path.c_str(), "rb");
+    uint8_t buf[4096];
+    size_t len = 0;
+
+    if (NULL == file)
+    {
+        printf("Cannot open %s\n", path.c_str());
+        return false;
+    }
+    while (0 < (len = fread(buf, 1, sizeof(buf), file)))
+    {
+        data.insert(data.end(), buf, buf + len);
+    }
+    fclose(file);
+
+    /* Like libFuzzer, pass a buffer of exactly the input size. */
+    uint8_t *input = (uint8_t *)malloc(data.size() ? data.size() : 1);
+    if (!data.empty())
+    {
+        memcpy(input, data.data(), data.size());
+    }
+    LLVMFuzzerTestOneInput(input, data.size());
+    free(input);
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int count = 0;
+    bool ok = true;
+    struct stat st;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ('-' == argv[i][0])
+        {
+            continue;
+        }
+        if ((0 == stat(argv[i], &st)) && S_ISDIR(st.st_mode))
+        {
+            DIR *dir = opendir(argv[i]);
+            struct dirent *entry = NULL;
+
+            while ((NULL != dir) && (NULL != (entry = readdir(dir))))
+            {
+                std::string path = std::string(argv[i]) + "/" + entry->d_name;
+
+                if ((0 == stat(path.c_str(), &st)) && S_ISREG(st.st_mode))
+                {
+                    ok = replay_file(path) && ok;
+                    count++;
+                }
+            }
+            if (NULL != dir)
+            {
+                closedir(dir);
+            }
+        }
+        else
+        {
+            ok = replay_file(argv[i]) && ok;
+            count++;
+        }
+    }
+
+    printf("Replayed %u inputs\n", count);
+    return (ok && count) ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
+
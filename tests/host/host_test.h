@@ -0,0 +1,82 @@
+/******************************************************************************
+ * File Name: host_test.h
+ *
+ * Description:
+ *   This header file contains the check macros shared by the host unit
+ *   tests. A failed check prints its location and makes the test return a
+ *   non-zero status to ctest; the test goes on with the next check.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+#define CHECK(cond)                        host_test_check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(a, b)                     CHECK((a) == (b))
+
+/* Runs a test function and reports its name. */
+#define RUN_TEST(fn)                       do { unsigned int before = host_test_failures; \
+                                                fn(); \
+                                                printf("%s %s\n", (before == host_test_failures) ? \
+                                                       "PASS" : "FAIL", #fn); } while(0)
+
+/* Status of the test, to return from main(). */
+#define HOST_TEST_RESULT()                 (host_test_failures ? 1 : 0)
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+static unsigned int host_test_failures = 0;
+
+/******************************************************************************
+ *                         INLINE FUNCTIONS
+ *****************************************************************************/
+static inline void host_test_check(bool ok, const char *cond, const char *file, int line)
+{
+    if (!ok)
+    {
+        printf("%s:%d: check failed: %s\n", file, line, cond);
+        host_test_failures++;
+    }
+}
+
+#endif /* #ifndef HOST_TEST_H */
+
+
+/* [] END OF FILE */
+
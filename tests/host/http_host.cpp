@@ -0,0 +1,100 @@
+/******************************************************************************
+ * File Name: http_host.cpp
+ *
+ * Description:
+ *   Host web server: the web pages of the application served over a TCP
+ *   port of the workstation through the HTTP shim (see shim/http_server.cpp
+ *   and shim/http_shim.cpp), with the real page handlers, packet filter
+ *   lists and handler statistics. The commits of the packet filter list
+ *   complete at once. tools/http_load.py measures it as it measures the kit.
+ *
+ *   Usage: http_host [port] [requests]
+ *
+ *   The server listens to port 8080 by default and serves requests until it
+ *   is stopped, or the given number of requests.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "rtx_os.h"
+#include "HTTP_server.hpp"
+#include "http_webserver_config.h"
+#include "pf_olm_config.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+#define HTTP_HOST_PORT                     (8080u)
+
+/* Stack of the thread serving the requests, as the HTTP server thread. */
+#define HTTP_HOST_STACK_SIZE               (64 * 1024)
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+extern WhdSTAInterface *wifi;
+
+static uint32_t host_requests;
+static cy_rslt_t host_result;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void http_host_entry(void *arg)
+{
+    (void)arg;
+    app_http_server_init(wifi);
+    fprintf(stderr, "http_host: serving http://127.0.0.1:%u\n",
+            (unsigned int)HTTPServer::host_port);
+    host_result = HTTPServer::host_serve(host_requests);
+}
+
+int main(int argc, char *argv[])
+{
+    HTTPServer::host_port = (1 < argc) ? (uint16_t)strtoul(argv[1], NULL, 10) : HTTP_HOST_PORT;
+    host_requests = (2 < argc) ? (uint32_t)strtoul(argv[2], NULL, 10) : 0;
+
+    pf_publish_lists();
+    if ((0 != host_thread_run(http_host_entry, NULL, HTTP_HOST_STACK_SIZE)) ||
+        (CY_RSLT_SUCCESS != host_result))
+    {
+        fprintf(stderr, "http_host: the server failed\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,146 @@
+/******************************************************************************
+ * File Name: HTTP_server.hpp
+ *
+ * Description:
+ *   Host stand-in for the HTTP server library. The page render benchmark
+ *   calls the page handlers directly. The host web server (see
+ *   tests/host/http_host.cpp) serves the registered resources over a TCP
+ *   socket of the workstation, one request per connection, in
+ *   shim/http_server.cpp.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef HTTP_SERVER_HPP
+#define HTTP_SERVER_HPP
+
+#include <stdint.h>
+#include "cy_result.h"
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+typedef enum
+{
+    CY_NW_INF_TYPE_WIFI = 0
+} cy_network_interface_type_t;
+
+typedef enum
+{
+    CY_STATIC_URL_CONTENT = 0,
+    CY_DYNAMIC_URL_CONTENT
+} cy_url_resource_type;
+
+typedef struct
+{
+    cy_network_interface_type_t type;
+    void *object;
+} cy_network_interface_t;
+
+/* Response stream: the connected socket and the bytes written to it. */
+typedef struct
+{
+    int socket;
+    uint32_t bytes;
+} cy_http_response_stream_t;
+
+typedef struct
+{
+    uint8_t *data;
+    uint16_t data_length;
+} cy_http_message_body_t;
+
+typedef int32_t (*url_processor_t)(const char *url_path,
+                                   const char *url_query_string,
+                                   cy_http_response_stream_t *stream,
+                                   void *arg,
+                                   cy_http_message_body_t *http_data);
+
+typedef struct
+{
+    url_processor_t resource_handler;
+    void *arg;
+} cy_resource_dynamic_data_t;
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Resources registered with a server. */
+#define HTTP_SERVER_MAX_RESOURCES          (16u)
+
+/******************************************************************************
+ *                           CLASS DECLARATION
+ *****************************************************************************/
+class HTTPServer
+{
+public:
+    /* TCP port listened to on the workstation instead of the port of the
+     * application, or 0 for start() not to listen, as for the benchmark.
+     */
+    static uint16_t host_port;
+
+    HTTPServer(cy_network_interface_t *network_interface, uint16_t port, uint16_t max_sockets);
+
+    cy_rslt_t register_resource(uint8_t *url, uint8_t *mime_type,
+                                cy_url_resource_type url_resource_type, void *resource_data);
+
+    cy_rslt_t start();
+
+    cy_rslt_t http_response_stream_write(cy_http_response_stream_t *stream,
+                                         const void *data, uint32_t length);
+
+    /* Serves the requests of the started server on the calling thread,
+     * forever or until max_requests requests were served if not 0.
+     */
+    static cy_rslt_t host_serve(uint32_t max_requests);
+
+private:
+    typedef struct
+    {
+        const char *url;
+        const char *mime_type;
+        cy_resource_dynamic_data_t *data;
+    } resource_t;
+
+    resource_t resources[HTTP_SERVER_MAX_RESOURCES];
+    uint32_t resource_count;
+    int listen_socket;
+
+    static HTTPServer *started;
+
+    void serve_connection(int socket);
+};
+
+#endif /* #ifndef HTTP_SERVER_HPP */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * File Name: WhdSTAInterface.h
+ *
+ * Description:
+ *   Host stand-in for the Wi-Fi interface of WHD. The HTTP shim runs without
+ *   a network: the interface stays disconnected.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef WHD_STA_INTERFACE_H
+#define WHD_STA_INTERFACE_H
+
+#include "mbed.h"
+
+class WhdSTAInterface : public NetworkInterface
+{
+public:
+    virtual nsapi_error_t set_credentials(const char *ssid, const char *pass,
+                                          nsapi_security_t security = NSAPI_SECURITY_NONE)
+    {
+        (void)ssid;
+        (void)pass;
+        (void)security;
+        return 0;
+    }
+
+    virtual nsapi_error_t connect() { return 0; }
+
+    virtual nsapi_error_t connect(const char *ssid, const char *pass,
+                                  nsapi_security_t security = NSAPI_SECURITY_NONE,
+                                  uint8_t channel = 0)
+    {
+        (void)ssid;
+        (void)pass;
+        (void)security;
+        (void)channel;
+        return 0;
+    }
+
+    virtual nsapi_error_t disconnect() { return 0; }
+
+    nsapi_connection_status_t get_connection_status() const
+    {
+        return NSAPI_STATUS_DISCONNECTED;
+    }
+
+    nsapi_error_t get_ip_address(SocketAddress *address)
+    {
+        (void)address;
+        return 0;
+    }
+};
+
+#endif /* #ifndef WHD_STA_INTERFACE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,296 @@
+/******************************************************************************
+ * File Name: http_server.cpp
+ *
+ * Description:
+ *   Host stand-in for the HTTP server library. The registered resources are
+ *   served over a TCP socket of the workstation, one request per connection
+ *   and one connection at a time, on the thread calling
+ *   HTTPServer::host_serve(). The response headers are written before the
+ *   page handler is called, without a length: the connection is closed at
+ *   the end of the response.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "HTTP_server.hpp"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Longest request: request line, headers and body. */
+#define HTTP_SERVER_REQUEST_LEN            (4096u)
+
+/* Pending connections of the listening socket. */
+#define HTTP_SERVER_BACKLOG                (4)
+
+#define HTTP_CONTENT_LENGTH                "Content-Length:"
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+uint16_t HTTPServer::host_port = 0;
+HTTPServer *HTTPServer::started = NULL;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Writes the whole buffer to the socket. */
+static bool http_server_send(int socket, const void *data, size_t length)
+{
+    const char *next = (const char *)data;
+
+    while (0 < length)
+    {
+        ssize_t sent = send(socket, next, length, MSG_NOSIGNAL);
+
+        if (0 >= sent)
+        {
+            return false;
+        }
+        next += sent;
+        length -= (size_t)sent;
+    }
+
+    return true;
+}
+
+/* Returns the Content-Length of the headers, 0 if there is none. */
+static size_t http_server_content_length(const char *headers)
+{
+    const char *line = strstr(headers, "\r\n");
+
+    while ((NULL != line) && ('\r' != line[2]))
+    {
+        line += 2;
+        if (!strncasecmp(line, HTTP_CONTENT_LENGTH, strlen(HTTP_CONTENT_LENGTH)))
+        {
+            return strtoul(line + strlen(HTTP_CONTENT_LENGTH), NULL, 10);
+        }
+        line = strstr(line, "\r\n");
+    }
+
+    return 0;
+}
+
+HTTPServer::HTTPServer(cy_network_interface_t *network_interface, uint16_t port,
+                       uint16_t max_sockets)
+    : resource_count(0), listen_socket(-1)
+{
+    (void)network_interface;
+    (void)port;
+    (void)max_sockets;
+}
+
+cy_rslt_t HTTPServer::register_resource(uint8_t *url, uint8_t *mime_type,
+                                        cy_url_resource_type url_resource_type,
+                                        void *resource_data)
+{
+    if ((CY_DYNAMIC_URL_CONTENT != url_resource_type) ||
+        (HTTP_SERVER_MAX_RESOURCES <= resource_count))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    resources[resource_count].url = (const char *)url;
+    resources[resource_count].mime_type = (const char *)mime_type;
+    resources[resource_count].data = (cy_resource_dynamic_data_t *)resource_data;
+    resource_count++;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t HTTPServer::start()
+{
+    struct sockaddr_in addr;
+    int reuse = 1;
+
+    if (0 == host_port)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(host_port);
+
+    listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if ((0 > listen_socket) ||
+        (0 != setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse))) ||
+        (0 != bind(listen_socket, (struct sockaddr *)&addr, sizeof(addr))) ||
+        (0 != listen(listen_socket, HTTP_SERVER_BACKLOG)))
+    {
+        perror("http_server");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    started = this;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t HTTPServer::http_response_stream_write(cy_http_response_stream_t *stream,
+                                                 const void *data, uint32_t length)
+{
+    stream->bytes += length;
+    if ((0 <= stream->socket) && !http_server_send(stream->socket, data, length))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+void HTTPServer::serve_connection(int socket)
+{
+    static const char not_found[] =
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    static const char too_large[] =
+        "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    char request[HTTP_SERVER_REQUEST_LEN + 1];
+    char headers[128];
+    cy_http_response_stream_t stream = { socket, 0 };
+    cy_http_message_body_t body = { NULL, 0 };
+    char *header_end = NULL;
+    char *path = NULL;
+    char *query = NULL;
+    size_t length = 0;
+    size_t content_length = 0;
+    const resource_t *resource = NULL;
+
+    /* Request line and headers. */
+    request[0] = '\0';
+    while (NULL == (header_end = strstr(request, "\r\n\r\n")))
+    {
+        ssize_t received = recv(socket, &request[length], HTTP_SERVER_REQUEST_LEN - length, 0);
+
+        if (0 >= received)
+        {
+            return;
+        }
+        length += (size_t)received;
+        request[length] = '\0';
+        if (HTTP_SERVER_REQUEST_LEN == length)
+        {
+            http_server_send(socket, too_large, strlen(too_large));
+            return;
+        }
+    }
+
+    /* Body. */
+    header_end[2] = '\0';
+    content_length = http_server_content_length(request);
+    body.data = (uint8_t *)&header_end[4];
+    if ((HTTP_SERVER_REQUEST_LEN - (size_t)(body.data - (uint8_t *)request) < content_length) ||
+        (UINT16_MAX < content_length))
+    {
+        http_server_send(socket, too_large, strlen(too_large));
+        return;
+    }
+    while ((size_t)(&request[length] - (char *)body.data) < content_length)
+    {
+        ssize_t received = recv(socket, &request[length], HTTP_SERVER_REQUEST_LEN - length, 0);
+
+        if (0 >= received)
+        {
+            return;
+        }
+        length += (size_t)received;
+    }
+    body.data_length = (uint16_t)content_length;
+
+    /* Path and query string of the request line "<method> <target> HTTP/1.1". */
+    path = strchr(request, ' ');
+    if ((NULL == path) || (NULL == strchr(path + 1, ' ')))
+    {
+        http_server_send(socket, not_found, strlen(not_found));
+        return;
+    }
+    path++;
+    *strchr(path, ' ') = '\0';
+    query = strchr(path, '?');
+    if (NULL != query)
+    {
+        *query++ = '\0';
+    }
+
+    for (uint32_t i = 0; (i < resource_count) && (NULL == resource); i++)
+    {
+        resource = !strcmp(path, resources[i].url) ? &resources[i] : NULL;
+    }
+    if (NULL == resource)
+    {
+        http_server_send(socket, not_found, strlen(not_found));
+        return;
+    }
+
+    snprintf(headers, sizeof(headers),
+             "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nConnection: close\r\n\r\n",
+             resource->mime_type);
+    if (http_server_send(socket, headers, strlen(headers)))
+    {
+        resource->data->resource_handler(path, query, &stream, resource->data->arg, &body);
+    }
+}
+
+cy_rslt_t HTTPServer::host_serve(uint32_t max_requests)
+{
+    if (NULL == started)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (uint32_t served = 0; (0 == max_requests) || (served < max_requests); served++)
+    {
+        int socket = accept(started->listen_socket, NULL, NULL);
+
+        if (0 > socket)
+        {
+            perror("http_server");
+            return CY_RSLT_TYPE_ERROR;
+        }
+        started->serve_connection(socket);
+        shutdown(socket, SHUT_WR);
+        close(socket);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,306 @@
+/******************************************************************************
+ * File Name: http_shim.cpp
+ *
+ * Description:
+ *   HTTP shim: host stand-ins for the modules of the application which drive
+ *   the WLAN device, the network or the RTOS, so that the page handlers, the
+ *   packet filter lists and the page render benchmark run unchanged on a
+ *   workstation (see tests/host/bench_http.cpp and tests/host/http_host.cpp).
+ *   The Wi-Fi interface stays disconnected and its reassociations succeed at
+ *   once, the offloads are never started and the reports are empty.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <pthread.h>
+#include "mbed.h"
+#include "rtx_os.h"
+#include "http_webserver_config.h"
+#include "pf_olm_config.h"
+#include "pf_commit_worker.h"
+#include "pf_tier_manager.h"
+#include "pf_ipv6.h"
+#include "arp_offload.h"
+#include "tko_offload.h"
+#include "emac_rx_hook.h"
+#include "wake_latency.h"
+#include "storm_detector.h"
+#include "fast_join.h"
+#include "app_events.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Report of a module left out of the host build: empty. */
+#define HOST_EMPTY_REPORT(name)                                         \
+    int name(char *buf, size_t buf_len)                                 \
+    {                                                                   \
+        (void)buf;                                                      \
+        (void)buf_len;                                                  \
+        return 0;                                                       \
+    }
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Thread started by host_thread_run(). */
+typedef struct
+{
+    osRtxThread_t cb;
+    void (*entry)(void *);
+    void *arg;
+} host_thread_t;
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ *****************************************************************************/
+/* The DWT counts nanoseconds, see mbed.h. */
+uint32_t SystemCoreClock = 1000000000UL;
+host_dwt_t host_dwt;
+host_core_debug_t host_core_debug;
+
+static WhdSTAInterface host_wifi;
+WhdSTAInterface *wifi = &host_wifi;
+
+const ol_fns_t pf_ol_fns = { NULL, NULL, NULL };
+const ol_fns_t pf_ipv6_ol_fns = { NULL, NULL, NULL };
+const ol_fns_t arp_ol_fns = { NULL, NULL, NULL };
+const ol_fns_t tko_ol_fns = { NULL, NULL, NULL };
+
+arp_ol_cfg_t arp_ol_cfg = { 0, 0, MBED_CONF_APP_ARP_OFFLOAD_PEERAGE_S };
+cy_tko_ol_cfg_t tko_ol_cfg = { MBED_CONF_APP_TKO_INTERVAL_S,
+                               MBED_CONF_APP_TKO_RETRY_INTERVAL_S,
+                               MBED_CONF_APP_TKO_RETRY_COUNT };
+
+static pf_commit_state_t commit_state = PF_COMMIT_IDLE;
+static const char *commit_state_names[] = {
+    "idle", "queued", "disconnecting", "restarting_olm",
+    "reassociating", "dhcp", "done", "failed"
+};
+
+static std::recursive_mutex critical_section;
+static thread_local host_thread_t *current_thread;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Mbed OS and RTX. */
+void core_util_critical_section_enter(void)
+{
+    critical_section.lock();
+}
+
+void core_util_critical_section_exit(void)
+{
+    critical_section.unlock();
+}
+
+osThreadId_t osThreadGetId(void)
+{
+    return (NULL != current_thread) ? &current_thread->cb : NULL;
+}
+
+static void *host_thread_entry(void *arg)
+{
+    current_thread = (host_thread_t *)arg;
+    current_thread->entry(current_thread->arg);
+
+    return NULL;
+}
+
+int host_thread_run(void (*entry)(void *), void *arg, uint32_t stack_size)
+{
+    host_thread_t thread = { { NULL, stack_size }, entry, arg };
+    pthread_attr_t attr;
+    pthread_t id;
+    int result;
+
+    if (0 != posix_memalign(&thread.cb.stack_mem, 4096, stack_size))
+    {
+        return -1;
+    }
+    pthread_attr_init(&attr);
+    result = pthread_attr_setstack(&attr, thread.cb.stack_mem, stack_size);
+    if (0 == result)
+    {
+        result = pthread_create(&id, &attr, host_thread_entry, &thread);
+    }
+    if (0 == result)
+    {
+        result = pthread_join(id, NULL);
+    }
+    pthread_attr_destroy(&attr);
+    free(thread.cb.stack_mem);
+
+    return result;
+}
+
+/* LPA: the default offload list and the OLM. */
+extern "C" const ol_desc_t *cycfg_get_default_ol_list(void);
+
+const void *get_default_ol_list(void)
+{
+    return cycfg_get_default_ol_list();
+}
+
+void cylpa_restart_olm(ol_desc_t *ol_list, void *nw_interface)
+{
+    (void)ol_list;
+    (void)nw_interface;
+}
+
+/* main.cpp: the reassociation succeeds, the Wi-Fi interface stays
+ * disconnected.
+ */
+cy_rslt_t app_wl_connect(WhdSTAInterface *wifi, const char *ssid, const char *pwd,
+                         nsapi_security_t security)
+{
+    (void)wifi;
+    (void)ssid;
+    (void)pwd;
+    (void)security;
+    return CY_RSLT_SUCCESS;
+}
+
+void app_wl_disconnect(WhdSTAInterface *wifi)
+{
+    (void)wifi;
+}
+
+/* pf_commit_worker.cpp: the commits run at once. */
+void pf_commit_request(bool restore_to_default)
+{
+    pf_commit_list(restore_to_default, NULL, NULL);
+}
+
+void pf_commit_set_state(pf_commit_state_t state)
+{
+    commit_state = state;
+}
+
+int pf_commit_status_report(char *buf, size_t buf_len)
+{
+    return snprintf(buf, buf_len, "%s\n", commit_state_names[commit_state]);
+}
+
+/* pf_ipv6.cpp: the IPv6 filters are left out of the LPA list. */
+uint8_t pf_ipv6_lpa_list(const cy_pf_ol_cfg_t *cfgs, const pf_ipv6_attrs_t *ipv6,
+                         cy_pf_ol_cfg_t *lpa_cfgs)
+{
+    uint8_t count = 0;
+
+    for (; CY_PF_OL_FEAT_LAST != cfgs->feature; cfgs++)
+    {
+        if (!PF_IS_IPV6(cfgs, ipv6))
+        {
+            lpa_cfgs[count++] = *cfgs;
+        }
+    }
+    lpa_cfgs[count].feature = CY_PF_OL_FEAT_LAST;
+
+    return count;
+}
+
+/* arp_offload.cpp: the settings are only kept. */
+cy_rslt_t arp_offload_configure(bool snoop, bool peer_auto_reply, uint32_t peerage_s)
+{
+    (void)snoop;
+    (void)peer_auto_reply;
+    arp_ol_cfg.peerage = peerage_s;
+    return CY_RSLT_SUCCESS;
+}
+
+bool arp_offload_get_snoop(void)
+{
+    return MBED_CONF_APP_ARP_OFFLOAD_SNOOP;
+}
+
+bool arp_offload_get_peer_auto_reply(void)
+{
+    return MBED_CONF_APP_ARP_OFFLOAD_PEER_AUTO_REPLY;
+}
+
+/* Tiered filter manager, disabled. */
+cy_rslt_t pf_tier_add_rule(const cy_pf_ol_cfg_t *cfg, const pf_ipv6_attr_t *ipv6)
+{
+    (void)cfg;
+    (void)ipv6;
+    return CY_RSLT_TYPE_ERROR;
+}
+
+void pf_tier_clear(void)
+{
+}
+
+int pf_tier_report_rule(uint8_t index, char *buf, size_t buf_len)
+{
+    (void)index;
+    (void)buf;
+    (void)buf_len;
+    return 0;
+}
+
+/* Counters and reports, empty. */
+uint32_t emac_rx_hook_get_discard_count(void)
+{
+    return 0;
+}
+
+uint32_t wake_latency_get_wake_count(void)
+{
+    return 0;
+}
+
+int wake_latency_report(wake_stage_t stage, char *buf, size_t buf_len)
+{
+    (void)stage;
+    (void)buf;
+    (void)buf_len;
+    return 0;
+}
+
+int FastJoinSTAInterface::report(char *buf, size_t buf_len)
+{
+    (void)buf;
+    (void)buf_len;
+    return 0;
+}
+
+HOST_EMPTY_REPORT(app_events_report)
+HOST_EMPTY_REPORT(arp_offload_report)
+HOST_EMPTY_REPORT(pf_ipv6_report)
+HOST_EMPTY_REPORT(pf_tier_report_summary)
+HOST_EMPTY_REPORT(storm_detector_report)
+HOST_EMPTY_REPORT(tko_offload_report)
+
+
+/* [] END OF FILE */
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * File Name: mbed.h
+ *
+ * Description:
+ *   Host stand-in for the parts of Mbed OS used by the page handlers, the
+ *   packet filter lists and their snapshots, so that they can be built on a
+ *   workstation by the HTTP shim (see tests/host/CMakeLists.txt). The DWT
+ *   cycle counter counts the nanoseconds of the steady clock, and
+ *   SystemCoreClock is set accordingly.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef MBED_H
+#define MBED_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+#define MBED_ASSERT(expr)                  assert(expr)
+
+/* Bits of the DWT and CoreDebug registers used by the application. */
+#define DWT_CTRL_CYCCNTENA_Msk             (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk         (1UL << 24)
+
+#define DWT                                (&host_dwt)
+#define CoreDebug                          (&host_core_debug)
+
+/* Stack pointer of the calling function. */
+#define __get_PSP()                        ((uintptr_t)__builtin_frame_address(0))
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+typedef int nsapi_error_t;
+
+#define NSAPI_ERROR_OK                     (0)
+
+typedef enum
+{
+    NSAPI_SECURITY_NONE = 0,
+    NSAPI_SECURITY_WPA2 = 4
+} nsapi_security_t;
+
+typedef enum
+{
+    NSAPI_STATUS_LOCAL_UP = 0,
+    NSAPI_STATUS_GLOBAL_UP,
+    NSAPI_STATUS_DISCONNECTED,
+    NSAPI_STATUS_CONNECTING
+} nsapi_connection_status_t;
+
+/* Cycle counter of the DWT, read as the steady clock in nanoseconds. */
+struct host_cycle_counter_t
+{
+    operator uint32_t() const
+    {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+struct host_dwt_t
+{
+    uint32_t CTRL;
+    host_cycle_counter_t CYCCNT;
+};
+
+struct host_core_debug_t
+{
+    uint32_t DEMCR;
+};
+
+extern host_dwt_t host_dwt;
+extern host_core_debug_t host_core_debug;
+extern uint32_t SystemCoreClock;
+
+class SocketAddress
+{
+public:
+    const char *get_ip_address() const { return "0.0.0.0"; }
+};
+
+class NetworkInterface
+{
+public:
+    virtual ~NetworkInterface() {}
+};
+
+namespace mbed
+{
+
+template <typename F>
+class Callback;
+
+/* Callback of a plain function, the only kind used by the headers. */
+template <typename R, typename... Args>
+class Callback<R(Args...)>
+{
+public:
+    Callback() : _fn(nullptr) {}
+    Callback(std::nullptr_t) : _fn(nullptr) {}
+    Callback(R (*fn)(Args...)) : _fn(fn) {}
+    R operator()(Args... args) const { return _fn(args...); }
+    explicit operator bool() const { return nullptr != _fn; }
+
+private:
+    R (*_fn)(Args...);
+};
+
+template <typename R, typename... Args>
+Callback<R(Args...)> callback(R (*fn)(Args...))
+{
+    return Callback<R(Args...)>(fn);
+}
+
+class Timer
+{
+public:
+    void start() { _start = std::chrono::steady_clock::now(); _running = true; }
+    void stop() { _elapsed += std::chrono::steady_clock::now() - _start; _running = false; }
+    std::chrono::microseconds elapsed_time() const
+    {
+        std::chrono::steady_clock::duration elapsed = _elapsed;
+
+        if (_running)
+        {
+            elapsed += std::chrono::steady_clock::now() - _start;
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::duration _elapsed{0};
+    bool _running = false;
+};
+
+template <typename Lockable>
+class ScopedLock
+{
+public:
+    explicit ScopedLock(Lockable &lockable) : _lockable(lockable) { _lockable.lock(); }
+    ~ScopedLock() { _lockable.unlock(); }
+
+private:
+    Lockable &_lockable;
+};
+
+} /* namespace mbed */
+
+namespace rtos
+{
+
+/* The Mbed OS mutex is recursive. */
+class Mutex
+{
+public:
+    void lock() { _mutex.lock(); }
+    bool trylock() { return _mutex.try_lock(); }
+    void unlock() { _mutex.unlock(); }
+
+private:
+    std::recursive_mutex _mutex;
+};
+
+} /* namespace rtos */
+
+using namespace mbed;
+using namespace rtos;
+
+typedef mbed::ScopedLock<rtos::Mutex> ScopedMutexLock;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+void core_util_critical_section_enter(void);
+void core_util_critical_section_exit(void);
+
+/******************************************************************************
+ *                         INLINE FUNCTIONS
+ *****************************************************************************/
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (0u == value) ? 32u : (uint32_t)__builtin_clz(value);
+}
+
+static inline uint32_t core_util_atomic_load_u32(const volatile uint32_t *valuePtr)
+{
+    return __atomic_load_n(valuePtr, __ATOMIC_SEQ_CST);
+}
+
+static inline void core_util_atomic_store_u32(volatile uint32_t *valuePtr, uint32_t desiredValue)
+{
+    __atomic_store_n(valuePtr, desiredValue, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t core_util_atomic_incr_u32(volatile uint32_t *valuePtr, uint32_t delta)
+{
+    return __atomic_add_fetch(valuePtr, delta, __ATOMIC_SEQ_CST);
+}
+
+static inline bool core_util_atomic_cas_u32(volatile uint32_t *ptr, uint32_t *expectedCurrentValue,
+                                            uint32_t desiredValue)
+{
+    return __atomic_compare_exchange_n(ptr, expectedCurrentValue, desiredValue, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t core_util_atomic_load_u64(const volatile uint64_t *valuePtr)
+{
+    return __atomic_load_n(valuePtr, __ATOMIC_SEQ_CST);
+}
+
+static inline bool core_util_atomic_cas_u64(volatile uint64_t *ptr, uint64_t *expectedCurrentValue,
+                                            uint64_t desiredValue)
+{
+    return __atomic_compare_exchange_n(ptr, expectedCurrentValue, desiredValue, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void *core_util_atomic_load_ptr(void *const volatile *valuePtr)
+{
+    return __atomic_load_n(valuePtr, __ATOMIC_SEQ_CST);
+}
+
+static inline void core_util_atomic_store_ptr(void *volatile *valuePtr, void *desiredValue)
+{
+    __atomic_store_n(valuePtr, desiredValue, __ATOMIC_SEQ_CST);
+}
+
+#endif /* #ifndef MBED_H */
+
+
+/* [] END OF FILE */
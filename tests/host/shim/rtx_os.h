@@ -0,0 +1,71 @@
+/******************************************************************************
+ * File Name: rtx_os.h
+ *
+ * Description:
+ *   Host stand-in for the RTX thread control block, so that the stack
+ *   painting of app/http_stats.cpp measures the stack of the thread the HTTP
+ *   shim runs the page handlers on (see shim/http_shim.cpp).
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef RTX_OS_H
+#define RTX_OS_H
+
+#include <stdint.h>
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+typedef void *osThreadId_t;
+
+/* Thread control block: only the stack of the thread. */
+typedef struct
+{
+    void *stack_mem;        /* Lowest address of the stack            */
+    uint32_t stack_size;    /* Size of the stack in bytes             */
+} osRtxThread_t;
+
+/******************************************************************************
+ *                     FUNCTION DECLARATIONS
+ *****************************************************************************/
+osThreadId_t osThreadGetId(void);
+
+/* Host only: runs a function on a thread with a stack of the given size,
+ * known to osThreadGetId(), and waits for its end. Returns 0 on success.
+ */
+int host_thread_run(void (*entry)(void *), void *arg, uint32_t stack_size);
+
+#endif /* #ifndef RTX_OS_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * File Name: cy_lpa_wifi_pf_ol.h
+ *
+ * Description:
+ *   Host stand-in for the packet filter offload types of the LPA library.
+ *   It declares the constants and the layout of cy_pf_ol_cfg_t used by the
+ *   application, so that the list management and the classifier can be
+ *   compiled and tested on a workstation (see tests/host/CMakeLists.txt).
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#ifndef CY_LPA_WIFI_PF_OL_H
+#define CY_LPA_WIFI_PF_OL_H
+
+#include <stdint.h>
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Host states a filter is active in, and its action. */
+#define CY_PF_ACTIVE_SLEEP                 (1)
+#define CY_PF_ACTIVE_WAKE                  (2)
+#define CY_PF_ACTION_DISCARD               (4)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Packet filter types. An entry of type CY_PF_OL_FEAT_LAST ends a list. */
+typedef enum
+{
+    CY_PF_OL_FEAT_PORTNUM = 1,
+    CY_PF_OL_FEAT_ETHTYPE,
+    CY_PF_OL_FEAT_IPTYPE,
+    CY_PF_OL_FEAT_LAST = 0x7fff
+} cy_pf_ol_feat_t;
+
+/* Port of a port filter. */
+typedef enum
+{
+    PF_PN_PORT_DEST = 1,
+    PF_PN_PORT_SOURCE = 2
+} cy_pn_direction_t;
+
+/* Transport protocol of a port filter. */
+typedef enum
+{
+    CY_PF_PROTOCOL_TCP = 6,
+    CY_PF_PROTOCOL_UDP = 17
+} cy_pf_proto_t;
+
+/* Port number, range and direction of a port filter. */
+typedef struct
+{
+    uint16_t portnum;
+    uint16_t range;
+    cy_pn_direction_t direction;
+} cy_pf_pn_t;
+
+/* Packet filter configuration. */
+typedef struct
+{
+    cy_pf_ol_feat_t feature;
+    uint32_t bits;
+    uint32_t id;
+    union
+    {
+        struct
+        {
+            cy_pf_pn_t portnum;
+            cy_pf_proto_t proto;
+        } pf;
+        struct
+        {
+            uint16_t eth_type;
+        } eth;
+        struct
+        {
+            uint8_t ip_type;
+        } ip;
+    } u;
+} cy_pf_ol_cfg_t;
+
+#endif /* #ifndef CY_LPA_WIFI_PF_OL_H */
+
+
+/* [] END OF FILE */
+
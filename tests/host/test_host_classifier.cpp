@@ -0,0 +1,382 @@
+/******************************************************************************
+ * File Name: test_host_classifier.cpp
+ *
+ * Description:
+ *   Host unit tests of the host classifier (host_classifier.cpp) with
+ *   packet vectors: Ethernet frames carrying IPv4 TCP and UDP packets,
+ *   fragments, truncated headers and non-IP frames.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "host_classifier.h"
+#include "host_test.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+#define IP4(a, b, c, d)                    (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | \
+                                            ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+#define ETH_HDR_LEN                        (14)
+#define IPV4_HDR_LEN                       (20)
+#define TCP_HDR_LEN                        (20)
+#define UDP_HDR_LEN                        (8)
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Ethernet frame under test. */
+typedef struct
+{
+    uint8_t data[256];
+    uint32_t len;
+} frame_t;
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+static const uint8_t host_mac[6] = { 0x00, 0xA0, 0x50, 0x12, 0x34, 0x56 };
+static const uint8_t mcast_mac[6] = { 0x01, 0x00, 0x5E, 0x7F, 0xFF, 0xFA };
+static const uint8_t ssdp_payload[] = "M-SEARCH * HTTP/1.1\r\n";
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+    put_be16(p, (uint16_t)(v >> 16));
+    put_be16(&p[2], (uint16_t)v);
+}
+
+/* Builds an Ethernet frame with an IPv4 header and the given L4 bytes. */
+static frame_t ipv4_frame(const uint8_t *dst_mac, uint32_t src, uint32_t dst, uint8_t proto,
+                          uint16_t frag, const uint8_t *l4, uint32_t l4_len)
+{
+    frame_t f;
+    uint8_t *ip = &f.data[ETH_HDR_LEN];
+
+    memset(&f, 0, sizeof(f));
+    memcpy(f.data, dst_mac, 6);
+    memcpy(&f.data[6], host_mac, 6);
+    put_be16(&f.data[12], 0x0800);
+    ip[0] = 0x45;
+    put_be16(&ip[2], (uint16_t)(IPV4_HDR_LEN + l4_len));
+    put_be16(&ip[6], frag);
+    ip[8] = 64;
+    ip[9] = proto;
+    put_be32(&ip[12], src);
+    put_be32(&ip[16], dst);
+    memcpy(&ip[IPV4_HDR_LEN], l4, l4_len);
+    f.len = ETH_HDR_LEN + IPV4_HDR_LEN + l4_len;
+    return f;
+}
+
+static frame_t tcp_frame(uint32_t src, uint32_t dst, uint8_t flags, uint16_t frag)
+{
+    uint8_t tcp[TCP_HDR_LEN + 4] = {0};
+
+    put_be16(&tcp[0], 40000);
+    put_be16(&tcp[2], 80);
+    tcp[12] = (TCP_HDR_LEN / 4) << 4;
+    tcp[13] = flags;
+    memcpy(&tcp[TCP_HDR_LEN], "GET ", 4);
+    return ipv4_frame(host_mac, src, dst, 6, frag, tcp, sizeof(tcp));
+}
+
+static frame_t ssdp_frame(const uint8_t *dst_mac, uint16_t frag)
+{
+    uint8_t udp[UDP_HDR_LEN + sizeof(ssdp_payload)] = {0};
+
+    put_be16(&udp[0], 1900);
+    put_be16(&udp[2], 1900);
+    put_be16(&udp[4], (uint16_t)sizeof(udp));
+    memcpy(&udp[UDP_HDR_LEN], ssdp_payload, sizeof(ssdp_payload));
+    return ipv4_frame(dst_mac, IP4(192, 168, 1, 20), IP4(239, 255, 255, 250), 17, frag,
+                      udp, sizeof(udp));
+}
+
+static frame_t arp_frame(void)
+{
+    static const uint8_t bcast_mac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    frame_t f;
+
+    memset(&f, 0, sizeof(f));
+    memcpy(f.data, bcast_mac, 6);
+    memcpy(&f.data[6], host_mac, 6);
+    put_be16(&f.data[12], 0x0806);
+    f.len = ETH_HDR_LEN + 28;
+    return f;
+}
+
+static hc_action_t run(const frame_t &f)
+{
+    return host_classifier_run(f.data, f.len);
+}
+
+static hc_rule_t drop_rule(uint8_t match)
+{
+    hc_rule_t rule;
+
+    memset(&rule, 0, sizeof(rule));
+    rule.match = match;
+    rule.action = HC_ACTION_DROP;
+    return rule;
+}
+
+static uint32_t hits(uint8_t index)
+{
+    hc_rule_t rule;
+
+    return host_classifier_get_rule(index, &rule) ? rule.hits : 0xFFFFFFFFu;
+}
+
+static void test_no_rules(void)
+{
+    host_classifier_clear();
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0)));
+    CHECK_EQ(HC_ACTION_KEEP, host_classifier_run(NULL, 0));
+    CHECK_EQ(0, host_classifier_get_rule_count());
+}
+
+static void test_networks_and_protocol(void)
+{
+    hc_rule_t rule = drop_rule(HC_MATCH_SRC_NET | HC_MATCH_IP_PROTO);
+
+    host_classifier_clear();
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_net("10.1.0.0/16", &rule.src_ip, &rule.src_mask));
+    rule.ip_proto = 6;
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&rule));
+
+    CHECK_EQ(HC_ACTION_DROP, run(tcp_frame(IP4(10, 1, 2, 3), IP4(10, 0, 0, 2), 0x10, 0)));
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 2, 2, 3), IP4(10, 0, 0, 2), 0x10, 0)));
+    CHECK_EQ(HC_ACTION_KEEP, run(ssdp_frame(mcast_mac, 0)));
+    CHECK_EQ(1u, hits(0));
+
+    rule = drop_rule(HC_MATCH_DST_NET | HC_MATCH_MCAST);
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_net("239.255.255.250%2F32", &rule.dst_ip, &rule.dst_mask));
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&rule));
+    CHECK_EQ(HC_ACTION_DROP, run(ssdp_frame(mcast_mac, 0)));
+    CHECK_EQ(HC_ACTION_KEEP, run(ssdp_frame(host_mac, 0)));
+    CHECK_EQ(1u, hits(1));
+}
+
+static void test_tcp_flags_and_payload(void)
+{
+    hc_rule_t syn = drop_rule(HC_MATCH_TCP_FLAGS);
+    hc_rule_t msearch = drop_rule(HC_MATCH_PAYLOAD);
+
+    host_classifier_clear();
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_tcp_flags("Sa", &syn.tcp_flags_value, &syn.tcp_flags_mask));
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&syn));
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_prefix("4d2d534541524348", msearch.prefix,
+                                              &msearch.prefix_len));
+    CHECK_EQ(8, msearch.prefix_len);
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&msearch));
+
+    CHECK_EQ(HC_ACTION_DROP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0)));
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x12, 0)));
+    CHECK_EQ(HC_ACTION_DROP, run(ssdp_frame(mcast_mac, 0)));
+    CHECK_EQ(1u, hits(0));
+    CHECK_EQ(1u, hits(1));
+}
+
+static void test_fragments(void)
+{
+    hc_rule_t syn = drop_rule(HC_MATCH_TCP_FLAGS);
+    hc_rule_t msearch = drop_rule(HC_MATCH_PAYLOAD);
+    hc_rule_t src = drop_rule(HC_MATCH_SRC_NET);
+
+    host_classifier_clear();
+    hc_parse_tcp_flags("S", &syn.tcp_flags_value, &syn.tcp_flags_mask);
+    hc_parse_prefix("4d2d5345", msearch.prefix, &msearch.prefix_len);
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&syn));
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&msearch));
+
+    /* The first fragment, with more fragments set, has the L4 header. */
+    CHECK_EQ(HC_ACTION_DROP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0x2000)));
+    CHECK_EQ(HC_ACTION_DROP, run(ssdp_frame(mcast_mac, 0x2000)));
+
+    /* The following fragments carry data which looks like L4 headers. */
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0x2001)));
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0x00B9)));
+    CHECK_EQ(HC_ACTION_KEEP, run(ssdp_frame(mcast_mac, 0x0001)));
+
+    /* The IP header fields still match. */
+    hc_parse_net("10.0.0.0/8", &src.src_ip, &src.src_mask);
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&src));
+    CHECK_EQ(HC_ACTION_DROP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0x2001)));
+    CHECK_EQ(1u, hits(2));
+}
+
+static void test_truncated_and_non_ip(void)
+{
+    hc_rule_t proto = drop_rule(HC_MATCH_IP_PROTO);
+    hc_rule_t mcast = drop_rule(HC_MATCH_MCAST);
+    frame_t f = tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0);
+
+    host_classifier_clear();
+    proto.ip_proto = 6;
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&proto));
+
+    /* Truncated IPv4 header, bad header length, runt frame. */
+    CHECK_EQ(HC_ACTION_KEEP, host_classifier_run(f.data, ETH_HDR_LEN + IPV4_HDR_LEN - 1));
+    f.data[ETH_HDR_LEN] = 0x44;
+    CHECK_EQ(HC_ACTION_KEEP, run(f));
+    f.data[ETH_HDR_LEN] = 0x4F;
+    CHECK_EQ(HC_ACTION_KEEP, run(f));
+    CHECK_EQ(HC_ACTION_KEEP, host_classifier_run(f.data, 6));
+
+    /* A TCP header cut short has no flags, but the protocol is known. */
+    f = tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 2), 0x02, 0);
+    CHECK_EQ(HC_ACTION_DROP, host_classifier_run(f.data, ETH_HDR_LEN + IPV4_HDR_LEN + 10));
+
+    /* Only the destination MAC is seen in a non-IP frame. */
+    CHECK_EQ(HC_ACTION_KEEP, run(arp_frame()));
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&mcast));
+    CHECK_EQ(HC_ACTION_DROP, run(arp_frame()));
+}
+
+static void test_first_match_and_counters(void)
+{
+    hc_rule_t keep = drop_rule(HC_MATCH_SRC_NET);
+    hc_rule_t drop = drop_rule(HC_MATCH_SRC_NET);
+    uint32_t drops = host_classifier_get_drop_count();
+    hc_rule_t copy;
+
+    host_classifier_clear();
+    keep.action = HC_ACTION_KEEP;
+    hc_parse_net("10.0.0.1", &keep.src_ip, &keep.src_mask);
+    hc_parse_net("10.0.0.0/24", &drop.src_ip, &drop.src_mask);
+    keep.id = 0;
+    drop.id = 1;
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&keep));
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&drop));
+
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 0, 0, 1), IP4(10, 0, 0, 9), 0x10, 0)));
+    CHECK_EQ(HC_ACTION_DROP, run(tcp_frame(IP4(10, 0, 0, 2), IP4(10, 0, 0, 9), 0x10, 0)));
+    CHECK_EQ(HC_ACTION_DROP, run(tcp_frame(IP4(10, 0, 0, 3), IP4(10, 0, 0, 9), 0x10, 0)));
+    CHECK_EQ(1u, hits(0));
+    CHECK_EQ(2u, hits(1));
+    CHECK_EQ(drops + 2, host_classifier_get_drop_count());
+
+    CHECK(host_classifier_get_rule(1, &copy));
+    CHECK_EQ(1, copy.id);
+    CHECK_EQ(IP4(10, 0, 0, 0), copy.src_ip);
+    CHECK(!host_classifier_get_rule(2, &copy));
+
+    /* A rule added after a clear starts with no hits. */
+    host_classifier_clear();
+    CHECK_EQ(0, host_classifier_get_rule_count());
+    CHECK_EQ(HC_ACTION_KEEP, run(tcp_frame(IP4(10, 0, 0, 2), IP4(10, 0, 0, 9), 0x10, 0)));
+    CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&drop));
+    CHECK_EQ(0u, hits(0));
+}
+
+static void test_table_limits(void)
+{
+    hc_rule_t rule = drop_rule(HC_MATCH_IP_PROTO);
+
+    host_classifier_clear();
+    for (int i = 0; i < HC_MAX_RULES; i++)
+    {
+        rule.ip_proto = (uint8_t)(100 + i);
+        CHECK_EQ(CY_RSLT_SUCCESS, host_classifier_add(&rule));
+    }
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, host_classifier_add(&rule));
+    CHECK_EQ(HC_MAX_RULES, host_classifier_get_rule_count());
+
+    host_classifier_clear();
+    rule.action = HC_ACTION_DROP + 1;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, host_classifier_add(&rule));
+    rule.action = HC_ACTION_DROP;
+    rule.prefix_len = HC_PREFIX_MAX_LEN + 1;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, host_classifier_add(&rule));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, host_classifier_add(NULL));
+    CHECK_EQ(0, host_classifier_get_rule_count());
+}
+
+static void test_rule_parsers(void)
+{
+    uint32_t ip = 0;
+    uint32_t mask = 0;
+    uint8_t value = 0;
+    uint8_t flags_mask = 0;
+    uint8_t prefix[HC_PREFIX_MAX_LEN];
+    uint8_t prefix_len = 0;
+
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_net("192.168.1.77/24", &ip, &mask));
+    CHECK_EQ(IP4(192, 168, 1, 0), ip);
+    CHECK_EQ(0xFFFFFF00u, mask);
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_net("0.0.0.0/0", &ip, &mask));
+    CHECK_EQ(0u, mask);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_net("192.168.1/24", &ip, &mask));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_net("192.168.1.256", &ip, &mask));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_net("192.168.1.1/33", &ip, &mask));
+
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_tcp_flags("SAf", &value, &flags_mask));
+    CHECK_EQ(HC_TCP_SYN | HC_TCP_ACK, value);
+    CHECK_EQ(HC_TCP_SYN | HC_TCP_ACK | HC_TCP_FIN, flags_mask);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_tcp_flags("SX", &value, &flags_mask));
+
+    CHECK_EQ(CY_RSLT_SUCCESS, hc_parse_prefix("00ff10", prefix, &prefix_len));
+    CHECK_EQ(3, prefix_len);
+    CHECK_EQ(0xFF, prefix[1]);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_prefix("0ff", prefix, &prefix_len));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_prefix("zz", prefix, &prefix_len));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, hc_parse_prefix("000102030405060708", prefix, &prefix_len));
+}
+
+int main(void)
+{
+    RUN_TEST(test_no_rules);
+    RUN_TEST(test_networks_and_protocol);
+    RUN_TEST(test_tcp_flags_and_payload);
+    RUN_TEST(test_fragments);
+    RUN_TEST(test_truncated_and_non_ip);
+    RUN_TEST(test_first_match_and_counters);
+    RUN_TEST(test_table_limits);
+    RUN_TEST(test_rule_parsers);
+
+    return HOST_TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
+
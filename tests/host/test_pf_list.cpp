@@ -0,0 +1,474 @@
+/******************************************************************************
+ * File Name: test_pf_list.cpp
+ *
+ * Description:
+ *   Host unit tests of the packet filter list management (pf_list.cpp):
+ *   parsing of the HTTP filter data, validation, addition, removal by ID,
+ *   replacement of a list and the filter ID map.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <string.h>
+#include "pf_list.h"
+#include "host_test.h"
+
+/******************************************************************************
+ *                                TYPEDEFS
+ *****************************************************************************/
+/* Filter data as split from the HTTP query string. */
+typedef struct
+{
+    char *str[MAX_HTTP_CONFIG_NUMBER];
+} form_t;
+
+/* Packet filter list with its buffer. */
+typedef struct
+{
+    cy_pf_ol_cfg_t cfgs[MAX_FILTERS];
+    pf_list_t list;
+} test_list_t;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+static void list_init(test_list_t *l)
+{
+    l->list.first = l->cfgs;
+    l->list.last = &l->cfgs[MAX_FILTERS - 1];
+    pf_list_clear(&l->list);
+}
+
+static int list_count(const test_list_t *l)
+{
+    return (int)(l->list.cur - l->list.first);
+}
+
+static form_t port_form(const char *action, const char *proto, const char *dir,
+                        const char *port)
+{
+    form_t f;
+
+    memset(&f, 0, sizeof(f));
+    f.str[PKT_FILTER_TYPE_ID] = (char *)"PF";
+    f.str[KEEP_OR_DISCARD_ID] = (char *)action;
+    f.str[TCP_OR_UDP_ID] = (char *)proto;
+    f.str[SOURCE_OR_DESTINATION_ID] = (char *)dir;
+    f.str[PORT_NUMBER_ID] = (char *)port;
+    return f;
+}
+
+static form_t eth_form(const char *action, const char *eth_type)
+{
+    form_t f;
+
+    memset(&f, 0, sizeof(f));
+    f.str[PKT_FILTER_TYPE_ID] = (char *)"ET";
+    f.str[KEEP_OR_DISCARD_ID] = (char *)action;
+    f.str[ETH_TYPE_VALUE_ID] = (char *)eth_type;
+    return f;
+}
+
+static form_t ip_form(const char *action, const char *ip_type, const char *version,
+                      const char *icmp6_type)
+{
+    form_t f;
+
+    memset(&f, 0, sizeof(f));
+    f.str[PKT_FILTER_TYPE_ID] = (char *)"IT";
+    f.str[KEEP_OR_DISCARD_ID] = (char *)action;
+    f.str[IP_TYPE_VALUE_ID] = (char *)ip_type;
+    f.str[IP_VERSION_ID] = (char *)version;
+    f.str[ICMP6_TYPE_ID] = (char *)icmp6_type;
+    return f;
+}
+
+static cy_rslt_t parse(form_t f, cy_pf_ol_cfg_t *cfg, pf_ipv6_attr_t *ipv6 = NULL)
+{
+    pf_ipv6_attr_t unused;
+
+    memset(cfg, 0, sizeof(*cfg));
+    return pf_parse_filter(f.str, cfg, (NULL != ipv6) ? ipv6 : &unused);
+}
+
+static cy_rslt_t add(test_list_t *l, form_t f)
+{
+    return pf_list_add(&l->list, f.str);
+}
+
+static void test_parse_port_filter(void)
+{
+    cy_pf_ol_cfg_t cfg;
+
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(port_form("K", "T", "DP", "80"), &cfg));
+    CHECK_EQ(CY_PF_OL_FEAT_PORTNUM, cfg.feature);
+    CHECK_EQ(80, cfg.u.pf.portnum.portnum);
+    CHECK_EQ(0, cfg.u.pf.portnum.range);
+    CHECK_EQ(PF_PN_PORT_DEST, cfg.u.pf.portnum.direction);
+    CHECK_EQ(CY_PF_PROTOCOL_TCP, cfg.u.pf.proto);
+    CHECK_EQ((uint32_t)(CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE), cfg.bits);
+
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(port_form("D", "U", "SP", "65535"), &cfg));
+    CHECK_EQ(65535, cfg.u.pf.portnum.portnum);
+    CHECK_EQ(PF_PN_PORT_SOURCE, cfg.u.pf.portnum.direction);
+    CHECK_EQ(CY_PF_PROTOCOL_UDP, cfg.u.pf.proto);
+    CHECK(cfg.bits & CY_PF_ACTION_DISCARD);
+
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form("K", "T", "DP", "65536"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form("K", "T", "DP", "-1"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form("K", "T", "DP", "80x"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form("K", "T", "DP", ""), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form("K", "T", "DP", NULL), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form("K", NULL, "DP", "80"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(port_form(NULL, "T", "DP", "80"), &cfg));
+}
+
+static void test_parse_eth_and_ip_filters(void)
+{
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(eth_form("K", "0x806"), &cfg));
+    CHECK_EQ(CY_PF_OL_FEAT_ETHTYPE, cfg.feature);
+    CHECK_EQ(0x806, cfg.u.eth.eth_type);
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(eth_form("K", "34525"), &cfg));
+    CHECK_EQ(PF_ETH_TYPE_IPV6, cfg.u.eth.eth_type);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(eth_form("K", "0x7FF"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(eth_form("K", "0x10000"), &cfg));
+
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(ip_form("D", "0x11", NULL, NULL), &cfg, &ipv6));
+    CHECK_EQ(CY_PF_OL_FEAT_IPTYPE, cfg.feature);
+    CHECK_EQ(17, cfg.u.ip.ip_type);
+    CHECK_EQ(0, ipv6.flags);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "0", NULL, NULL), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "256", NULL, NULL), &cfg));
+
+    /* IPv6 next header, optionally narrowed to one ICMPv6 type. The bits
+     * read by the LPA only hold its own flags.
+     */
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(ip_form("K", "58", "6", "135"), &cfg, &ipv6));
+    CHECK_EQ(PF_IPV6_NEXT_HEADER | PF_IPV6_ICMP6_TYPE, ipv6.flags);
+    CHECK_EQ(135, ipv6.icmp6_type);
+    CHECK_EQ((uint32_t)(CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE), cfg.bits);
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(ip_form("K", "17", "6", NULL), &cfg, &ipv6));
+    CHECK_EQ(PF_IPV6_NEXT_HEADER, ipv6.flags);
+    CHECK_EQ((uint32_t)(CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE), cfg.bits);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("D", "17", "6", NULL), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "44", "6", NULL), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "17", "6", "135"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "58", "4", NULL), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "58", "6", "256"), &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(ip_form("K", "17", "5", NULL), &cfg));
+}
+
+static void test_parse_active_mode(void)
+{
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+    form_t f = port_form("K", "U", "DP", "53");
+
+    f.str[ACTIVE_MODE_ID] = (char *)"S";
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(f, &cfg));
+    CHECK_EQ((uint32_t)CY_PF_ACTIVE_SLEEP, cfg.bits);
+    f.str[ACTIVE_MODE_ID] = (char *)"W";
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(f, &cfg));
+    CHECK_EQ((uint32_t)CY_PF_ACTIVE_WAKE, cfg.bits);
+    f.str[ACTIVE_MODE_ID] = (char *)"A";
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(f, &cfg));
+    CHECK_EQ((uint32_t)(CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE), cfg.bits);
+    f.str[ACTIVE_MODE_ID] = (char *)"X";
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(f, &cfg));
+
+    f.str[PKT_FILTER_TYPE_ID] = (char *)"ZZ";
+    f.str[ACTIVE_MODE_ID] = NULL;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, parse(f, &cfg));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_parse_filter(NULL, &cfg, &ipv6));
+}
+
+static void test_add_and_validate(void)
+{
+    test_list_t l;
+
+    list_init(&l);
+    CHECK_EQ(0, list_count(&l));
+
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "T", "DP", "80")));
+    CHECK_EQ(1, list_count(&l));
+    CHECK_EQ(0u, l.cfgs[0].id);
+    CHECK_EQ(CY_PF_OL_FEAT_LAST, l.cfgs[1].feature);
+
+    /* Duplicates are rejected, other protocol or direction is not one. */
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_validate(&l.list, port_form("K", "T", "DP", "80").str));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, port_form("K", "T", "DP", "80")));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", "80")));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "T", "SP", "80")));
+    CHECK_EQ(3, list_count(&l));
+
+    /* Keep and discard filters do not mix. */
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, eth_form("D", "0x806")));
+    CHECK_EQ(3, list_count(&l));
+
+    /* An IPv6 filter on any ICMPv6 type covers the narrowed ones. */
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, ip_form("K", "58", "6", NULL)));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, ip_form("K", "58", "6", "135")));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, ip_form("K", "6", NULL, NULL)));
+    CHECK_EQ(5, list_count(&l));
+
+    /* IPv6 filters are covered by a keep filter on the IPv6 Ether type. */
+    list_init(&l);
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, eth_form("K", "0x86DD")));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, ip_form("K", "17", "6", NULL)));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, ip_form("K", "17", NULL, NULL)));
+
+    /* The same holds when the IPv6 filter is added first. */
+    list_init(&l);
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, ip_form("K", "17", "6", NULL)));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, eth_form("K", "0x86DD")));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, eth_form("K", "0x800")));
+    CHECK_EQ(2, list_count(&l));
+
+    /* Nothing follows a discard filter. */
+    list_init(&l);
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, eth_form("D", "0x806")));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, eth_form("D", "0x800")));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, port_form("K", "U", "DP", "53")));
+    CHECK_EQ(1, list_count(&l));
+}
+
+static void test_list_full(void)
+{
+    test_list_t l;
+    char port[8];
+
+    list_init(&l);
+    for (int i = 0; i < MAX_FILTERS - 1; i++)
+    {
+        snprintf(port, sizeof(port), "%d", 1000 + i);
+        CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", port)));
+        CHECK_EQ((uint32_t)i, l.cfgs[i].id);
+    }
+    CHECK_EQ(MAX_FILTERS - 1, list_count(&l));
+    CHECK_EQ(CY_PF_OL_FEAT_LAST, l.cfgs[MAX_FILTERS - 1].feature);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, add(&l, port_form("K", "U", "DP", "2000")));
+    CHECK_EQ(MAX_FILTERS - 1, list_count(&l));
+    CHECK_EQ((1u << (MAX_FILTERS - 1)) - 1, l.list.id_map);
+}
+
+static void test_remove_by_id(void)
+{
+    test_list_t l;
+
+    list_init(&l);
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", "1")));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", "2")));
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", "3")));
+    CHECK_EQ(0x7u, l.list.id_map);
+
+    /* The following filters move down and keep their order and IDs. */
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_remove(&l.list, 1));
+    CHECK_EQ(2, list_count(&l));
+    CHECK_EQ(1, l.cfgs[0].u.pf.portnum.portnum);
+    CHECK_EQ(0u, l.cfgs[0].id);
+    CHECK_EQ(3, l.cfgs[1].u.pf.portnum.portnum);
+    CHECK_EQ(2u, l.cfgs[1].id);
+    CHECK_EQ(CY_PF_OL_FEAT_LAST, l.cfgs[2].feature);
+    CHECK_EQ(0x5u, l.list.id_map);
+
+    /* Unknown and out of range IDs. */
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_remove(&l.list, 1));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_remove(&l.list, PF_LIST_MAX_ID));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_remove(&l.list, 255));
+
+    /* The freed ID is the lowest free one and is taken again. */
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", "4")));
+    CHECK_EQ(1u, l.cfgs[2].id);
+    CHECK_EQ(0x7u, l.list.id_map);
+
+    /* Remove-last removes the last added filter, whatever its ID. */
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_remove_last(&l.list));
+    CHECK_EQ(0x5u, l.list.id_map);
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_remove_last(&l.list));
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_remove_last(&l.list));
+    CHECK_EQ(0, list_count(&l));
+    CHECK_EQ(0u, l.list.id_map);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_remove_last(&l.list));
+}
+
+static void test_set(void)
+{
+    test_list_t l;
+    cy_pf_ol_cfg_t cfgs[MAX_FILTERS];
+    pf_ipv6_attrs_t ipv6;
+
+    memset(cfgs, 0, sizeof(cfgs));
+    for (int i = 0; i < 4; i++)
+    {
+        cfgs[i].feature = CY_PF_OL_FEAT_ETHTYPE;
+        cfgs[i].u.eth.eth_type = (uint16_t)(0x800 + i);
+    }
+    /* Valid, duplicate, out of range and valid IDs. */
+    cfgs[0].id = 5;
+    cfgs[1].id = 5;
+    cfgs[2].id = PF_LIST_MAX_ID + 3;
+    cfgs[3].id = 0;
+
+    list_init(&l);
+    CHECK_EQ(CY_RSLT_SUCCESS, add(&l, port_form("K", "U", "DP", "1")));
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_set(&l.list, cfgs, NULL, 4));
+    CHECK_EQ(4, list_count(&l));
+    CHECK_EQ(CY_PF_OL_FEAT_LAST, l.cfgs[4].feature);
+    CHECK_EQ(5u, l.cfgs[0].id);
+    CHECK_EQ(1u, l.cfgs[1].id);
+    CHECK_EQ(2u, l.cfgs[2].id);
+    CHECK_EQ(0u, l.cfgs[3].id);
+    CHECK_EQ(0x27u, l.list.id_map);
+    CHECK_EQ(0x803, l.cfgs[3].u.eth.eth_type);
+
+    /* Too many filters leave the list unchanged. */
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set(&l.list, cfgs, NULL, MAX_FILTERS));
+    CHECK_EQ(4, list_count(&l));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set(&l.list, NULL, NULL, 1));
+
+    /* An empty list. */
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_set(&l.list, NULL, NULL, 0));
+    CHECK_EQ(0, list_count(&l));
+    CHECK_EQ(0u, l.list.id_map);
+    CHECK_EQ(CY_PF_OL_FEAT_LAST, l.cfgs[0].feature);
+
+    /* The IPv6 attributes follow their filter to a new ID, and go with
+     * the ID when the filter is removed.
+     */
+    memset(&ipv6, 0, sizeof(ipv6));
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(ip_form("K", "17", "6", NULL), &cfgs[1], &ipv6.attr[5]));
+    cfgs[1].id = 5;
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_set(&l.list, cfgs, &ipv6, 2));
+    CHECK_EQ(0u, l.cfgs[1].id);
+    CHECK(!PF_IS_IPV6(&l.cfgs[0], &l.list.ipv6));
+    CHECK(PF_IS_IPV6(&l.cfgs[1], &l.list.ipv6));
+    CHECK_EQ(0, l.list.ipv6.attr[5].flags);
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_remove(&l.list, 0));
+    CHECK_EQ(0, l.list.ipv6.attr[0].flags);
+}
+
+static void test_set_checked(void)
+{
+    test_list_t l;
+    cy_pf_ol_cfg_t cfgs[3];
+    pf_ipv6_attrs_t ipv6;
+
+    memset(cfgs, 0, sizeof(cfgs));
+    memset(&ipv6, 0, sizeof(ipv6));
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(port_form("K", "U", "DP", "53"), &cfgs[0]));
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(eth_form("K", "0x806"), &cfgs[1]));
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(ip_form("K", "58", "6", "135"), &cfgs[2], &ipv6.attr[2]));
+    cfgs[1].id = 1;
+    cfgs[2].id = 2;
+
+    list_init(&l);
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_set_checked(&l.list, cfgs, &ipv6, 3));
+    CHECK_EQ(3, list_count(&l));
+    CHECK_EQ(0x7u, l.list.id_map);
+    CHECK(PF_IS_IPV6(&l.cfgs[2], &l.list.ipv6));
+    CHECK_EQ(135, l.list.ipv6.attr[2].icmp6_type);
+
+    /* Duplicates. */
+    cfgs[1] = cfgs[0];
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, cfgs, &ipv6, 3));
+    CHECK_EQ(0, list_count(&l));
+
+    /* Keep and discard filters mixed, or a filter after a discard one. */
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(eth_form("D", "0x806"), &cfgs[1]));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, cfgs, NULL, 2));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[1], &ipv6, 2));
+    CHECK_EQ(CY_RSLT_SUCCESS, pf_list_set_checked(&l.list, &cfgs[1], NULL, 1));
+
+    /* A filter active in no host state, or of an unknown feature. */
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(eth_form("K", "0x806"), &cfgs[1]));
+    cfgs[1].bits &= ~(CY_PF_ACTIVE_SLEEP | CY_PF_ACTIVE_WAKE);
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[1], NULL, 1));
+    cfgs[1].bits |= CY_PF_ACTIVE_WAKE;
+    cfgs[1].feature = (cy_pf_ol_feat_t)0x7F;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[1], NULL, 1));
+
+    /* IPv6 filters next to the IPv6 Ether type. */
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(eth_form("K", "0x86DD"), &cfgs[1]));
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[1], &ipv6, 2));
+    CHECK_EQ(0, list_count(&l));
+
+    /* IPv6 attributes which the web page never produces: unknown flags,
+     * an ICMPv6 type without the IPv6 next header or on another protocol.
+     */
+    ipv6.attr[2].flags |= 0x80;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[2], &ipv6, 1));
+    ipv6.attr[2].flags = PF_IPV6_ICMP6_TYPE;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[2], &ipv6, 1));
+    ipv6.attr[2].flags = PF_IPV6_NEXT_HEADER | PF_IPV6_ICMP6_TYPE;
+    cfgs[2].u.ip.ip_type = 17;
+    CHECK_EQ(CY_RSLT_TYPE_ERROR, pf_list_set_checked(&l.list, &cfgs[2], &ipv6, 1));
+    CHECK_EQ(0, list_count(&l));
+}
+
+static void test_print_filter(void)
+{
+    cy_pf_ol_cfg_t cfg;
+    pf_ipv6_attr_t ipv6;
+    char out[512] = "";
+    char build[64];
+
+    CHECK_EQ(CY_RSLT_SUCCESS, parse(ip_form("K", "58", "6", "135"), &cfg, &ipv6));
+    cfg.id = 3;
+    print_filter(&cfg, &ipv6, out, build, sizeof(build));
+    CHECK(NULL != strstr(out, "ID 3[IP Type]"));
+    CHECK(NULL != strstr(out, "Packet Type = 0x3a"));
+    CHECK(NULL != strstr(out, "IP Version = 6"));
+    CHECK(NULL != strstr(out, "ICMPv6 Type = 135"));
+    CHECK(NULL != strstr(out, "Action = Keep"));
+}
+
+int main(void)
+{
+    RUN_TEST(test_parse_port_filter);
+    RUN_TEST(test_parse_eth_and_ip_filters);
+    RUN_TEST(test_parse_active_mode);
+    RUN_TEST(test_add_and_validate);
+    RUN_TEST(test_list_full);
+    RUN_TEST(test_remove_by_id);
+    RUN_TEST(test_set);
+    RUN_TEST(test_set_checked);
+    RUN_TEST(test_print_filter);
+
+    return HOST_TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
+
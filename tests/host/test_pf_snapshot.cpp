@@ -0,0 +1,281 @@
+/******************************************************************************
+ * File Name: test_pf_snapshot.cpp
+ *
+ * Description:
+ *   Host unit tests of the packet filter list snapshots (pf_snapshot.cpp),
+ *   run with threads: publication while reading, and more read sections
+ *   than reader slots.
+ *
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "mbed.h"
+#include "pf_snapshot.h"
+#include "host_test.h"
+
+/******************************************************************************
+ *                                 MACROS
+ *****************************************************************************/
+/* Versions published by the writer of test_publish_while_reading(). */
+#define PUBLISH_VERSIONS                   (20000)
+
+/* Reader threads of test_publish_while_reading(). */
+#define PUBLISH_READERS                    (PF_SNAPSHOT_READER_THREADS - 1)
+
+/* Reader threads of test_more_readers(), twice the reader slots. */
+#define MORE_READERS                       (2 * PF_SNAPSHOT_MAX_READERS)
+
+/******************************************************************************
+ *                            GLOBAL VARIABLES
+ *****************************************************************************/
+/* Errors seen by the threads, checked by the test once they are joined. */
+static volatile uint32_t thread_errors;
+
+static volatile uint32_t writer_done;
+static pthread_barrier_t inside_barrier;
+static pthread_barrier_t leave_barrier;
+
+/******************************************************************************
+ *                         FUNCTION DEFINITIONS
+ *****************************************************************************/
+/* Publishes a list whose filters all carry the low byte of the tag. */
+static void publish_tagged(uint32_t tag)
+{
+    cy_pf_ol_cfg_t cfgs[MAX_FILTERS];
+    uint8_t count = (uint8_t)(tag % MAX_FILTERS);
+
+    memset(cfgs, 0, sizeof(cfgs));
+    for (uint8_t i = 0; i < count; i++)
+    {
+        cfgs[i].feature = CY_PF_OL_FEAT_IPTYPE;
+        cfgs[i].id = (uint8_t)tag;
+        cfgs[i].u.ip.ip_type = (uint8_t)(tag >> 8);
+    }
+    pf_snapshot_publish(PF_SNAPSHOT_ACTIVE, cfgs, NULL, count, false);
+}
+
+/* Returns true if a snapshot holds the list published by publish_tagged()
+ * for its tag, the tag being the version relative to base.
+ */
+static bool snapshot_is_tagged(const pf_snapshot_t *snapshot, uint32_t base)
+{
+    uint32_t tag = snapshot->version - base;
+
+    if (snapshot->count != (uint8_t)(tag % MAX_FILTERS))
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < snapshot->count; i++)
+    {
+        if ((CY_PF_OL_FEAT_IPTYPE != snapshot->cfgs[i].feature) ||
+            ((uint8_t)tag != snapshot->cfgs[i].id) ||
+            ((uint8_t)(tag >> 8) != snapshot->cfgs[i].u.ip.ip_type))
+        {
+            return false;
+        }
+    }
+    return (CY_PF_OL_FEAT_LAST == snapshot->cfgs[snapshot->count].feature);
+}
+
+/* Version of the list published last, read outside of the other readers. */
+static uint32_t current_version(void)
+{
+    pf_snapshot_reader_t reader = pf_snapshot_read_lock();
+    uint32_t version = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE)->version;
+
+    pf_snapshot_read_unlock(reader);
+    return version;
+}
+
+static void *publish_writer(void *arg)
+{
+    uint32_t base = *(const uint32_t *)arg;
+
+    for (uint32_t version = base + 1; version <= base + PUBLISH_VERSIONS; version++)
+    {
+        publish_tagged(version - base);
+    }
+    core_util_atomic_store_u32(&writer_done, 1);
+    return NULL;
+}
+
+/* Reads while the writer publishes: a snapshot stays whole and unchanged
+ * for the read section, and the versions read never go back.
+ */
+static void *publish_reader(void *arg)
+{
+    uint32_t base = *(const uint32_t *)arg;
+    uint32_t last_version = 0;
+    pf_snapshot_reader_t reader;
+    const pf_snapshot_t *snapshot = NULL;
+    uint32_t version = 0;
+
+    while (!core_util_atomic_load_u32(&writer_done))
+    {
+        reader = pf_snapshot_read_lock();
+        snapshot = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+        version = snapshot->version;
+        if (!snapshot_is_tagged(snapshot, base) || (version < last_version))
+        {
+            core_util_atomic_incr_u32(&thread_errors, 1);
+        }
+        sched_yield();
+        if ((version != snapshot->version) || !snapshot_is_tagged(snapshot, base))
+        {
+            core_util_atomic_incr_u32(&thread_errors, 1);
+        }
+        pf_snapshot_read_unlock(reader);
+        last_version = version;
+    }
+    return NULL;
+}
+
+static void test_publish_while_reading(void)
+{
+    pthread_t writer;
+    pthread_t readers[PUBLISH_READERS];
+    uint32_t base = 0;
+
+    publish_tagged(0);
+    base = current_version();
+    thread_errors = 0;
+    writer_done = 0;
+
+    for (uint8_t i = 0; i < PUBLISH_READERS; i++)
+    {
+        CHECK_EQ(0, pthread_create(&readers[i], NULL, publish_reader, &base));
+    }
+    CHECK_EQ(0, pthread_create(&writer, NULL, publish_writer, &base));
+    pthread_join(writer, NULL);
+    for (uint8_t i = 0; i < PUBLISH_READERS; i++)
+    {
+        pthread_join(readers[i], NULL);
+    }
+
+    CHECK_EQ(0u, thread_errors);
+
+    /* A version staged while the snapshots were held is published by the
+     * last reader leaving, or by the writer once they all left.
+     */
+    CHECK_EQ(base + PUBLISH_VERSIONS, current_version());
+}
+
+/* Enters a read section with the other readers, then leaves it once the
+ * test published while they were all inside.
+ */
+static void *more_reader(void *arg)
+{
+    uint32_t base = *(const uint32_t *)arg;
+    pf_snapshot_reader_t reader = pf_snapshot_read_lock();
+    const pf_snapshot_t *snapshot = pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE);
+
+    if ((base != snapshot->version) || !snapshot_is_tagged(snapshot, base))
+    {
+        core_util_atomic_incr_u32(&thread_errors, 1);
+    }
+
+    pthread_barrier_wait(&inside_barrier);
+    pthread_barrier_wait(&leave_barrier);
+
+    if ((base != snapshot->version) || !snapshot_is_tagged(snapshot, base))
+    {
+        core_util_atomic_incr_u32(&thread_errors, 1);
+    }
+    pf_snapshot_read_unlock(reader);
+    return NULL;
+}
+
+static void test_more_readers(void)
+{
+    pthread_t readers[MORE_READERS];
+    pf_snapshot_reader_t reader;
+    uint32_t base = 0;
+
+    publish_tagged(0);
+    base = current_version();
+    thread_errors = 0;
+    pthread_barrier_init(&inside_barrier, NULL, MORE_READERS + 1);
+    pthread_barrier_init(&leave_barrier, NULL, MORE_READERS + 1);
+
+    for (uint8_t i = 0; i < MORE_READERS; i++)
+    {
+        CHECK_EQ(0, pthread_create(&readers[i], NULL, more_reader, &base));
+    }
+    pthread_barrier_wait(&inside_barrier);
+
+    /* Every slot is taken: one more section shares the slot of the others,
+     * and so does not block either.
+     */
+    reader = pf_snapshot_read_lock();
+    CHECK_EQ(PF_SNAPSHOT_READER_SHARED, reader);
+    CHECK_EQ(base, pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE)->version);
+    pf_snapshot_read_unlock(reader);
+
+    /* Publishing neither blocks nor changes the held snapshot. The versions
+     * beyond the free snapshots stay staged.
+     */
+    for (uint32_t tag = 1; tag <= PF_SNAPSHOT_SLOTS + 2; tag++)
+    {
+        publish_tagged(tag);
+    }
+
+    pthread_barrier_wait(&leave_barrier);
+    for (uint8_t i = 0; i < MORE_READERS; i++)
+    {
+        pthread_join(readers[i], NULL);
+    }
+    pthread_barrier_destroy(&inside_barrier);
+    pthread_barrier_destroy(&leave_barrier);
+
+    CHECK_EQ(0u, thread_errors);
+
+    /* The last reader leaving published the staged version. */
+    reader = pf_snapshot_read_lock();
+    CHECK(PF_SNAPSHOT_READER_SHARED != reader);
+    CHECK_EQ(base + PF_SNAPSHOT_SLOTS + 2, pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE)->version);
+    CHECK(snapshot_is_tagged(pf_snapshot_get(reader, PF_SNAPSHOT_ACTIVE), base));
+    pf_snapshot_read_unlock(reader);
+}
+
+int main(void)
+{
+    RUN_TEST(test_publish_while_reading);
+    RUN_TEST(test_more_readers);
+
+    return HOST_TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+"""
+Generator of the kit configurations of the packet filter offload example.
+
+Reads the single policy file policy/wlan_policy.json and:
+
+- writes app/pf_policy.h, the default packet filter list of all the kits
+  as pf_dsl filters (see app/pf_dsl.h and app/pf_default_list.cpp);
+- writes, for each kit, the Wi-Fi and power parameters of
+  COMPONENT_CUSTOM_DESIGN_MODUS/TARGET_<kit>/design.modus and the same
+  settings in the sources the Device Configurator generates from it:
+  the host wake of GeneratedSource/cycfg_connectivity_wifi.h and the power
+  settings of GeneratedSource/cycfg_system.h and cycfg_system.c;
+- checks that the host wake pin in GeneratedSource/cycfg_pins.h is the one
+  of the policy. Moving a pin requires the Device Configurator;
+- prints, for each kit, the packet filter slots used in the WLAN device.
+
+The RAM and flash used by the packet filter lists are not estimated here:
+they depend on the compiler and on the options of mbed_app.json. See the
+RAM report printed by the kit at startup and the map file of the build.
+
+A kit inherits the "common" section of the policy; its entry in "targets"
+only lists what differs.
+
+Usage: gen_policy.py [--check]
+
+With --check, nothing is written: the generator exits with status 1 if a
+file is out of date with the policy or a host wake pin differs.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+POLICY = os.path.join(ROOT, "policy", "wlan_policy.json")
+HEADER = os.path.join(ROOT, "app", "pf_policy.h")
+MODUS_DIR = os.path.join(ROOT, "COMPONENT_CUSTOM_DESIGN_MODUS")
+
+LIST_HEADER = os.path.join(ROOT, "app", "pf_list.h")
+
+# design.modus parameters written from the policy.
+SUPPLY_PARAMS = ["vddaMv", "vdddMv", "vBackupMv", "vddNsMv", "vddio0Mv", "vddio1Mv"]
+POWER_PARAMS = ["actPwrMode", "coreRegulator", "idlePwrMode", "deepsleepLatency"]
+
+# cycfg_system.h supply defines, in the order of SUPPLY_PARAMS.
+SUPPLY_DEFINES = ["CY_CFG_PWR_VDDA_MV", "CY_CFG_PWR_VDDD_MV", "CY_CFG_PWR_VBACKUP_MV",
+                  "CY_CFG_PWR_VDD_NS_MV", "CY_CFG_PWR_VDDIO0_MV", "CY_CFG_PWR_VDDIO1_MV"]
+
+PROTOCOLS = {"tcp": "CY_PF_PROTOCOL_TCP", "udp": "CY_PF_PROTOCOL_UDP"}
+DIRECTIONS = {"dest": "PF_PN_PORT_DEST", "source": "PF_PN_PORT_SOURCE"}
+
+LICENSE = """\
+ ******************************************************************************
+ * Copyright (2019-2020), Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software (“EULA”).
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress’s integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death (“High Risk Product”). By
+ * including Cypress’s product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ *****************************************************************************/
+"""
+
+
+def fail(message):
+    sys.exit("gen_policy: " + message)
+
+
+def max_filters():
+    """Returns MAX_FILTERS, the entries of a packet filter list (app/pf_list.h)."""
+    with open(LIST_HEADER) as header:
+        match = re.search(r"#define MAX_FILTERS\s+\((\d+)\)", header.read())
+    if not match:
+        fail("app/pf_list.h has no MAX_FILTERS")
+    return int(match.group(1))
+
+
+def merge(base, delta):
+    """Returns base updated with delta, merging the nested sections."""
+    result = dict(base)
+    for key, value in delta.items():
+        if isinstance(value, dict) and isinstance(result.get(key), dict):
+            result[key] = merge(result[key], value)
+        else:
+            result[key] = value
+    return result
+
+
+def filter_key(rule):
+    """Identifies the packets a filter matches, whatever its action."""
+    if rule["type"] == "port":
+        return ("port", rule["protocol"], rule["direction"], int(rule["port"]))
+    return (rule["type"], int(str(rule[rule["type"]]), 0))
+
+
+def dsl_filter(rule):
+    """Returns the pf_dsl expression of one filter of the policy."""
+    kind = rule["type"]
+    if kind == "port":
+        if rule["protocol"] not in PROTOCOLS or rule["direction"] not in DIRECTIONS:
+            fail("%s: bad protocol or direction" % rule["name"])
+        expr = "pf_dsl::keep_port(%s, %s, %d)" % (
+            PROTOCOLS[rule["protocol"]], DIRECTIONS[rule["direction"]], int(rule["port"]))
+    elif kind == "ethtype":
+        expr = "pf_dsl::keep_ethtype(0x%04X)" % int(rule["ethtype"], 0)
+    elif kind == "iptype":
+        expr = "pf_dsl::keep_iptype(%d)" % int(str(rule["iptype"]), 0)
+    else:
+        fail("%s: unknown filter type %r" % (rule["name"], kind))
+    if rule["action"] == "discard":
+        expr = "pf_dsl::discard(%s)" % expr
+    elif rule["action"] != "keep":
+        fail("%s: unknown action %r" % (rule["name"], rule["action"]))
+    active = rule.get("active", "always")
+    if active in ("sleep", "wake"):
+        expr = "pf_dsl::%s_only(%s)" % (active, expr)
+    elif active != "always":
+        fail("%s: unknown active state %r" % (rule["name"], active))
+    return expr
+
+
+def check_filters(filters, slots, limit):
+    """Applies the rules of PF_DSL_STATIC_ASSERT_VALID before the build."""
+    keys = [filter_key(rule) for rule in filters]
+    discards = sum(rule["action"] == "discard" for rule in filters)
+    if len(filters) > min(slots, limit - 1):
+        fail("%d filters, only %d slots" % (len(filters), min(slots, limit - 1)))
+    if len(set(keys)) != len(keys):
+        fail("duplicate packet filters")
+    if discards and (discards != 1 or len(filters) != 1):
+        fail("a discard filter must be the only filter of the list")
+
+
+def render_header(filters):
+    lines = ["/******************************************************************************",
+             " * File Name: pf_policy.h",
+             " *",
+             " * Description:",
+             " *   This header file contains the default packet filter list of all the",
+             " *   kits. It is generated by tools/gen_policy.py from policy/wlan_policy.json;",
+             " *   edit the policy and run the generator rather than this file.",
+             " *"]
+    lines += LICENSE.rstrip("\n").split("\n")
+    lines += ["",
+              "#ifndef PF_POLICY_H",
+              "#define PF_POLICY_H",
+              "",
+              "#include \"pf_dsl.h\"",
+              "",
+              "/******************************************************************************",
+              " *                                 MACROS",
+              " *****************************************************************************/",
+              "/* Entries of the default packet filter list, in filter ID order. */",
+              "#define PF_POLICY_DEFAULT_FILTERS \\"]
+    exprs = [dsl_filter(rule) for rule in filters]
+    for i, (rule, expr) in enumerate(zip(filters, exprs)):
+        sep = "," if i < len(exprs) - 1 else ""
+        lines.append("    /* %-8s */ %s%s \\" % (rule["name"], expr, sep))
+    lines[-1] = lines[-1][:-2]
+    lines += ["",
+              "#endif /* #ifndef PF_POLICY_H */",
+              "",
+              "",
+              "/* [] END OF FILE */",
+              ""]
+    return "\n".join(lines) + "\n"
+
+
+def render_modus(text, target, config):
+    values = {"hostWake": config["host_wake"]["hostWake"],
+              "hostIRQ": config["host_wake"]["hostIRQ"]}
+    for param in POWER_PARAMS:
+        values[param] = str(config["power"][param])
+    for param in SUPPLY_PARAMS:
+        values[param] = str(config["power"]["supply_mv"])
+    for param, value in values.items():
+        pattern = r'(<Param id="%s" value=")[^"]*(")' % param
+        if not re.search(pattern, text):
+            fail("%s: design.modus has no parameter %s" % (target, param))
+        text = re.sub(pattern, lambda m: m.group(1) + value + m.group(2), text)
+    return text
+
+
+def render_defines(text, target, name, values):
+    """Returns a generated source with the values of its defines replaced."""
+    for define, value in values.items():
+        pattern = r"(#define %s )\S+" % define
+        if not re.search(pattern, text):
+            fail("%s: %s has no %s" % (target, name, define))
+        text = re.sub(pattern, lambda m: m.group(1) + value, text)
+    return text
+
+
+def render_system(text, target, config):
+    power = config["power"]
+    values = {"CY_CFG_PWR_SYS_IDLE_MODE": power["idlePwrMode"],
+              "CY_CFG_PWR_SYS_ACTIVE_MODE": "CY_CFG_PWR_MODE_" + power["actPwrMode"],
+              "CY_CFG_PWR_DEEPSLEEP_LATENCY": "%sUL" % power["deepsleepLatency"],
+              "CY_CFG_PWR_USING_LDO": "1" if "LDO" in power["coreRegulator"] else "0"}
+    for define in SUPPLY_DEFINES:
+        values[define] = str(power["supply_mv"])
+    return render_defines(text, target, "cycfg_system.h", values)
+
+
+def render_system_c(text, target, config):
+    ulp = "1" if config["power"]["actPwrMode"] == "ULP" else "0"
+    return render_defines(text, target, "cycfg_system.c", {"CY_CFG_PWR_USING_ULP": ulp})
+
+
+def render_wifi(text, target, config):
+    host_wake = config["host_wake"]
+    irq = host_wake["hostIRQ"]
+    values = {"CYCFG_WIFI_HOST_WAKE_ENABLED":
+                  "(1u)" if host_wake["hostWake"] == "true" else "(0u)",
+              "CYCFG_WIFI_HOST_WAKE_GPIO": irq + "_HAL_PORT_PIN",
+              "CYCFG_WIFI_HOST_WAKE_IRQ_EVENT": irq + "_HAL_IRQ"}
+    return render_defines(text, target, "cycfg_connectivity_wifi.h", values)
+
+
+def host_wake_pin(target):
+    path = os.path.join(MODUS_DIR, "TARGET_" + target, "GeneratedSource", "cycfg_pins.h")
+    with open(path) as pins:
+        text = pins.read()
+    port = re.search(r"#define CYBSP_WIFI_HOST_WAKE_PORT_NUM (\d+)U", text)
+    pin = re.search(r"#define CYBSP_WIFI_HOST_WAKE_PIN (\d+)U", text)
+    if not port or not pin:
+        return None
+    return "P%s_%s" % (port.group(1), pin.group(1))
+
+
+def update(path, text, check, stale):
+    if os.path.exists(path):
+        with open(path, encoding="utf-8", newline="") as current:
+            if current.read() == text:
+                return
+    stale.append(os.path.relpath(path, ROOT))
+    if not check:
+        with open(path, "w", encoding="utf-8", newline="") as out:
+            out.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="only check that the generated files are up to date")
+    args = parser.parse_args()
+
+    with open(POLICY) as policy_file:
+        policy = json.load(policy_file)
+    filters = policy["filters"]
+    limit = max_filters()
+    stale = []
+    errors = []
+
+    update(HEADER, render_header(filters), args.check, stale)
+
+    print("%-24s %-9s %-6s %7s" % ("kit", "wlan", "wake", "slots"))
+    for target, delta in sorted(policy["targets"].items()):
+        config = merge(policy["common"], delta)
+        check_filters(filters, config["filter_slots"], limit)
+
+        base = os.path.join(MODUS_DIR, "TARGET_" + target)
+        generated = os.path.join(base, "GeneratedSource")
+        outputs = [(os.path.join(base, "design.modus"), render_modus),
+                   (os.path.join(generated, "cycfg_connectivity_wifi.h"), render_wifi),
+                   (os.path.join(generated, "cycfg_system.h"), render_system),
+                   (os.path.join(generated, "cycfg_system.c"), render_system_c)]
+        for path, render in outputs:
+            with open(path, encoding="utf-8", newline="") as f:
+                update(path, render(f.read(), target, config), args.check, stale)
+
+        pin = host_wake_pin(target)
+        if pin != config["host_wake_pin"]:
+            errors.append("%s: host wake pin is %s, the policy says %s; move it with "
+                          "the Device Configurator" % (target, pin, config["host_wake_pin"]))
+
+        print("%-24s %-9s %-6s %3d/%-3d" % (
+            target, config["wlan"], pin, len(filters), config["filter_slots"]))
+
+    for path in stale:
+        print(("Out of date: " if args.check else "Updated: ") + path)
+    for error in errors:
+        print("Error: " + error, file=sys.stderr)
+    if errors or (args.check and stale):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
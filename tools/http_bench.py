@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Decoder of the page render benchmark of the packet filter offload example.
+
+Reads the serial terminal output of a kit built with http-bench-enable set
+to 1, extracts the "HTTP_BENCH" lines and prints the report as one JSON
+document. With --baseline, compares the report with an earlier one and
+exits with status 1 if the cycles, the response length, the number of
+writes or the stack use of any packet filter count grew by more than the
+tolerance. A log holding several runs, e.g. across resets, is reported from
+its last run.
+
+Usage: http_bench.py [LOG] [--baseline FILE] [--tolerance PERCENT]
+
+LOG defaults to the standard input, e.g.
+    mbed sterm | tee boot.log
+    http_bench.py boot.log > report.json
+or, without a kit, the host build of tests/host (cycles are nanoseconds):
+    bench_http | http_bench.py
+"""
+
+import argparse
+import json
+import sys
+
+TAG = "HTTP_BENCH "
+
+# Fields compared with the baseline. The minimum cycles are the least noisy.
+CHECKED = ["cycles_min", "bytes", "writes", "stack"]
+
+
+def decode(lines):
+    report = {"config": {}, "results": []}
+    for line in lines:
+        start = line.find(TAG)
+        if start < 0:
+            continue
+        record = json.loads(line[start + len(TAG):])
+        if "filters" in record:
+            report["results"].append(record)
+        else:
+            report = {"config": record, "results": []}
+    if not report["results"]:
+        sys.exit("No %r lines found." % TAG.strip())
+    return report
+
+
+def compare(report, baseline, tolerance):
+    previous = {r["filters"]: r for r in baseline["results"]}
+    regressions = []
+    for result in report["results"]:
+        base = previous.get(result["filters"])
+        if base is None:
+            continue
+        for field in CHECKED:
+            limit = base[field] * (1 + tolerance / 100.0)
+            if result[field] > limit:
+                regressions.append("filters=%d %s %d -> %d" % (
+                    result["filters"], field, base[field], result[field]))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("log", nargs="?", help="serial terminal output")
+    parser.add_argument("--baseline", help="earlier report to compare with")
+    parser.add_argument("--tolerance", type=float, default=5.0,
+                        help="allowed growth in percent (default 5)")
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, errors="replace") as log:
+            report = decode(log)
+    else:
+        report = decode(sys.stdin)
+    print(json.dumps(report, indent=2))
+
+    if args.baseline:
+        with open(args.baseline) as baseline:
+            regressions = compare(report, json.load(baseline), args.tolerance)
+        for regression in regressions:
+            print("Regression: " + regression, file=sys.stderr)
+        if regressions:
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
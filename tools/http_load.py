@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""
+Load generator for the web server of the packet filter offload example.
+
+For each active list size, applies a list of that many keep filters, then
+fills the pending list one keep filter at a time and, for each pending list
+size, requests the home page repeatedly to measure the requests per second,
+the latency percentiles and the bytes per response. Prints one JSON object
+per pair of list sizes, then the handler statistics measured by the server
+(/http_stats), with the stack high-water mark of each handler.
+
+Usage: http_load.py <IP address of the kit> [--requests N] [--filters N]
+                    [--active N]
+       http_load.py --server build-host/http_host [...]
+
+With --server, the host web server of tests/host is started on a free port
+of the workstation and measured instead of a kit: the same page handlers
+and lists, built for the workstation, where the commits complete at once.
+
+The pending list is cleared first with "Remove Last Filter" and left empty
+at the end. Each applied list makes the kit reassociate with the AP, and is
+stored; the filters of the active lists are only active while the host is
+asleep, so the kit stays reachable while it is awake. The default list is
+restored at the end, which also removes the stored list.
+"""
+
+import argparse
+import http.client
+import json
+import socket
+import subprocess
+import time
+
+# Fields of the "Add Filter" form, in the order the browser posts them. The
+# kit reads the fields by position, so every field is always posted.
+FORM_FIELDS = [
+    ("filter_type", "PF"), ("action", "K"), ("protocol", "T"),
+    ("direction", "DP"), ("port_number", ""), ("ether_type", "0x"),
+    ("ip_proto", "0x"), ("src_net", ""), ("dst_net", ""),
+    ("tcp_flags", ""), ("mcast", "A"), ("payload", ""), ("active", "A"),
+    ("ip_version", "4"), ("icmp6_type", ""),
+]
+
+# Mixed keep filters: port, Ether type and IP type.
+FILTERS = [
+    {"port_number": "80"},
+    {"filter_type": "ET", "ether_type": "0x0806"},
+    {"protocol": "U", "port_number": "68"},
+    {"protocol": "U", "direction": "SP", "port_number": "53"},
+    {"filter_type": "ET", "ether_type": "0x888E"},
+    {"filter_type": "IT", "ip_proto": "0x01"},
+    {"protocol": "U", "port_number": "5353"},
+    {"direction": "SP", "port_number": "1883"},
+    {"filter_type": "IT", "ip_proto": "0x11"},
+    {"protocol": "U", "port_number": "123"},
+]
+
+# Longest wait for a commit, which includes the reassociation of the kit.
+COMMIT_TIMEOUT_S = 60
+
+
+def form_body(fields):
+    """Builds the body posted by the "Add Filter" form."""
+    return "&".join("%s=%s" % (name, fields.get(name, default))
+                    for name, default in FORM_FIELDS)
+
+
+def request(server, method, path, body=None):
+    """Sends one request and returns (latency in seconds, response length, response)."""
+    conn = http.client.HTTPConnection(*server, timeout=10)
+    headers = {"Content-Type": "application/x-www-form-urlencoded"} if body else {}
+    start = time.perf_counter()
+    conn.request(method, path, body=body, headers=headers)
+    data = conn.getresponse().read()
+    latency = time.perf_counter() - start
+    conn.close()
+    return latency, len(data), data
+
+
+def percentile(samples, percent):
+    ordered = sorted(samples)
+    index = max(0, min(len(ordered) - 1, int(round(percent / 100.0 * len(ordered))) - 1))
+    return ordered[index]
+
+
+def measure(server, count):
+    latencies = []
+    sizes = []
+    start = time.perf_counter()
+    for _ in range(count):
+        latency, size, _ = request(server, "GET", "/")
+        latencies.append(latency)
+        sizes.append(size)
+    elapsed = time.perf_counter() - start
+    return {
+        "requests_per_s": round(count / elapsed, 2),
+        "latency_ms": {
+            "p50": round(percentile(latencies, 50) * 1000, 1),
+            "p90": round(percentile(latencies, 90) * 1000, 1),
+            "p99": round(percentile(latencies, 99) * 1000, 1),
+            "max": round(max(latencies) * 1000, 1),
+        },
+        "bytes_per_response": round(sum(sizes) / len(sizes)),
+    }
+
+
+def clear_pending(server):
+    for _ in range(len(FILTERS) + 1):
+        request(server, "GET", "/?remove=remove")
+
+
+def fill_pending(server, count, **fields):
+    for index in range(count):
+        request(server, "POST", "/?add=add", form_body(dict(FILTERS[index], **fields)))
+
+
+def commit(server, query):
+    """Requests a commit and waits for its end, across the reassociation."""
+    request(server, "GET", "/?%s=%s" % (query, query))
+    deadline = time.monotonic() + COMMIT_TIMEOUT_S
+    while time.monotonic() < deadline:
+        try:
+            _, _, status = request(server, "GET", "/commit_status")
+        except OSError:
+            status = b""
+        state = status.decode(errors="replace").split("\n", 1)[0]
+        if state in ("done", "failed"):
+            if state == "failed":
+                raise SystemExit("http_load: the commit failed")
+            return
+        time.sleep(0.5)
+    raise SystemExit("http_load: the commit did not end in %d s" % COMMIT_TIMEOUT_S)
+
+
+def free_port():
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def start_server(path):
+    """Starts the host web server and waits until it accepts connections."""
+    port = free_port()
+    process = subprocess.Popen([path, str(port)], stdout=subprocess.DEVNULL)
+    deadline = time.monotonic() + 10
+    while time.monotonic() < deadline:
+        if process.poll() is not None:
+            raise SystemExit("http_load: %s exited with %d" % (path, process.returncode))
+        try:
+            socket.create_connection(("127.0.0.1", port), timeout=1).close()
+            return process, ("127.0.0.1", port)
+        except OSError:
+            time.sleep(0.1)
+    process.kill()
+    raise SystemExit("http_load: %s does not accept connections" % path)
+
+
+def run(server, args):
+    clear_pending(server)
+    for active in range(min(args.active, len(FILTERS)) + 1):
+        fill_pending(server, active, active="S")
+        commit(server, "apply_filter")
+        for size in range(min(args.filters, len(FILTERS)) + 1):
+            if size:
+                request(server, "POST", "/?add=add", form_body(FILTERS[size - 1]))
+            result = {"active_filters": active, "pending_filters": size}
+            result.update(measure(server, args.requests))
+            print(json.dumps(result), flush=True)
+        clear_pending(server)
+    commit(server, "restore_defaults")
+
+    _, _, stats = request(server, "GET", "/http_stats")
+    print(stats.decode(errors="replace"), end="")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("host", nargs="?", help="IP address of the kit")
+    parser.add_argument("--port", type=int, default=80,
+                        help="TCP port of the web server of the kit")
+    parser.add_argument("--server", metavar="HTTP_HOST",
+                        help="host web server to start and measure instead of a kit")
+    parser.add_argument("--requests", type=int, default=50,
+                        help="home page requests per pair of list sizes")
+    parser.add_argument("--filters", type=int, default=len(FILTERS),
+                        help="largest pending list size measured")
+    parser.add_argument("--active", type=int, default=len(FILTERS),
+                        help="largest active list size measured")
+    args = parser.parse_args()
+    if (args.host is None) == (args.server is None):
+        parser.error("give either the IP address of the kit or --server")
+
+    if args.server:
+        process, server = start_server(args.server)
+        try:
+            run(server, args)
+        finally:
+            process.terminate()
+            process.wait()
+    else:
+        run((args.host, args.port), args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Decoder of the binary console logs of the packet filter offload example.
+
+With log-binary-enable set to 1 in mbed_app.json, the kit sends each log as
+a binary frame holding the address of its format string and its raw
+arguments (see app/app_log.cpp). This script reads the console output, looks
+the format strings up in the ELF file of the application, and prints the
+logs as text, prefixed with the kit time in seconds. The rest of the console
+output, such as the output of the libraries, is passed through.
+
+Usage: log_decode.py <ELF file of the application> [<input>]
+
+The input is a file or a serial device, stdin by default. Set a serial
+device to raw mode first, for example: stty -F /dev/ttyACM0 115200 raw
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+# Frame layout, see app_log_output() in app/app_log.cpp.
+FRAME_SYNC = 0x1E
+FRAME_HDR_LEN = 11
+
+LEVELS = {1: "Error: ", 2: "Info: "}
+
+# Argument types, see app_log_arg_t in app/app_log.h.
+ARG_I32, ARG_I64, ARG_F64, ARG_STR, ARG_PTR = range(1, 6)
+STR_TRUNCATED = 0x80
+
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d*)?)(?:hh|h|ll|l|j|z|t|L)?"
+                        r"([diouxXcsfFeEgGaAp%])")
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+
+def load_sections(path):
+    """Returns (address, bytes) of the sections of an ELF32 file loaded on the target."""
+    with open(path, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise SystemExit("%s: not a little-endian ELF32 file" % path)
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+    sections = []
+    for i in range(shnum):
+        _, sh_type, flags, addr, offset, size = struct.unpack_from(
+            "<IIIIII", data, shoff + i * shentsize)
+        if sh_type == SHT_PROGBITS and flags & SHF_ALLOC and size:
+            sections.append((addr, data[offset:offset + size]))
+    return sections
+
+
+def read_string(sections, addr):
+    """Returns the NUL-terminated string at a target address, or None."""
+    for base, data in sections:
+        if base <= addr < base + len(data):
+            end = data.find(b"\0", addr - base)
+            return data[addr - base:end if end >= 0 else None].decode("latin-1")
+    return None
+
+
+def parse_args(data):
+    """Returns the (type, value) arguments of a frame."""
+    args = []
+    pos = 0
+    while pos < len(data):
+        arg_type = data[pos]
+        if arg_type in (ARG_I32, ARG_PTR) and pos + 5 <= len(data):
+            args.append((arg_type, struct.unpack_from("<I", data, pos + 1)[0]))
+            pos += 5
+        elif arg_type == ARG_I64 and pos + 9 <= len(data):
+            args.append((arg_type, struct.unpack_from("<Q", data, pos + 1)[0]))
+            pos += 9
+        elif arg_type == ARG_F64 and pos + 9 <= len(data):
+            args.append((arg_type, struct.unpack_from("<d", data, pos + 1)[0]))
+            pos += 9
+        elif arg_type == ARG_STR and pos + 2 <= len(data):
+            length = data[pos + 1] & ~STR_TRUNCATED
+            text = data[pos + 2:pos + 2 + length].decode("latin-1")
+            if data[pos + 1] & STR_TRUNCATED:
+                text += "..."
+            args.append((arg_type, text))
+            pos += 2 + length
+        else:
+            break
+    return args
+
+
+def format_arg(spec, conv, arg):
+    """Formats one argument as the kit prints it in text mode."""
+    if arg is None:
+        return "?"
+    arg_type, value = arg
+    if conv in "diouxXc" and arg_type in (ARG_I32, ARG_I64):
+        bits = 32 if arg_type == ARG_I32 else 64
+        if conv in "di" and value >= 1 << (bits - 1):
+            value -= 1 << bits
+        return ("%" + spec + ("d" if conv == "u" else conv)) % value
+    if conv in "fFeEgGaA" and arg_type == ARG_F64:
+        return ("%" + spec + ("f" if conv in "aA" else conv)) % value
+    if conv == "s" and arg_type == ARG_STR:
+        return ("%" + spec + "s") % value
+    if conv == "p" and arg_type in (ARG_PTR, ARG_I32):
+        return ("%" + spec + "s") % ("0x%x" % value)
+    return "?"
+
+
+def format_log(fmt, args):
+    """Returns the text of a log from its format string and arguments."""
+    args = iter(args)
+
+    def convert(match):
+        if match.group(2) == "%":
+            return "%"
+        return format_arg(match.group(1), match.group(2), next(args, None))
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode_frame(sections, frame):
+    """Returns the text of a frame, or None if it is not a valid frame."""
+    check = 0
+    for byte in frame[1:-1]:
+        check ^= byte
+    if check != frame[-1]:
+        return None
+    fmt_addr, tick, level = struct.unpack_from("<IIB", frame, 2)
+    fmt = read_string(sections, fmt_addr)
+    if fmt is None:
+        fmt = "<unknown log 0x%08x>\n" % fmt_addr
+    text = format_log(fmt, parse_args(frame[FRAME_HDR_LEN:-1]))
+    return "[%10.3f] %s%s" % (tick / 1000.0, LEVELS.get(level, ""), text)
+
+
+def decode(sections, stream, out):
+    """Decodes the console output read from a binary stream."""
+    buf = b""
+    while True:
+        chunk = stream.read1(256) if hasattr(stream, "read1") else stream.read(256)
+        if not chunk:
+            break
+        buf += chunk
+        while buf:
+            sync = buf.find(bytes([FRAME_SYNC]))
+            if sync:
+                out.write(buf[:sync if sync > 0 else None].decode("latin-1"))
+                buf = buf[sync:] if sync > 0 else b""
+                continue
+            if len(buf) < 2 or len(buf) < buf[1] + 3:
+                break
+            frame = buf[:buf[1] + 3]
+            text = decode_frame(sections, frame)
+            if text is None:
+                # Not a frame: pass the sync byte through and resynchronize.
+                out.write(buf[:1].decode("latin-1"))
+                buf = buf[1:]
+            else:
+                out.write(text)
+                buf = buf[len(frame):]
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("elf", help="ELF file of the application running on the kit")
+    parser.add_argument("input", nargs="?", help="console output, stdin by default")
+    args = parser.parse_args()
+
+    sections = load_sections(args.elf)
+    if args.input:
+        with open(args.input, "rb", buffering=0) as stream:
+            decode(sections, stream, sys.stdout)
+    else:
+        decode(sections, sys.stdin.buffer, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()